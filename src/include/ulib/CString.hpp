@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2013-2016,2022 Michael Fink
+// Copyright (C) 2013-2016,2022,2026 Michael Fink
 //
 /// \file CString.hpp implementation of a platform independent CString class
 /// \note This implementation is not complete!
@@ -11,9 +11,25 @@
 #include <cstdarg>
 #include <cctype>
 #include <cstdio>
+#include <cstddef>
+#include <cstring>
+#include <cwchar>
+#include <cwctype>
 #include <atomic>
 #include <iterator>
 #include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <compare>
+#include <type_traits>
+#include <ulib/StringSearch.hpp>
+#include <ulib/CStringPool.hpp>
+#include <ulib/CStringStats.hpp>
+#include <ulib/StringFormat.hpp>
+#include <ulib/StringNumber.hpp>
+#include <ulib/StringHash.hpp>
+#include <ulib/CharConvert.hpp>
 
 #ifdef _MSC_VER
 // TODO remove once all methods are implemented
@@ -82,11 +98,21 @@ struct CharTypeTraits
    // narrow -> wide
    static int ConvertFromOther(LPWSTR strDestBuffer, int destLength, LPCSTR strSource)
    {
+      return ConvertFromOther(strDestBuffer, destLength, strSource, StringLength(strSource));
+   }
+
+   /// narrow -> wide, with given source length; returns number of converted
+   /// characters, without zero terminator, or -1 on conversion errors. When
+   /// strDestBuffer is nullptr, only the number of characters is returned.
+   static int ConvertFromOther(LPWSTR strDestBuffer, int destLength, LPCSTR strSource, int sourceLength)
+   {
+      if (sourceLength == 0)
+         return 0;
+
 #ifdef _MSC_VER
-      return ::MultiByteToWideChar(CP_ACP, 0, strSource, -1, strDestBuffer, destLength);
+      return ::MultiByteToWideChar(CP_ACP, 0, strSource, sourceLength, strDestBuffer, destLength);
 #elif defined(__ANDROID__)
-      size_t ret = mbstowcs(strDestBuffer, strSource, destLength);
-      return static_cast<int>(ret);
+      return CharConvert::NarrowToWide(strDestBuffer, destLength, strSource, sourceLength);
 #endif
    }
 
@@ -113,7 +139,7 @@ struct CharTypeTraits
    static int StringCompareIgnoreCase(PCXSTR lhs, PCXSTR rhs)
    {
 #ifdef _MSC_VER
-      return strcmpi(lhs, rhs);
+      return _stricmp(lhs, rhs);
 #elif defined(__ANDROID__)
       return strcasecmp(lhs, rhs);
 #endif
@@ -135,6 +161,11 @@ struct CharTypeTraits<WCHAR>
    typedef CharType* PXSTR;         ///< type of character string
    typedef const CharType* PCXSTR;  ///< type of character string; const version
 
+#ifdef __ANDROID__
+   /// max. buffer length used to determine the length of formatted text
+   static constexpr size_t c_maxFormatBufferLength = 16 * 1024 * 1024;
+#endif
+
    /// returns string length for wide character
    static int StringLength(const WCHAR* str)
    {
@@ -146,23 +177,29 @@ struct CharTypeTraits<WCHAR>
    /// returns string length for wide character, but only searches to a given max size
    static int StringLengthN(const WCHAR* str, int maxSize)
    {
-#ifdef _MSC_VER
       if (str == nullptr)
          return 0;
       return static_cast<int>(wcsnlen(str, maxSize));
-#elif defined(__ANDROID__)
-      return -1; // TODO
-#endif
    }
 
    // wide -> narrow
    static int ConvertFromOther(LPSTR strDestBuffer, int destLength, LPCWSTR strSource)
    {
+      return ConvertFromOther(strDestBuffer, destLength, strSource, StringLength(strSource));
+   }
+
+   /// wide -> narrow, with given source length; returns number of converted
+   /// bytes, without zero terminator, or -1 on conversion errors. When
+   /// strDestBuffer is nullptr, only the number of bytes is returned.
+   static int ConvertFromOther(LPSTR strDestBuffer, int destLength, LPCWSTR strSource, int sourceLength)
+   {
+      if (sourceLength == 0)
+         return 0;
+
 #ifdef _MSC_VER
-      return ::WideCharToMultiByte(CP_ACP, 0, strSource, -1, strDestBuffer, destLength, nullptr, nullptr);
+      return ::WideCharToMultiByte(CP_ACP, 0, strSource, sourceLength, strDestBuffer, destLength, nullptr, nullptr);
 #elif defined(__ANDROID__)
-      size_t ret = ::wcstombs(strDestBuffer, strSource, destLength);
-      return static_cast<int>(ret);
+      return CharConvert::WideToNarrow(strDestBuffer, destLength, strSource, sourceLength);
 #endif
    }
 
@@ -174,7 +211,28 @@ struct CharTypeTraits<WCHAR>
 
       return _vsnwprintf_s(strBuffer, bufferLength, bufferLength, strFormat, args);
 #elif defined(__ANDROID__)
-      return -1; // TODO
+      if (strBuffer != nullptr && bufferLength != 0)
+         return vswprintf(strBuffer, bufferLength, strFormat, args);
+
+      // unlike vsnprintf(), vswprintf() can't determine the length without a
+      // buffer, so format into a growing buffer until the text fits
+      std::vector<WCHAR> buffer(256);
+      for (;;)
+      {
+         va_list argsCopy;
+         va_copy(argsCopy, args);
+         int length = vswprintf(buffer.data(), buffer.size(), strFormat, argsCopy);
+         va_end(argsCopy);
+
+         if (length >= 0)
+            return length;
+
+         // -1 is also returned for encoding errors, so stop growing at some point
+         if (buffer.size() >= c_maxFormatBufferLength)
+            return -1;
+
+         buffer.resize(buffer.size() * 2);
+      }
 #endif
    }
 
@@ -198,10 +256,77 @@ struct CharTypeTraits<WCHAR>
    }
 };
 
+/// \brief Reference count policy for CStringT, using an atomic counter
+/// \details This is the default policy; strings may be passed between threads.
+struct CStringAtomicRefCount
+{
+   /// Type of the reference counter
+   typedef std::atomic<int> CountType;
+
+   /// Increments reference count
+   static void Increment(CountType& count) throw()
+   {
+      count.fetch_add(1, std::memory_order_relaxed);
+   }
+
+   /// Decrements reference count; returns true when the last reference was released
+   static bool Decrement(CountType& count) throw()
+   {
+      return count.fetch_sub(1, std::memory_order_acq_rel) <= 1;
+   }
+
+   /// Returns current reference count
+   static int Get(const CountType& count) throw()
+   {
+      return count.load(std::memory_order_acquire);
+   }
+};
+
+/// \brief Reference count policy for CStringT, using a plain integer counter
+/// \details Use this policy only for strings that are confined to a single
+/// thread; no atomic operations are used for reference counting.
+struct CStringLocalRefCount
+{
+   /// Type of the reference counter
+   typedef int CountType;
+
+   /// Increments reference count
+   static void Increment(CountType& count) throw()
+   {
+      ++count;
+   }
+
+   /// Decrements reference count; returns true when the last reference was released
+   static bool Decrement(CountType& count) throw()
+   {
+      return --count <= 0;
+   }
+
+   /// Returns current reference count
+   static int Get(const CountType& count) throw()
+   {
+      return count;
+   }
+};
+
+template <typename TString>
+class CStringConcatPartT;
+
+template <typename TString>
+class CStringConcatOwnedPartT;
+
+template <typename TString, typename TLeft, typename TRight>
+class CStringConcatT;
+
 /// \brief A platform independent MFC CString template class
 /// \details This class implements a platform independent string class
 /// that is modeled after the CStringT class found in the MFC library.
-template <typename T>
+/// Copies of a string share the heap allocated string data, using a
+/// reference count; modifying a string first makes its data unique (copy on
+/// write). Short strings are stored in an inline buffer and are copied.
+/// The reference count policy determines if string data may be shared
+/// between threads; see CStringAtomicRefCount and CStringLocalRefCount.
+template <typename T, typename TRefCount = CStringAtomicRefCount>
 class CStringT
 {
 public:
@@ -225,7 +350,8 @@ private:
    {
       int m_dataLength;         ///< actual length of string
       int m_allocLength;        ///< number of chars allocated in buffer
-      std::atomic<int> m_numRefs;  ///< number of references
+      typename TRefCount::CountType m_numRefs;  ///< number of references
+      mutable std::atomic<size_t> m_hash;       ///< cached hash value; 0 when not calculated yet
       // these fields are followed by the actual string buffer, and a zero terminator char
 
       void* GetData() throw()
@@ -235,71 +361,114 @@ private:
 
       void AddRef()
       {
-         ++m_numRefs;
+         TRefCount::Increment(m_numRefs);
       }
 
       void Release()
       {
-         ATLASSERT(m_numRefs != 0);
-         if (--m_numRefs <= 0)
+         ATLASSERT(TRefCount::Get(m_numRefs) != 0);
+         if (TRefCount::Decrement(m_numRefs))
             Free();
       }
 
       bool IsShared() const throw()
       {
-         return m_numRefs > 1;
+         return TRefCount::Get(m_numRefs) > 1;
+      }
+
+      /// Returns hash value of the string; calculates it on first call. Since
+      /// shared string data is never modified, the value can be cached even
+      /// when multiple threads access the data.
+      size_t GetHash() const throw()
+      {
+         size_t hash = m_hash.load(std::memory_order_relaxed);
+         if (hash == 0)
+         {
+            // when the hash value happens to be 0, it is calculated every time
+            hash = StringHash::Hash(static_cast<const XCHAR*>(
+               const_cast<CStringData*>(this)->GetData()), static_cast<size_t>(m_dataLength));
+
+            m_hash.store(hash, std::memory_order_relaxed);
+         }
+
+         return hash;
+      }
+
+      /// Invalidates cached hash value; must be called before modifying the string
+      void ResetHash() throw()
+      {
+         m_hash.store(0, std::memory_order_relaxed);
       }
 
+      /// Allocates string data for at least the given length; the allocated
+      /// length is rounded up to the pool's size class
       static CStringData* Allocate(int length) throw()
       {
          ATLASSERT(length >= 0);
          if (length < 0)
             return nullptr;
 
-         int dataBytes = (length + 1) * sizeof(XCHAR);
-         // TODO align size
-         int totalSize = sizeof(CStringData) + dataBytes;
-         CStringData* data = (CStringData*)malloc(totalSize);
+         size_t totalSize = CStringPool::RoundUpSize(GetAllocSize(length));
+         CStringData* data = (CStringData*)CStringPool::Allocate(totalSize);
 
          if (data == nullptr)
             return nullptr;
 
+         CStringStats::OnAllocate(totalSize);
+
          data->m_dataLength = 0;
-         data->m_allocLength = length;
+         data->m_allocLength = GetAllocLength(totalSize);
          data->m_numRefs = 1;
+         data->m_hash = 0;
 
          return data;
       }
 
-      /// Reallocates memory for string buffer; the buffer's content may be destroyed
+      /// Reallocates memory for string buffer; the buffer's content and the
+      /// string length are preserved
       static CStringData* Reallocate(CStringData* data, int length) throw()
       {
          ATLASSERT(length >= 0);
          if (length < 0)
             return data;
 
-         int dataBytes = (length + 1) * sizeof(XCHAR);
-         int totalSize = sizeof(CStringData) + dataBytes;
-         CStringData* newData = (CStringData*)realloc(data, totalSize);
+         size_t oldSize = GetAllocSize(data->m_allocLength);
+         size_t totalSize = CStringPool::RoundUpSize(GetAllocSize(length));
+         CStringData* newData = (CStringData*)CStringPool::Reallocate(data, oldSize, totalSize);
 
+         // when out of memory, the old data stays valid
          if (newData == nullptr)
-         {
-            free(data);
             return nullptr;
-         }
+
+         CStringStats::OnReallocate(oldSize, totalSize);
 
          data = newData;
 
-         data->m_dataLength = 0;
-         data->m_allocLength = length;
+         data->m_allocLength = GetAllocLength(totalSize);
          data->m_numRefs = 1;
+         data->m_hash = 0;
 
          return data;
       }
 
       void Free()
       {
-         free(this);
+         size_t size = GetAllocSize(m_allocLength);
+         CStringStats::OnFree(size);
+
+         CStringPool::Free(this, size);
+      }
+
+      /// Returns number of bytes needed for string data with given allocated length
+      static size_t GetAllocSize(int allocLength) throw()
+      {
+         return sizeof(CStringData) + (allocLength + 1) * sizeof(XCHAR);
+      }
+
+      /// Returns allocated length that fits into given number of bytes
+      static int GetAllocLength(size_t allocSize) throw()
+      {
+         return static_cast<int>((allocSize - sizeof(CStringData)) / sizeof(XCHAR)) - 1;
       }
    };
 
@@ -309,93 +478,82 @@ public:
    /// Default ctor
    CStringT()
    {
-      CStringData* data = GetNilString();
-      Attach(data);
+      SetInlineLength(0);
    }
 
-   /// Copy ctor
+   /// Copy ctor; shares the string data with the other string, except when
+   /// the other string uses its inline buffer
    CStringT(const CStringT& str)
    {
+      if (str.IsInline())
+      {
+         CopyInline(str);
+         return;
+      }
+
       CStringData* sourceData = str.GetData();
-      CStringData* newData = CloneData(sourceData);
-      Attach(newData);
+      sourceData->AddRef();
+      Attach(sourceData);
    }
 
    /// Copy ctor; using other char type
-   CStringT(const CStringT<YCHAR>& str)
+   CStringT(const CStringT<YCHAR, TRefCount>& str)
    {
-      Attach(GetNilString());
-
-      int destLength = CharTypeTraits<YCHAR>::ConvertFromOther(nullptr, 0, str);
-      if (destLength > 0)
-      {
-         PXSTR strBuffer = GetBuffer(destLength);
+      SetInlineLength(0);
 
-         CharTypeTraits<YCHAR>::ConvertFromOther(strBuffer, destLength, str);
-
-         ReleaseBufferSetLength(destLength);
-      }
-      else
-         Empty();
+      SetOtherString(str.GetString(), str.GetLength());
    }
 
    /// Ctor, taking a C style string, zero-terminated
    CStringT(PCXSTR str)
    {
       int length = CharTypeTraits<T>::StringLength(str);
-      CStringData* data = Allocate(length);
-      if (data == nullptr)
-         throw std::runtime_error("CString: out of memory");
+      Allocate(length);
 
-      Attach(data);
       SetLength(length);
-      CopyChars(m_data, length, str, length);
+      CopyChars(GetChars(), length, str, length);
    }
 
    /// Ctor, taking an other character type C style string, zero-terminated
    CStringT(PCYSTR str)
    {
-      Attach(GetNilString());
-
-      int destLength = CharTypeTraits<YCHAR>::ConvertFromOther(nullptr, 0, str);
-      if (destLength > 0)
-      {
-         PXSTR strBuffer = GetBuffer(destLength);
-
-         CharTypeTraits<YCHAR>::ConvertFromOther(strBuffer, destLength, str);
+      SetInlineLength(0);
 
-         ReleaseBufferSetLength(destLength);
-      }
-      else
-         Empty();
+      SetOtherString(str, CharTypeTraits<YCHAR>::StringLength(str));
    }
 
    /// Ctor, taking a C style string and a length
    CStringT(PCXSTR str, int length)
    {
-      CStringData* data = Allocate(length);
-      if (data == nullptr)
-         throw std::runtime_error("CString: out of memory");
+      Allocate(length);
 
-      Attach(data);
       SetLength(length);
-      CopyChars(m_data, length, str, length);
+      CopyChars(GetChars(), length, str, length);
    }
 
    /// Ctor, taking an other character type C style string and a length
    CStringT(PCYSTR str, int length)
    {
-      Attach(GetNilString());
+      SetInlineLength(0);
 
-      CStringT<YCHAR> otherStr(str, length);
+      SetOtherString(str, length);
+   }
+
+   /// Ctor, taking a concatenation of strings; see operator+
+   template <typename TLeft, typename TRight>
+   CStringT(const CStringConcatT<CStringT, TLeft, TRight>& concat)
+   {
+      int length = concat.GetLength();
+      Allocate(length);
 
-      SetString(otherStr);
+      concat.CopyTo(GetChars());
+      SetLength(length);
    }
 
    /// Ctor, taking a char and a repeat count
    CStringT(XCHAR ch, int repeat = 1)
    {
-      Attach(GetNilString());
+      SetInlineLength(0);
 
       ATLASSERT(repeat >= 0);
 
@@ -404,12 +562,7 @@ public:
 
       PXSTR buffer = GetBuffer(repeat);
 
-#ifdef _MSC_VER
-      auto targetIter = stdext::checked_array_iterator<PXSTR>(buffer, repeat);
-#elif defined(__ANDROID__)
-      auto targetIter = buffer;
-#endif
-      std::fill_n(targetIter, repeat, ch);
+      std::fill_n(buffer, repeat, ch);
 
       ReleaseBufferSetLength(repeat);
    }
@@ -417,24 +570,71 @@ public:
    /// Ctor, taking an other char type char and a repeat count
    CStringT(YCHAR ch, int repeat = 1)
    {
-      Attach(GetNilString());
+      SetInlineLength(0);
+
+      if (repeat <= 0)
+         return;
+
+      // a wide character may be converted to more than one narrow character
+      SetOtherString(&ch, 1);
+
+      int length = GetLength();
+      if (repeat > 1 && length > 0)
+      {
+         PXSTR buffer = GetBuffer(length * repeat);
+         for (int index = 1; index < repeat; index++)
+            CopyChars(buffer + index * length, length, buffer, length);
 
-      // TODO convert to other type, then flood characters
+         ReleaseBufferSetLength(length * repeat);
+      }
    }
 
    /// Dtor
    ~CStringT() throw()
    {
-      CStringData* data = GetData();
-      data->Release();
+      ReleaseStorage();
    }
 
    // operators
 
-   /// Assign operator
+   /// Assign operator; shares the string data with the other string, except
+   /// when the other string uses its inline buffer
    CStringT& operator=(const CStringT& str)
    {
-      SetString(str);
+      if (this == &str)
+         return *this;
+
+      if (str.IsInline())
+      {
+         ReleaseStorage();
+         CopyInline(str);
+         return *this;
+      }
+
+      CStringData* sourceData = str.GetData();
+      if (!IsInline() && GetData() == sourceData)
+         return *this;
+
+      sourceData->AddRef();
+      ReleaseStorage();
+      Attach(sourceData);
+
+      return *this;
+   }
+
+   /// Assign operator, taking a concatenation of strings; see operator+
+   template <typename TLeft, typename TRight>
+   CStringT& operator=(const CStringConcatT<CStringT, TLeft, TRight>& concat)
+   {
+      // a concatenation referencing this string is converted first, since
+      // its characters are overwritten
+      if (concat.IsReferencing(GetString(), GetString() + GetLength()))
+         return operator=(CStringT(concat));
+
+      int length = concat.GetLength();
+      concat.CopyTo(GetBuffer(length));
+      ReleaseBufferSetLength(length);
+
       return *this;
    }
 
@@ -445,6 +645,20 @@ public:
       return *this;
    }
 
+   /// Assign operator, using other char type
+   CStringT& operator=(const CStringT<YCHAR, TRefCount>& str)
+   {
+      SetOtherString(str.GetString(), str.GetLength());
+      return *this;
+   }
+
+   /// Assign operator, other character type C-style strings
+   CStringT& operator=(PCYSTR str)
+   {
+      SetOtherString(str, CharTypeTraits<YCHAR>::StringLength(str));
+      return *this;
+   }
+
    /// In-place add operator
    CStringT& operator+=(const CStringT& str)
    {
@@ -452,6 +666,14 @@ public:
       return *this;
    }
 
+   /// In-place add operator, taking a concatenation of strings
+   template <typename TLeft, typename TRight>
+   CStringT& operator+=(const CStringConcatT<CStringT, TLeft, TRight>& concat)
+   {
+      Append(concat);
+      return *this;
+   }
+
    /// In-place add operator, C-style strings
    CStringT& operator+=(PCXSTR str)
    {
@@ -474,13 +696,13 @@ public:
       if (!(index >= 0 && index <= GetLength()))
          throw std::invalid_argument("CString: invalid index argument to array operator");
 
-      return m_data[index];
+      return GetString()[index];
    }
 
    /// C-style string "cast" operator
    operator PCXSTR() const throw()
    {
-      return m_data;
+      return GetString();
    }
 
    /// Appends a C-style string
@@ -495,6 +717,25 @@ public:
       Append(str.GetString(), str.GetLength());
    }
 
+   /// Appends a concatenation of strings
+   template <typename TLeft, typename TRight>
+   void Append(const CStringConcatT<CStringT, TLeft, TRight>& concat)
+   {
+      int oldLength = GetLength();
+
+      // a concatenation referencing this string is converted first, since
+      // growing the buffer may move the characters
+      if (concat.IsReferencing(GetString(), GetString() + oldLength))
+      {
+         Append(CStringT(concat));
+         return;
+      }
+
+      int newLength = oldLength + concat.GetLength();
+      concat.CopyTo(GetBuffer(newLength) + oldLength);
+      ReleaseBufferSetLength(newLength);
+   }
+
    /// Appends a string, with given length
    void Append(PCXSTR str, int length)
    {
@@ -510,8 +751,16 @@ public:
 
       int newLength = iOldLength + length;
 
+      // appending a part of this string; the buffer may move when resizing
+      PCXSTR oldBuffer = GetString();
+      bool isSelfAppend = str >= oldBuffer && str <= oldBuffer + iOldLength;
+      ptrdiff_t selfOffset = str - oldBuffer;
+
       PXSTR buffer = GetBuffer(newLength);
 
+      if (isSelfAppend)
+         str = buffer + selfOffset;
+
       CopyChars(buffer + iOldLength, length, str, length);
 
       ReleaseBufferSetLength(newLength);
@@ -520,7 +769,15 @@ public:
    /// Appends a single character
    void AppendChar(XCHAR ch)
    {
-      // TODO convert to other type, then append
+      int length = GetLength();
+
+      // fast path: unique buffer with enough space left
+      PXSTR buffer = length < GetAllocLength() && !IsShared()
+         ? GetChars()
+         : PrepareWrite(length + 1);
+
+      buffer[length] = ch;
+      SetLength(length + 1);
    }
 
    /// Empties the string
@@ -529,11 +786,8 @@ public:
       if (GetLength() == 0)
          return;
 
-      CStringData* oldData = GetData();
-      oldData->Release();
-
-      CStringData* newData = GetNilString();
-      Attach(newData);
+      ReleaseStorage();
+      SetInlineLength(0);
    }
 
    /// Returns character at given index
@@ -544,18 +798,18 @@ public:
       if (!(index >= 0 && index <= GetLength()))
          throw std::invalid_argument("CString: invalid index argument to GetAt()");
 
-      return m_data[index];
+      return GetString()[index];
    }
 
    /// Returns a writable buffer of current string
    PXSTR GetBuffer()
    {
-      CStringData* data = GetData();
+      if (IsShared())
+         Fork(GetLength());
 
-      if (data->IsShared())
-         Fork(data->m_dataLength);
+      ResetHash();
 
-      return m_data;
+      return GetChars();
    }
 
    /// Returns a writable buffer of current string, with minimum given buffer length
@@ -578,8 +832,8 @@ public:
    {
       if (newLength == -1)
       {
-         int maxSize = GetData()->m_allocLength;
-         newLength = CharTypeTraits<T>::StringLengthN(m_data, maxSize);
+         int maxSize = GetAllocLength();
+         newLength = CharTypeTraits<T>::StringLengthN(GetString(), maxSize);
       }
 
       SetLength(newLength);
@@ -593,16 +847,115 @@ public:
       SetLength(newLength);
    }
 
+   /// \brief Reserves buffer for at least the given number of characters
+   /// \details The string isn't modified; appending characters up to the
+   /// given length won't reallocate the buffer. Shared strings get their own
+   /// buffer.
+   void Reserve(int length)
+   {
+      ATLASSERT(length >= 0);
+      if (length < 0)
+         throw std::invalid_argument("CString: invalid length argument to Reserve()");
+
+      if (length <= GetAllocLength() && !IsShared())
+         return;
+
+      length = std::max(length, GetLength());
+
+      if (IsShared())
+         Fork(length);
+      else
+         Reallocate(length);
+   }
+
+   /// Reserves buffer for at least the given number of characters; same as
+   /// Reserve(), for compatibility with ATL
+   void Preallocate(int length)
+   {
+      Reserve(length);
+   }
+
+   /// \brief Frees unused buffer space
+   /// \details Reallocates the buffer to the smallest size that fits the
+   /// string. Shared strings and strings in the inline buffer aren't modified.
+   void ShrinkToFit()
+   {
+      if (IsInline() || IsShared())
+         return;
+
+      int length = GetLength();
+
+      // check if a smaller size class fits the string
+      size_t minSize = length <= c_inlineLength ? 0 :
+         CStringPool::RoundUpSize(CStringData::GetAllocSize(length));
+
+      if (minSize >= CStringData::GetAllocSize(GetAllocLength()))
+         return;
+
+      Reallocate(length);
+   }
+
+   /// Frees unused buffer space; same as ShrinkToFit(), for compatibility with ATL
+   void FreeExtra()
+   {
+      ShrinkToFit();
+   }
+
+   /// Returns number of characters that fit into the buffer without reallocating
+   int GetAllocLength() const throw()
+   {
+      return IsInline() ? c_inlineLength : GetData()->m_allocLength;
+   }
+
+   /// Truncates string to given length; the buffer is kept
+   void Truncate(int newLength)
+   {
+      ATLASSERT(newLength >= 0 && newLength <= GetLength());
+      if (newLength < 0 || newLength > GetLength())
+         throw std::invalid_argument("CString: invalid length argument to Truncate()");
+
+      if (newLength == GetLength())
+         return;
+
+      if (newLength == 0 && IsShared())
+      {
+         Empty();
+         return;
+      }
+
+      if (IsShared())
+         Fork(newLength);
+
+      SetLength(newLength);
+   }
+
    /// Returns string length, without string-terminating zero character
    int GetLength() const throw()
    {
-      return GetData()->m_dataLength;
+      return IsInline()
+         ? c_inlineLength - static_cast<int>(m_inline[c_inlineLength])
+         : GetData()->m_dataLength;
    }
 
    /// Returns raw C string
    PCXSTR GetString() const throw()
    {
-      return m_data;
+      return IsInline() ? m_inline : m_data;
+   }
+
+   /// Returns hash value of the string; for heap allocated strings, the value
+   /// is calculated on first call and cached in the string data. Copies share
+   /// the string data, so they only calculate it once. Modifying the string
+   /// invalidates the cached value; for buffers returned by GetBuffer(), this
+   /// happens when the buffer is released. Strings in the inline buffer
+   /// calculate the value on every call.
+   size_t GetHash() const throw()
+   {
+      // strings in the inline buffer are short enough to hash every time
+      if (IsInline())
+         return StringHash::Hash(m_inline, static_cast<size_t>(GetLength()));
+
+      return GetData()->GetHash();
    }
 
    /// Returns if string is empty
@@ -619,8 +972,8 @@ public:
       if (!(index >= 0 && index < GetLength()))
          throw std::invalid_argument("CString: invalid index argument to SetAt()");
 
-      // TODO do differently?
-      m_data[index] = ch;
+      PXSTR buffer = PrepareWrite(GetLength());
+      buffer[index] = ch;
    }
 
    /// Sets new string
@@ -643,7 +996,7 @@ public:
 
       // copy
       PXSTR buffer = GetBuffer(length);
-      int allocLength = GetData()->m_allocLength;
+      int allocLength = GetAllocLength();
 
       CopyChars(buffer, allocLength, str, length);
 
@@ -652,28 +1005,93 @@ public:
 
    // friend operators
 
-   /// Add operator, with two CStringT's
-   friend CStringT operator+(const CStringT& lhs, const CStringT& rhs)
+   /// Type of concatenation of two string parts, returned by operator+
+   typedef CStringConcatT<CStringT, CStringConcatPartT<CStringT>, CStringConcatPartT<CStringT>> ConcatType;
+
+   /// Add operator, with two CStringT's; the returned concatenation is
+   /// converted to a CStringT using a single allocation
+   friend ConcatType operator+(const CStringT& lhs, const CStringT& rhs)
    {
-      CStringT result(lhs);
-      result.Append(rhs);
-      return result;
+      return ConcatType(CStringConcatPartT<CStringT>(lhs), CStringConcatPartT<CStringT>(rhs));
    }
 
    /// Add operator, with a C-style string and a CStringT
-   friend CStringT operator+(PCXSTR lhs, const CStringT& rhs)
+   friend ConcatType operator+(PCXSTR lhs, const CStringT& rhs)
    {
-      CStringT result(lhs);
-      result.Append(rhs);
-      return result;
+      return ConcatType(CStringConcatPartT<CStringT>(lhs), CStringConcatPartT<CStringT>(rhs));
    }
 
    /// Add operator, with a CStringT and a C-style string
-   friend CStringT operator+(const CStringT& lhs, PCXSTR rhs)
+   friend ConcatType operator+(const CStringT& lhs, PCXSTR rhs)
+   {
+      return ConcatType(CStringConcatPartT<CStringT>(lhs), CStringConcatPartT<CStringT>(rhs));
+   }
+
+   /// Add operator, with a character and a CStringT
+   friend ConcatType operator+(XCHAR lhs, const CStringT& rhs)
+   {
+      return ConcatType(CStringConcatPartT<CStringT>(lhs), CStringConcatPartT<CStringT>(rhs));
+   }
+
+   /// Add operator, with a CStringT and a character
+   friend ConcatType operator+(const CStringT& lhs, XCHAR rhs)
+   {
+      return ConcatType(CStringConcatPartT<CStringT>(lhs), CStringConcatPartT<CStringT>(rhs));
+   }
+
+   // add operators with temporary CStringT's; the concatenation keeps a copy
+   // of the temporary string, so that it can't be destroyed before the
+   // concatenation is converted
+
+   /// Type of concatenation with a temporary string on the left side
+   typedef CStringConcatT<CStringT, CStringConcatOwnedPartT<CStringT>, CStringConcatPartT<CStringT>> ConcatOwnedLeftType;
+
+   /// Type of concatenation with a temporary string on the right side
+   typedef CStringConcatT<CStringT, CStringConcatPartT<CStringT>, CStringConcatOwnedPartT<CStringT>> ConcatOwnedRightType;
+
+   /// Type of concatenation of two temporary strings
+   typedef CStringConcatT<CStringT, CStringConcatOwnedPartT<CStringT>, CStringConcatOwnedPartT<CStringT>> ConcatOwnedType;
+
+   /// Add operator, with a temporary CStringT and a CStringT
+   friend ConcatOwnedLeftType operator+(CStringT&& lhs, const CStringT& rhs)
+   {
+      return ConcatOwnedLeftType(CStringConcatOwnedPartT<CStringT>(lhs), CStringConcatPartT<CStringT>(rhs));
+   }
+
+   /// Add operator, with a temporary CStringT and a C-style string
+   friend ConcatOwnedLeftType operator+(CStringT&& lhs, PCXSTR rhs)
+   {
+      return ConcatOwnedLeftType(CStringConcatOwnedPartT<CStringT>(lhs), CStringConcatPartT<CStringT>(rhs));
+   }
+
+   /// Add operator, with a temporary CStringT and a character
+   friend ConcatOwnedLeftType operator+(CStringT&& lhs, XCHAR rhs)
    {
-      CStringT result(lhs);
-      result.Append(rhs);
-      return result;
+      return ConcatOwnedLeftType(CStringConcatOwnedPartT<CStringT>(lhs), CStringConcatPartT<CStringT>(rhs));
+   }
+
+   /// Add operator, with a CStringT and a temporary CStringT
+   friend ConcatOwnedRightType operator+(const CStringT& lhs, CStringT&& rhs)
+   {
+      return ConcatOwnedRightType(CStringConcatPartT<CStringT>(lhs), CStringConcatOwnedPartT<CStringT>(rhs));
+   }
+
+   /// Add operator, with a C-style string and a temporary CStringT
+   friend ConcatOwnedRightType operator+(PCXSTR lhs, CStringT&& rhs)
+   {
+      return ConcatOwnedRightType(CStringConcatPartT<CStringT>(lhs), CStringConcatOwnedPartT<CStringT>(rhs));
+   }
+
+   /// Add operator, with a character and a temporary CStringT
+   friend ConcatOwnedRightType operator+(XCHAR lhs, CStringT&& rhs)
+   {
+      return ConcatOwnedRightType(CStringConcatPartT<CStringT>(lhs), CStringConcatOwnedPartT<CStringT>(rhs));
+   }
+
+   /// Add operator, with two temporary CStringT's
+   friend ConcatOwnedType operator+(CStringT&& lhs, CStringT&& rhs)
+   {
+      return ConcatOwnedType(CStringConcatOwnedPartT<CStringT>(lhs), CStringConcatOwnedPartT<CStringT>(rhs));
    }
 
    // comparison operators
@@ -825,51 +1243,193 @@ public:
       return 0;
    }
 
+   /// Replaces all occurrences of a character with another character;
+   /// returns the number of replaced characters
    int Replace(XCHAR chOld, XCHAR chNew)
    {
-      // TODO implement
-      return 0;
+      if (chOld == chNew)
+         return 0;
+
+      // only get a writable buffer when there's something to replace
+      int length = GetLength();
+      PCXSTR found = StringSearch::FindChar(GetString(), length, chOld);
+      if (found == nullptr)
+         return 0;
+
+      int startIndex = static_cast<int>(found - GetString());
+
+      PXSTR buffer = GetBuffer();
+      size_t count = StringSearch::ReplaceChar(
+         buffer + startIndex, length - startIndex, chOld, chNew);
+
+      ReleaseBufferSetLength(length);
+
+      return static_cast<int>(count);
    }
 
+   /// Replaces all occurrences of a string with another string; returns the
+   /// number of replaced strings. Use CStringReplacer to replace multiple
+   /// strings in one pass.
    int Replace(PCXSTR strOld, PCXSTR strNew)
    {
-      // TODO implement
-      return 0;
-   }
+      int oldLength = strOld == nullptr ? 0 : CharTypeTraits<XCHAR>::StringLength(strOld);
+      if (oldLength == 0)
+         return 0;
 
-   int Remove(XCHAR chRemove)
-   {
-      // TODO implement
-      return 0;
-   }
+      int newLength = strNew == nullptr ? 0 : CharTypeTraits<XCHAR>::StringLength(strNew);
 
+      // count occurrences first, in order to allocate the result only once
+      PCXSTR text = GetString();
+      int length = GetLength();
+
+      int count = 0;
+      for (PCXSTR pos = text, end = text + length;
+         (pos = StringSearch::FindString(pos, static_cast<size_t>(end - pos), strOld, static_cast<size_t>(oldLength))) != nullptr;
+         pos += oldLength)
+         count++;
+
+      if (count == 0)
+         return 0;
+
+      CStringT result;
+      int resultLength = length + count * (newLength - oldLength);
+      PXSTR dest = result.GetBuffer(resultLength);
+
+      PCXSTR pos = text;
+      for (int index = 0; index < count; index++)
+      {
+         PCXSTR found = StringSearch::FindString(pos, static_cast<size_t>(text + length - pos), strOld, static_cast<size_t>(oldLength));
+
+         dest = std::copy(pos, found, dest);
+         dest = std::copy(strNew, strNew + newLength, dest);
+         pos = found + oldLength;
+      }
+
+      std::copy(pos, text + length, dest);
+      result.ReleaseBufferSetLength(resultLength);
+
+      *this = result;
+      return count;
+   }
+
+   /// Removes all occurrences of a character; returns the number of removed
+   /// characters
+   int Remove(XCHAR chRemove)
+   {
+      // only get a writable buffer when there's something to remove
+      int length = GetLength();
+      PCXSTR found = StringSearch::FindChar(GetString(), length, chRemove);
+      if (found == nullptr)
+         return 0;
+
+      int startIndex = static_cast<int>(found - GetString());
+
+      PXSTR buffer = GetBuffer();
+      size_t remainingLength = StringSearch::RemoveChar(
+         buffer + startIndex, length - startIndex, chRemove);
+
+      int newLength = startIndex + static_cast<int>(remainingLength);
+      ReleaseBufferSetLength(newLength);
+
+      return length - newLength;
+   }
+
+   /// Returns the next token, starting at given index, using the characters
+   /// in tokens as separators; startIndex is set to the position after the
+   /// token, or -1 when there are no more tokens.
    CStringT Tokenize(PCXSTR tokens, int& startIndex) const
    {
-      // TODO implement
+      ATLASSERT(startIndex >= 0);
+
+      if (startIndex < 0)
+         throw std::invalid_argument("CString: invalid start index argument to Tokenize()");
+
+      int length = GetLength();
+
+      if (tokens == nullptr || *tokens == 0)
+      {
+         if (startIndex < length)
+            return CStringT(GetString() + startIndex, length - startIndex);
+      }
+      else if (startIndex < length)
+      {
+         size_t tokensLength = CharTypeTraits<T>::StringLength(tokens);
+
+         // skip leading separators
+         PCXSTR tokenStart = StringSearch::FindCharOf(
+            GetString() + startIndex, length - startIndex,
+            tokens, tokensLength, false);
+
+         if (tokenStart != nullptr)
+         {
+            int tokenIndex = static_cast<int>(tokenStart - GetString());
+
+            PCXSTR tokenEnd = StringSearch::FindCharOf(
+               tokenStart, length - tokenIndex,
+               tokens, tokensLength, true);
+
+            int tokenLength = tokenEnd == nullptr
+               ? length - tokenIndex
+               : static_cast<int>(tokenEnd - tokenStart);
+
+            startIndex = tokenIndex + tokenLength + 1;
+
+            return Mid(tokenIndex, tokenLength);
+         }
+      }
+
+      // no more tokens
+      startIndex = -1;
       return CStringT();
    }
 
-   int Find(XCHAR /*ch*/, int /*startIndex*/ = 0) const throw()
+   /// Finds a character, starting at given index; returns -1 when not found
+   int Find(XCHAR ch, int startIndex = 0) const throw()
    {
-      // TODO implement
-      return 0;
+      int length = GetLength();
+      if (startIndex < 0 || startIndex >= length)
+         return -1;
+
+      PCXSTR found = StringSearch::FindChar(
+         GetString() + startIndex, length - startIndex, ch);
+
+      return found == nullptr ? -1 : static_cast<int>(found - GetString());
    }
 
-   int Find(PCXSTR /*str*/, int /*startIndex*/ = 0) const throw()
+   /// Finds a substring, starting at given index; returns -1 when not found
+   int Find(PCXSTR str, int startIndex = 0) const throw()
    {
-      return 0;
+      int length = GetLength();
+      if (str == nullptr || startIndex < 0 || startIndex > length)
+         return -1;
+
+      PCXSTR found = StringSearch::FindString(
+         GetString() + startIndex, length - startIndex,
+         str, CharTypeTraits<T>::StringLength(str));
+
+      return found == nullptr ? -1 : static_cast<int>(found - GetString());
    }
 
-   int FindOneOf(PCXSTR /*strCharColl*/) const throw()
+   /// Finds the first character that is one of the characters in the given
+   /// string; returns -1 when not found
+   int FindOneOf(PCXSTR strCharColl) const throw()
    {
-      // TODO implement
-      return 0;
+      if (strCharColl == nullptr)
+         return -1;
+
+      PCXSTR found = StringSearch::FindCharOf(
+         GetString(), GetLength(),
+         strCharColl, CharTypeTraits<T>::StringLength(strCharColl), true);
+
+      return found == nullptr ? -1 : static_cast<int>(found - GetString());
    }
 
+   /// Finds the last occurrence of a character; returns -1 when not found
    int ReverseFind(XCHAR ch) const throw()
    {
-      // TODO implement
-      return 0;
+      PCXSTR found = StringSearch::ReverseFindChar(GetString(), GetLength(), ch);
+
+      return found == nullptr ? -1 : static_cast<int>(found - GetString());
    }
 
    CStringT& MakeUpper()
@@ -1008,16 +1568,18 @@ public:
       return CStringT(GetString(), count);
    }
 
+   /// Returns the substring from the start of the string that only consists
+   /// of characters in the given string
    CStringT SpanIncluding(PCXSTR strCharColl) const
    {
-      // TODO implement
-      return CStringT();
+      return Left(SpanLength(strCharColl, false));
    }
 
+   /// Returns the substring from the start of the string that consists of
+   /// characters not in the given string
    CStringT SpanExcluding(PCXSTR strCharColl) const
    {
-      // TODO implement
-      return CStringT();
+      return Left(SpanLength(strCharColl, true));
    }
 
    // formatting
@@ -1050,7 +1612,14 @@ public:
    /// sets it as new string; va_args version
    void FormatV(PCXSTR strFormat, va_list args)
    {
-      int bufferLength = CharTypeTraits<T>::FormatBuffer(nullptr, 0, strFormat, args);
+      // the argument list is used twice, so the first pass must use a copy
+      va_list argsCopy;
+      va_copy(argsCopy, args);
+      int bufferLength = CharTypeTraits<T>::FormatBuffer(nullptr, 0, strFormat, argsCopy);
+      va_end(argsCopy);
+
+      if (bufferLength < 0)
+         throw std::invalid_argument("CString: invalid format string or arguments");
 
       PXSTR strBuffer = GetBufferSetLength(bufferLength);
       if (strBuffer == nullptr)
@@ -1072,28 +1641,152 @@ public:
       Append(str);
    }
 
+   /// Formats text using format string and arguments and sets it as new
+   /// string; the format string is checked at compile time, and the text is
+   /// formatted in a single pass. See StringFormat.hpp for supported format
+   /// specifiers.
+   template <typename... Args>
+   void FormatFast(StringFormat::FormatString<XCHAR, std::type_identity_t<Args>...> format, const Args&... args)
+   {
+      StringFormat::Format(*this, format, args...);
+   }
+
+   /// Formats text using format string and arguments and appends it to the
+   /// current string; see FormatFast().
+   template <typename... Args>
+   void AppendFormatFast(StringFormat::FormatString<XCHAR, std::type_identity_t<Args>...> format, const Args&... args)
+   {
+      StringFormat::AppendFormat(*this, format, args...);
+   }
+
+   /// Appends signed integer as decimal number, padded with zeros to the
+   /// given minimum number of digits; see StringNumber.hpp
+   template <typename TInteger>
+   void AppendInt(TInteger value, int width = 0)
+   {
+      StringNumber::AppendInt(*this, value, width);
+   }
+
+   /// Appends unsigned integer as decimal number, padded with zeros to the
+   /// given minimum number of digits
+   template <typename TUnsigned>
+   void AppendUInt(TUnsigned value, int width = 0)
+   {
+      StringNumber::AppendUInt(*this, value, width);
+   }
+
+   /// Appends integer as hex number, padded with zeros to the given minimum
+   /// number of digits
+   template <typename TInteger>
+   void AppendHex(TInteger value, int width = 0, bool upperCase = false)
+   {
+      StringNumber::AppendHex(*this, value, width, upperCase);
+   }
+
+   /// Appends floating point value; with a precision of -1, the shortest
+   /// representation is used that reads back to the same value
+   void AppendDouble(double value, int precision = -1)
+   {
+      StringNumber::AppendDouble(*this, value, precision);
+   }
+
 private:
-   /// Optimisation: empty string data that never gets collected by ref count
-   struct CNilStringData : public CStringData
+   /// Number of characters that can be stored in the inline buffer, without
+   /// the zero terminator; the inline buffer is 16 bytes long, and its last
+   /// character is used as tag
+   static constexpr int c_inlineLength = static_cast<int>(16 / sizeof(XCHAR)) - 1;
+
+   /// Tag value that marks a heap allocated string; inline strings store the
+   /// number of unused characters as tag, which is in the range 0 to
+   /// c_inlineLength
+   static constexpr XCHAR c_heapTag = static_cast<XCHAR>(-1);
+
+   static_assert(sizeof(PXSTR) <= c_inlineLength * sizeof(XCHAR),
+      "the heap pointer must not overlap the tag");
+
+   /// Returns if the string is stored in the inline buffer
+   bool IsInline() const throw()
    {
-      /// Ctor
-      CNilStringData()
-      {
-         CStringData::m_numRefs = 2; // ensures that the nil string never gets freed
-         CStringData::m_dataLength = 0;
-         CStringData::m_allocLength = 0;
+      return m_inline[c_inlineLength] != c_heapTag;
+   }
+
+   /// Returns if the string data is shared with other strings; inline
+   /// strings are never shared
+   bool IsShared() const throw()
+   {
+      return !IsInline() && GetData()->IsShared();
+   }
 
-         extraBuffer[0] = extraBuffer[1] = 0;
+   /// Returns writable string characters; the string must not be shared
+   PXSTR GetChars() throw()
+   {
+      return IsInline() ? m_inline : m_data;
+   }
+
+   /// Switches to the inline buffer and sets the inline string length; any
+   /// heap allocated string data must have been released before
+   void SetInlineLength(int length) throw()
+   {
+      ATLASSERT(length >= 0 && length <= c_inlineLength);
+
+      // when the inline buffer is full, the tag doubles as zero terminator
+      m_inline[length] = 0;
+      m_inline[c_inlineLength] = static_cast<XCHAR>(c_inlineLength - length);
+   }
+
+   /// Copies an inline string from another string; any heap allocated string
+   /// data must have been released before
+   void CopyInline(const CStringT& str) throw()
+   {
+      int length = str.GetLength();
+      CopyChars(m_inline, c_inlineLength, str.m_inline, length);
+      SetInlineLength(length);
+   }
+
+   /// Sets new string, converted from other character type string with given
+   /// length; the string is empty when the conversion fails
+   void SetOtherString(PCYSTR str, int length)
+   {
+      // narrow to wide conversion never results in more characters, so the
+      // source length can be used, and the string is only converted once
+      int destLength = sizeof(XCHAR) > sizeof(YCHAR)
+         ? length
+         : CharTypeTraits<YCHAR>::ConvertFromOther(nullptr, 0, str, length);
+
+      if (destLength <= 0)
+      {
+         Empty();
+         return;
       }
 
-   private:
-      /// Extra buffer for null terminating characters
-      wchar_t extraBuffer[2];
-   };
+      PXSTR strBuffer = GetBuffer(destLength);
+
+      int convertedLength = CharTypeTraits<YCHAR>::ConvertFromOther(strBuffer, destLength, str, length);
+
+      ReleaseBufferSetLength(std::max(convertedLength, 0));
+   }
+
+   /// Returns the number of characters from the start of the string until
+   /// the first character that is (stopInSet is true) or isn't (stopInSet is
+   /// false) in the given character set
+   int SpanLength(PCXSTR strCharColl, bool stopInSet) const
+   {
+      int length = GetLength();
+      if (strCharColl == nullptr)
+         return stopInSet ? length : 0;
 
-   /// Returns the string data struct
+      PCXSTR found = StringSearch::FindCharOf(
+         GetString(), length,
+         strCharColl, CharTypeTraits<T>::StringLength(strCharColl), stopInSet);
+
+      return found == nullptr ? length : static_cast<int>(found - GetString());
+   }
+
+   /// Returns the string data struct; only valid for heap allocated strings
    CStringData* GetData() const throw()
    {
+      ATLASSERT(!IsInline());
+
       // this class uses the same layout as the MFC CString class;
       // it allocates a space of two pointers, the first pointer being
       // a CStringData struct, and the second pointer points to the
@@ -1101,58 +1794,73 @@ private:
       return reinterpret_cast<CStringData*>(m_data) - 1;
    }
 
-   /// Allocates a new string data and string data
-   CStringData* Allocate(int length) throw()
+   /// Allocates a buffer for a string with given length; uses the inline
+   /// buffer when the string is short enough. Must only be called from ctors.
+   void Allocate(int length)
    {
-      return CStringData::Allocate(length);
+      if (length <= c_inlineLength)
+      {
+         SetInlineLength(0);
+         return;
+      }
+
+      CStringData* data = CStringData::Allocate(length);
+      if (data == nullptr)
+         throw std::runtime_error("CString: out of memory");
+
+      Attach(data);
    }
 
-   /// Frees string data
-   void Free(CStringData* data)
+   /// Releases the reference to heap allocated string data, if any
+   void ReleaseStorage() throw()
    {
-      data->Free();
+      if (!IsInline())
+         GetData()->Release();
    }
 
-   /// Attaches a new string data
-   void Attach(CStringData* data)
+   /// Attaches heap allocated string data
+   void Attach(CStringData* data) throw()
    {
       m_data = static_cast<PXSTR>(data->GetData());
+      m_inline[c_inlineLength] = c_heapTag;
+   }
+
+   /// Invalidates the cached hash value; must be called before modifying the
+   /// string
+   void ResetHash() throw()
+   {
+      if (!IsInline())
+         GetData()->ResetHash();
    }
 
    /// Sets a new length for stored string; doesn't reallocate
    void SetLength(int length)
    {
       ATLASSERT(length >= 0);
-      ATLASSERT(length <= GetData()->m_allocLength);
+      ATLASSERT(length <= GetAllocLength());
 
-      if (length < 0 || length > GetData()->m_allocLength)
+      if (length < 0 || length > GetAllocLength())
          throw std::invalid_argument("CString: invalid length argument to SetLength()");
 
+      if (IsInline())
+      {
+         SetInlineLength(length);
+         return;
+      }
+
       GetData()->m_dataLength = length;
+      GetData()->ResetHash();
       m_data[length] = 0;
    }
 
    /// Makes string non-shared by creating a unique copy
    void Fork(int newLength)
    {
-      CStringData* oldData = GetData();
-      int oldLength = oldData->m_dataLength;
-
-      CStringData* newData = Allocate(newLength);
-      if (newData == nullptr)
-         throw std::runtime_error("CString: out of memory");
-
-      int iCharsToCopy = std::min(oldLength, newLength) + 1;
+      ATLASSERT(IsShared());
 
-      CopyChars(
-         static_cast<PXSTR>(newData->GetData()), iCharsToCopy,
-         static_cast<PXSTR>(oldData->GetData()), iCharsToCopy);
+      CStringStats::OnFork();
 
-      newData->m_dataLength = newLength;
-
-      oldData->Release();
-
-      Attach(newData);
+      Reallocate(newLength);
    }
 
    /// Prepares the string buffer for writing, to have at least given length;
@@ -1162,43 +1870,36 @@ private:
       if (length < 0)
          throw std::runtime_error("CString::PrepareWrite(): invalid length");
 
-      CStringData* oldData = GetData();
-
-      bool isTooShort = oldData->m_allocLength < length;
-
-      if (oldData->IsShared() || isTooShort)
+      if (IsShared() || GetAllocLength() < length)
          PrepareWrite2(length);
 
-      return m_data;
+      ResetHash();
+
+      return GetChars();
    }
 
    /// Extends the buffer and makes it non-shared (unique)
-   PXSTR PrepareWrite2(int length)
+   void PrepareWrite2(int length)
    {
-      CStringData* oldData = GetData();
-
       // resize to whatever is bigger; current or given size
-      length = std::max(oldData->m_dataLength, length);
+      length = std::max(GetLength(), length);
 
-      if (oldData->IsShared())
+      if (IsShared())
          Fork(length);
       else
-         if (oldData->m_allocLength < length)
+         if (GetAllocLength() < length)
          {
             // unique, but buffer too small; increase buffer size
             ResizeBuffer(length);
          }
-
-      return m_data;
    }
 
    /// Resizes the buffer to be at least given size; increases buffer size by factor
    void ResizeBuffer(int length)
    {
-      CStringData* oldData = GetData();
-      int newLength = oldData->m_allocLength;
+      int newLength = GetAllocLength();
 
-      if (oldData->m_allocLength <= 1024 * 1024 * 1024) // 1 GB
+      if (newLength <= 1024 * 1024 * 1024) // 1 GB
       {
          // under 1 GB size: increase buffer by factor 1.5
          newLength = newLength + newLength / 2;
@@ -1214,36 +1915,56 @@ private:
       Reallocate(newLength);
    }
 
-   /// Reallocates buffer to be exactly the given size; current string is copied over
+   /// \brief Moves the string to a new unique buffer for the given length
+   /// \details Uses the inline buffer when the length is short enough. The
+   /// string is truncated when it is longer than the given length.
    void Reallocate(int newLength)
    {
-      CStringData* oldData = GetData();
-      ATLASSERT(oldData->m_allocLength < newLength); // must only be called to enlarge the buffer
-
-      if (newLength <= 0 || oldData->m_allocLength >= newLength)
+      ATLASSERT(newLength >= 0);
+      if (newLength < 0)
          throw std::runtime_error("CString::Reallocate: illegal parameter");
 
-      CStringData* newData = CStringData::Reallocate(oldData, newLength);
-      if (newData == nullptr)
-         throw std::runtime_error("CString::Reallocate: out of memory");
+      int length = std::min(GetLength(), newLength);
 
-      Attach(newData);
-   }
+      if (newLength <= c_inlineLength)
+      {
+         if (IsInline())
+         {
+            SetInlineLength(length);
+            return;
+         }
 
-   /// Clones string data and contained string
-   static CStringData* CloneData(CStringData* data)
-   {
-      CStringData* newData = CStringData::Allocate(data->m_dataLength);
-      if (newData == nullptr)
-         throw std::runtime_error("CString: out of memory");
+         // the inline buffer overlaps the heap pointer
+         CStringData* oldData = GetData();
+         CopyChars(m_inline, c_inlineLength, static_cast<PXSTR>(oldData->GetData()), length);
+         SetInlineLength(length);
 
-      newData->m_dataLength = data->m_dataLength;
+         oldData->Release();
+         return;
+      }
+
+      if (!IsInline() && !IsShared() && newLength >= GetLength())
+      {
+         // unique heap buffer; the buffer's content is preserved
+         CStringData* newData = CStringData::Reallocate(GetData(), newLength);
+         if (newData == nullptr)
+            throw std::runtime_error("CString::Reallocate: out of memory");
+
+         Attach(newData);
+         return;
+      }
+
+      CStringData* newData = CStringData::Allocate(newLength);
+      if (newData == nullptr)
+         throw std::runtime_error("CString::Reallocate: out of memory");
 
-      CopyChars(
-         static_cast<PXSTR>(newData->GetData()), newData->m_dataLength + 1,
-         static_cast<PXSTR>(data->GetData()), data->m_dataLength + 1);
+      PXSTR newBuffer = static_cast<PXSTR>(newData->GetData());
+      CopyChars(newBuffer, newLength, GetString(), length);
+      newBuffer[length] = 0;
+      newData->m_dataLength = length;
 
-      return newData;
+      ReleaseStorage();
+      Attach(newData);
    }
 
    /// Copies characters from the source, including length, to target buffer;
@@ -1251,30 +1972,306 @@ private:
    static void CopyChars(PXSTR strTargetBuffer, int lenTargetBuffer,
       PCXSTR strSource, int lenSource)
    {
-#ifdef _MSC_VER
-      auto targetIter = stdext::checked_array_iterator<PXSTR>(strTargetBuffer, lenTargetBuffer);
-#elif defined(__ANDROID__)
-      auto targetIter = strTargetBuffer;
-#endif
+      ATLASSERT(lenSource <= lenTargetBuffer);
+      (void)lenTargetBuffer;
 
       // using std::copy automatically handles overlapped cases
-      std::copy(strSource, strSource + lenSource, targetIter);
+      std::copy(strSource, strSource + lenSource, strTargetBuffer);
+   }
+
+private:
+   union
+   {
+      /// String characters of a heap allocated string; the CStringData
+      /// header is stored before the characters
+      PXSTR m_data;
+
+      /// Inline buffer for short strings; the last character is the tag that
+      /// indicates if the inline buffer or the heap pointer is used
+      XCHAR m_inline[c_inlineLength + 1];
+   };
+};
+
+/// \brief Part of a string concatenation
+/// \details Stores a pointer to the characters of a CStringT or a C-style
+/// string, together with its length, or a single character. The referenced
+/// string must outlive the concatenation; this is the case when it is
+/// converted to a string in the same expression.
+template <typename TString>
+class CStringConcatPartT
+{
+public:
+   typedef typename TString::XCHAR XCHAR;    ///< Type of character
+   typedef typename TString::PXSTR PXSTR;    ///< Type of character string
+   typedef typename TString::PCXSTR PCXSTR;  ///< Type of character string; const version
+
+   /// Ctor; takes a string
+   explicit CStringConcatPartT(const TString& str) throw()
+      :m_str(str.GetString()),
+      m_length(str.GetLength()),
+      m_ch(0)
+   {
+   }
+
+   /// Ctor; takes a C-style string
+   explicit CStringConcatPartT(PCXSTR str) throw()
+      :m_str(str == nullptr ? &c_empty : str),
+      m_length(CharTypeTraits<XCHAR>::StringLength(str)),
+      m_ch(0)
+   {
+   }
+
+   /// Ctor; takes a single character
+   explicit CStringConcatPartT(XCHAR ch) throw()
+      :m_str(nullptr),
+      m_length(1),
+      m_ch(ch)
+   {
+   }
+
+   /// Returns length of part
+   int GetLength() const throw()
+   {
+      return m_length;
+   }
+
+   /// Copies part to buffer; returns position after the copied characters
+   PXSTR CopyTo(PXSTR buffer) const throw()
+   {
+      if (m_str == nullptr)
+         *buffer = m_ch;
+      else
+         std::copy(m_str, m_str + m_length, buffer);
+
+      return buffer + m_length;
+   }
+
+   /// Returns if the part references characters in the given range
+   bool IsReferencing(PCXSTR begin, PCXSTR end) const throw()
+   {
+      return m_str != nullptr && m_length > 0 &&
+         std::less<PCXSTR>()(m_str, end) && std::less<PCXSTR>()(begin, m_str + m_length);
+   }
+
+private:
+   /// Empty string, used for null C-style strings
+   static constexpr XCHAR c_empty = 0;
+
+   PCXSTR m_str;  ///< string; nullptr when storing a single character
+   int m_length;  ///< string length
+   XCHAR m_ch;    ///< single character
+};
+
+/// \brief Part of a string concatenation, owning a temporary string
+/// \details Stores a copy of a temporary CStringT, which would otherwise be
+/// destroyed before a stored concatenation is converted; the copy shares the
+/// heap allocated string data, or copies the inline buffer.
+template <typename TString>
+class CStringConcatOwnedPartT
+{
+public:
+   typedef typename TString::PXSTR PXSTR;    ///< Type of character string
+   typedef typename TString::PCXSTR PCXSTR;  ///< Type of character string; const version
+
+   /// Ctor; takes a temporary string
+   explicit CStringConcatOwnedPartT(const TString& str)
+      :m_str(str)
+   {
+   }
+
+   /// Returns length of part
+   int GetLength() const throw()
+   {
+      return m_str.GetLength();
+   }
+
+   /// Copies part to buffer; returns position after the copied characters
+   PXSTR CopyTo(PXSTR buffer) const throw()
+   {
+      PCXSTR str = m_str.GetString();
+      return std::copy(str, str + m_str.GetLength(), buffer);
+   }
+
+   /// Returns if the part references characters in the given range; the
+   /// owned string is never modified by other strings, so this is false
+   bool IsReferencing(PCXSTR begin, PCXSTR end) const throw()
+   {
+      (void)begin;
+      (void)end;
+      return false;
+   }
+
+private:
+   TString m_str; ///< string
+};
+
+/// \brief Concatenation of two strings, returned by CStringT::operator+
+/// \details Each operator+ adds another node to the concatenation, without
+/// copying any characters. When the concatenation is converted to a CStringT,
+/// the total length is known and all parts are copied into a single buffer.
+/// The concatenation can also be used as C-style string, e.g. when passed to
+/// a function or a function template taking a PCXSTR, or as an argument to
+/// FormatFast(); the string is then built once and kept until the
+/// concatenation is destroyed at the end of the expression.
+/// Concatenations can't be copied; don't store them using auto, since the
+/// referenced strings could change or be destroyed before the concatenation
+/// is used. Temporary CStringT's are kept by the concatenation, though.
+template <typename TString, typename TLeft, typename TRight>
+class CStringConcatT
+{
+public:
+   typedef typename TString::XCHAR XCHAR;    ///< Type of character
+   typedef typename TString::PXSTR PXSTR;    ///< Type of character string
+   typedef typename TString::PCXSTR PCXSTR;  ///< Type of character string; const version
+
+   /// Type of part
+   typedef CStringConcatPartT<TString> PartType;
+
+   /// Type of part, owning a temporary string
+   typedef CStringConcatOwnedPartT<TString> OwnedPartType;
+
+   /// Ctor; takes left and right parts
+   CStringConcatT(const TLeft& left, const TRight& right)
+      :m_left(left),
+      m_right(right),
+      m_length(left.GetLength() + right.GetLength())
+   {
+   }
+
+   /// Assign operator; not available
+   CStringConcatT& operator=(const CStringConcatT&) = delete;
+
+   /// Returns total length of concatenated string
+   int GetLength() const throw()
+   {
+      return m_length;
+   }
+
+   /// Copies all parts to buffer; returns position after the copied characters
+   PXSTR CopyTo(PXSTR buffer) const throw()
+   {
+      return m_right.CopyTo(m_left.CopyTo(buffer));
+   }
+
+   /// Returns if any part references characters in the given range
+   bool IsReferencing(PCXSTR begin, PCXSTR end) const throw()
+   {
+      return m_left.IsReferencing(begin, end) || m_right.IsReferencing(begin, end);
+   }
+
+   /// Returns concatenated string as C-style string; the string is built on
+   /// the first call and is valid until the concatenation is destroyed
+   PCXSTR GetString() const
+   {
+      if (m_string == nullptr)
+      {
+         m_string.reset(new XCHAR[m_length + 1]);
+         *CopyTo(m_string.get()) = 0;
+      }
+
+      return m_string.get();
+   }
+
+   /// C-style string "cast" operator; see GetString()
+   operator PCXSTR() const
+   {
+      return GetString();
+   }
+
+   /// Equality operator, with a string, a C-style string or another
+   /// concatenation; also used for the reversed arguments and for operator!=
+   template <typename TOther>
+      requires std::is_convertible_v<const TOther&, PCXSTR>
+   friend bool operator==(const CStringConcatT& lhs, const TOther& rhs)
+   {
+      return CharTypeTraits<XCHAR>::StringCompare(lhs.GetString(), rhs) == 0;
+   }
+
+   /// Three-way comparison operator, with a string, a C-style string or
+   /// another concatenation; used for the relational operators
+   template <typename TOther>
+      requires std::is_convertible_v<const TOther&, PCXSTR>
+   friend std::strong_ordering operator<=>(const CStringConcatT& lhs, const TOther& rhs)
+   {
+      return CharTypeTraits<XCHAR>::StringCompare(lhs.GetString(), rhs) <=> 0;
+   }
+
+   /// Add operator, with a string
+   friend CStringConcatT<TString, CStringConcatT, PartType> operator+(const CStringConcatT& lhs, const TString& rhs)
+   {
+      return CStringConcatT<TString, CStringConcatT, PartType>(lhs, PartType(rhs));
+   }
+
+   /// Add operator, with a temporary string
+   friend CStringConcatT<TString, CStringConcatT, OwnedPartType> operator+(const CStringConcatT& lhs, TString&& rhs)
+   {
+      return CStringConcatT<TString, CStringConcatT, OwnedPartType>(lhs, OwnedPartType(rhs));
    }
 
-   /// Returns a statically allocated CStringData struct that
-   /// represents an empty string
-   static CStringData* GetNilString()
+   /// Add operator, with a C-style string
+   friend CStringConcatT<TString, CStringConcatT, PartType> operator+(const CStringConcatT& lhs, PCXSTR rhs)
    {
-      // TODO not thread safe
-      static CNilStringData s_nilData;
+      return CStringConcatT<TString, CStringConcatT, PartType>(lhs, PartType(rhs));
+   }
 
-      s_nilData.AddRef();
-      return &s_nilData;
+   /// Add operator, with a character
+   friend CStringConcatT<TString, CStringConcatT, PartType> operator+(const CStringConcatT& lhs, XCHAR rhs)
+   {
+      return CStringConcatT<TString, CStringConcatT, PartType>(lhs, PartType(rhs));
+   }
+
+   /// Add operator, with a string on the left side
+   friend CStringConcatT<TString, PartType, CStringConcatT> operator+(const TString& lhs, const CStringConcatT& rhs)
+   {
+      return CStringConcatT<TString, PartType, CStringConcatT>(PartType(lhs), rhs);
+   }
+
+   /// Add operator, with a temporary string on the left side
+   friend CStringConcatT<TString, OwnedPartType, CStringConcatT> operator+(TString&& lhs, const CStringConcatT& rhs)
+   {
+      return CStringConcatT<TString, OwnedPartType, CStringConcatT>(OwnedPartType(lhs), rhs);
+   }
+
+   /// Add operator, with a C-style string on the left side
+   friend CStringConcatT<TString, PartType, CStringConcatT> operator+(PCXSTR lhs, const CStringConcatT& rhs)
+   {
+      return CStringConcatT<TString, PartType, CStringConcatT>(PartType(lhs), rhs);
+   }
+
+   /// Add operator, with a character on the left side
+   friend CStringConcatT<TString, PartType, CStringConcatT> operator+(XCHAR lhs, const CStringConcatT& rhs)
+   {
+      return CStringConcatT<TString, PartType, CStringConcatT>(PartType(lhs), rhs);
+   }
+
+   /// Add operator, with another concatenation
+   template <typename TOtherLeft, typename TOtherRight>
+   friend CStringConcatT<TString, CStringConcatT, CStringConcatT<TString, TOtherLeft, TOtherRight>>
+      operator+(const CStringConcatT& lhs, const CStringConcatT<TString, TOtherLeft, TOtherRight>& rhs)
+   {
+      return CStringConcatT<TString, CStringConcatT, CStringConcatT<TString, TOtherLeft, TOtherRight>>(lhs, rhs);
    }
 
 private:
-   /// String data
-   PXSTR m_data;
+   template <typename TOtherString, typename TOtherLeft, typename TOtherRight>
+   friend class CStringConcatT;
+
+   /// Copy ctor; only used when adding the concatenation to another one, so
+   /// the concatenated string isn't copied
+   CStringConcatT(const CStringConcatT& concat)
+      :m_left(concat.m_left),
+      m_right(concat.m_right),
+      m_length(concat.m_length)
+   {
+   }
+
+private:
+   TLeft m_left;     ///< left part
+   TRight m_right;   ///< right part
+   int m_length;     ///< total length
+
+   /// concatenated string; only allocated by GetString()
+   mutable std::unique_ptr<XCHAR[]> m_string;
 };
 
 /// String for ANSI characters
@@ -1285,3 +2282,27 @@ typedef CStringT<WCHAR> CStringW;
 
 /// String for characters, type determined by Unicode setting
 typedef CStringT<TCHAR> CString;
+
+/// String for ANSI characters, confined to a single thread
+typedef CStringT<CHAR, CStringLocalRefCount> CStringLocalA;
+
+/// String for UCS, 16 bit characters, confined to a single thread
+typedef CStringT<WCHAR, CStringLocalRefCount> CStringLocalW;
+
+/// String for characters, confined to a single thread; type determined by
+/// Unicode setting
+typedef CStringT<TCHAR, CStringLocalRefCount> CStringLocal;
+
+namespace std
+{
+   /// hash function for strings, so that they can be used in unordered containers
+   template <typename T, typename TRefCount>
+   struct hash<CStringT<T, TRefCount>>
+   {
+      /// returns hash value; see CStringT::GetHash()
+      size_t operator()(const CStringT<T, TRefCount>& str) const noexcept
+      {
+         return str.GetHash();
+      }
+   };
+}
@@ -0,0 +1,96 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file CStringAtom.hpp interned string atoms
+//
+#pragma once
+
+#include <ulib/CStringView.hpp>
+#include <functional>
+#include <cstddef>
+
+/// \brief Interned string
+/// \details All atoms with equal text share a single immutable string instance,
+/// stored in a global intern table, together with a precomputed hash value. This
+/// makes comparing atoms a pointer compare. Interning a string that is already
+/// in the table doesn't lock and doesn't allocate. Strings are never removed
+/// from the table, so only use atoms for a limited set of identifiers that
+/// repeat, e.g. the names of the configured loggers.
+class CStringAtom
+{
+public:
+   /// ctor; creates atom for the empty string
+   CStringAtom() throw();
+
+   /// ctor; interns given text
+   explicit CStringAtom(CStringView text);
+
+   /// returns atom for the lower case version of the given text
+   static CStringAtom FromLowerCase(CStringView text);
+
+   /// returns interned string
+   const CString& GetString() const throw() { return m_entry->m_text; }
+
+   /// returns precomputed hash value
+   size_t GetHash() const throw() { return m_entry->m_hash; }
+
+   /// returns if atom is the empty string
+   bool IsEmpty() const throw() { return m_entry->m_text.IsEmpty(); }
+
+   /// equality operator; compares pointers only
+   friend bool operator==(const CStringAtom& lhs, const CStringAtom& rhs) throw()
+   {
+      return lhs.m_entry == rhs.m_entry;
+   }
+
+   /// inequality operator; compares pointers only
+   friend bool operator!=(const CStringAtom& lhs, const CStringAtom& rhs) throw()
+   {
+      return lhs.m_entry != rhs.m_entry;
+   }
+
+   /// less operator; compares pointers only, so the order isn't alphabetical
+   friend bool operator<(const CStringAtom& lhs, const CStringAtom& rhs) throw()
+   {
+      return std::less<const void*>()(lhs.m_entry, rhs.m_entry);
+   }
+
+private:
+   /// entry in the intern table; immutable after being inserted
+   struct Entry
+   {
+      CString m_text;            ///< interned string
+      size_t m_hash;             ///< hash value of string
+   };
+
+   /// intern table
+   struct Table;
+
+   /// ctor; takes table entry
+   explicit CStringAtom(const Entry* entry) throw()
+      :m_entry(entry)
+   {
+   }
+
+   /// finds or inserts entry for given text
+   static const Entry* Intern(CStringView text);
+
+private:
+   /// table entry
+   const Entry* m_entry;
+};
+
+namespace std
+{
+   /// hash function for string atoms; returns precomputed hash value
+   template <>
+   struct hash<CStringAtom>
+   {
+      /// returns hash value
+      size_t operator()(const CStringAtom& atom) const noexcept
+      {
+         return atom.GetHash();
+      }
+   };
+}
@@ -0,0 +1,442 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file CStringPool.hpp size class pool allocator for string data
+//
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+/// \brief Allocator functions used for string data
+/// \details Set a custom allocator using CStringPool::SetAllocator(). All
+/// functions get passed the size of the memory block.
+struct CStringAllocator
+{
+   /// allocates a memory block; returns nullptr when out of memory
+   void* (*m_allocate)(size_t size);
+
+   /// reallocates a memory block, preserving its content; returns nullptr
+   /// when out of memory, leaving the block untouched
+   void* (*m_reallocate)(void* ptr, size_t oldSize, size_t newSize);
+
+   /// frees a memory block
+   void (*m_free)(void* ptr, size_t size);
+};
+
+/// statistics of the string pool
+struct CStringPoolStats
+{
+   /// number of allocations that were served from a free list
+   uint64_t m_hits;
+
+   /// number of allocations of pooled sizes that had to allocate from the heap
+   uint64_t m_misses;
+
+   /// number of bytes currently held in thread and global free lists
+   uint64_t m_bytesHeld;
+};
+
+/// \brief Allocator for string data, with a thread caching size class pool
+/// \details Memory blocks of up to 256 bytes are rounded up to one of the
+/// size classes 16, 32, 64, 128 and 256 bytes. When the pool is enabled,
+/// freed blocks are put into a free list of the current thread, and
+/// allocations are served from that list without locking. When a thread's
+/// free list gets too long, half of it is returned to a global pool as a
+/// batch; threads whose free list is empty fetch a whole batch at once.
+/// Blocks are also returned when a thread exits. The number of blocks in
+/// the global pool is checked before locking it, so that misses don't
+/// contend on its mutex when it is empty. Larger blocks are always
+/// allocated from the heap.
+///
+/// The pool is enabled by defining ULIB_CSTRING_POOL, or by calling Enable()
+/// at startup. Since every block is allocated from the heap with the rounded
+/// size, blocks can be freed by the pool and the heap interchangeably, so
+/// enabling or disabling the pool at any time is safe. In contrast, a custom
+/// allocator must be set before any string is allocated.
+class CStringPool
+{
+public:
+   /// number of size classes
+   static constexpr size_t c_numSizeClasses = 5;
+
+   /// largest size that is pooled
+   static constexpr size_t c_maxPooledSize = 256;
+
+   /// enables or disables the pool
+   static void Enable(bool enable = true) throw()
+   {
+      s_enabled.store(enable, std::memory_order_relaxed);
+   }
+
+   /// returns if pool is enabled
+   static bool IsEnabled() throw()
+   {
+      return s_enabled.load(std::memory_order_relaxed);
+   }
+
+   /// sets a custom allocator; must be called before any string is allocated
+   static void SetAllocator(const CStringAllocator& allocator) throw()
+   {
+      s_customAllocator = allocator;
+      s_hasCustomAllocator = true;
+   }
+
+   /// returns the size of the memory block that is actually allocated for
+   /// the given size
+   static size_t RoundUpSize(size_t size) throw()
+   {
+      int sizeClass = GetSizeClass(size);
+      return sizeClass < 0 ? size : GetClassSize(sizeClass);
+   }
+
+   /// allocates a memory block; size must have been rounded up using
+   /// RoundUpSize(); returns nullptr when out of memory
+   static void* Allocate(size_t size) throw()
+   {
+      if (s_hasCustomAllocator)
+         return s_customAllocator.m_allocate(size);
+
+      int sizeClass = GetSizeClass(size);
+      if (sizeClass < 0 || !IsEnabled())
+         return malloc(size);
+
+      ThreadCache* cache = GetThreadCache();
+      if (cache == nullptr)
+         return malloc(size);
+
+      if (cache->m_freeList[sizeClass] == nullptr)
+         FetchFromGlobalPool(*cache, sizeClass);
+
+      FreeBlock* block = cache->m_freeList[sizeClass];
+      if (block == nullptr)
+      {
+         Increment(cache->m_misses);
+         return malloc(size);
+      }
+
+      cache->m_freeList[sizeClass] = block->m_next;
+      cache->m_numBlocks[sizeClass]--;
+      Increment(cache->m_hits);
+      cache->m_bytesHeld.store(
+         cache->m_bytesHeld.load(std::memory_order_relaxed) - size,
+         std::memory_order_relaxed);
+
+      return block;
+   }
+
+   /// reallocates a memory block, preserving its content; sizes must have
+   /// been rounded up using RoundUpSize(); returns nullptr when out of
+   /// memory, leaving the block untouched
+   static void* Reallocate(void* ptr, size_t oldSize, size_t newSize) throw()
+   {
+      if (s_hasCustomAllocator)
+         return s_customAllocator.m_reallocate(ptr, oldSize, newSize);
+
+      if (oldSize == newSize)
+         return ptr;
+
+      if (oldSize > c_maxPooledSize && newSize > c_maxPooledSize)
+         return realloc(ptr, newSize);
+
+      void* newPtr = Allocate(newSize);
+      if (newPtr == nullptr)
+         return nullptr;
+
+      memcpy(newPtr, ptr, std::min(oldSize, newSize));
+      Free(ptr, oldSize);
+
+      return newPtr;
+   }
+
+   /// frees a memory block; size must have been rounded up using RoundUpSize()
+   static void Free(void* ptr, size_t size) throw()
+   {
+      if (s_hasCustomAllocator)
+      {
+         s_customAllocator.m_free(ptr, size);
+         return;
+      }
+
+      int sizeClass = GetSizeClass(size);
+      if (sizeClass < 0 || !IsEnabled())
+      {
+         free(ptr);
+         return;
+      }
+
+      ThreadCache* cache = GetThreadCache();
+      if (cache == nullptr)
+      {
+         FreeBlock* block = static_cast<FreeBlock*>(ptr);
+         block->m_next = nullptr;
+         ReturnToGlobalPool(block, sizeClass, 1);
+         return;
+      }
+
+      FreeBlock* block = static_cast<FreeBlock*>(ptr);
+      block->m_next = cache->m_freeList[sizeClass];
+      cache->m_freeList[sizeClass] = block;
+      cache->m_numBlocks[sizeClass]++;
+      cache->m_bytesHeld.store(
+         cache->m_bytesHeld.load(std::memory_order_relaxed) + size,
+         std::memory_order_relaxed);
+
+      if (cache->m_numBlocks[sizeClass] >= c_maxThreadBlocks)
+         ReturnBatch(*cache, sizeClass, c_maxThreadBlocks / 2);
+   }
+
+   /// returns current statistics, summed up over all threads
+   static CStringPoolStats GetStats()
+   {
+      GlobalPool& pool = GetGlobalPool();
+      std::lock_guard<std::mutex> lock(pool.m_mutex);
+
+      CStringPoolStats stats = pool.m_exitedThreadStats;
+      for (size_t sizeClass = 0; sizeClass < c_numSizeClasses; sizeClass++)
+      {
+         stats.m_bytesHeld += pool.m_numBlocks[sizeClass].load(std::memory_order_relaxed) *
+            GetClassSize(static_cast<int>(sizeClass));
+      }
+
+      for (ThreadCache* cache = pool.m_firstCache; cache != nullptr; cache = cache->m_nextCache)
+      {
+         stats.m_hits += cache->m_hits.load(std::memory_order_relaxed);
+         stats.m_misses += cache->m_misses.load(std::memory_order_relaxed);
+         stats.m_bytesHeld += cache->m_bytesHeld.load(std::memory_order_relaxed);
+      }
+
+      return stats;
+   }
+
+private:
+   /// maximum number of blocks per size class in a thread's free list
+   static constexpr size_t c_maxThreadBlocks = 64;
+
+   /// maximum number of blocks per size class in the global pool; more blocks are freed
+   static constexpr size_t c_maxGlobalBlocks = 4096;
+
+   /// a block in a free list
+   struct FreeBlock
+   {
+      FreeBlock* m_next;         ///< next block in list
+      FreeBlock* m_nextBatch;    ///< next batch in the global pool; only used by a batch's first block
+   };
+
+   static_assert(sizeof(FreeBlock) <= 16, "free block must fit into the smallest size class");
+
+   /// \brief free lists of a single thread
+   /// \details Constant initialized and trivially destructible, so that it
+   /// can still be used when strings are freed after the thread cache was
+   /// cleaned up. Counters are only written by the owning thread.
+   struct ThreadCache
+   {
+      FreeBlock* m_freeList[c_numSizeClasses];     ///< free lists
+      size_t m_numBlocks[c_numSizeClasses];        ///< number of blocks in free lists
+      std::atomic<uint64_t> m_hits;                ///< number of hits
+      std::atomic<uint64_t> m_misses;              ///< number of misses
+      std::atomic<uint64_t> m_bytesHeld;           ///< number of bytes in free lists
+      ThreadCache* m_nextCache;                    ///< next registered thread cache
+      bool m_registered;                           ///< indicates if cache was registered
+      bool m_exited;                               ///< indicates if thread is exiting
+   };
+
+   /// cleans up a thread's cache when the thread exits
+   struct ThreadCacheCleanup
+   {
+      /// dtor; returns all blocks to the global pool
+      ~ThreadCacheCleanup()
+      {
+         ThreadCache& cache = t_cache;
+         cache.m_exited = true;
+
+         GlobalPool& pool = GetGlobalPool();
+         for (size_t sizeClass = 0; sizeClass < c_numSizeClasses; sizeClass++)
+            ReturnBatch(cache, static_cast<int>(sizeClass), cache.m_numBlocks[sizeClass]);
+
+         std::lock_guard<std::mutex> lock(pool.m_mutex);
+
+         pool.m_exitedThreadStats.m_hits += cache.m_hits.load(std::memory_order_relaxed);
+         pool.m_exitedThreadStats.m_misses += cache.m_misses.load(std::memory_order_relaxed);
+
+         ThreadCache** link = &pool.m_firstCache;
+         while (*link != &cache)
+            link = &(*link)->m_nextCache;
+
+         *link = cache.m_nextCache;
+      }
+   };
+
+   /// global pool, shared by all threads
+   struct GlobalPool
+   {
+      std::mutex m_mutex;                                   ///< mutex protecting the lists
+      FreeBlock* m_batches[c_numSizeClasses] = {};          ///< lists of batches; each batch is a free list
+      std::atomic<size_t> m_numBlocks[c_numSizeClasses] = {}; ///< number of blocks in all batches; also read without locking
+      ThreadCache* m_firstCache = nullptr;                  ///< list of registered thread caches
+      CStringPoolStats m_exitedThreadStats = {};            ///< statistics of exited threads
+   };
+
+   /// returns size class index for given size, or -1 when size isn't pooled
+   static int GetSizeClass(size_t size) throw()
+   {
+      if (size <= 16) return 0;
+      if (size <= 32) return 1;
+      if (size <= 64) return 2;
+      if (size <= 128) return 3;
+      if (size <= 256) return 4;
+      return -1;
+   }
+
+   /// returns size of memory blocks of given size class
+   static size_t GetClassSize(int sizeClass) throw()
+   {
+      return size_t(16) << sizeClass;
+   }
+
+   /// increments a counter that is only written by the owning thread
+   static void Increment(std::atomic<uint64_t>& counter) throw()
+   {
+      counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+   }
+
+   /// returns the global pool; it is never destroyed, since strings may be
+   /// freed during static destruction
+   static GlobalPool& GetGlobalPool()
+   {
+      static GlobalPool* s_globalPool = new GlobalPool;
+      return *s_globalPool;
+   }
+
+   /// returns the current thread's cache, or nullptr when the thread is exiting
+   static ThreadCache* GetThreadCache()
+   {
+      ThreadCache& cache = t_cache;
+      if (cache.m_exited)
+         return nullptr;
+
+      if (!cache.m_registered)
+      {
+         // accessing the cleanup object registers its dtor for this thread
+         (void)&t_cacheCleanup;
+
+         GlobalPool& pool = GetGlobalPool();
+         std::lock_guard<std::mutex> lock(pool.m_mutex);
+
+         cache.m_nextCache = pool.m_firstCache;
+         pool.m_firstCache = &cache;
+         cache.m_registered = true;
+      }
+
+      return &cache;
+   }
+
+   /// fetches a batch of blocks from the global pool into the thread's free
+   /// list; the thread's free list must be empty
+   static void FetchFromGlobalPool(ThreadCache& cache, int sizeClass)
+   {
+      GlobalPool& pool = GetGlobalPool();
+
+      // check without locking first; the global pool is empty most of the
+      // time when threads allocate more strings than they free
+      if (pool.m_numBlocks[sizeClass].load(std::memory_order_relaxed) == 0)
+         return;
+
+      FreeBlock* first = nullptr;
+      {
+         std::lock_guard<std::mutex> lock(pool.m_mutex);
+
+         first = pool.m_batches[sizeClass];
+         if (first == nullptr)
+            return;
+
+         pool.m_batches[sizeClass] = first->m_nextBatch;
+      }
+
+      // the blocks are only counted after unlocking
+      size_t numBlocks = 0;
+      for (FreeBlock* block = first; block != nullptr; block = block->m_next)
+         numBlocks++;
+
+      pool.m_numBlocks[sizeClass].fetch_sub(numBlocks, std::memory_order_relaxed);
+
+      cache.m_freeList[sizeClass] = first;
+      cache.m_numBlocks[sizeClass] += numBlocks;
+      cache.m_bytesHeld.store(
+         cache.m_bytesHeld.load(std::memory_order_relaxed) + numBlocks * GetClassSize(sizeClass),
+         std::memory_order_relaxed);
+   }
+
+   /// returns a number of blocks from the thread's free list to the global pool
+   static void ReturnBatch(ThreadCache& cache, int sizeClass, size_t numBlocks)
+   {
+      if (numBlocks == 0)
+         return;
+
+      // detach the first blocks of the thread's free list
+      FreeBlock* first = cache.m_freeList[sizeClass];
+      FreeBlock* last = first;
+      for (size_t index = 1; index < numBlocks; index++)
+         last = last->m_next;
+
+      cache.m_freeList[sizeClass] = last->m_next;
+      last->m_next = nullptr;
+
+      cache.m_numBlocks[sizeClass] -= numBlocks;
+      cache.m_bytesHeld.store(
+         cache.m_bytesHeld.load(std::memory_order_relaxed) - numBlocks * GetClassSize(sizeClass),
+         std::memory_order_relaxed);
+
+      ReturnToGlobalPool(first, sizeClass, numBlocks);
+   }
+
+   /// returns a list of blocks to the global pool, as a single batch; frees
+   /// the blocks when the global pool is full
+   static void ReturnToGlobalPool(FreeBlock* first, int sizeClass, size_t numBlocks)
+   {
+      GlobalPool& pool = GetGlobalPool();
+      {
+         std::lock_guard<std::mutex> lock(pool.m_mutex);
+
+         if (pool.m_numBlocks[sizeClass].load(std::memory_order_relaxed) + numBlocks <= c_maxGlobalBlocks)
+         {
+            first->m_nextBatch = pool.m_batches[sizeClass];
+            pool.m_batches[sizeClass] = first;
+            pool.m_numBlocks[sizeClass].fetch_add(numBlocks, std::memory_order_relaxed);
+            return;
+         }
+      }
+
+      while (first != nullptr)
+      {
+         FreeBlock* block = first;
+         first = first->m_next;
+         free(block);
+      }
+   }
+
+private:
+   /// indicates if pool is enabled
+#ifdef ULIB_CSTRING_POOL
+   static inline std::atomic<bool> s_enabled{ true };
+#else
+   static inline std::atomic<bool> s_enabled{ false };
+#endif
+
+   /// indicates if a custom allocator was set
+   static inline bool s_hasCustomAllocator = false;
+
+   /// custom allocator
+   static inline CStringAllocator s_customAllocator = {};
+
+   /// free lists of the current thread
+   static inline thread_local ThreadCache t_cache = {};
+
+   /// cleans up the free lists of the current thread when it exits
+   static inline thread_local ThreadCacheCleanup t_cacheCleanup;
+};
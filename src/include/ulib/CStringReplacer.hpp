@@ -0,0 +1,382 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file CStringReplacer.hpp replacing multiple patterns in a single pass
+//
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+
+/// \brief Replaces multiple patterns in a string, in a single pass
+/// \details Add all pattern and replacement pairs first, then call Compile()
+/// once. This builds an Aho-Corasick automaton that finds all patterns while
+/// scanning the text once. Replace() can then be called any number of times,
+/// also from multiple threads at the same time, and produces the result with
+/// a single allocation.
+///
+/// When patterns overlap in the text, the match that starts first is
+/// replaced; when multiple patterns start at the same position, the longest
+/// one is replaced. Replaced text isn't scanned again. This is the same
+/// result as calling CString::Replace() with each pattern, when no pattern
+/// is part of another pattern or replacement.
+template <typename T>
+class CStringReplacerT
+{
+public:
+   typedef T XCHAR;              ///< Type of character
+   typedef const XCHAR* PCXSTR;  ///< Type of character string
+
+   /// String type that is used for replacements and results
+   typedef typename std::conditional<sizeof(XCHAR) == 1, CStringA, CStringW>::type StringType;
+
+   /// \brief Adds pattern and replacement
+   /// \details The pattern must not be empty. Adding the same pattern again
+   /// replaces the previous replacement. Compile() must be called after all
+   /// patterns were added.
+   void Add(PCXSTR pattern, int patternLength, PCXSTR replacement, int replacementLength)
+   {
+      ATLASSERT(pattern != nullptr && patternLength > 0);
+      if (pattern == nullptr || patternLength <= 0)
+         throw std::runtime_error("CStringReplacer::Add: pattern must not be empty");
+
+      m_compiled = false;
+
+      StringType patternText(pattern, patternLength);
+      StringType replacementText(replacement, replacement == nullptr ? 0 : replacementLength);
+
+      for (size_t index = 0; index < m_patterns.size(); index++)
+      {
+         if (m_patterns[index] == patternText)
+         {
+            m_replacements[index] = replacementText;
+            return;
+         }
+      }
+
+      m_patterns.push_back(patternText);
+      m_replacements.push_back(replacementText);
+   }
+
+   /// Adds pattern and replacement, as C-style strings
+   void Add(PCXSTR pattern, PCXSTR replacement)
+   {
+      Add(pattern, pattern == nullptr ? 0 : static_cast<int>(std::char_traits<XCHAR>::length(pattern)),
+         replacement, replacement == nullptr ? 0 : static_cast<int>(std::char_traits<XCHAR>::length(replacement)));
+   }
+
+   /// Returns number of added patterns
+   size_t GetCount() const throw() { return m_patterns.size(); }
+
+   /// Returns if the automaton was compiled after the last pattern was added
+   bool IsCompiled() const throw() { return m_compiled; }
+
+   /// Compiles all added patterns into the automaton
+   void Compile()
+   {
+      BuildAlphabet();
+      BuildTrie();
+      BuildFailureLinks();
+
+      m_failure.clear();
+      m_compiled = true;
+   }
+
+   /// \brief Replaces all patterns in given text and stores the result
+   /// \details Returns the number of replaced patterns. The result string
+   /// must not be the string that contains the text.
+   int Replace(PCXSTR text, int length, StringType& result) const
+   {
+      std::vector<Match> matches;
+      FindMatches(text, length, matches);
+
+      BuildResult(text, length, matches, result);
+
+      return static_cast<int>(matches.size());
+   }
+
+   /// Replaces all patterns in given string; returns the number of replaced patterns
+   int Replace(StringType& str) const
+   {
+      std::vector<Match> matches;
+      FindMatches(str.GetString(), str.GetLength(), matches);
+
+      // leave string untouched when there's nothing to replace
+      if (matches.empty())
+         return 0;
+
+      StringType result;
+      BuildResult(str.GetString(), str.GetLength(), matches, result);
+
+      str = result;
+
+      return static_cast<int>(matches.size());
+   }
+
+private:
+   /// match of a pattern in the text
+   struct Match
+   {
+      int m_start;      ///< start index of match in text
+      int m_length;     ///< length of match
+      int m_pattern;    ///< index of matched pattern
+   };
+
+   /// returns character class of given character; 0 when the character
+   /// isn't part of any pattern
+   int ClassOf(XCHAR ch) const
+   {
+      auto value = static_cast<std::make_unsigned_t<XCHAR>>(ch);
+      if (value < 256)
+         return m_byteClasses[value];
+
+      auto iter = std::lower_bound(m_wideChars.begin(), m_wideChars.end(), ch);
+      if (iter == m_wideChars.end() || *iter != ch)
+         return 0;
+
+      return m_numByteClasses + static_cast<int>(iter - m_wideChars.begin());
+   }
+
+   /// maps all characters of all patterns to character classes, so that the
+   /// transition table only needs one column per character class
+   void BuildAlphabet()
+   {
+      std::fill(std::begin(m_byteClasses), std::end(m_byteClasses), 0);
+      m_wideChars.clear();
+
+      int numClasses = 1;
+      for (const StringType& pattern : m_patterns)
+      {
+         for (int index = 0; index < pattern.GetLength(); index++)
+         {
+            XCHAR ch = pattern.GetString()[index];
+            auto value = static_cast<std::make_unsigned_t<XCHAR>>(ch);
+
+            if (value < 256)
+            {
+               if (m_byteClasses[value] == 0)
+                  m_byteClasses[value] = numClasses++;
+            }
+            else
+               m_wideChars.push_back(ch);
+         }
+      }
+
+      std::sort(m_wideChars.begin(), m_wideChars.end());
+      m_wideChars.erase(std::unique(m_wideChars.begin(), m_wideChars.end()), m_wideChars.end());
+
+      m_numByteClasses = numClasses;
+      m_numClasses = numClasses + static_cast<int>(m_wideChars.size());
+   }
+
+   /// adds a new state to the automaton; returns state index
+   int AddState(int depth)
+   {
+      m_transitions.resize(m_transitions.size() + m_numClasses, -1);
+      m_depth.push_back(depth);
+      m_output.push_back(-1);
+      m_failure.push_back(0);
+      m_dictionaryLink.push_back(-1);
+
+      return static_cast<int>(m_depth.size()) - 1;
+   }
+
+   /// builds trie of all patterns, using the transition table
+   void BuildTrie()
+   {
+      m_transitions.clear();
+      m_depth.clear();
+      m_output.clear();
+      m_failure.clear();
+      m_dictionaryLink.clear();
+
+      AddState(0);
+
+      for (size_t patternIndex = 0; patternIndex < m_patterns.size(); patternIndex++)
+      {
+         const StringType& pattern = m_patterns[patternIndex];
+
+         int state = 0;
+         for (int index = 0; index < pattern.GetLength(); index++)
+         {
+            size_t transition = static_cast<size_t>(state) * m_numClasses + ClassOf(pattern.GetString()[index]);
+            if (m_transitions[transition] < 0)
+            {
+               int newState = AddState(index + 1);
+               m_transitions[transition] = newState;
+            }
+
+            state = m_transitions[transition];
+         }
+
+         m_output[state] = static_cast<int>(patternIndex);
+      }
+   }
+
+   /// \brief calculates failure links, in breadth-first order
+   /// \details Missing transitions are set to the transition of the failure
+   /// state, so that the automaton is a DFA and scanning never has to follow
+   /// failure links. The dictionary link of a state points to the next state
+   /// on the failure chain that matches a pattern.
+   void BuildFailureLinks()
+   {
+      std::vector<int> queue;
+      queue.reserve(m_depth.size());
+
+      for (int charClass = 0; charClass < m_numClasses; charClass++)
+      {
+         int& next = m_transitions[charClass];
+         if (next < 0)
+            next = 0;
+         else
+         {
+            m_failure[next] = 0;
+            queue.push_back(next);
+         }
+      }
+
+      for (size_t queueIndex = 0; queueIndex < queue.size(); queueIndex++)
+      {
+         int state = queue[queueIndex];
+         int failure = m_failure[state];
+
+         m_dictionaryLink[state] = m_output[failure] >= 0 ? failure : m_dictionaryLink[failure];
+
+         for (int charClass = 0; charClass < m_numClasses; charClass++)
+         {
+            int& next = m_transitions[static_cast<size_t>(state) * m_numClasses + charClass];
+            int failureNext = m_transitions[static_cast<size_t>(failure) * m_numClasses + charClass];
+
+            if (next < 0)
+               next = failureNext;
+            else
+            {
+               m_failure[next] = failureNext;
+               queue.push_back(next);
+            }
+         }
+      }
+   }
+
+   /// \brief finds all non-overlapping matches, leftmost first and longest
+   /// \details A candidate match is kept until no match that starts earlier
+   /// can be found anymore; this is the case when the current state's depth
+   /// doesn't reach back to the candidate's start, or at the end of the text.
+   /// After storing the match, scanning restarts at the end of the match.
+   void FindMatches(PCXSTR text, int length, std::vector<Match>& matches) const
+   {
+      ATLASSERT(m_compiled); // call Compile() after adding patterns
+      if (!m_compiled)
+         throw std::runtime_error("CStringReplacer::Replace: patterns must be compiled first");
+
+      Match candidate = { 0, 0, -1 };
+      int state = 0;
+
+      for (int index = 0; index < length; index++)
+      {
+         state = m_transitions[static_cast<size_t>(state) * m_numClasses + ClassOf(text[index])];
+
+         int matchState = m_output[state] >= 0 ? state : m_dictionaryLink[state];
+         for (; matchState >= 0; matchState = m_dictionaryLink[matchState])
+         {
+            int matchLength = m_depth[matchState];
+            int matchStart = index + 1 - matchLength;
+
+            if (candidate.m_pattern < 0 ||
+               matchStart < candidate.m_start ||
+               (matchStart == candidate.m_start && matchLength > candidate.m_length))
+               candidate = Match{ matchStart, matchLength, m_output[matchState] };
+         }
+
+         if (candidate.m_pattern >= 0 &&
+            (index + 1 - m_depth[state] > candidate.m_start || index + 1 == length))
+         {
+            matches.push_back(candidate);
+
+            index = candidate.m_start + candidate.m_length - 1;
+            state = 0;
+            candidate.m_pattern = -1;
+         }
+      }
+   }
+
+   /// builds result from text and matches, allocating the result only once
+   void BuildResult(PCXSTR text, int length, const std::vector<Match>& matches, StringType& result) const
+   {
+      int newLength = length;
+      for (const Match& match : matches)
+         newLength += m_replacements[match.m_pattern].GetLength() - match.m_length;
+
+      result.Empty();
+      if (newLength == 0)
+         return;
+
+      XCHAR* dest = result.GetBuffer(newLength);
+
+      int lastEnd = 0;
+      for (const Match& match : matches)
+      {
+         dest = std::copy(text + lastEnd, text + match.m_start, dest);
+
+         const StringType& replacement = m_replacements[match.m_pattern];
+         dest = std::copy(replacement.GetString(), replacement.GetString() + replacement.GetLength(), dest);
+
+         lastEnd = match.m_start + match.m_length;
+      }
+
+      std::copy(text + lastEnd, text + length, dest);
+
+      result.ReleaseBufferSetLength(newLength);
+   }
+
+private:
+   /// all patterns
+   std::vector<StringType> m_patterns;
+
+   /// all replacements, with the same index as the patterns
+   std::vector<StringType> m_replacements;
+
+   /// indicates if the automaton was compiled after the last pattern was added
+   bool m_compiled = false;
+
+   /// character classes for characters below 256; 0 means no class
+   int m_byteClasses[256] = {};
+
+   /// number of classes for characters below 256, including class 0
+   int m_numByteClasses = 1;
+
+   /// sorted characters of 256 and above that are part of any pattern
+   std::vector<XCHAR> m_wideChars;
+
+   /// number of character classes; number of columns of the transition table
+   int m_numClasses = 1;
+
+   /// transition table; one row of m_numClasses columns for each state
+   std::vector<int> m_transitions;
+
+   /// depth of each state, which is the length of the matched text
+   std::vector<int> m_depth;
+
+   /// pattern index matched by each state, or -1
+   std::vector<int> m_output;
+
+   /// failure link of each state; only used while compiling
+   std::vector<int> m_failure;
+
+   /// dictionary link of each state, or -1
+   std::vector<int> m_dictionaryLink;
+};
+
+/// Replacer for ANSI strings
+typedef CStringReplacerT<CHAR> CStringReplacerA;
+
+/// Replacer for UCS, 16 bit strings
+typedef CStringReplacerT<WCHAR> CStringReplacerW;
+
+/// Replacer for strings, type determined by Unicode setting
+typedef CStringReplacerT<TCHAR> CStringReplacer;
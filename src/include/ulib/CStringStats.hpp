@@ -0,0 +1,263 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file CStringStats.hpp allocation statistics for string data
+//
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/// snapshot of string allocation statistics
+struct CStringStatsSnapshot
+{
+   /// number of allocation size buckets; see CStringStats::GetBucketLimit()
+   static constexpr size_t c_numSizeBuckets = 12;
+
+   /// indicates if statistics are collected at all
+   bool m_enabled = false;
+
+   /// number of bytes currently allocated for string data
+   uint64_t m_liveBytes = 0;
+
+   /// maximum number of bytes allocated for string data at any time
+   uint64_t m_peakBytes = 0;
+
+   /// number of allocations
+   uint64_t m_numAllocations = 0;
+
+   /// number of reallocations, when growing or shrinking a buffer
+   uint64_t m_numReallocations = 0;
+
+   /// number of frees
+   uint64_t m_numFrees = 0;
+
+   /// number of times shared string data was copied before modifying it
+   uint64_t m_numForks = 0;
+
+   /// number of allocations and reallocations, by size bucket
+   uint64_t m_sizeBuckets[c_numSizeBuckets] = {};
+
+   /// returns statistics as JSON object
+   std::string ToJson() const;
+
+   /// returns statistics as readable text, one value per line
+   std::string ToText() const;
+};
+
+/// \brief Allocation statistics for string data
+/// \details Records live and peak bytes, allocations by size, reallocations,
+/// frees and copy-on-write forks of the string data of the portable CStringT
+/// class. The statistics are collected by defining ULIB_CSTRING_STATS;
+/// otherwise all recording functions are empty and are optimized away, and
+/// Snapshot() returns an empty snapshot. Only heap allocations are counted;
+/// strings in the inline buffer don't allocate. The ATL CString class isn't
+/// instrumented. Counters are updated with relaxed atomic operations, so a
+/// snapshot taken while other threads modify strings may be slightly
+/// inconsistent.
+class CStringStats
+{
+public:
+   /// indicates if statistics are collected
+#ifdef ULIB_CSTRING_STATS
+   static constexpr bool c_enabled = true;
+#else
+   static constexpr bool c_enabled = false;
+#endif
+
+   /// smallest bucket size; the buckets double in size
+   static constexpr size_t c_minBucketSize = 16;
+
+   /// returns index of size bucket for allocation size
+   static size_t GetBucketIndex(size_t size) throw()
+   {
+      size_t index = 0;
+      size_t limit = c_minBucketSize;
+      while (size > limit && index < CStringStatsSnapshot::c_numSizeBuckets - 1)
+      {
+         limit *= 2;
+         index++;
+      }
+
+      return index;
+   }
+
+   /// returns largest allocation size in given bucket; the last bucket
+   /// contains all larger sizes and returns 0
+   static size_t GetBucketLimit(size_t index) throw()
+   {
+      return index >= CStringStatsSnapshot::c_numSizeBuckets - 1 ? 0 : c_minBucketSize << index;
+   }
+
+   /// records allocation of given number of bytes
+   static void OnAllocate(size_t size) throw()
+   {
+#ifdef ULIB_CSTRING_STATS
+      Increment(s_counters.m_numAllocations);
+      Increment(s_counters.m_sizeBuckets[GetBucketIndex(size)]);
+      AddLiveBytes(size);
+#else
+      (void)size;
+#endif
+   }
+
+   /// records reallocation from old to new number of bytes
+   static void OnReallocate(size_t oldSize, size_t newSize) throw()
+   {
+#ifdef ULIB_CSTRING_STATS
+      Increment(s_counters.m_numReallocations);
+      Increment(s_counters.m_sizeBuckets[GetBucketIndex(newSize)]);
+      s_counters.m_liveBytes.fetch_sub(oldSize, std::memory_order_relaxed);
+      AddLiveBytes(newSize);
+#else
+      (void)oldSize;
+      (void)newSize;
+#endif
+   }
+
+   /// records freeing given number of bytes
+   static void OnFree(size_t size) throw()
+   {
+#ifdef ULIB_CSTRING_STATS
+      Increment(s_counters.m_numFrees);
+      s_counters.m_liveBytes.fetch_sub(size, std::memory_order_relaxed);
+#else
+      (void)size;
+#endif
+   }
+
+   /// records copying shared string data before modifying it
+   static void OnFork() throw()
+   {
+#ifdef ULIB_CSTRING_STATS
+      Increment(s_counters.m_numForks);
+#endif
+   }
+
+   /// returns current statistics
+   static CStringStatsSnapshot Snapshot() throw()
+   {
+      CStringStatsSnapshot snapshot;
+
+#ifdef ULIB_CSTRING_STATS
+      snapshot.m_enabled = true;
+      snapshot.m_liveBytes = s_counters.m_liveBytes.load(std::memory_order_relaxed);
+      snapshot.m_peakBytes = s_counters.m_peakBytes.load(std::memory_order_relaxed);
+      snapshot.m_numAllocations = s_counters.m_numAllocations.load(std::memory_order_relaxed);
+      snapshot.m_numReallocations = s_counters.m_numReallocations.load(std::memory_order_relaxed);
+      snapshot.m_numFrees = s_counters.m_numFrees.load(std::memory_order_relaxed);
+      snapshot.m_numForks = s_counters.m_numForks.load(std::memory_order_relaxed);
+
+      for (size_t index = 0; index < CStringStatsSnapshot::c_numSizeBuckets; index++)
+         snapshot.m_sizeBuckets[index] = s_counters.m_sizeBuckets[index].load(std::memory_order_relaxed);
+#endif
+
+      return snapshot;
+   }
+
+   /// resets all counters; live bytes are kept, and the peak is set to the
+   /// live bytes, so that the peak of the next period can be measured
+   static void Reset() throw()
+   {
+#ifdef ULIB_CSTRING_STATS
+      s_counters.m_peakBytes.store(s_counters.m_liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      s_counters.m_numAllocations.store(0, std::memory_order_relaxed);
+      s_counters.m_numReallocations.store(0, std::memory_order_relaxed);
+      s_counters.m_numFrees.store(0, std::memory_order_relaxed);
+      s_counters.m_numForks.store(0, std::memory_order_relaxed);
+
+      for (auto& bucket : s_counters.m_sizeBuckets)
+         bucket.store(0, std::memory_order_relaxed);
+#endif
+   }
+
+private:
+#ifdef ULIB_CSTRING_STATS
+   /// all counters; zero initialized, since it's only used as static variable
+   struct Counters
+   {
+      std::atomic<uint64_t> m_liveBytes;           ///< live bytes
+      std::atomic<uint64_t> m_peakBytes;           ///< peak bytes
+      std::atomic<uint64_t> m_numAllocations;      ///< number of allocations
+      std::atomic<uint64_t> m_numReallocations;    ///< number of reallocations
+      std::atomic<uint64_t> m_numFrees;            ///< number of frees
+      std::atomic<uint64_t> m_numForks;            ///< number of forks
+      std::atomic<uint64_t> m_sizeBuckets[CStringStatsSnapshot::c_numSizeBuckets]; ///< size buckets
+   };
+
+   /// increments a counter
+   static void Increment(std::atomic<uint64_t>& counter) throw()
+   {
+      counter.fetch_add(1, std::memory_order_relaxed);
+   }
+
+   /// adds to live bytes and updates peak bytes
+   static void AddLiveBytes(size_t size) throw()
+   {
+      uint64_t liveBytes = s_counters.m_liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+
+      uint64_t peakBytes = s_counters.m_peakBytes.load(std::memory_order_relaxed);
+      while (liveBytes > peakBytes &&
+         !s_counters.m_peakBytes.compare_exchange_weak(peakBytes, liveBytes, std::memory_order_relaxed))
+      {
+      }
+   }
+
+   /// all counters
+   static inline Counters s_counters = {};
+#endif
+};
+
+inline std::string CStringStatsSnapshot::ToJson() const
+{
+   std::string json = "{";
+   json += "\"enabled\":" + std::string(m_enabled ? "true" : "false");
+   json += ",\"liveBytes\":" + std::to_string(m_liveBytes);
+   json += ",\"peakBytes\":" + std::to_string(m_peakBytes);
+   json += ",\"allocations\":" + std::to_string(m_numAllocations);
+   json += ",\"reallocations\":" + std::to_string(m_numReallocations);
+   json += ",\"frees\":" + std::to_string(m_numFrees);
+   json += ",\"forks\":" + std::to_string(m_numForks);
+   json += ",\"sizeBuckets\":[";
+
+   for (size_t index = 0; index < c_numSizeBuckets; index++)
+   {
+      if (index > 0)
+         json += ",";
+
+      size_t limit = CStringStats::GetBucketLimit(index);
+      json += "{\"maxSize\":" + (limit == 0 ? std::string("null") : std::to_string(limit));
+      json += ",\"count\":" + std::to_string(m_sizeBuckets[index]) + "}";
+   }
+
+   json += "]}";
+   return json;
+}
+
+inline std::string CStringStatsSnapshot::ToText() const
+{
+   if (!m_enabled)
+      return "CString statistics are disabled; define ULIB_CSTRING_STATS to enable them\n";
+
+   std::string text;
+   text += "live bytes: " + std::to_string(m_liveBytes) + "\n";
+   text += "peak bytes: " + std::to_string(m_peakBytes) + "\n";
+   text += "allocations: " + std::to_string(m_numAllocations) + "\n";
+   text += "reallocations: " + std::to_string(m_numReallocations) + "\n";
+   text += "frees: " + std::to_string(m_numFrees) + "\n";
+   text += "forks: " + std::to_string(m_numForks) + "\n";
+
+   for (size_t index = 0; index < c_numSizeBuckets; index++)
+   {
+      size_t limit = CStringStats::GetBucketLimit(index);
+      text += limit == 0
+         ? "size > " + std::to_string(CStringStats::GetBucketLimit(index - 1))
+         : "size <= " + std::to_string(limit);
+
+      text += ": " + std::to_string(m_sizeBuckets[index]) + "\n";
+   }
+
+   return text;
+}
@@ -0,0 +1,333 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file CStringU8.hpp UTF-8 encoded string
+//
+#pragma once
+
+#include <ulib/UTF8Convert.hpp>
+#include <iterator>
+#include <cstring>
+
+/// \brief UTF-8 encoded string
+/// \details Stores the UTF-8 bytes in a CStringA, so copying behaves the same
+/// as for CStringA: copies share heap allocated string data, while short
+/// strings in the inline buffer of the portable CStringT are copied. Text
+/// that is only passed around stays UTF-8 and uses one byte for each ASCII
+/// character, instead of 2 or 4 bytes in a CStringW.
+///
+/// The string caches if its bytes are valid UTF-8 and how many code points
+/// it contains; both are determined lazily, when first asked for, and are
+/// kept up to date when appending strings whose state is already known. A
+/// string converted from a wide string is always valid. Converting to a
+/// wide string, or iterating over the code points, replaces invalid
+/// sequences with U+FFFD.
+class CStringU8
+{
+public:
+   typedef char XCHAR;              ///< Type of character
+   typedef const XCHAR* PCXSTR;     ///< Type of character string
+
+   /// \brief iterator over the code points of the string
+   /// \details Invalid sequences are returned as U+FFFD.
+   class CodePointIterator
+   {
+   public:
+      typedef std::forward_iterator_tag iterator_category;  ///< iterator category
+      typedef char32_t value_type;                          ///< type of code point
+      typedef ptrdiff_t difference_type;                    ///< difference type
+      typedef const char32_t* pointer;                      ///< pointer type
+      typedef char32_t reference;                           ///< code points are returned by value
+
+      /// ctor; starts at given position
+      CodePointIterator(PCXSTR pos, PCXSTR end) throw()
+         :m_pos(pos),
+         m_end(end)
+      {
+         Decode();
+      }
+
+      /// returns current code point
+      char32_t operator*() const throw() { return m_codePoint; }
+
+      /// returns position of the current code point in the string's bytes
+      PCXSTR GetPosition() const throw() { return m_pos; }
+
+      /// advances to the next code point
+      CodePointIterator& operator++() throw()
+      {
+         m_pos = m_next;
+         Decode();
+         return *this;
+      }
+
+      /// advances to the next code point; postfix version
+      CodePointIterator operator++(int) throw()
+      {
+         CodePointIterator iter = *this;
+         ++*this;
+         return iter;
+      }
+
+      /// compares iterators
+      bool operator==(const CodePointIterator& rhs) const throw() { return m_pos == rhs.m_pos; }
+
+      /// compares iterators
+      bool operator!=(const CodePointIterator& rhs) const throw() { return m_pos != rhs.m_pos; }
+
+   private:
+      /// decodes code point at the current position
+      void Decode() throw()
+      {
+         m_next = m_pos;
+         if (m_pos >= m_end)
+         {
+            m_codePoint = 0;
+            return;
+         }
+
+         // fast path for ASCII characters
+         if (static_cast<unsigned char>(*m_pos) < 0x80)
+         {
+            m_codePoint = static_cast<char32_t>(*m_next++);
+            return;
+         }
+
+         m_codePoint = UTF8Convert::DecodeCodePoint(m_next, m_end);
+         if (m_codePoint > UTF8Convert::c_maxCodePoint)
+            m_codePoint = UTF8Convert::c_replacementChar;
+      }
+
+   private:
+      /// position of current code point
+      PCXSTR m_pos;
+
+      /// position of next code point
+      PCXSTR m_next = nullptr;
+
+      /// end of string
+      PCXSTR m_end;
+
+      /// current code point
+      char32_t m_codePoint = 0;
+   };
+
+   /// ctor; creates an empty string
+   CStringU8() throw()
+      :m_validation(Validation::valid),
+      m_codePointCount(0)
+   {
+   }
+
+   /// ctor; takes zero terminated UTF-8 text
+   CStringU8(PCXSTR text)
+      :m_bytes(text)
+   {
+   }
+
+   /// ctor; takes UTF-8 text with given length in bytes
+   CStringU8(PCXSTR text, int length)
+      :m_bytes(text, length)
+   {
+   }
+
+#ifdef __cpp_char8_t
+   /// ctor; takes an u8"" string literal
+   CStringU8(const char8_t* text)
+      :m_bytes(reinterpret_cast<PCXSTR>(text))
+   {
+   }
+#endif
+
+   /// ctor; takes bytes that contain UTF-8 text; copies the string the same
+   /// way as CStringA's copy ctor
+   explicit CStringU8(const CStringA& bytes)
+      :m_bytes(bytes)
+   {
+   }
+
+   /// ctor; converts from a wide string
+   explicit CStringU8(const CStringW& text)
+   {
+      Assign(text.GetString(), text.GetLength());
+   }
+
+   /// ctor; converts from a wide string with given length
+   CStringU8(const wchar_t* text, int length)
+   {
+      Assign(text, length);
+   }
+
+   /// returns length of the string, in bytes
+   int GetLength() const throw() { return m_bytes.GetLength(); }
+
+   /// returns if the string is empty
+   bool IsEmpty() const throw() { return m_bytes.IsEmpty(); }
+
+   /// returns the zero terminated UTF-8 text
+   PCXSTR GetString() const throw() { return m_bytes.GetString(); }
+
+   /// returns the bytes of the string
+   const CStringA& GetBytes() const throw() { return m_bytes; }
+
+   /// returns if the string contains valid UTF-8 text; the result is cached
+   bool IsValid() const
+   {
+      if (m_validation == Validation::unknown)
+         m_validation = UTF8Convert::IsValid(GetString(), static_cast<size_t>(GetLength()))
+            ? Validation::valid
+            : Validation::invalid;
+
+      return m_validation == Validation::valid;
+   }
+
+   /// returns number of code points in the string; each invalid sequence
+   /// counts as one code point; the result is cached
+   int GetCodePointCount() const
+   {
+      if (m_codePointCount < 0)
+         m_codePointCount = static_cast<int>(
+            UTF8Convert::CountCodePoints(GetString(), static_cast<size_t>(GetLength())));
+
+      return m_codePointCount;
+   }
+
+   /// converts string to a wide string
+   CStringW ToStringW() const
+   {
+      CStringW text;
+      if (IsEmpty())
+         return text;
+
+      // UTF-8 text never has more code points than bytes, and each code point
+      // that needs a surrogate pair has four bytes, so the byte length is
+      // large enough; this saves measuring the text first
+      const size_t length = static_cast<size_t>(GetLength());
+
+      wchar_t* buffer = text.GetBuffer(GetLength());
+      size_t wideLength = UTF8Convert::ToWide(buffer, length, GetString(), length);
+      text.ReleaseBufferSetLength(static_cast<int>(wideLength));
+
+      return text;
+   }
+
+   /// sets an empty string
+   void Empty() throw()
+   {
+      m_bytes.Empty();
+      m_validation = Validation::valid;
+      m_codePointCount = 0;
+   }
+
+   /// appends UTF-8 text with given length in bytes
+   void Append(PCXSTR text, int length)
+   {
+      m_bytes.Append(text, length);
+      m_validation = Validation::unknown;
+      m_codePointCount = -1;
+   }
+
+   /// \brief appends another UTF-8 string
+   /// \details When both strings are valid, the result is valid as well, and
+   /// the code point counts are added, when both are known.
+   CStringU8& operator+=(const CStringU8& str)
+   {
+      Validation validation = m_validation == Validation::valid ? str.m_validation : Validation::unknown;
+      int codePointCount = validation == Validation::valid && m_codePointCount >= 0 && str.m_codePointCount >= 0
+         ? m_codePointCount + str.m_codePointCount
+         : -1;
+
+      m_bytes.Append(str.GetString(), str.GetLength());
+
+      m_validation = validation;
+      m_codePointCount = codePointCount;
+
+      return *this;
+   }
+
+   /// appends zero terminated UTF-8 text
+   CStringU8& operator+=(PCXSTR text)
+   {
+      Append(text, static_cast<int>(std::strlen(text)));
+      return *this;
+   }
+
+   /// returns iterator to the first code point
+   CodePointIterator begin() const throw()
+   {
+      return CodePointIterator(GetString(), GetString() + GetLength());
+   }
+
+   /// returns iterator after the last code point
+   CodePointIterator end() const throw()
+   {
+      return CodePointIterator(GetString() + GetLength(), GetString() + GetLength());
+   }
+
+   /// compares strings; the bytes are compared
+   friend bool operator==(const CStringU8& lhs, const CStringU8& rhs) throw()
+   {
+      return lhs.GetLength() == rhs.GetLength() &&
+         std::memcmp(lhs.GetString(), rhs.GetString(), static_cast<size_t>(lhs.GetLength())) == 0;
+   }
+
+   /// compares strings
+   friend bool operator!=(const CStringU8& lhs, const CStringU8& rhs) throw()
+   {
+      return !(lhs == rhs);
+   }
+
+   /// \brief compares strings
+   /// \details Comparing the UTF-8 bytes results in the same order as
+   /// comparing the code points.
+   friend bool operator<(const CStringU8& lhs, const CStringU8& rhs) throw()
+   {
+      int result = std::memcmp(lhs.GetString(), rhs.GetString(),
+         static_cast<size_t>(std::min(lhs.GetLength(), rhs.GetLength())));
+
+      return result < 0 || (result == 0 && lhs.GetLength() < rhs.GetLength());
+   }
+
+private:
+   /// converts wide text and stores it
+   void Assign(const wchar_t* text, int length)
+   {
+      m_bytes.Empty();
+      m_validation = Validation::valid;
+      m_codePointCount = -1;
+
+      if (length <= 0)
+      {
+         m_codePointCount = 0;
+         return;
+      }
+
+      int utf8Length = static_cast<int>(UTF8Convert::FromWide(nullptr, 0, text, static_cast<size_t>(length)));
+
+      char* buffer = m_bytes.GetBuffer(utf8Length);
+      UTF8Convert::FromWide(buffer, static_cast<size_t>(utf8Length), text, static_cast<size_t>(length));
+      m_bytes.ReleaseBufferSetLength(utf8Length);
+
+      if (!UTF8Convert::IsWideUTF16())
+         m_codePointCount = length;
+   }
+
+private:
+   /// validation state
+   enum class Validation
+   {
+      unknown, ///< not validated yet
+      valid,   ///< valid UTF-8 text
+      invalid, ///< text contains invalid sequences
+   };
+
+   /// UTF-8 bytes
+   CStringA m_bytes;
+
+   /// validation state; determined when first needed
+   mutable Validation m_validation = Validation::unknown;
+
+   /// number of code points, or -1 when not counted yet
+   mutable int m_codePointCount = -1;
+};
@@ -0,0 +1,363 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file CStringView.hpp non-owning view on a string
+//
+#pragma once
+
+#include <string>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <cctype>
+#include <cwctype>
+#include <ulib/StringHash.hpp>
+#include <ulib/StringSearch.hpp>
+
+/// \brief Non-owning view on a part of a string
+/// \details The view consists of a pointer to the characters and a length;
+/// the characters are not necessarily zero terminated. Substring operations
+/// like Mid() or Trim() return views into the same buffer, without allocating
+/// memory. The viewed string must outlive the view. Use ToString() to store
+/// the viewed characters.
+template <typename T>
+class CStringViewT
+{
+public:
+   typedef T XCHAR;              ///< Type of character
+   typedef const XCHAR* PCXSTR;  ///< Type of character string
+
+   /// String type that is returned by ToString()
+   typedef typename std::conditional<sizeof(XCHAR) == 1, CStringA, CStringW>::type StringType;
+
+   /// Default ctor; empty view
+   CStringViewT() throw()
+      :m_str(&c_empty),
+      m_length(0)
+   {
+   }
+
+   /// Ctor; takes a C-style string and a length
+   CStringViewT(PCXSTR str, int length) throw()
+      :m_str(str == nullptr ? &c_empty : str),
+      m_length(str == nullptr ? 0 : length)
+   {
+      ATLASSERT(length >= 0);
+   }
+
+   /// \brief Ctor; takes a zero-terminated C-style string
+   /// \details This ctor is explicit, so that calling functions that have
+   /// overloads for both CString and CStringView isn't ambiguous.
+   explicit CStringViewT(PCXSTR str) throw()
+      :m_str(str == nullptr ? &c_empty : str),
+      m_length(str == nullptr ? 0 : static_cast<int>(std::char_traits<XCHAR>::length(str)))
+   {
+   }
+
+   /// Ctor; takes any string class with GetString() and GetLength() methods, e.g. CString
+   template <typename TString,
+      typename = typename std::enable_if<
+         std::is_same<decltype(std::declval<const TString&>().GetString()), PCXSTR>::value>::type>
+   CStringViewT(const TString& str) throw()
+      :m_str(str.GetString()),
+      m_length(str.GetLength())
+   {
+   }
+
+   /// \brief Ctor; temporary strings are not available
+   /// \details The view would point to the characters of a string that is
+   /// destroyed at the end of the expression; this includes concatenations of
+   /// strings, returned by operator+.
+   template <typename TString,
+      typename = typename std::enable_if<
+         std::is_same<decltype(std::declval<const TString&>().GetString()), PCXSTR>::value>::type>
+   CStringViewT(const TString&& str) = delete;
+
+   /// Returns pointer to the viewed characters; not necessarily zero terminated
+   PCXSTR GetData() const throw() { return m_str; }
+
+   /// Returns length of view
+   int GetLength() const throw() { return m_length; }
+
+   /// Returns if view is empty
+   bool IsEmpty() const throw() { return m_length == 0; }
+
+   /// Returns character at given index
+   XCHAR GetAt(int index) const
+   {
+      ATLASSERT(index >= 0 && index < m_length);
+
+      if (index < 0 || index >= m_length)
+         throw std::invalid_argument("CStringView: invalid index argument to GetAt()");
+
+      return m_str[index];
+   }
+
+   /// Array operator
+   XCHAR operator[](int index) const
+   {
+      return GetAt(index);
+   }
+
+   /// Copies the viewed characters to a new string
+   StringType ToString() const
+   {
+      return StringType(m_str, m_length);
+   }
+
+   // search
+
+   /// Finds character, starting at given index; returns -1 when not found
+   int Find(XCHAR ch, int start = 0) const throw()
+   {
+      if (start < 0 || start >= m_length)
+         return -1;
+
+      PCXSTR found = StringSearch::FindChar(m_str + start, static_cast<size_t>(m_length - start), ch);
+      return found == nullptr ? -1 : static_cast<int>(found - m_str);
+   }
+
+   /// Finds substring, starting at given index; returns -1 when not found
+   int Find(const CStringViewT& subString, int start = 0) const throw()
+   {
+      if (start < 0 || start > m_length)
+         return -1;
+
+      PCXSTR found = StringSearch::FindString(m_str + start, static_cast<size_t>(m_length - start),
+         subString.m_str, static_cast<size_t>(subString.m_length));
+
+      return found == nullptr ? -1 : static_cast<int>(found - m_str);
+   }
+
+   /// Finds zero-terminated substring, starting at given index; returns -1
+   /// when not found. A template, so that passing a CString isn't ambiguous.
+   template <typename TChar,
+      typename = typename std::enable_if<std::is_same<TChar, XCHAR>::value>::type>
+   int Find(const TChar* subString, int start = 0) const throw()
+   {
+      return Find(CStringViewT(subString), start);
+   }
+
+   /// Finds last occurrence of character; returns -1 when not found
+   int ReverseFind(XCHAR ch) const throw()
+   {
+      PCXSTR found = StringSearch::ReverseFindChar(m_str, static_cast<size_t>(m_length), ch);
+      return found == nullptr ? -1 : static_cast<int>(found - m_str);
+   }
+
+   /// Finds first character that is in the given character set; returns -1 when not found
+   int FindOneOf(const CStringViewT& charSet) const throw()
+   {
+      PCXSTR found = StringSearch::FindCharOf(m_str, static_cast<size_t>(m_length),
+         charSet.m_str, static_cast<size_t>(charSet.m_length), true);
+
+      return found == nullptr ? -1 : static_cast<int>(found - m_str);
+   }
+
+   /// Finds first character that is in the given zero-terminated character
+   /// set; returns -1 when not found
+   template <typename TChar,
+      typename = typename std::enable_if<std::is_same<TChar, XCHAR>::value>::type>
+   int FindOneOf(const TChar* charSet) const throw()
+   {
+      return FindOneOf(CStringViewT(charSet));
+   }
+
+   // comparison
+
+   /// Compares view with other view; returns negative, zero or positive value
+   int Compare(const CStringViewT& other) const throw()
+   {
+      int result = std::char_traits<XCHAR>::compare(m_str, other.m_str, std::min(m_length, other.m_length));
+      if (result != 0)
+         return result;
+
+      return m_length < other.m_length ? -1 : (m_length > other.m_length ? 1 : 0);
+   }
+
+   /// Compares view with other view, ignoring case; returns negative, zero or positive value
+   int CompareNoCase(const CStringViewT& other) const throw()
+   {
+      int minLength = std::min(m_length, other.m_length);
+      for (int index = 0; index < minLength; index++)
+      {
+         XCHAR lhs = ToLower(m_str[index]);
+         XCHAR rhs = ToLower(other.m_str[index]);
+         if (lhs != rhs)
+            return lhs < rhs ? -1 : 1;
+      }
+
+      return m_length < other.m_length ? -1 : (m_length > other.m_length ? 1 : 0);
+   }
+
+   // substrings
+
+   /// Returns view on the part starting at given index, up to the end
+   CStringViewT Mid(int first) const throw()
+   {
+      return Mid(first, m_length);
+   }
+
+   /// Returns view on the part starting at given index, with given length;
+   /// parameters are clamped to the viewed string, like CString::Mid() does
+   CStringViewT Mid(int first, int count) const throw()
+   {
+      first = std::min(std::max(first, 0), m_length);
+      count = std::min(std::max(count, 0), m_length - first);
+
+      return CStringViewT(m_str + first, count);
+   }
+
+   /// Returns view on the first count characters
+   CStringViewT Left(int count) const throw()
+   {
+      return Mid(0, count);
+   }
+
+   /// Returns view on the last count characters
+   CStringViewT Right(int count) const throw()
+   {
+      count = std::min(std::max(count, 0), m_length);
+      return Mid(m_length - count, count);
+   }
+
+   /// Returns view with leading and trailing whitespace removed
+   CStringViewT Trim() const throw()
+   {
+      return TrimLeft().TrimRight();
+   }
+
+   /// Returns view with leading and trailing characters in the given set removed
+   CStringViewT Trim(PCXSTR targets) const throw()
+   {
+      return TrimLeft(targets).TrimRight(targets);
+   }
+
+   /// Returns view with leading whitespace removed
+   CStringViewT TrimLeft() const throw()
+   {
+      int first = 0;
+      while (first < m_length && IsSpace(m_str[first]))
+         first++;
+
+      return Mid(first);
+   }
+
+   /// Returns view with leading characters in the given set removed
+   CStringViewT TrimLeft(PCXSTR targets) const throw()
+   {
+      CStringViewT targetSet(targets);
+
+      int first = 0;
+      while (first < m_length && targetSet.Find(m_str[first]) != -1)
+         first++;
+
+      return Mid(first);
+   }
+
+   /// Returns view with trailing whitespace removed
+   CStringViewT TrimRight() const throw()
+   {
+      int length = m_length;
+      while (length > 0 && IsSpace(m_str[length - 1]))
+         length--;
+
+      return Left(length);
+   }
+
+   /// Returns view with trailing characters in the given set removed
+   CStringViewT TrimRight(PCXSTR targets) const throw()
+   {
+      CStringViewT targetSet(targets);
+
+      int length = m_length;
+      while (length > 0 && targetSet.Find(m_str[length - 1]) != -1)
+         length--;
+
+      return Left(length);
+   }
+
+   // comparison operators
+
+   /// Equality operator
+   friend bool operator==(const CStringViewT& lhs, const CStringViewT& rhs) throw()
+   {
+      return lhs.m_length == rhs.m_length && lhs.Compare(rhs) == 0;
+   }
+
+   /// Equality operator, with a C-style string; a template, so that comparing
+   /// with a CString isn't ambiguous
+   template <typename TChar,
+      typename = typename std::enable_if<std::is_same<TChar, XCHAR>::value>::type>
+   friend bool operator==(const CStringViewT& lhs, const TChar* rhs) throw()
+   {
+      return lhs == CStringViewT(rhs);
+   }
+
+   /// Inequality operator
+   friend bool operator!=(const CStringViewT& lhs, const CStringViewT& rhs) throw()
+   {
+      return !(lhs == rhs);
+   }
+
+   /// Inequality operator, with a C-style string
+   template <typename TChar,
+      typename = typename std::enable_if<std::is_same<TChar, XCHAR>::value>::type>
+   friend bool operator!=(const CStringViewT& lhs, const TChar* rhs) throw()
+   {
+      return !(lhs == CStringViewT(rhs));
+   }
+
+   /// Less operator
+   friend bool operator<(const CStringViewT& lhs, const CStringViewT& rhs) throw()
+   {
+      return lhs.Compare(rhs) < 0;
+   }
+
+private:
+   /// Returns if character is a whitespace character
+   static bool IsSpace(char ch) throw() { return isspace(static_cast<unsigned char>(ch)) != 0; }
+
+   /// Returns if character is a whitespace character; wide char version
+   static bool IsSpace(wchar_t ch) throw() { return iswspace(ch) != 0; }
+
+   /// Returns lower case character
+   static char ToLower(char ch) throw() { return static_cast<char>(tolower(static_cast<unsigned char>(ch))); }
+
+   /// Returns lower case character; wide char version
+   static wchar_t ToLower(wchar_t ch) throw() { return static_cast<wchar_t>(towlower(ch)); }
+
+private:
+   /// Empty string, used for empty views
+   static constexpr XCHAR c_empty = 0;
+
+   /// Pointer to viewed characters
+   PCXSTR m_str;
+
+   /// Number of viewed characters
+   int m_length;
+};
+
+/// View on ANSI characters
+typedef CStringViewT<CHAR> CStringViewA;
+
+/// View on UCS, 16 bit characters
+typedef CStringViewT<WCHAR> CStringViewW;
+
+/// View on characters, type determined by Unicode setting
+typedef CStringViewT<TCHAR> CStringView;
+
+namespace std
+{
+   /// hash function for views; returns the same value as for a string with the same text
+   template <typename T>
+   struct hash<CStringViewT<T>>
+   {
+      /// returns hash value
+      size_t operator()(const CStringViewT<T>& view) const noexcept
+      {
+         return StringHash::Hash(view.GetData(), static_cast<size_t>(view.GetLength()));
+      }
+   };
+}
@@ -0,0 +1,445 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file CharConvert.hpp conversion between narrow and wide character strings
+/// \details Converting between char and wchar_t strings is done using the
+/// locale's multibyte conversion functions, which process one character per
+/// call. Since most text is pure ASCII, and ASCII characters are the same in
+/// all supported multibyte encodings, runs of ASCII characters are converted
+/// using SIMD kernels instead, 16 or 32 bytes at a time. Only the non-ASCII
+/// characters are passed to the locale converter. The kernels use the same
+/// instruction set detection as the StringSearch kernels; on other platforms,
+/// a scalar implementation is used that checks 8 bytes at a time.
+//
+#pragma once
+
+#include <ulib/StringSearch.hpp>
+#include <cstdint>
+#include <cwchar>
+#include <climits>
+#include <algorithm>
+#include <type_traits>
+
+#if defined(ULIB_STRINGSEARCH_X86) && defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+/// \brief conversion between narrow and wide character strings
+namespace CharConvert
+{
+   /// \brief scalar implementation of the ASCII kernels
+   namespace Scalar
+   {
+      /// returns index of first non-ASCII character, or length when all characters are ASCII
+      inline size_t FindNonAscii(const char* str, size_t length)
+      {
+         size_t index = 0;
+
+         // check 8 bytes at a time
+         for (; index + sizeof(uint64_t) <= length; index += sizeof(uint64_t))
+         {
+            uint64_t block;
+            memcpy(&block, str + index, sizeof(block));
+            if ((block & 0x8080808080808080ULL) != 0)
+               break;
+         }
+
+         for (; index < length; index++)
+            if (static_cast<unsigned char>(str[index]) >= 0x80)
+               break;
+
+         return index;
+      }
+
+      /// returns index of first non-ASCII character, or length when all characters are ASCII
+      inline size_t FindNonAscii(const wchar_t* str, size_t length)
+      {
+         size_t index = 0;
+         for (; index < length; index++)
+            if (static_cast<std::make_unsigned_t<wchar_t>>(str[index]) >= 0x80)
+               break;
+
+         return index;
+      }
+
+      /// widens leading ASCII characters; returns number of converted characters
+      inline size_t WidenAscii(wchar_t* dest, const char* src, size_t length)
+      {
+         size_t index = 0;
+         for (; index < length; index++)
+         {
+            unsigned char ch = static_cast<unsigned char>(src[index]);
+            if (ch >= 0x80)
+               break;
+
+            dest[index] = static_cast<wchar_t>(ch);
+         }
+
+         return index;
+      }
+
+      /// narrows leading ASCII characters; returns number of converted characters
+      inline size_t NarrowAscii(char* dest, const wchar_t* src, size_t length)
+      {
+         size_t index = 0;
+         for (; index < length; index++)
+         {
+            auto ch = static_cast<std::make_unsigned_t<wchar_t>>(src[index]);
+            if (ch >= 0x80)
+               break;
+
+            dest[index] = static_cast<char>(ch);
+         }
+
+         return index;
+      }
+   } // namespace Scalar
+
+#ifdef ULIB_STRINGSEARCH_X86
+
+   /// \brief SIMD kernels, written once for all vector types
+   namespace Kernel
+   {
+      /// returns index of first non-ASCII character, or length when all characters are ASCII
+      template <typename V, typename T>
+      ULIB_KERNEL_INLINE size_t FindNonAscii(const T* str, size_t length)
+      {
+         using namespace StringSearch;
+
+         constexpr size_t step = V::c_size / sizeof(T);
+         typename V::Type highBits = V::template Broadcast<T>(static_cast<T>(~0x7f));
+
+         size_t index = 0;
+         for (; index + step <= length; index += step)
+         {
+            typename V::Type isAscii = V::template CompareEqual<T>(
+               V::And(V::Load(str + index), highBits), V::Zero());
+
+            unsigned int mask = V::MoveMask(isAscii) ^ V::c_fullMask;
+            if (mask != 0)
+               return index + Vector::LowestBit(mask) / sizeof(T);
+         }
+
+         return index + Scalar::FindNonAscii(str + index, length - index);
+      }
+   } // namespace Kernel
+
+   /// \brief SSE2 widen and narrow kernels
+   namespace Sse2
+   {
+      /// widens leading ASCII characters, 16 at a time; returns number of converted characters
+      inline size_t WidenAscii(wchar_t* dest, const char* src, size_t length)
+      {
+         const __m128i zero = _mm_setzero_si128();
+
+         size_t index = 0;
+         for (; index + 16 <= length; index += 16)
+         {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + index));
+            if (_mm_movemask_epi8(block) != 0)
+               break;
+
+            __m128i low = _mm_unpacklo_epi8(block, zero);
+            __m128i high = _mm_unpackhi_epi8(block, zero);
+
+            __m128i* target = reinterpret_cast<__m128i*>(dest + index);
+            if constexpr (sizeof(wchar_t) == 2)
+            {
+               _mm_storeu_si128(target, low);
+               _mm_storeu_si128(target + 1, high);
+            }
+            else
+            {
+               _mm_storeu_si128(target, _mm_unpacklo_epi16(low, zero));
+               _mm_storeu_si128(target + 1, _mm_unpackhi_epi16(low, zero));
+               _mm_storeu_si128(target + 2, _mm_unpacklo_epi16(high, zero));
+               _mm_storeu_si128(target + 3, _mm_unpackhi_epi16(high, zero));
+            }
+         }
+
+         return index + Scalar::WidenAscii(dest + index, src + index, length - index);
+      }
+
+      /// narrows leading ASCII characters, 16 at a time; returns number of converted characters
+      inline size_t NarrowAscii(char* dest, const wchar_t* src, size_t length)
+      {
+         const __m128i zero = _mm_setzero_si128();
+
+         size_t index = 0;
+         for (; index + 16 <= length; index += 16)
+         {
+            const __m128i* source = reinterpret_cast<const __m128i*>(src + index);
+            __m128i result;
+
+            if constexpr (sizeof(wchar_t) == 2)
+            {
+               __m128i block1 = _mm_loadu_si128(source);
+               __m128i block2 = _mm_loadu_si128(source + 1);
+
+               __m128i highBits = _mm_and_si128(_mm_or_si128(block1, block2), _mm_set1_epi16(static_cast<short>(0xff80)));
+               if (_mm_movemask_epi8(_mm_cmpeq_epi16(highBits, zero)) != 0xffff)
+                  break;
+
+               result = _mm_packus_epi16(block1, block2);
+            }
+            else
+            {
+               __m128i block1 = _mm_loadu_si128(source);
+               __m128i block2 = _mm_loadu_si128(source + 1);
+               __m128i block3 = _mm_loadu_si128(source + 2);
+               __m128i block4 = _mm_loadu_si128(source + 3);
+
+               __m128i highBits = _mm_and_si128(
+                  _mm_or_si128(_mm_or_si128(block1, block2), _mm_or_si128(block3, block4)),
+                  _mm_set1_epi32(static_cast<int>(0xffffff80)));
+               if (_mm_movemask_epi8(_mm_cmpeq_epi32(highBits, zero)) != 0xffff)
+                  break;
+
+               result = _mm_packus_epi16(
+                  _mm_packs_epi32(block1, block2),
+                  _mm_packs_epi32(block3, block4));
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + index), result);
+         }
+
+         return index + Scalar::NarrowAscii(dest + index, src + index, length - index);
+      }
+   } // namespace Sse2
+
+   /// \brief AVX2 kernels
+   /// \details The functions are compiled with AVX2 enabled.
+   namespace Avx2
+   {
+      /// returns index of first non-ASCII character, or length when all characters are ASCII
+      template <typename T>
+      ULIB_TARGET_AVX2 inline size_t FindNonAscii(const T* str, size_t length)
+      {
+         return Kernel::FindNonAscii<StringSearch::Vector::Avx2>(str, length);
+      }
+
+      /// widens leading ASCII characters, 32 at a time; returns number of converted characters
+      ULIB_TARGET_AVX2 inline size_t WidenAscii(wchar_t* dest, const char* src, size_t length)
+      {
+         size_t index = 0;
+         for (; index + 32 <= length; index += 32)
+         {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + index));
+            if (_mm256_movemask_epi8(block) != 0)
+               break;
+
+            __m128i low = _mm256_castsi256_si128(block);
+            __m128i high = _mm256_extracti128_si256(block, 1);
+
+            __m256i* target = reinterpret_cast<__m256i*>(dest + index);
+            if constexpr (sizeof(wchar_t) == 2)
+            {
+               _mm256_storeu_si256(target, _mm256_cvtepu8_epi16(low));
+               _mm256_storeu_si256(target + 1, _mm256_cvtepu8_epi16(high));
+            }
+            else
+            {
+               _mm256_storeu_si256(target, _mm256_cvtepu8_epi32(low));
+               _mm256_storeu_si256(target + 1, _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)));
+               _mm256_storeu_si256(target + 2, _mm256_cvtepu8_epi32(high));
+               _mm256_storeu_si256(target + 3, _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)));
+            }
+         }
+
+         return index + Sse2::WidenAscii(dest + index, src + index, length - index);
+      }
+
+      /// narrows leading ASCII characters, 32 at a time; returns number of converted characters
+      ULIB_TARGET_AVX2 inline size_t NarrowAscii(char* dest, const wchar_t* src, size_t length)
+      {
+         const __m256i zero = _mm256_setzero_si256();
+
+         size_t index = 0;
+         for (; index + 32 <= length; index += 32)
+         {
+            const __m256i* source = reinterpret_cast<const __m256i*>(src + index);
+            __m256i result;
+
+            if constexpr (sizeof(wchar_t) == 2)
+            {
+               __m256i block1 = _mm256_loadu_si256(source);
+               __m256i block2 = _mm256_loadu_si256(source + 1);
+
+               __m256i highBits = _mm256_and_si256(_mm256_or_si256(block1, block2), _mm256_set1_epi16(static_cast<short>(0xff80)));
+               if (static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(highBits, zero))) != 0xffffffff)
+                  break;
+
+               // packing works per 128-bit lane; reorder the 64-bit parts afterwards
+               result = _mm256_permute4x64_epi64(_mm256_packus_epi16(block1, block2), 0xd8);
+            }
+            else
+            {
+               __m256i block1 = _mm256_loadu_si256(source);
+               __m256i block2 = _mm256_loadu_si256(source + 1);
+               __m256i block3 = _mm256_loadu_si256(source + 2);
+               __m256i block4 = _mm256_loadu_si256(source + 3);
+
+               __m256i highBits = _mm256_and_si256(
+                  _mm256_or_si256(_mm256_or_si256(block1, block2), _mm256_or_si256(block3, block4)),
+                  _mm256_set1_epi32(static_cast<int>(0xffffff80)));
+               if (static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi32(highBits, zero))) != 0xffffffff)
+                  break;
+
+               // packing works per 128-bit lane; reorder the 32-bit parts afterwards
+               __m256i packed = _mm256_packus_epi16(
+                  _mm256_packs_epi32(block1, block2),
+                  _mm256_packs_epi32(block3, block4));
+
+               result = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+            }
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + index), result);
+         }
+
+         return index + Sse2::NarrowAscii(dest + index, src + index, length - index);
+      }
+   } // namespace Avx2
+
+#endif // ULIB_STRINGSEARCH_X86
+
+   // dispatching functions
+
+   /// returns index of first non-ASCII character, or length when all characters are ASCII
+   template <typename T>
+   inline size_t FindNonAscii(const T* str, size_t length)
+   {
+#ifdef ULIB_STRINGSEARCH_X86
+      if (length * sizeof(T) >= StringSearch::Vector::Avx2::c_size &&
+         StringSearch::GetCpuLevel() == StringSearch::CpuLevel::avx2)
+         return Avx2::FindNonAscii(str, length);
+
+      if (length * sizeof(T) >= StringSearch::Vector::Sse2::c_size)
+         return Kernel::FindNonAscii<StringSearch::Vector::Sse2>(str, length);
+#endif
+      return Scalar::FindNonAscii(str, length);
+   }
+
+   /// widens leading ASCII characters; returns number of converted characters
+   inline size_t WidenAscii(wchar_t* dest, const char* src, size_t length)
+   {
+#ifdef ULIB_STRINGSEARCH_X86
+      if (length >= 32 && StringSearch::GetCpuLevel() == StringSearch::CpuLevel::avx2)
+         return Avx2::WidenAscii(dest, src, length);
+
+      if (length >= 16)
+         return Sse2::WidenAscii(dest, src, length);
+#endif
+      return Scalar::WidenAscii(dest, src, length);
+   }
+
+   /// narrows leading ASCII characters; returns number of converted characters
+   inline size_t NarrowAscii(char* dest, const wchar_t* src, size_t length)
+   {
+#ifdef ULIB_STRINGSEARCH_X86
+      if (length >= 32 && StringSearch::GetCpuLevel() == StringSearch::CpuLevel::avx2)
+         return Avx2::NarrowAscii(dest, src, length);
+
+      if (length >= 16)
+         return Sse2::NarrowAscii(dest, src, length);
+#endif
+      return Scalar::NarrowAscii(dest, src, length);
+   }
+
+   /// \brief converts narrow string in the current locale's multibyte encoding to a wide string
+   /// \details When dest is nullptr, only the number of wide characters is returned.
+   /// Otherwise at most destLength characters are written, without a zero
+   /// terminator. A narrow string never results in more wide characters than
+   /// it has bytes. Returns -1 when the string contains an invalid or incomplete
+   /// multibyte character.
+   inline int NarrowToWide(wchar_t* dest, int destLength, const char* src, int srcLength)
+   {
+      size_t srcPos = 0, destPos = 0;
+      size_t srcEnd = static_cast<size_t>(srcLength);
+      size_t destEnd = dest == nullptr ? srcEnd : static_cast<size_t>(destLength);
+
+      std::mbstate_t state = {};
+      for (;;)
+      {
+         // ASCII run
+         size_t count = std::min(srcEnd - srcPos, destEnd - destPos);
+         count = dest == nullptr
+            ? FindNonAscii(src + srcPos, count)
+            : WidenAscii(dest + destPos, src + srcPos, count);
+
+         srcPos += count;
+         destPos += count;
+
+         if (srcPos >= srcEnd || destPos >= destEnd)
+            break;
+
+         // non-ASCII character
+         wchar_t ch = 0;
+         size_t ret = std::mbrtowc(&ch, src + srcPos, srcEnd - srcPos, &state);
+         if (ret == static_cast<size_t>(-1) || ret == static_cast<size_t>(-2))
+            return -1;
+
+         if (dest != nullptr)
+            dest[destPos] = ch;
+
+         srcPos += ret == 0 ? 1 : ret;
+         destPos++;
+      }
+
+      return static_cast<int>(destPos);
+   }
+
+   /// \brief converts wide string to a narrow string in the current locale's multibyte encoding
+   /// \details When dest is nullptr, only the number of bytes is returned.
+   /// Otherwise at most destLength bytes are written, without a zero
+   /// terminator; a multibyte character that doesn't fit completely isn't
+   /// written. Returns -1 when a character can't be represented in the
+   /// multibyte encoding.
+   inline int WideToNarrow(char* dest, int destLength, const wchar_t* src, int srcLength)
+   {
+      size_t srcPos = 0, destPos = 0;
+      size_t srcEnd = static_cast<size_t>(srcLength);
+      size_t destEnd = dest == nullptr ? SIZE_MAX : static_cast<size_t>(destLength);
+
+      std::mbstate_t state = {};
+      for (;;)
+      {
+         // ASCII run
+         size_t count = std::min(srcEnd - srcPos, destEnd - destPos);
+         count = dest == nullptr
+            ? FindNonAscii(src + srcPos, count)
+            : NarrowAscii(dest + destPos, src + srcPos, count);
+
+         srcPos += count;
+         destPos += count;
+
+         if (srcPos >= srcEnd || destPos >= destEnd)
+            break;
+
+         // non-ASCII character
+         char buffer[MB_LEN_MAX];
+         size_t ret = std::wcrtomb(buffer, src[srcPos], &state);
+         if (ret == static_cast<size_t>(-1))
+            return -1;
+
+         if (dest != nullptr)
+         {
+            if (destPos + ret > destEnd)
+               break;
+
+            std::copy(buffer, buffer + ret, dest + destPos);
+         }
+
+         srcPos++;
+         destPos += ret;
+      }
+
+      return static_cast<int>(destPos);
+   }
+
+} // namespace CharConvert
+
+#if defined(ULIB_STRINGSEARCH_X86) && defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
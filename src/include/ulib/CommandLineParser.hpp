@@ -1,11 +1,13 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2008,2009,2012,2013,2017 Michael Fink
+// Copyright (C) 2008,2009,2012,2013,2017,2026 Michael Fink
 //
 /// \file CommandLineParser.hpp command line parser
 //
 #pragma once
 
+#include <ulib/CStringView.hpp>
+
 /// \brief command line parser
 /// \details parses command lines; supports double-quoted parameters
 class CommandLineParser
@@ -20,6 +22,10 @@ public:
    /// returns next parameter
    bool GetNext(CString& nextParameter);
 
+   /// returns next parameter, as view into the command line; the view is
+   /// valid as long as the parser object exists
+   bool GetNext(CStringView& nextParameter);
+
 private:
    /// command line
    CString m_commandLine;
@@ -1,12 +1,13 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006,2007,2008,2009,2012,2017,2022 Michael Fink
+// Copyright (C) 2006,2007,2008,2009,2012,2017,2022,2026 Michael Fink
 //
 /// \file Exception.hpp exception base class
 //
 #pragma once
 
 #include <stdexcept>
+#include <ulib/StringFormat.hpp>
 
 /// exception base class
 class Exception : public std::runtime_error
@@ -43,11 +44,11 @@ private:
    static CStringA FormatExceptionText(LPCTSTR message, LPCSTR sourceFile, UINT sourceLine)
    {
       CStringA text;
-      text.Format(
-         "%s(%u): %ls",
+      StringFormat::Format(text,
+         "%s(%u): %s",
          sourceFile,
          sourceLine,
-         message == nullptr ? _T("no message given") : message);
+         CStringA(message == nullptr ? _T("no message given") : message));
 
       return text;
    }
@@ -1,13 +1,14 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2008-2012,2017,2020,2023 Michael Fink
+// Copyright (C) 2008-2012,2017,2020,2023,2026 Michael Fink
 //
 /// \file IoCContainer.hpp Inversion of Control container
 //
 #pragma once
 
 #include <string>
-#include <map>
+#include <unordered_map>
+#include <typeindex>
 #include <functional>
 #include <any>
 
@@ -26,17 +27,14 @@ public:
    template <typename TClass>
    void Register(std::reference_wrapper<TClass> ref)
    {
-      std::string name = typeid(TClass).raw_name();
-      m_mapAllInstances[name] = ref;
+      m_mapAllInstances[std::type_index(typeid(TClass))] = ref;
    }
 
    /// resolves class to object
    template <typename TInterface>
    TInterface& Resolve()
    {
-      std::string name = typeid(TInterface).raw_name();
-
-      T_mapAllInstances::iterator iter = m_mapAllInstances.find(name);
+      T_mapAllInstances::iterator iter = m_mapAllInstances.find(std::type_index(typeid(TInterface)));
 
       if (iter == m_mapAllInstances.end())
          throw std::runtime_error(std::string("class not registered: ") + typeid(TInterface).name());
@@ -60,8 +58,8 @@ private:
    IoCContainer& operator=(IoCContainer&&) = delete;        ///< removed move assign operator
 
 private:
-   /// instance map type
-   typedef std::map<std::string, std::any> T_mapAllInstances;
+   /// instance map type; maps types to references
+   typedef std::unordered_map<std::type_index, std::any> T_mapAllInstances;
 
    /// instance map
    T_mapAllInstances m_mapAllInstances;
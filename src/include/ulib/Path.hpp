@@ -1,12 +1,14 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2014-2017,2020 Michael Fink
+// Copyright (C) 2014-2017,2020,2026 Michael Fink
 //
 /// \file Path.hpp Path class
 //
 
 #pragma once
 
+#include <ulib/CStringView.hpp>
+
 /// file and folder path class
 class Path
 {
@@ -100,6 +102,18 @@ public:
    /// returns folder name, without filename, but ending slash
    static CString FolderName(const CString& path);
 
+   /// returns filename and extension, as view into the given path
+   static CStringView FilenameAndExt(CStringView path);
+
+   /// returns filename without extension, as view into the given path
+   static CStringView FilenameOnly(CStringView path);
+
+   /// returns extension only, with leading dot, as view into the given path
+   static CStringView ExtensionOnly(CStringView path);
+
+   /// returns folder name, without filename, but ending slash, as view into the given path
+   static CStringView FolderName(CStringView path);
+
    /// returns short path name (filename in 8.3 format); file must actually exist
    static CString ShortPathName(const CString& path);
 
@@ -0,0 +1,568 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file StringFormat.hpp type-safe, single pass string formatting
+/// \details The functions in this file format text using printf-style format
+/// strings, but with variadic templates instead of va_list. The format string
+/// is checked at compile time against the number and types of the arguments;
+/// a mismatch results in a compile error. Numbers are formatted using
+/// std::to_chars, and the result is written directly into the buffer of the
+/// string, in one pass.
+///
+/// Format specifiers have the form %[flags][width][.precision]type, with the
+/// flags - (left justify), 0 (pad with zeros) and + (always show sign). Length
+/// modifiers like l, ll, h or z are accepted and ignored, since the argument
+/// type is known. Supported types are:
+/// - d, i, u: integer, decimal; the value is formatted as is, regardless of
+///   the signedness of the type character
+/// - x, X: integer, hexadecimal
+/// - c: character
+/// - s: C-style string, or string class with GetString() or GetData(), and
+///   GetLength() methods
+/// - f, e, E, g, G: floating point value
+/// - %%: percent sign
+/// Width and precision can't be passed as arguments, using the * character.
+//
+#pragma once
+
+#include <charconv>
+#include <type_traits>
+#include <algorithm>
+#include <cstring>
+#include <cwchar>
+#include <string>
+#include <iterator>
+
+/// \brief type-safe string formatting
+namespace StringFormat
+{
+   /// kind of format argument
+   enum class ArgKind
+   {
+      integer,       ///< integer, including bool
+      floating,      ///< floating point value
+      character,     ///< single character
+      string,        ///< C-style string or string class
+      unsupported,   ///< type can't be formatted
+   };
+
+   /// maximum width or precision in a format specifier
+   constexpr int c_maxWidth = 4096;
+
+   /// maximum precision of floating point values
+   constexpr int c_maxFloatPrecision = 64;
+
+   /// parsed format specifier
+   struct Spec
+   {
+      bool m_leftJustify = false;   ///< left justify, instead of right justify
+      bool m_zeroPad = false;       ///< pad numbers with zeros instead of spaces
+      bool m_showSign = false;      ///< shows + sign for positive numbers
+      int m_width = 0;              ///< minimum width
+      int m_precision = -1;         ///< precision; -1 when not specified
+      char m_type = 0;              ///< type character
+   };
+
+   /// type of the characters of a string class
+   template <typename TString>
+   using CharTypeOf = std::remove_cv_t<std::remove_pointer_t<
+      decltype(std::declval<const TString&>().GetString())>>;
+
+   /// string class with GetString() and GetLength() methods, e.g. CString
+   template <typename TArg, typename TChar>
+   concept StringClassArg = requires(const TArg& arg)
+   {
+      { arg.GetString() } -> std::convertible_to<const TChar*>;
+      { arg.GetLength() } -> std::convertible_to<int>;
+   };
+
+   /// string view class with GetData() and GetLength() methods, e.g. CStringView
+   template <typename TArg, typename TChar>
+   concept StringViewArg = requires(const TArg& arg)
+   {
+      { arg.GetData() } -> std::convertible_to<const TChar*>;
+      { arg.GetLength() } -> std::convertible_to<int>;
+   };
+
+   /// returns kind of format argument of given type
+   template <typename TChar, typename TArg>
+   constexpr ArgKind GetArgKind()
+   {
+      using Arg = std::remove_cvref_t<TArg>;
+
+      if constexpr (std::is_same_v<Arg, TChar> || std::is_same_v<Arg, char>)
+         return ArgKind::character;
+      else if constexpr (std::is_integral_v<Arg>)
+         return ArgKind::integer;
+      else if constexpr (std::is_floating_point_v<Arg>)
+         return ArgKind::floating;
+      else if constexpr (std::is_convertible_v<const Arg&, const TChar*> ||
+         StringClassArg<Arg, TChar> || StringViewArg<Arg, TChar>)
+         return ArgKind::string;
+      else
+         return ArgKind::unsupported;
+   }
+
+   /// returns if argument kind can be formatted using given type character
+   constexpr bool IsMatchingArgKind(char type, ArgKind kind)
+   {
+      switch (type)
+      {
+      case 'd': case 'i': case 'u': case 'x': case 'X': case 'c':
+         return kind == ArgKind::integer || kind == ArgKind::character;
+      case 'f': case 'e': case 'E': case 'g': case 'G':
+         return kind == ArgKind::floating;
+      case 's':
+         return kind == ArgKind::string;
+      default:
+         return false;
+      }
+   }
+
+   /// parses format specifier, starting after the % character; returns
+   /// pointer after the type character, or nullptr when the specifier is invalid
+   template <typename TChar>
+   constexpr const TChar* ParseSpec(const TChar* pos, Spec& spec)
+   {
+      for (;; pos++)
+      {
+         if (*pos == '-')
+            spec.m_leftJustify = true;
+         else if (*pos == '0')
+            spec.m_zeroPad = true;
+         else if (*pos == '+')
+            spec.m_showSign = true;
+         else
+            break;
+      }
+
+      for (; *pos >= '0' && *pos <= '9'; pos++)
+      {
+         spec.m_width = spec.m_width * 10 + (*pos - '0');
+         if (spec.m_width > c_maxWidth)
+            return nullptr;
+      }
+
+      if (*pos == '.')
+      {
+         spec.m_precision = 0;
+         for (pos++; *pos >= '0' && *pos <= '9'; pos++)
+         {
+            spec.m_precision = spec.m_precision * 10 + (*pos - '0');
+            if (spec.m_precision > c_maxWidth)
+               return nullptr;
+         }
+      }
+
+      // skip length modifiers
+      while (*pos == 'h' || *pos == 'l' || *pos == 'z' || *pos == 'j' || *pos == 't')
+         pos++;
+
+      switch (*pos)
+      {
+      case 'd': case 'i': case 'u': case 'x': case 'X': case 'c': case 's':
+         break;
+      case 'f': case 'e': case 'E': case 'g': case 'G':
+         if (spec.m_precision > c_maxFloatPrecision)
+            return nullptr;
+         break;
+      default:
+         return nullptr;
+      }
+
+      spec.m_type = static_cast<char>(*pos);
+      return pos + 1;
+   }
+
+   /// called when checking the format string at compile time fails; since the
+   /// function isn't constexpr, calling it results in a compile error
+   inline void InvalidFormatString(const char* /*message*/)
+   {
+   }
+
+   /// \brief format string, checked at compile time
+   /// \details The format string is implicitly constructed from a string
+   /// literal; the constructor checks the format string against the argument
+   /// types, and fails compiling when the format string is invalid.
+   template <typename TChar, typename... Args>
+   class FormatString
+   {
+   public:
+      /// ctor; checks format string
+      template <typename TText>
+         requires std::is_convertible_v<const TText&, const TChar*>
+      consteval FormatString(const TText& text)
+         :m_text(text)
+      {
+         constexpr ArgKind argKinds[] = { GetArgKind<TChar, Args>()..., ArgKind::unsupported };
+
+         size_t argIndex = 0;
+         for (const TChar* pos = m_text; *pos != 0;)
+         {
+            if (*pos++ != '%')
+               continue;
+
+            if (*pos == '%')
+            {
+               pos++;
+               continue;
+            }
+
+            Spec spec;
+            pos = ParseSpec(pos, spec);
+            if (pos == nullptr)
+            {
+               InvalidFormatString("invalid format specifier");
+               return;
+            }
+
+            if (argIndex >= sizeof...(Args))
+            {
+               InvalidFormatString("too few arguments for format string");
+               return;
+            }
+
+            if (!IsMatchingArgKind(spec.m_type, argKinds[argIndex]))
+               InvalidFormatString("argument type doesn't match format specifier");
+
+            argIndex++;
+         }
+
+         if (argIndex != sizeof...(Args))
+            InvalidFormatString("too many arguments for format string");
+      }
+
+      /// returns format string
+      const TChar* Get() const throw() { return m_text; }
+
+   private:
+      /// format string
+      const TChar* m_text;
+   };
+
+   /// \brief writes formatted text directly into a string buffer
+   /// \details The writer locks the string buffer while formatting, and grows
+   /// it geometrically when necessary. Finish() must be called to release
+   /// the buffer and set the new length.
+   template <typename TString>
+   class Writer
+   {
+   public:
+      /// character type
+      typedef CharTypeOf<TString> XCHAR;
+
+      /// ctor; starts writing at the end of the string, reserving given number of characters
+      Writer(TString& str, int reserveLength)
+         :m_str(str),
+         m_length(str.GetLength()),
+         m_capacity(str.GetLength() + reserveLength),
+         m_buffer(str.GetBuffer(m_capacity))
+      {
+      }
+
+      /// releases string buffer and sets new length
+      void Finish()
+      {
+         m_str.ReleaseBufferSetLength(m_length);
+      }
+
+      /// appends characters
+      template <typename TSourceChar>
+      void Append(const TSourceChar* text, int length)
+      {
+         XCHAR* dest = Reserve(length);
+         for (int index = 0; index < length; index++)
+            dest[index] = static_cast<XCHAR>(text[index]);
+
+         m_length += length;
+      }
+
+      /// appends characters; same character type version
+      void Append(const XCHAR* text, int length)
+      {
+         std::memcpy(Reserve(length), text, length * sizeof(XCHAR));
+         m_length += length;
+      }
+
+      /// appends a character multiple times
+      void Fill(XCHAR ch, int count)
+      {
+         if (count <= 0)
+            return;
+
+         std::fill_n(Reserve(count), count, ch);
+         m_length += count;
+      }
+
+      /// appends formatted argument
+      template <typename TArg>
+      void AppendArg(const Spec& spec, const TArg& arg)
+      {
+         using Arg = std::remove_cvref_t<TArg>;
+
+         if constexpr (std::is_integral_v<Arg>)
+         {
+            if (spec.m_type == 'c')
+            {
+               XCHAR ch = static_cast<XCHAR>(arg);
+               AppendPadded(spec, &ch, 1);
+            }
+            else if constexpr (std::is_same_v<Arg, bool>)
+               AppendInteger(spec, arg ? 1 : 0);
+            else
+               AppendInteger(spec, arg);
+         }
+         else if constexpr (std::is_floating_point_v<Arg>)
+            AppendFloat(spec, arg);
+         else if constexpr (std::is_convertible_v<const Arg&, const XCHAR*>)
+         {
+            const XCHAR* text = arg;
+            AppendString(spec, text, text == nullptr ? 0 : StringLength(text));
+         }
+         else if constexpr (StringClassArg<Arg, XCHAR>)
+            AppendString(spec, arg.GetString(), arg.GetLength());
+         else
+            AppendString(spec, arg.GetData(), arg.GetLength());
+      }
+
+   private:
+      /// reserves space for given number of characters, after the current
+      /// length; returns pointer to the reserved space
+      XCHAR* Reserve(int count)
+      {
+         if (m_length + count > m_capacity)
+         {
+            // release buffer first, so that both CString implementations
+            // preserve the content already written
+            m_str.ReleaseBufferSetLength(m_length);
+
+            m_capacity = std::max(m_capacity + m_capacity / 2, m_length + count);
+            m_buffer = m_str.GetBuffer(m_capacity);
+         }
+
+         return m_buffer + m_length;
+      }
+
+      /// returns length of C-style string
+      static int StringLength(const char* text) { return static_cast<int>(std::strlen(text)); }
+
+      /// returns length of C-style string; wide char version
+      static int StringLength(const wchar_t* text) { return static_cast<int>(std::wcslen(text)); }
+
+      /// appends text, padded to the width of the format specifier
+      template <typename TSourceChar>
+      void AppendPadded(const Spec& spec, const TSourceChar* text, int length)
+      {
+         int padding = spec.m_width - length;
+
+         if (!spec.m_leftJustify)
+            Fill(' ', padding);
+
+         Append(text, length);
+
+         if (spec.m_leftJustify)
+            Fill(' ', padding);
+      }
+
+      /// appends string, truncated to the precision of the format specifier
+      void AppendString(const Spec& spec, const XCHAR* text, int length)
+      {
+         if (spec.m_precision >= 0)
+            length = std::min(length, spec.m_precision);
+
+         AppendPadded(spec, text, length);
+      }
+
+      /// appends number; the digits don't contain the sign
+      void AppendNumber(const Spec& spec, bool isNegative, const char* digits, int numDigits)
+      {
+         bool hasSign = isNegative || spec.m_showSign;
+
+         int numZeros = 0;
+         if (spec.m_precision >= 0 && spec.m_type != 'f' && spec.m_type != 'e' &&
+            spec.m_type != 'E' && spec.m_type != 'g' && spec.m_type != 'G')
+            numZeros = std::max(spec.m_precision - numDigits, 0);
+
+         int length = (hasSign ? 1 : 0) + numZeros + numDigits;
+         if (spec.m_zeroPad && !spec.m_leftJustify && spec.m_width > length)
+         {
+            numZeros += spec.m_width - length;
+            length = spec.m_width;
+         }
+
+         if (!spec.m_leftJustify)
+            Fill(' ', spec.m_width - length);
+
+         if (hasSign)
+            Fill(isNegative ? '-' : '+', 1);
+
+         Fill('0', numZeros);
+         Append(digits, numDigits);
+
+         if (spec.m_leftJustify)
+            Fill(' ', spec.m_width - length);
+      }
+
+      /// appends integer
+      template <typename TInteger>
+      void AppendInteger(const Spec& spec, TInteger value)
+      {
+         char digits[72];
+         std::to_chars_result result;
+         bool isNegative = false;
+
+         if (spec.m_type == 'x' || spec.m_type == 'X')
+         {
+            // like printf, negative numbers are formatted as two's complement
+            result = std::to_chars(digits, std::end(digits),
+               static_cast<std::make_unsigned_t<TInteger>>(value), 16);
+
+            if (spec.m_type == 'X')
+            {
+               for (char* pos = digits; pos != result.ptr; pos++)
+                  if (*pos >= 'a' && *pos <= 'f')
+                     *pos = static_cast<char>(*pos - 'a' + 'A');
+            }
+         }
+         else
+         {
+            // format absolute value, in order to apply zero padding after the sign
+            std::make_unsigned_t<TInteger> absValue = static_cast<std::make_unsigned_t<TInteger>>(value);
+            if constexpr (std::is_signed_v<TInteger>)
+            {
+               isNegative = value < 0;
+               if (isNegative)
+                  absValue = static_cast<std::make_unsigned_t<TInteger>>(0 - absValue);
+            }
+
+            result = std::to_chars(digits, std::end(digits), absValue);
+         }
+
+         AppendNumber(spec, isNegative, digits, static_cast<int>(result.ptr - digits));
+      }
+
+      /// appends floating point value
+      template <typename TFloat>
+      void AppendFloat(const Spec& spec, TFloat value)
+      {
+         // fixed format of the largest double value has 309 digits before the point
+         char digits[512];
+
+         std::chars_format format = std::chars_format::fixed;
+         if (spec.m_type == 'e' || spec.m_type == 'E')
+            format = std::chars_format::scientific;
+         else if (spec.m_type == 'g' || spec.m_type == 'G')
+            format = std::chars_format::general;
+
+         int precision = spec.m_precision >= 0 ? spec.m_precision : 6;
+
+         std::to_chars_result result = std::to_chars(digits, std::end(digits),
+            static_cast<double>(value), format, precision);
+
+         const char* start = digits;
+         bool isNegative = *start == '-';
+         if (isNegative)
+            start++;
+
+         if (spec.m_type == 'E' || spec.m_type == 'G')
+         {
+            for (char* pos = digits; pos != result.ptr; pos++)
+               if (*pos >= 'a' && *pos <= 'z')
+                  *pos = static_cast<char>(*pos - 'a' + 'A');
+         }
+
+         AppendNumber(spec, isNegative, start, static_cast<int>(result.ptr - start));
+      }
+
+   private:
+      /// string to write to
+      TString& m_str;
+
+      /// current length of written text
+      int m_length;
+
+      /// current capacity of the buffer
+      int m_capacity;
+
+      /// string buffer
+      XCHAR* m_buffer;
+   };
+
+   /// formats text and appends it to given writer; all arguments already formatted
+   template <typename TString>
+   void FormatArgs(Writer<TString>& writer, const CharTypeOf<TString>* pos)
+   {
+      while (*pos != 0)
+      {
+         const CharTypeOf<TString>* start = pos;
+         while (*pos != 0 && *pos != '%')
+            pos++;
+
+         writer.Append(start, static_cast<int>(pos - start));
+
+         if (*pos == 0)
+            break;
+
+         // since all arguments were already used, only %% can follow
+         writer.Append(pos, 1);
+         pos += 2;
+      }
+   }
+
+   /// formats text and appends it to given writer, using the first argument
+   /// at the first format specifier
+   template <typename TString, typename TArg, typename... Args>
+   void FormatArgs(Writer<TString>& writer, const CharTypeOf<TString>* pos,
+      const TArg& arg, const Args&... args)
+   {
+      for (;;)
+      {
+         const CharTypeOf<TString>* start = pos;
+         while (*pos != '%')
+            pos++;
+
+         writer.Append(start, static_cast<int>(pos - start));
+
+         if (pos[1] != '%')
+            break;
+
+         writer.Append(pos, 1);
+         pos += 2;
+      }
+
+      Spec spec;
+      pos = ParseSpec(pos + 1, spec);
+
+      writer.AppendArg(spec, arg);
+
+      FormatArgs(writer, pos, args...);
+   }
+
+   /// formats text using format string and arguments, and appends it to the string
+   template <typename TString, typename... Args>
+   void AppendFormat(TString& str,
+      FormatString<CharTypeOf<TString>, std::type_identity_t<Args>...> format,
+      const Args&... args)
+   {
+      const CharTypeOf<TString>* text = format.Get();
+
+      Writer<TString> writer(str,
+         static_cast<int>(std::char_traits<CharTypeOf<TString>>::length(text)) + 16 * static_cast<int>(sizeof...(Args)));
+
+      FormatArgs(writer, text, args...);
+
+      writer.Finish();
+   }
+
+   /// formats text using format string and arguments, and sets it as new string
+   template <typename TString, typename... Args>
+   void Format(TString& str,
+      FormatString<CharTypeOf<TString>, std::type_identity_t<Args>...> format,
+      const Args&... args)
+   {
+      str.Empty();
+      AppendFormat(str, format, args...);
+   }
+
+} // namespace StringFormat
@@ -0,0 +1,182 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file StringHash.hpp fast non-cryptographic hash function for strings
+/// \details The hash function follows the wyhash algorithm: the input is
+/// processed in blocks of 48 bytes, using three independent lanes that are
+/// each mixed with a 64x64 to 128 bit multiplication. The lanes don't depend
+/// on each other, so the CPU can execute them in parallel. Short inputs
+/// are read with a few overlapping loads, without any loop. The hash values
+/// are the same on all platforms with the same byte order, but they aren't
+/// meant to be stored.
+//
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#include <intrin.h>
+#endif
+
+/// \brief string hash function
+namespace StringHash
+{
+   /// secret values, used to mix the input
+   constexpr uint64_t c_secret[4] =
+   {
+      0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+   };
+
+   /// multiplies two 64 bit values; returns low 64 bits in a and high 64 bits in b
+   inline void Multiply(uint64_t& a, uint64_t& b)
+   {
+#if defined(__SIZEOF_INT128__)
+      __uint128_t result = static_cast<__uint128_t>(a) * b;
+      a = static_cast<uint64_t>(result);
+      b = static_cast<uint64_t>(result >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+      a = _umul128(a, b, &b);
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+      uint64_t low = a * b;
+      b = __umulh(a, b);
+      a = low;
+#else
+      // portable version, using 32 bit multiplications
+      uint64_t aHigh = a >> 32, aLow = static_cast<uint32_t>(a);
+      uint64_t bHigh = b >> 32, bLow = static_cast<uint32_t>(b);
+
+      uint64_t highHigh = aHigh * bHigh;
+      uint64_t highLow = aHigh * bLow;
+      uint64_t lowHigh = aLow * bHigh;
+      uint64_t lowLow = aLow * bLow;
+
+      uint64_t middle = (lowLow >> 32) + static_cast<uint32_t>(highLow) + static_cast<uint32_t>(lowHigh);
+
+      a = (middle << 32) | static_cast<uint32_t>(lowLow);
+      b = highHigh + (highLow >> 32) + (lowHigh >> 32) + (middle >> 32);
+#endif
+   }
+
+   /// multiplies two 64 bit values and folds the 128 bit result
+   inline uint64_t Mix(uint64_t a, uint64_t b)
+   {
+      Multiply(a, b);
+      return a ^ b;
+   }
+
+   /// reads 8 bytes, in native byte order
+   inline uint64_t Read8(const uint8_t* data)
+   {
+      uint64_t value;
+      std::memcpy(&value, data, sizeof(value));
+      return value;
+   }
+
+   /// reads 4 bytes, in native byte order
+   inline uint64_t Read4(const uint8_t* data)
+   {
+      uint32_t value;
+      std::memcpy(&value, data, sizeof(value));
+      return value;
+   }
+
+   /// reads 1 to 3 bytes
+   inline uint64_t Read3(const uint8_t* data, size_t length)
+   {
+      return (static_cast<uint64_t>(data[0]) << 16) |
+         (static_cast<uint64_t>(data[length >> 1]) << 8) |
+         data[length - 1];
+   }
+
+   /// calculates 64 bit hash value of given bytes
+   inline uint64_t Hash64(const void* buffer, size_t length, uint64_t seed = 0)
+   {
+      const uint8_t* data = static_cast<const uint8_t*>(buffer);
+
+      seed ^= Mix(seed ^ c_secret[0], c_secret[1]);
+
+      uint64_t a, b;
+      if (length <= 16)
+      {
+         if (length >= 4)
+         {
+            size_t offset = (length >> 3) << 2;
+            a = (Read4(data) << 32) | Read4(data + offset);
+            b = (Read4(data + length - 4) << 32) | Read4(data + length - 4 - offset);
+         }
+         else if (length > 0)
+         {
+            a = Read3(data, length);
+            b = 0;
+         }
+         else
+            a = b = 0;
+      }
+      else
+      {
+         size_t remaining = length;
+         if (remaining > 48)
+         {
+            // three independent lanes
+            uint64_t seed1 = seed, seed2 = seed;
+            do
+            {
+               seed = Mix(Read8(data) ^ c_secret[1], Read8(data + 8) ^ seed);
+               seed1 = Mix(Read8(data + 16) ^ c_secret[2], Read8(data + 24) ^ seed1);
+               seed2 = Mix(Read8(data + 32) ^ c_secret[3], Read8(data + 40) ^ seed2);
+
+               data += 48;
+               remaining -= 48;
+            } while (remaining > 48);
+
+            seed ^= seed1 ^ seed2;
+         }
+
+         while (remaining > 16)
+         {
+            seed = Mix(Read8(data) ^ c_secret[1], Read8(data + 8) ^ seed);
+
+            data += 16;
+            remaining -= 16;
+         }
+
+         // last 16 bytes, possibly overlapping with the previous block
+         a = Read8(data + remaining - 16);
+         b = Read8(data + remaining - 8);
+      }
+
+      a ^= c_secret[1];
+      b ^= seed;
+      Multiply(a, b);
+
+      return Mix(a ^ c_secret[0] ^ length, b ^ c_secret[1]);
+   }
+
+   /// calculates hash value of given characters
+   template <typename TChar>
+   size_t Hash(const TChar* text, size_t length)
+   {
+      return static_cast<size_t>(Hash64(text, length * sizeof(TChar)));
+   }
+
+} // namespace StringHash
+
+#ifdef __ATLSTR_H__
+namespace std
+{
+   /// hash function for ATL strings, so that they can be used in unordered containers
+   template <typename BaseType, class StringTraits>
+   struct hash<ATL::CStringT<BaseType, StringTraits>>
+   {
+      /// returns hash value
+      size_t operator()(const ATL::CStringT<BaseType, StringTraits>& str) const noexcept
+      {
+         return StringHash::Hash(str.GetString(), static_cast<size_t>(str.GetLength()));
+      }
+   };
+}
+#endif
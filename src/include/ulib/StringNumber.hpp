@@ -0,0 +1,296 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file StringNumber.hpp appending numbers to strings and parsing numbers
+/// \details The Append functions format a single number without any format
+/// string; the digits are written directly into the buffer of the string.
+/// Decimal numbers are formatted two digits at a time, using a lookup table
+/// of digit pairs. Floating point values are formatted using std::to_chars.
+/// The Parse functions are the reverse, using std::from_chars. All functions
+/// work with any string class that has GetString(), GetLength(), GetBuffer()
+/// and ReleaseBufferSetLength() methods, e.g. CString.
+//
+#pragma once
+
+#include <charconv>
+#include <type_traits>
+#include <algorithm>
+#include <string>
+#include <iterator>
+#include <cstdint>
+
+/// \brief appending numbers to strings and parsing numbers from strings
+namespace StringNumber
+{
+   /// all pairs of decimal digits, from 00 to 99
+   constexpr char c_digitPairs[201] =
+      "00010203040506070809"
+      "10111213141516171819"
+      "20212223242526272829"
+      "30313233343536373839"
+      "40414243444546474849"
+      "50515253545556575859"
+      "60616263646566676869"
+      "70717273747576777879"
+      "80818283848586878889"
+      "90919293949596979899";
+
+   /// hex digits, lower and upper case
+   constexpr char c_hexDigits[2][17] = { "0123456789abcdef", "0123456789ABCDEF" };
+
+   /// maximum number of characters of an integer, including sign
+   constexpr int c_maxIntegerLength = 66;
+
+   /// type of the characters of a string class
+   template <typename TString>
+   using CharTypeOf = std::remove_cv_t<std::remove_pointer_t<
+      decltype(std::declval<const TString&>().GetString())>>;
+
+   /// formats unsigned value as decimal number; writes backwards from the end
+   /// of the buffer and returns the start of the digits
+   template <typename TChar, typename TUnsigned>
+   TChar* FormatDecimal(TChar* end, TUnsigned value)
+   {
+      static_assert(std::is_unsigned_v<TUnsigned>, "value must be unsigned");
+
+      while (value >= 100)
+      {
+         unsigned int index = static_cast<unsigned int>(value % 100) * 2;
+         value /= 100;
+
+         *--end = static_cast<TChar>(c_digitPairs[index + 1]);
+         *--end = static_cast<TChar>(c_digitPairs[index]);
+      }
+
+      if (value >= 10)
+      {
+         unsigned int index = static_cast<unsigned int>(value) * 2;
+         *--end = static_cast<TChar>(c_digitPairs[index + 1]);
+         *--end = static_cast<TChar>(c_digitPairs[index]);
+      }
+      else
+         *--end = static_cast<TChar>('0' + static_cast<unsigned int>(value));
+
+      return end;
+   }
+
+   /// formats unsigned value as hex number; writes backwards from the end of
+   /// the buffer and returns the start of the digits
+   template <typename TChar, typename TUnsigned>
+   TChar* FormatHex(TChar* end, TUnsigned value, bool upperCase)
+   {
+      static_assert(std::is_unsigned_v<TUnsigned>, "value must be unsigned");
+
+      const char* hexDigits = c_hexDigits[upperCase ? 1 : 0];
+      do
+      {
+         *--end = static_cast<TChar>(hexDigits[value & 0x0f]);
+         value >>= 4;
+      } while (value != 0);
+
+      return end;
+   }
+
+   /// appends digits to the string, with optional minus sign, and padded
+   /// with zeros to given number of digits
+   template <typename TString, typename TSourceChar>
+   void AppendDigits(TString& str, bool isNegative, const TSourceChar* digits, int numDigits, int width)
+   {
+      typedef CharTypeOf<TString> XCHAR;
+
+      int numZeros = std::max(width - numDigits, 0);
+      int oldLength = str.GetLength();
+      int newLength = oldLength + (isNegative ? 1 : 0) + numZeros + numDigits;
+
+      XCHAR* dest = str.GetBuffer(newLength) + oldLength;
+
+      if (isNegative)
+         *dest++ = static_cast<XCHAR>('-');
+
+      dest = std::fill_n(dest, numZeros, static_cast<XCHAR>('0'));
+      std::copy_n(digits, numDigits, dest);
+
+      str.ReleaseBufferSetLength(newLength);
+   }
+
+   /// appends unsigned integer as decimal number, padded with zeros to the
+   /// given minimum number of digits
+   template <typename TString, typename TUnsigned>
+   void AppendUInt(TString& str, TUnsigned value, int width = 0)
+   {
+      static_assert(std::is_unsigned_v<TUnsigned>, "use AppendInt() for signed values");
+
+      CharTypeOf<TString> buffer[c_maxIntegerLength];
+      auto* end = std::end(buffer);
+      auto* start = FormatDecimal(end, value);
+
+      AppendDigits(str, false, start, static_cast<int>(end - start), width);
+   }
+
+   /// appends signed integer as decimal number, padded with zeros to the
+   /// given minimum number of digits; the minus sign isn't counted as digit
+   template <typename TString, typename TInteger>
+   void AppendInt(TString& str, TInteger value, int width = 0)
+   {
+      static_assert(std::is_integral_v<TInteger>, "value must be an integer");
+
+      using Unsigned = std::make_unsigned_t<TInteger>;
+
+      Unsigned absValue = static_cast<Unsigned>(value);
+      bool isNegative = false;
+      if constexpr (std::is_signed_v<TInteger>)
+      {
+         isNegative = value < 0;
+         if (isNegative)
+            absValue = static_cast<Unsigned>(0 - absValue);
+      }
+
+      CharTypeOf<TString> buffer[c_maxIntegerLength];
+      auto* end = std::end(buffer);
+      auto* start = FormatDecimal(end, absValue);
+
+      AppendDigits(str, isNegative, start, static_cast<int>(end - start), width);
+   }
+
+   /// appends integer as hex number, without prefix, padded with zeros to
+   /// the given minimum number of digits; negative numbers are formatted as
+   /// two's complement
+   template <typename TString, typename TInteger>
+   void AppendHex(TString& str, TInteger value, int width = 0, bool upperCase = false)
+   {
+      static_assert(std::is_integral_v<TInteger>, "value must be an integer");
+
+      CharTypeOf<TString> buffer[c_maxIntegerLength];
+      auto* end = std::end(buffer);
+      auto* start = FormatHex(end, static_cast<std::make_unsigned_t<TInteger>>(value), upperCase);
+
+      AppendDigits(str, false, start, static_cast<int>(end - start), width);
+   }
+
+   /// appends floating point value; with a precision of -1, the shortest
+   /// representation is used that reads back to the same value, otherwise
+   /// the fixed format with the given number of decimal places
+   template <typename TString>
+   void AppendDouble(TString& str, double value, int precision = -1)
+   {
+      // fixed format of the largest double value has 309 digits before the point
+      char digits[512];
+
+      std::to_chars_result result = precision < 0
+         ? std::to_chars(digits, std::end(digits), value)
+         : std::to_chars(digits, std::end(digits), value, std::chars_format::fixed, std::min(precision, 64));
+
+      AppendDigits(str, false, digits, static_cast<int>(result.ptr - digits), 0);
+   }
+
+   /// \brief copies number text to a char buffer, for std::from_chars
+   /// \details Skips a leading plus sign, which std::from_chars doesn't
+   /// accept. Returns false when the text contains non-ASCII characters, or
+   /// when another sign follows the plus sign.
+   template <typename TChar>
+   bool CopyNumberText(const TChar* text, int length, std::string& buffer)
+   {
+      if (length > 0 && text[0] == static_cast<TChar>('+'))
+      {
+         text++;
+         length--;
+
+         if (length > 0 && (text[0] == static_cast<TChar>('+') || text[0] == static_cast<TChar>('-')))
+            return false;
+      }
+
+      buffer.resize(static_cast<size_t>(length));
+      for (int index = 0; index < length; index++)
+      {
+         if (static_cast<std::make_unsigned_t<TChar>>(text[index]) > 0x7f)
+            return false;
+
+         buffer[index] = static_cast<char>(text[index]);
+      }
+
+      return true;
+   }
+
+   /// \brief parses integer from text
+   /// \details The whole text must consist of the number; no whitespace is
+   /// skipped. Returns false when the text isn't a valid number or the
+   /// number is out of range for the type; the value isn't modified then.
+   template <typename TInteger, typename TChar>
+   bool ParseInt(const TChar* text, int length, TInteger& value, int base = 10)
+   {
+      static_assert(std::is_integral_v<TInteger>, "value must be an integer");
+
+      const char* start;
+      const char* end;
+      std::string buffer;
+
+      if constexpr (std::is_same_v<TChar, char>)
+      {
+         start = text;
+         end = text + length;
+         if (length > 0 && *start == '+')
+         {
+            start++;
+            if (start != end && *start == '-')
+               return false;
+         }
+      }
+      else
+      {
+         if (!CopyNumberText(text, length, buffer))
+            return false;
+
+         start = buffer.data();
+         end = start + buffer.size();
+      }
+
+      if (start == end || *start == '+')
+         return false;
+
+      TInteger result{};
+      std::from_chars_result parseResult = std::from_chars(start, end, result, base);
+      if (parseResult.ec != std::errc{} || parseResult.ptr != end)
+         return false;
+
+      value = result;
+      return true;
+   }
+
+   /// parses integer from string; see ParseInt() above
+   template <typename TInteger, typename TString>
+      requires requires(const TString& str) { str.GetString(); str.GetLength(); }
+   bool ParseInt(const TString& str, TInteger& value, int base = 10)
+   {
+      return ParseInt(str.GetString(), str.GetLength(), value, base);
+   }
+
+   /// \brief parses floating point value from text
+   /// \details Accepts fixed and scientific format; the whole text must
+   /// consist of the number. Returns false when the text isn't a valid
+   /// number; the value isn't modified then.
+   template <typename TChar>
+   bool ParseDouble(const TChar* text, int length, double& value)
+   {
+      std::string buffer;
+      if (!CopyNumberText(text, length, buffer) || buffer.empty())
+         return false;
+
+      double result = 0.0;
+      std::from_chars_result parseResult = std::from_chars(buffer.data(), buffer.data() + buffer.size(), result);
+      if (parseResult.ec != std::errc{} || parseResult.ptr != buffer.data() + buffer.size())
+         return false;
+
+      value = result;
+      return true;
+   }
+
+   /// parses floating point value from string; see ParseDouble() above
+   template <typename TString>
+      requires requires(const TString& str) { str.GetString(); str.GetLength(); }
+   bool ParseDouble(const TString& str, double& value)
+   {
+      return ParseDouble(str.GetString(), str.GetLength(), value);
+   }
+
+} // namespace StringNumber
@@ -0,0 +1,678 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file StringSearch.hpp character search kernels for strings
+/// \details The functions in this file work on raw character buffers of
+/// 8, 16 and 32 bit characters, with given length. On x86 and x64 platforms,
+/// SSE2 and AVX2 kernels are used; the kernel is chosen at runtime, depending
+/// on the CPU. All other platforms use the scalar implementation.
+//
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+/// defined when SSE2 and AVX2 kernels are available
+#define ULIB_STRINGSEARCH_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(ULIB_STRINGSEARCH_X86) && (defined(__GNUC__) || defined(__clang__))
+/// marks a function to be compiled with AVX2 enabled, inlining all called functions
+#define ULIB_TARGET_AVX2 __attribute__((target("avx2"), flatten))
+/// marks a function to be compiled with SSE4.1 enabled, inlining all called functions
+#define ULIB_TARGET_SSE41 __attribute__((target("sse4.1"), flatten))
+/// \brief marks a kernel function to be inlined, also when not optimizing
+/// \details The kernels are compiled with the instruction set of the
+/// function they are inlined into; a kernel that was compiled on its own
+/// would pass AVX2 vectors to and from the AVX2 enabled vector operations
+/// with a different calling convention, e.g. in debug builds.
+#define ULIB_KERNEL_INLINE __attribute__((always_inline)) inline
+#else
+/// marks a function to be compiled with AVX2 enabled; not needed for MSVC
+#define ULIB_TARGET_AVX2
+/// marks a function to be compiled with SSE4.1 enabled; not needed for MSVC
+#define ULIB_TARGET_SSE41
+/// marks a kernel function to be inlined; MSVC doesn't need it, since it
+/// compiles all functions with the same calling convention for vectors
+#define ULIB_KERNEL_INLINE inline
+#endif
+
+#if defined(ULIB_STRINGSEARCH_X86) && defined(__GNUC__) && !defined(__clang__)
+// the kernel templates are only instantiated with AVX2 types when inlined
+// into AVX2 enabled functions, so the ABI warning doesn't apply
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+/// \brief character search kernels
+namespace StringSearch
+{
+   /// instruction set level used by the search kernels
+   enum class CpuLevel
+   {
+      scalar = 0, ///< plain C++ loops
+      sse2 = 1,   ///< SSE2, 16 bytes per step
+      sse41 = 2,  ///< SSE4.1, 16 bytes per step; only used by kernels that need byte shuffles
+      avx2 = 3,   ///< AVX2, 32 bytes per step
+   };
+
+   /// detects instruction set level of the current CPU
+   inline CpuLevel DetectCpuLevel()
+   {
+#ifdef ULIB_STRINGSEARCH_X86
+#ifdef _MSC_VER
+      int info[4] = {};
+      __cpuid(info, 0);
+      int maxLeaf = info[0];
+
+      __cpuid(info, 1);
+      if ((info[2] & (1 << 19)) == 0)
+         return CpuLevel::sse2;
+
+      // check that the OS saves the YMM registers
+      bool osxsave = (info[2] & (1 << 27)) != 0;
+      if (maxLeaf < 7 || !osxsave || (_xgetbv(0) & 6) != 6)
+         return CpuLevel::sse41;
+
+      __cpuidex(info, 7, 0);
+      return (info[1] & (1 << 5)) != 0 ? CpuLevel::avx2 : CpuLevel::sse41;
+#else
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2"))
+         return CpuLevel::avx2;
+
+      return __builtin_cpu_supports("sse4.1") ? CpuLevel::sse41 : CpuLevel::sse2;
+#endif
+#else
+      return CpuLevel::scalar;
+#endif
+   }
+
+   /// returns instruction set level used by the search kernels; detected once
+   inline CpuLevel GetCpuLevel()
+   {
+      static const CpuLevel s_cpuLevel = DetectCpuLevel();
+      return s_cpuLevel;
+   }
+
+   /// \brief scalar implementation of all search kernels
+   namespace Scalar
+   {
+      /// returns if character is contained in the character set
+      template <typename T>
+      inline bool IsInSet(T ch, const T* charSet, size_t charSetLength)
+      {
+         for (size_t index = 0; index < charSetLength; index++)
+            if (charSet[index] == ch)
+               return true;
+
+         return false;
+      }
+
+      /// finds first occurrence of character; returns nullptr when not found
+      template <typename T>
+      inline const T* FindChar(const T* str, size_t length, T ch)
+      {
+         for (const T* end = str + length; str < end; str++)
+            if (*str == ch)
+               return str;
+
+         return nullptr;
+      }
+
+      /// finds last occurrence of character; returns nullptr when not found
+      template <typename T>
+      inline const T* ReverseFindChar(const T* str, size_t length, T ch)
+      {
+         for (const T* pos = str + length; pos > str; )
+            if (*--pos == ch)
+               return pos;
+
+         return nullptr;
+      }
+
+      /// finds first character that is (or isn't, when inSet is false) in the
+      /// given character set; returns nullptr when not found
+      template <typename T>
+      inline const T* FindCharOf(const T* str, size_t length,
+         const T* charSet, size_t charSetLength, bool inSet)
+      {
+         for (const T* end = str + length; str < end; str++)
+            if (IsInSet(*str, charSet, charSetLength) == inSet)
+               return str;
+
+         return nullptr;
+      }
+
+      /// replaces all occurrences of a character; returns number of replaced characters
+      template <typename T>
+      inline size_t ReplaceChar(T* str, size_t length, T oldCh, T newCh)
+      {
+         size_t count = 0;
+         for (T* end = str + length; str < end; str++)
+            if (*str == oldCh)
+            {
+               *str = newCh;
+               count++;
+            }
+
+         return count;
+      }
+
+      /// removes all occurrences of a character; returns new length
+      template <typename T>
+      inline size_t RemoveChar(T* str, size_t length, T ch)
+      {
+         T* dest = str;
+         for (const T* src = str, *end = str + length; src < end; src++)
+            if (*src != ch)
+               *dest++ = *src;
+
+         return static_cast<size_t>(dest - str);
+      }
+
+      /// finds first occurrence of a substring; returns nullptr when not found
+      template <typename T>
+      inline const T* FindString(const T* str, size_t length, const T* subStr, size_t subLength)
+      {
+         if (subLength == 0)
+            return str;
+
+         if (subLength > length)
+            return nullptr;
+
+         const T* last = str + length - subLength;
+         for (; str <= last; str++)
+            if (*str == *subStr &&
+               memcmp(str, subStr, subLength * sizeof(T)) == 0)
+               return str;
+
+         return nullptr;
+      }
+   } // namespace Scalar
+
+#ifdef ULIB_STRINGSEARCH_X86
+
+   /// \brief SIMD vector operations
+   /// \details Each vector class provides the same set of operations, so that
+   /// the kernels below can be written once for SSE2 and AVX2. Compare results
+   /// are converted to byte masks, so that a matching character of size N sets
+   /// N consecutive bits in the mask.
+   namespace Vector
+   {
+      /// 128-bit SSE2 vector operations
+      struct Sse2
+      {
+         typedef __m128i Type;                  ///< vector type
+         static constexpr size_t c_size = 16;   ///< vector size in bytes
+
+         /// loads unaligned vector
+         static Type Load(const void* ptr) { return _mm_loadu_si128(static_cast<const __m128i*>(ptr)); }
+
+         /// stores unaligned vector
+         static void Store(void* ptr, Type value) { _mm_storeu_si128(static_cast<__m128i*>(ptr), value); }
+
+         /// sets all characters in the vector to the given character
+         template <typename T>
+         static Type Broadcast(T ch)
+         {
+            if constexpr (sizeof(T) == 1)
+               return _mm_set1_epi8(static_cast<char>(ch));
+            else if constexpr (sizeof(T) == 2)
+               return _mm_set1_epi16(static_cast<short>(ch));
+            else
+               return _mm_set1_epi32(static_cast<int>(ch));
+         }
+
+         /// compares all characters for equality
+         template <typename T>
+         static Type CompareEqual(Type lhs, Type rhs)
+         {
+            if constexpr (sizeof(T) == 1)
+               return _mm_cmpeq_epi8(lhs, rhs);
+            else if constexpr (sizeof(T) == 2)
+               return _mm_cmpeq_epi16(lhs, rhs);
+            else
+               return _mm_cmpeq_epi32(lhs, rhs);
+         }
+
+         static Type Or(Type lhs, Type rhs) { return _mm_or_si128(lhs, rhs); }     ///< bitwise or
+         static Type And(Type lhs, Type rhs) { return _mm_and_si128(lhs, rhs); }   ///< bitwise and
+         static Type Zero() { return _mm_setzero_si128(); }                        ///< zero vector
+
+         /// selects from ifSet where mask is set, and from ifClear otherwise
+         static Type Select(Type mask, Type ifSet, Type ifClear)
+         {
+            return _mm_or_si128(_mm_and_si128(mask, ifSet), _mm_andnot_si128(mask, ifClear));
+         }
+
+         /// returns byte mask
+         static unsigned int MoveMask(Type value) { return static_cast<unsigned int>(_mm_movemask_epi8(value)); }
+
+         /// byte mask with all bits set
+         static constexpr unsigned int c_fullMask = 0xffff;
+      };
+
+      /// 256-bit AVX2 vector operations
+      struct Avx2
+      {
+         typedef __m256i Type;                  ///< vector type
+         static constexpr size_t c_size = 32;   ///< vector size in bytes
+
+         /// loads unaligned vector
+         ULIB_TARGET_AVX2 static Type Load(const void* ptr) { return _mm256_loadu_si256(static_cast<const __m256i*>(ptr)); }
+
+         /// stores unaligned vector
+         ULIB_TARGET_AVX2 static void Store(void* ptr, Type value) { _mm256_storeu_si256(static_cast<__m256i*>(ptr), value); }
+
+         /// sets all characters in the vector to the given character
+         template <typename T>
+         ULIB_TARGET_AVX2 static Type Broadcast(T ch)
+         {
+            if constexpr (sizeof(T) == 1)
+               return _mm256_set1_epi8(static_cast<char>(ch));
+            else if constexpr (sizeof(T) == 2)
+               return _mm256_set1_epi16(static_cast<short>(ch));
+            else
+               return _mm256_set1_epi32(static_cast<int>(ch));
+         }
+
+         /// compares all characters for equality
+         template <typename T>
+         ULIB_TARGET_AVX2 static Type CompareEqual(Type lhs, Type rhs)
+         {
+            if constexpr (sizeof(T) == 1)
+               return _mm256_cmpeq_epi8(lhs, rhs);
+            else if constexpr (sizeof(T) == 2)
+               return _mm256_cmpeq_epi16(lhs, rhs);
+            else
+               return _mm256_cmpeq_epi32(lhs, rhs);
+         }
+
+         ULIB_TARGET_AVX2 static Type Or(Type lhs, Type rhs) { return _mm256_or_si256(lhs, rhs); }    ///< bitwise or
+         ULIB_TARGET_AVX2 static Type And(Type lhs, Type rhs) { return _mm256_and_si256(lhs, rhs); }  ///< bitwise and
+         ULIB_TARGET_AVX2 static Type Zero() { return _mm256_setzero_si256(); }                       ///< zero vector
+
+         /// selects from ifSet where mask is set, and from ifClear otherwise
+         ULIB_TARGET_AVX2 static Type Select(Type mask, Type ifSet, Type ifClear)
+         {
+            return _mm256_blendv_epi8(ifClear, ifSet, mask);
+         }
+
+         /// returns byte mask
+         ULIB_TARGET_AVX2 static unsigned int MoveMask(Type value) { return static_cast<unsigned int>(_mm256_movemask_epi8(value)); }
+
+         /// byte mask with all bits set
+         static constexpr unsigned int c_fullMask = 0xffffffff;
+      };
+
+      /// returns index of lowest set bit; mask must not be zero
+      inline unsigned int LowestBit(unsigned int mask)
+      {
+#ifdef _MSC_VER
+         unsigned long index = 0;
+         _BitScanForward(&index, mask);
+         return index;
+#else
+         return static_cast<unsigned int>(__builtin_ctz(mask));
+#endif
+      }
+
+      /// returns index of highest set bit; mask must not be zero
+      inline unsigned int HighestBit(unsigned int mask)
+      {
+#ifdef _MSC_VER
+         unsigned long index = 0;
+         _BitScanReverse(&index, mask);
+         return index;
+#else
+         return 31 - static_cast<unsigned int>(__builtin_clz(mask));
+#endif
+      }
+   } // namespace Vector
+
+   /// \brief SIMD kernels, written once for all vector types
+   /// \details The kernels process full vectors only; the remaining characters
+   /// are handled by the scalar implementation, so that no memory outside of
+   /// the string is accessed.
+   namespace Kernel
+   {
+      /// max. number of characters in a set that is searched using SIMD
+      static constexpr size_t c_maxVectorCharSetLength = 16;
+
+      /// finds first occurrence of character
+      template <typename V, typename T>
+      ULIB_KERNEL_INLINE const T* FindChar(const T* str, size_t length, T ch)
+      {
+         constexpr size_t step = V::c_size / sizeof(T);
+         typename V::Type needle = V::template Broadcast<T>(ch);
+
+         size_t index = 0;
+         for (; index + step <= length; index += step)
+         {
+            unsigned int mask = V::MoveMask(
+               V::template CompareEqual<T>(V::Load(str + index), needle));
+            if (mask != 0)
+               return str + index + Vector::LowestBit(mask) / sizeof(T);
+         }
+
+         return Scalar::FindChar(str + index, length - index, ch);
+      }
+
+      /// finds last occurrence of character
+      template <typename V, typename T>
+      ULIB_KERNEL_INLINE const T* ReverseFindChar(const T* str, size_t length, T ch)
+      {
+         constexpr size_t step = V::c_size / sizeof(T);
+         typename V::Type needle = V::template Broadcast<T>(ch);
+
+         size_t index = length;
+         for (; index >= step; index -= step)
+         {
+            unsigned int mask = V::MoveMask(
+               V::template CompareEqual<T>(V::Load(str + index - step), needle));
+            if (mask != 0)
+               return str + index - step + Vector::HighestBit(mask) / sizeof(T);
+         }
+
+         return Scalar::ReverseFindChar(str, index, ch);
+      }
+
+      /// finds first character that is (or isn't) in the given character set;
+      /// the set must not contain more than c_maxVectorCharSetLength characters
+      template <typename V, typename T>
+      ULIB_KERNEL_INLINE const T* FindCharOf(const T* str, size_t length,
+         const T* charSet, size_t charSetLength, bool inSet)
+      {
+         constexpr size_t step = V::c_size / sizeof(T);
+
+         typename V::Type needles[c_maxVectorCharSetLength];
+         for (size_t setIndex = 0; setIndex < charSetLength; setIndex++)
+            needles[setIndex] = V::template Broadcast<T>(charSet[setIndex]);
+
+         size_t index = 0;
+         for (; index + step <= length; index += step)
+         {
+            typename V::Type block = V::Load(str + index);
+
+            typename V::Type matches = V::Zero();
+            for (size_t setIndex = 0; setIndex < charSetLength; setIndex++)
+               matches = V::Or(matches, V::template CompareEqual<T>(block, needles[setIndex]));
+
+            unsigned int mask = V::MoveMask(matches);
+            if (!inSet)
+               mask ^= V::c_fullMask;
+
+            if (mask != 0)
+               return str + index + Vector::LowestBit(mask) / sizeof(T);
+         }
+
+         return Scalar::FindCharOf(str + index, length - index, charSet, charSetLength, inSet);
+      }
+
+      /// replaces all occurrences of a character
+      template <typename V, typename T>
+      ULIB_KERNEL_INLINE size_t ReplaceChar(T* str, size_t length, T oldCh, T newCh)
+      {
+         constexpr size_t step = V::c_size / sizeof(T);
+         typename V::Type oldNeedle = V::template Broadcast<T>(oldCh);
+         typename V::Type newChars = V::template Broadcast<T>(newCh);
+
+         size_t count = 0;
+         size_t index = 0;
+         for (; index + step <= length; index += step)
+         {
+            typename V::Type block = V::Load(str + index);
+            typename V::Type matches = V::template CompareEqual<T>(block, oldNeedle);
+
+            unsigned int mask = V::MoveMask(matches);
+            if (mask == 0)
+               continue;
+
+            V::Store(str + index, V::Select(matches, newChars, block));
+
+            for (; mask != 0; mask &= mask - 1)
+               count++;
+         }
+
+         return count / sizeof(T) +
+            Scalar::ReplaceChar(str + index, length - index, oldCh, newCh);
+      }
+
+      /// removes all occurrences of a character; returns new length
+      template <typename V, typename T>
+      ULIB_KERNEL_INLINE size_t RemoveChar(T* str, size_t length, T ch)
+      {
+         constexpr size_t step = V::c_size / sizeof(T);
+         typename V::Type needle = V::template Broadcast<T>(ch);
+
+         // blocks without the character are moved as a whole; the target
+         // position is never after the source position, so a block is always
+         // loaded before it is overwritten
+         size_t destIndex = 0;
+         size_t index = 0;
+         for (; index + step <= length; index += step)
+         {
+            typename V::Type block = V::Load(str + index);
+            unsigned int mask = V::MoveMask(V::template CompareEqual<T>(block, needle));
+
+            if (mask == 0)
+            {
+               if (destIndex != index)
+                  V::Store(str + destIndex, block);
+               destIndex += step;
+               continue;
+            }
+
+            for (size_t blockIndex = 0; blockIndex < step; blockIndex++)
+               if (str[index + blockIndex] != ch)
+                  str[destIndex++] = str[index + blockIndex];
+         }
+
+         for (; index < length; index++)
+            if (str[index] != ch)
+               str[destIndex++] = str[index];
+
+         return destIndex;
+      }
+
+      /// finds first occurrence of a substring; compares first and last
+      /// character of the substring for a whole vector of positions at once
+      template <typename V, typename T>
+      ULIB_KERNEL_INLINE const T* FindString(const T* str, size_t length, const T* subStr, size_t subLength)
+      {
+         if (subLength == 0)
+            return str;
+
+         if (subLength > length)
+            return nullptr;
+
+         if (subLength == 1)
+            return FindChar<V>(str, length, subStr[0]);
+
+         constexpr size_t step = V::c_size / sizeof(T);
+         typename V::Type first = V::template Broadcast<T>(subStr[0]);
+         typename V::Type last = V::template Broadcast<T>(subStr[subLength - 1]);
+
+         size_t numPositions = length - subLength + 1;
+
+         size_t index = 0;
+         for (; index + step <= numPositions; index += step)
+         {
+            typename V::Type blockFirst = V::Load(str + index);
+            typename V::Type blockLast = V::Load(str + index + subLength - 1);
+
+            unsigned int mask = V::MoveMask(V::And(
+               V::template CompareEqual<T>(blockFirst, first),
+               V::template CompareEqual<T>(blockLast, last)));
+
+            while (mask != 0)
+            {
+               unsigned int charIndex = Vector::LowestBit(mask) / sizeof(T);
+
+               const T* candidate = str + index + charIndex;
+               if (memcmp(candidate + 1, subStr + 1, (subLength - 2) * sizeof(T)) == 0)
+                  return candidate;
+
+               // clear all bits of this character
+               mask &= static_cast<unsigned int>(~((1ull << ((charIndex + 1) * sizeof(T))) - 1));
+            }
+         }
+
+         return Scalar::FindString(str + index, length - index, subStr, subLength);
+      }
+   } // namespace Kernel
+
+   /// \brief AVX2 instantiations of the kernels
+   /// \details The functions are compiled with AVX2 enabled, and inline the
+   /// kernels; when optimizing, also all vector operations.
+   namespace Avx2
+   {
+      /// finds first occurrence of character
+      template <typename T>
+      ULIB_TARGET_AVX2 inline const T* FindChar(const T* str, size_t length, T ch)
+      {
+         return Kernel::FindChar<Vector::Avx2>(str, length, ch);
+      }
+
+      /// finds last occurrence of character
+      template <typename T>
+      ULIB_TARGET_AVX2 inline const T* ReverseFindChar(const T* str, size_t length, T ch)
+      {
+         return Kernel::ReverseFindChar<Vector::Avx2>(str, length, ch);
+      }
+
+      /// finds first character that is (or isn't) in the given character set
+      template <typename T>
+      ULIB_TARGET_AVX2 inline const T* FindCharOf(const T* str, size_t length,
+         const T* charSet, size_t charSetLength, bool inSet)
+      {
+         return Kernel::FindCharOf<Vector::Avx2>(str, length, charSet, charSetLength, inSet);
+      }
+
+      /// replaces all occurrences of a character
+      template <typename T>
+      ULIB_TARGET_AVX2 inline size_t ReplaceChar(T* str, size_t length, T oldCh, T newCh)
+      {
+         return Kernel::ReplaceChar<Vector::Avx2>(str, length, oldCh, newCh);
+      }
+
+      /// removes all occurrences of a character
+      template <typename T>
+      ULIB_TARGET_AVX2 inline size_t RemoveChar(T* str, size_t length, T ch)
+      {
+         return Kernel::RemoveChar<Vector::Avx2>(str, length, ch);
+      }
+
+      /// finds first occurrence of a substring
+      template <typename T>
+      ULIB_TARGET_AVX2 inline const T* FindString(const T* str, size_t length, const T* subStr, size_t subLength)
+      {
+         return Kernel::FindString<Vector::Avx2>(str, length, subStr, subLength);
+      }
+   } // namespace Avx2
+
+#endif // ULIB_STRINGSEARCH_X86
+
+   // dispatching functions
+
+   /// finds first occurrence of character; returns nullptr when not found
+   template <typename T>
+   inline const T* FindChar(const T* str, size_t length, T ch)
+   {
+#ifdef ULIB_STRINGSEARCH_X86
+      if (length * sizeof(T) >= Vector::Avx2::c_size && GetCpuLevel() == CpuLevel::avx2)
+         return Avx2::FindChar(str, length, ch);
+
+      if (length * sizeof(T) >= Vector::Sse2::c_size)
+         return Kernel::FindChar<Vector::Sse2>(str, length, ch);
+#endif
+      return Scalar::FindChar(str, length, ch);
+   }
+
+   /// finds last occurrence of character; returns nullptr when not found
+   template <typename T>
+   inline const T* ReverseFindChar(const T* str, size_t length, T ch)
+   {
+#ifdef ULIB_STRINGSEARCH_X86
+      if (length * sizeof(T) >= Vector::Avx2::c_size && GetCpuLevel() == CpuLevel::avx2)
+         return Avx2::ReverseFindChar(str, length, ch);
+
+      if (length * sizeof(T) >= Vector::Sse2::c_size)
+         return Kernel::ReverseFindChar<Vector::Sse2>(str, length, ch);
+#endif
+      return Scalar::ReverseFindChar(str, length, ch);
+   }
+
+   /// finds first character that is (or isn't, when inSet is false) in the
+   /// given character set; returns nullptr when not found
+   template <typename T>
+   inline const T* FindCharOf(const T* str, size_t length,
+      const T* charSet, size_t charSetLength, bool inSet)
+   {
+#ifdef ULIB_STRINGSEARCH_X86
+      if (charSetLength <= Kernel::c_maxVectorCharSetLength)
+      {
+         if (length * sizeof(T) >= Vector::Avx2::c_size && GetCpuLevel() == CpuLevel::avx2)
+            return Avx2::FindCharOf(str, length, charSet, charSetLength, inSet);
+
+         if (length * sizeof(T) >= Vector::Sse2::c_size)
+            return Kernel::FindCharOf<Vector::Sse2>(str, length, charSet, charSetLength, inSet);
+      }
+#endif
+      return Scalar::FindCharOf(str, length, charSet, charSetLength, inSet);
+   }
+
+   /// replaces all occurrences of a character; returns number of replaced characters
+   template <typename T>
+   inline size_t ReplaceChar(T* str, size_t length, T oldCh, T newCh)
+   {
+#ifdef ULIB_STRINGSEARCH_X86
+      if (length * sizeof(T) >= Vector::Avx2::c_size && GetCpuLevel() == CpuLevel::avx2)
+         return Avx2::ReplaceChar(str, length, oldCh, newCh);
+
+      if (length * sizeof(T) >= Vector::Sse2::c_size)
+         return Kernel::ReplaceChar<Vector::Sse2>(str, length, oldCh, newCh);
+#endif
+      return Scalar::ReplaceChar(str, length, oldCh, newCh);
+   }
+
+   /// removes all occurrences of a character; returns new length
+   template <typename T>
+   inline size_t RemoveChar(T* str, size_t length, T ch)
+   {
+#ifdef ULIB_STRINGSEARCH_X86
+      if (length * sizeof(T) >= Vector::Avx2::c_size && GetCpuLevel() == CpuLevel::avx2)
+         return Avx2::RemoveChar(str, length, ch);
+
+      if (length * sizeof(T) >= Vector::Sse2::c_size)
+         return Kernel::RemoveChar<Vector::Sse2>(str, length, ch);
+#endif
+      return Scalar::RemoveChar(str, length, ch);
+   }
+
+   /// finds first occurrence of a substring; returns nullptr when not found
+   template <typename T>
+   inline const T* FindString(const T* str, size_t length, const T* subStr, size_t subLength)
+   {
+#ifdef ULIB_STRINGSEARCH_X86
+      if (length * sizeof(T) >= Vector::Avx2::c_size && GetCpuLevel() == CpuLevel::avx2)
+         return Avx2::FindString(str, length, subStr, subLength);
+
+      if (length * sizeof(T) >= Vector::Sse2::c_size)
+         return Kernel::FindString<Vector::Sse2>(str, length, subStr, subLength);
+#endif
+      return Scalar::FindString(str, length, subStr, subLength);
+   }
+
+} // namespace StringSearch
+
+#if defined(ULIB_STRINGSEARCH_X86) && defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
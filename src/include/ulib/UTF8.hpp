@@ -1,16 +1,48 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2000-2022 Michael Fink
+// Copyright (C) 2000-2022,2026 Michael Fink
 //
 /// \file UTF8.hpp UTF-8 conversion
+/// \details Invalid UTF-8 sequences and unpaired surrogates are replaced by
+/// U+FFFD REPLACEMENT CHARACTER. In non-Unicode builds, strings are assumed
+/// to be UTF-8 already, and are copied unchanged.
 //
 #pragma once
 
 #include <vector>
+#include <string>
 
 /// \brief converts string to UTF-8 encoding
 /// \details the resulting buffer always contains a zero character as string terminator
 void StringToUTF8(const CString& text, std::vector<char>& utf8Buffer);
 
+/// \brief converts text with given length to UTF-8 encoding
+/// \details When utf8Buffer is nullptr, only the number of bytes needed is
+/// returned, e.g. to size a buffer for multiple texts at once. Otherwise at
+/// most bufferLength bytes are written, without a zero terminator, and the
+/// number of bytes written is returned; a character that doesn't fit
+/// completely isn't written.
+size_t StringToUTF8(const TCHAR* text, size_t length, char* utf8Buffer, size_t bufferLength);
+
+/// \brief converts text with given length to UTF-8 and appends it to the string
+/// \details The string is only reallocated when its capacity isn't large
+/// enough. Returns the number of bytes appended.
+size_t StringToUTF8(const TCHAR* text, size_t length, std::string& utf8Text);
+
 /// converts from UTF-8 encoded text to CString; the text must be zero terminated
 CString UTF8ToString(const char* utf8Text);
+
+/// converts from UTF-8 encoded text with given length in bytes to CString
+CString UTF8ToString(const char* utf8Text, size_t length);
+
+/// \brief converts from UTF-8 encoded text with given length in bytes to characters
+/// \details When buffer is nullptr, only the number of characters needed is
+/// returned. Otherwise at most bufferLength characters are written, without
+/// a zero terminator, and the number of characters written is returned. The
+/// text never results in more characters than it has bytes.
+size_t UTF8ToString(const char* utf8Text, size_t length, TCHAR* buffer, size_t bufferLength);
+
+/// \brief converts from UTF-8 encoded text with given length in bytes and appends it to the string
+/// \details The string is only reallocated when its capacity isn't large
+/// enough. Returns the number of characters appended.
+size_t UTF8ToString(const char* utf8Text, size_t length, CString& text);
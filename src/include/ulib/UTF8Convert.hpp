@@ -0,0 +1,993 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file UTF8Convert.hpp conversion between UTF-8 and wide character strings
+/// \details Wide strings are UTF-16 when wchar_t has 16 bits, as on Windows,
+/// and UTF-32 when wchar_t has 32 bits. On x86 and x64 platforms, UTF-8 text
+/// is validated and converted in blocks of 16 or 32 bytes, using SSE4.1 or
+/// AVX2 kernels chosen at runtime. Blocks of ASCII characters are widened
+/// directly, as are runs of two and three byte sequences; other valid blocks
+/// are decoded without further checks. Blocks with invalid sequences, and all
+/// text on other platforms, are decoded one code point at a time. Invalid
+/// UTF-8 sequences and unpaired surrogates are replaced by U+FFFD REPLACEMENT
+/// CHARACTER, following the "maximal subpart" practice of the Unicode
+/// standard, which is the same that the Win32 conversion functions do.
+//
+#pragma once
+
+#include <ulib/CharConvert.hpp>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <bit>
+#include <type_traits>
+
+#if defined(ULIB_STRINGSEARCH_X86) && defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+/// \brief conversion between UTF-8 and wide character strings
+namespace UTF8Convert
+{
+   /// largest Unicode code point
+   constexpr char32_t c_maxCodePoint = 0x10FFFF;
+
+   /// U+FFFD REPLACEMENT CHARACTER, used for invalid sequences
+   constexpr char32_t c_replacementChar = 0xFFFD;
+
+   /// returned by DecodeCodePoint() for an invalid sequence
+   constexpr char32_t c_invalidSequence = 0xFFFFFFFF;
+
+   /// returned by DecodeCodePoint() for a sequence that is cut off by the end of the text
+   constexpr char32_t c_incompleteSequence = 0xFFFFFFFE;
+
+   /// maximum number of bytes of an UTF-8 sequence
+   constexpr size_t c_maxSequenceLength = 4;
+
+   /// returns if the wide character type uses UTF-16
+   constexpr bool IsWideUTF16() { return sizeof(wchar_t) == 2; }
+
+   /// returns if the byte is a continuation byte of a multibyte sequence
+   inline bool IsContinuationByte(char ch)
+   {
+      return (static_cast<unsigned char>(ch) & 0xC0) == 0x80;
+   }
+
+   /// returns number of bytes of the sequence started by given lead byte, or
+   /// 0 when the byte can't start a sequence
+   inline size_t GetSequenceLength(char leadByte)
+   {
+      auto value = static_cast<unsigned char>(leadByte);
+      if (value < 0x80)
+         return 1;
+
+      if (value < 0xC2)
+         return 0; // continuation bytes and overlong two byte sequences
+
+      if (value < 0xE0)
+         return 2;
+
+      if (value < 0xF0)
+         return 3;
+
+      return value < 0xF5 ? 4 : 0;
+   }
+
+   /// \brief decodes one code point and advances the position
+   /// \details pos must be before end. Returns c_invalidSequence for an
+   /// invalid sequence, and c_incompleteSequence when the text ends in the
+   /// middle of a sequence. In both cases, pos is advanced by the bytes that
+   /// started a valid sequence, but at least by one byte. Overlong sequences,
+   /// surrogates and code points beyond U+10FFFF are invalid.
+   inline char32_t DecodeCodePoint(const char*& pos, const char* end)
+   {
+      char leadByte = *pos++;
+      if (static_cast<unsigned char>(leadByte) < 0x80)
+         return static_cast<char32_t>(leadByte);
+
+      size_t length = GetSequenceLength(leadByte);
+      if (length == 0)
+         return c_invalidSequence;
+
+      auto lead = static_cast<unsigned char>(leadByte);
+      char32_t codePoint = lead & (0x7F >> length);
+
+      // the second byte has a smaller range after some lead bytes
+      unsigned char lower = 0x80, upper = 0xBF;
+      if (lead == 0xE0)
+         lower = 0xA0; // overlong
+      else if (lead == 0xED)
+         upper = 0x9F; // surrogates
+      else if (lead == 0xF0)
+         lower = 0x90; // overlong
+      else if (lead == 0xF4)
+         upper = 0x8F; // beyond U+10FFFF
+
+      for (size_t index = 1; index < length; index++)
+      {
+         if (pos == end)
+            return c_incompleteSequence;
+
+         auto value = static_cast<unsigned char>(*pos);
+         if (value < lower || value > upper)
+            return c_invalidSequence;
+
+         codePoint = (codePoint << 6) | (value & 0x3F);
+         pos++;
+
+         lower = 0x80;
+         upper = 0xBF;
+      }
+
+      return codePoint;
+   }
+
+   /// \brief encodes code point as UTF-8 and returns the number of bytes
+   /// \details The buffer must have space for c_maxSequenceLength bytes.
+   /// Surrogates and code points beyond U+10FFFF are encoded as U+FFFD.
+   inline size_t EncodeCodePoint(char32_t codePoint, char* buffer)
+   {
+      if (codePoint < 0x80)
+      {
+         buffer[0] = static_cast<char>(codePoint);
+         return 1;
+      }
+
+      if (codePoint < 0x800)
+      {
+         buffer[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+         buffer[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+         return 2;
+      }
+
+      if ((codePoint >= 0xD800 && codePoint < 0xE000) || codePoint > c_maxCodePoint)
+         codePoint = c_replacementChar;
+
+      if (codePoint < 0x10000)
+      {
+         buffer[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+         buffer[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+         buffer[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+         return 3;
+      }
+
+      buffer[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+      buffer[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+      buffer[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+      buffer[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+      return 4;
+   }
+
+   /// returns number of wide characters needed to store the code point
+   inline size_t GetWideLength(char32_t codePoint)
+   {
+      return IsWideUTF16() && codePoint >= 0x10000 ? 2 : 1;
+   }
+
+   /// stores code point as one or two wide characters; returns number of characters
+   inline size_t StoreWide(char32_t codePoint, wchar_t* dest)
+   {
+      if (IsWideUTF16() && codePoint >= 0x10000)
+      {
+         codePoint -= 0x10000;
+         dest[0] = static_cast<wchar_t>(0xD800 + (codePoint >> 10));
+         dest[1] = static_cast<wchar_t>(0xDC00 + (codePoint & 0x3FF));
+         return 2;
+      }
+
+      dest[0] = static_cast<wchar_t>(codePoint);
+      return 1;
+   }
+
+   /// \brief decodes one code point from a wide string and advances the position
+   /// \details pos must be before end. Unpaired surrogates and values beyond
+   /// U+10FFFF are returned as U+FFFD.
+   inline char32_t DecodeWide(const wchar_t*& pos, const wchar_t* end)
+   {
+      auto codePoint = static_cast<char32_t>(*pos++);
+      if (codePoint >= 0xD800 && codePoint < 0xDC00 && IsWideUTF16())
+      {
+         if (pos == end || *pos < 0xDC00 || *pos >= 0xE000)
+            return c_replacementChar;
+
+         return 0x10000 + ((codePoint - 0xD800) << 10) + (static_cast<char32_t>(*pos++) - 0xDC00);
+      }
+
+      if ((codePoint >= 0xD800 && codePoint < 0xE000) || codePoint > c_maxCodePoint)
+         return c_replacementChar;
+
+      return codePoint;
+   }
+
+   /// \brief returns number of bytes at the end of a block that start a
+   /// sequence that isn't complete in the block
+   /// \details The block must have at least 3 bytes.
+   inline size_t GetIncompleteLength(const char* blockEnd)
+   {
+      if (static_cast<unsigned char>(blockEnd[-1]) >= 0xC0)
+         return 1;
+
+      if (static_cast<unsigned char>(blockEnd[-2]) >= 0xE0)
+         return 2;
+
+      return static_cast<unsigned char>(blockEnd[-3]) >= 0xF0 ? 3 : 0;
+   }
+
+   /// \brief decodes valid UTF-8 text without checking it
+   /// \details The text must have been validated and must end with a complete
+   /// sequence. Returns number of wide characters written.
+   inline size_t DecodeValid(wchar_t* dest, const char* src, size_t length)
+   {
+      auto pos = reinterpret_cast<const unsigned char*>(src);
+      auto end = pos + length;
+
+      wchar_t* start = dest;
+      while (pos < end)
+      {
+         unsigned char lead = *pos;
+         char32_t codePoint;
+         if (lead < 0x80)
+         {
+            codePoint = lead;
+            pos++;
+         }
+         else if (lead < 0xE0)
+         {
+            codePoint = ((lead & 0x1Fu) << 6) | (pos[1] & 0x3Fu);
+            pos += 2;
+         }
+         else if (lead < 0xF0)
+         {
+            codePoint = ((lead & 0x0Fu) << 12) | ((pos[1] & 0x3Fu) << 6) | (pos[2] & 0x3Fu);
+            pos += 3;
+         }
+         else
+         {
+            codePoint = ((lead & 0x07u) << 18) | ((pos[1] & 0x3Fu) << 12) | ((pos[2] & 0x3Fu) << 6) | (pos[3] & 0x3Fu);
+            pos += 4;
+         }
+
+         dest += StoreWide(codePoint, dest);
+      }
+
+      return static_cast<size_t>(dest - start);
+   }
+
+   /// \brief converts one code point, or one invalid sequence, to wide characters
+   /// \details When dest is nullptr, only destPos is advanced. Returns false,
+   /// without advancing pos, when the wide characters don't fit.
+   inline bool ToWideStep(wchar_t* dest, size_t& destPos, size_t destEnd, const char*& pos, const char* end)
+   {
+      const char* start = pos;
+      char32_t codePoint = DecodeCodePoint(pos, end);
+      if (codePoint > c_maxCodePoint)
+         codePoint = c_replacementChar;
+
+      size_t wideLength = GetWideLength(codePoint);
+      if (destPos + wideLength > destEnd)
+      {
+         pos = start;
+         return false;
+      }
+
+      if (dest != nullptr)
+         StoreWide(codePoint, dest + destPos);
+
+      destPos += wideLength;
+      return true;
+   }
+
+   /// \brief scalar implementation of validation and conversion
+   /// \details Runs of ASCII characters are processed 8 bytes at a time.
+   namespace Scalar
+   {
+      /// returns the length of the valid UTF-8 text at the start of the text
+      inline size_t Validate(const char* src, size_t length)
+      {
+         const char* pos = src;
+         const char* end = src + length;
+
+         while (pos < end)
+         {
+            if (static_cast<unsigned char>(*pos) < 0x80)
+            {
+               pos += CharConvert::Scalar::FindNonAscii(pos, static_cast<size_t>(end - pos));
+               continue;
+            }
+
+            const char* start = pos;
+            if (DecodeCodePoint(pos, end) > c_maxCodePoint)
+               return static_cast<size_t>(start - src);
+         }
+
+         return length;
+      }
+
+      /// returns number of code points in the text; each invalid sequence counts as one
+      inline size_t CountCodePoints(const char* src, size_t length)
+      {
+         const char* pos = src;
+         const char* end = src + length;
+
+         size_t count = 0;
+         while (pos < end)
+         {
+            if (static_cast<unsigned char>(*pos) < 0x80)
+            {
+               size_t asciiLength = CharConvert::Scalar::FindNonAscii(pos, static_cast<size_t>(end - pos));
+               pos += asciiLength;
+               count += asciiLength;
+               continue;
+            }
+
+            DecodeCodePoint(pos, end);
+            count++;
+         }
+
+         return count;
+      }
+
+      /// converts UTF-8 text to a wide string; see UTF8Convert::ToWide()
+      inline size_t ToWide(wchar_t* dest, size_t destLength, const char* src, size_t srcLength)
+      {
+         const char* pos = src;
+         const char* end = src + srcLength;
+
+         size_t destPos = 0;
+         size_t destEnd = dest == nullptr ? SIZE_MAX : destLength;
+
+         while (pos < end && destPos < destEnd)
+         {
+            if (static_cast<unsigned char>(*pos) < 0x80)
+            {
+               size_t count = std::min(static_cast<size_t>(end - pos), destEnd - destPos);
+               count = dest == nullptr
+                  ? CharConvert::Scalar::FindNonAscii(pos, count)
+                  : CharConvert::Scalar::WidenAscii(dest + destPos, pos, count);
+
+               pos += count;
+               destPos += count;
+               continue;
+            }
+
+            if (!ToWideStep(dest, destPos, destEnd, pos, end))
+               break;
+         }
+
+         return destPos;
+      }
+   } // namespace Scalar
+
+#ifdef ULIB_STRINGSEARCH_X86
+
+   /// \brief lookup tables for validating UTF-8 with SIMD instructions
+   /// \details The tables implement the algorithm of John Keiser and Daniel
+   /// Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte". Each
+   /// pair of adjacent bytes is classified by looking up the high and low
+   /// nibble of the first byte and the high nibble of the second byte; the
+   /// three results are combined with a bitwise and, and any remaining bit
+   /// marks an error. Missing and extra continuation bytes of three and four
+   /// byte sequences are checked separately.
+   namespace Lookup
+   {
+      constexpr uint8_t c_tooShort = 1 << 0;    ///< lead byte followed by lead byte or ASCII
+      constexpr uint8_t c_tooLong = 1 << 1;     ///< ASCII followed by continuation byte
+      constexpr uint8_t c_overlong3 = 1 << 2;   ///< overlong three byte sequence
+      constexpr uint8_t c_tooLarge = 1 << 3;    ///< code point beyond U+10FFFF
+      constexpr uint8_t c_surrogate = 1 << 4;   ///< encoded surrogate
+      constexpr uint8_t c_overlong2 = 1 << 5;   ///< overlong two byte sequence
+      constexpr uint8_t c_tooLarge1000 = 1 << 6; ///< code point beyond U+10FFFF, starting with F4 90
+      constexpr uint8_t c_overlong4 = 1 << 6;   ///< overlong four byte sequence
+      constexpr uint8_t c_twoConts = 1 << 7;    ///< two continuation bytes in a row
+
+      /// errors that depend on the byte after a continuation byte
+      constexpr uint8_t c_carry = c_tooShort | c_tooLong | c_twoConts;
+
+      /// lookup table for the high nibble of the first byte
+      alignas(16) inline constexpr uint8_t c_byte1High[16] =
+      {
+         // 0_______: ASCII
+         c_tooLong, c_tooLong, c_tooLong, c_tooLong,
+         c_tooLong, c_tooLong, c_tooLong, c_tooLong,
+         // 10______: continuation
+         c_twoConts, c_twoConts, c_twoConts, c_twoConts,
+         // 1100____: two byte lead, C0 and C1 are overlong
+         c_tooShort | c_overlong2,
+         // 1101____: two byte lead
+         c_tooShort,
+         // 1110____: three byte lead
+         c_tooShort | c_overlong3 | c_surrogate,
+         // 1111____: four byte lead
+         c_tooShort | c_tooLarge | c_tooLarge1000 | c_overlong4,
+      };
+
+      /// lookup table for the low nibble of the first byte
+      alignas(16) inline constexpr uint8_t c_byte1Low[16] =
+      {
+         // ____0000
+         c_carry | c_overlong3 | c_overlong2 | c_overlong4,
+         // ____0001
+         c_carry | c_overlong2,
+         // ____001_
+         c_carry,
+         c_carry,
+         // ____0100
+         c_carry | c_tooLarge,
+         // ____0101 and above
+         c_carry | c_tooLarge | c_tooLarge1000,
+         c_carry | c_tooLarge | c_tooLarge1000,
+         c_carry | c_tooLarge | c_tooLarge1000,
+         c_carry | c_tooLarge | c_tooLarge1000,
+         c_carry | c_tooLarge | c_tooLarge1000,
+         c_carry | c_tooLarge | c_tooLarge1000,
+         c_carry | c_tooLarge | c_tooLarge1000,
+         c_carry | c_tooLarge | c_tooLarge1000,
+         // ____1101
+         c_carry | c_tooLarge | c_tooLarge1000 | c_surrogate,
+         c_carry | c_tooLarge | c_tooLarge1000,
+         c_carry | c_tooLarge | c_tooLarge1000,
+      };
+
+      /// lookup table for the high nibble of the second byte
+      alignas(16) inline constexpr uint8_t c_byte2High[16] =
+      {
+         // 0_______: ASCII
+         c_tooShort, c_tooShort, c_tooShort, c_tooShort,
+         c_tooShort, c_tooShort, c_tooShort, c_tooShort,
+         // 1000____
+         c_tooLong | c_overlong2 | c_twoConts | c_overlong3 | c_tooLarge1000 | c_overlong4,
+         // 1001____
+         c_tooLong | c_overlong2 | c_twoConts | c_overlong3 | c_tooLarge,
+         // 101_____
+         c_tooLong | c_overlong2 | c_twoConts | c_surrogate | c_tooLarge,
+         c_tooLong | c_overlong2 | c_twoConts | c_surrogate | c_tooLarge,
+         // 11______: lead byte
+         c_tooShort, c_tooShort, c_tooShort, c_tooShort,
+      };
+   } // namespace Lookup
+
+   /// \brief block operations for the SIMD kernels
+   /// \details All functions work on one block of c_size bytes, and need the
+   /// 3 bytes before the block to be readable, since the validation checks
+   /// each byte against the bytes before it.
+   namespace Block
+   {
+      /// block operations using SSE4.1 instructions
+      struct Sse41
+      {
+         static constexpr size_t c_size = 16;   ///< block size in bytes
+
+         /// loads 16 bytes
+         ULIB_TARGET_SSE41 static __m128i Load(const void* ptr) { return _mm_loadu_si128(static_cast<const __m128i*>(ptr)); }
+
+         /// stores 16 bytes
+         ULIB_TARGET_SSE41 static void Store(void* ptr, __m128i value) { _mm_storeu_si128(static_cast<__m128i*>(ptr), value); }
+
+         /// loads lookup table
+         ULIB_TARGET_SSE41 static __m128i LoadTable(const uint8_t* table)
+         {
+            return _mm_load_si128(reinterpret_cast<const __m128i*>(table));
+         }
+
+         /// returns if the block contains only ASCII characters
+         ULIB_TARGET_SSE41 static bool IsAscii(const char* pos)
+         {
+            return _mm_movemask_epi8(Load(pos)) == 0;
+         }
+
+         /// returns if the block contains valid UTF-8 text; a sequence that
+         /// is cut off at the end of the block isn't checked
+         ULIB_TARGET_SSE41 static bool IsValid(const char* pos)
+         {
+            __m128i input = Load(pos);
+            __m128i prev1 = Load(pos - 1);
+            __m128i prev2 = Load(pos - 2);
+            __m128i prev3 = Load(pos - 3);
+
+            const __m128i lowNibble = _mm_set1_epi8(0x0F);
+            __m128i byte1High = _mm_shuffle_epi8(LoadTable(Lookup::c_byte1High), _mm_and_si128(_mm_srli_epi16(prev1, 4), lowNibble));
+            __m128i byte1Low = _mm_shuffle_epi8(LoadTable(Lookup::c_byte1Low), _mm_and_si128(prev1, lowNibble));
+            __m128i byte2High = _mm_shuffle_epi8(LoadTable(Lookup::c_byte2High), _mm_and_si128(_mm_srli_epi16(input, 4), lowNibble));
+            __m128i specialCases = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+            // the third and fourth byte of a sequence must be continuation bytes
+            __m128i isThirdByte = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 1)));
+            __m128i isFourthByte = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 1)));
+            __m128i mustBeContinuation = _mm_cmpgt_epi8(_mm_or_si128(isThirdByte, isFourthByte), _mm_setzero_si128());
+            __m128i error = _mm_xor_si128(_mm_and_si128(mustBeContinuation, _mm_set1_epi8(static_cast<char>(0x80))), specialCases);
+
+            return _mm_testz_si128(error, error) != 0;
+         }
+
+         /// widens block of ASCII characters
+         ULIB_TARGET_SSE41 static void WidenAscii(wchar_t* dest, const char* pos)
+         {
+            __m128i input = Load(pos);
+            if constexpr (IsWideUTF16())
+            {
+               Store(dest, _mm_cvtepu8_epi16(input));
+               Store(dest + 8, _mm_cvtepu8_epi16(_mm_srli_si128(input, 8)));
+            }
+            else
+            {
+               Store(dest, _mm_cvtepu8_epi32(input));
+               Store(dest + 4, _mm_cvtepu8_epi32(_mm_srli_si128(input, 4)));
+               Store(dest + 8, _mm_cvtepu8_epi32(_mm_srli_si128(input, 8)));
+               Store(dest + 12, _mm_cvtepu8_epi32(_mm_srli_si128(input, 12)));
+            }
+         }
+
+         /// returns number of code points in the first length bytes of a valid block
+         ULIB_TARGET_SSE41 static size_t CountCodePoints(const char* pos, size_t length)
+         {
+            // all bytes that aren't continuation bytes start a code point
+            unsigned int leadBytes = static_cast<unsigned int>(
+               _mm_movemask_epi8(_mm_cmpgt_epi8(Load(pos), _mm_set1_epi8(static_cast<char>(0xBF)))));
+
+            return static_cast<size_t>(std::popcount(leadBytes & ((1u << length) - 1)));
+         }
+
+         /// returns number of wide characters of the first length bytes of a valid block
+         ULIB_TARGET_SSE41 static size_t GetWideLength(const char* pos, size_t length)
+         {
+            size_t count = CountCodePoints(pos, length);
+
+            // four byte sequences need a surrogate pair in UTF-16
+            if constexpr (IsWideUTF16())
+            {
+               __m128i input = Load(pos);
+               unsigned int fourByteLeads = static_cast<unsigned int>(
+                  _mm_movemask_epi8(_mm_cmpgt_epi8(input, _mm_set1_epi8(static_cast<char>(0xEF)))) &
+                  _mm_movemask_epi8(input));
+
+               count += static_cast<size_t>(std::popcount(fourByteLeads & ((1u << length) - 1)));
+            }
+
+            return count;
+         }
+
+         /// \brief decodes a run of three byte or two byte sequences
+         /// \details The 16 bytes at pos must be valid, but may end with an
+         /// incomplete sequence. Four code points of three bytes each, as in
+         /// CJK text, or eight code points of two bytes each, are decoded at
+         /// once. Returns the number of wide characters written, or 0 when
+         /// the bytes don't start with such a run; pos is advanced.
+         ULIB_TARGET_SSE41 static size_t DecodeRun(wchar_t* dest, const char*& pos)
+         {
+            __m128i input = Load(pos);
+            unsigned int continuationBytes = static_cast<unsigned int>(
+               _mm_movemask_epi8(_mm_cmplt_epi8(input, _mm_set1_epi8(static_cast<char>(0xC0)))));
+
+            // four three byte sequences, followed by the start of another sequence
+            if ((continuationBytes & 0x1FFF) == 0x0DB6)
+            {
+               __m128i value = _mm_shuffle_epi8(input,
+                  _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1));
+
+               __m128i codePoints = _mm_or_si128(_mm_or_si128(
+                  _mm_and_si128(value, _mm_set1_epi32(0x3F)),
+                  _mm_and_si128(_mm_srli_epi32(value, 2), _mm_set1_epi32(0xFC0))),
+                  _mm_and_si128(_mm_srli_epi32(value, 4), _mm_set1_epi32(0xF000)));
+
+               if constexpr (IsWideUTF16())
+                  _mm_storel_epi64(reinterpret_cast<__m128i*>(dest), _mm_packus_epi32(codePoints, codePoints));
+               else
+                  Store(dest, codePoints);
+
+               pos += 12;
+               return 4;
+            }
+
+            // eight two byte sequences; the last lead byte must not start a
+            // longer sequence that continues after the block
+            if (continuationBytes == 0xAAAA && static_cast<unsigned char>(pos[14]) < 0xE0)
+            {
+               __m128i value = _mm_shuffle_epi8(input,
+                  _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+
+               __m128i codePoints = _mm_or_si128(
+                  _mm_and_si128(value, _mm_set1_epi16(0x3F)),
+                  _mm_and_si128(_mm_srli_epi16(value, 2), _mm_set1_epi16(0x7C0)));
+
+               if constexpr (IsWideUTF16())
+                  Store(dest, codePoints);
+               else
+               {
+                  Store(dest, _mm_cvtepu16_epi32(codePoints));
+                  Store(dest + 4, _mm_cvtepu16_epi32(_mm_srli_si128(codePoints, 8)));
+               }
+
+               pos += 16;
+               return 8;
+            }
+
+            return 0;
+         }
+      };
+
+      /// block operations using AVX2 instructions
+      struct Avx2
+      {
+         static constexpr size_t c_size = 32;   ///< block size in bytes
+
+         /// loads 32 bytes
+         ULIB_TARGET_AVX2 static __m256i Load(const void* ptr) { return _mm256_loadu_si256(static_cast<const __m256i*>(ptr)); }
+
+         /// stores 32 bytes
+         ULIB_TARGET_AVX2 static void Store(void* ptr, __m256i value) { _mm256_storeu_si256(static_cast<__m256i*>(ptr), value); }
+
+         /// loads lookup table into both lanes
+         ULIB_TARGET_AVX2 static __m256i LoadTable(const uint8_t* table)
+         {
+            return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+         }
+
+         /// returns if the block contains only ASCII characters
+         ULIB_TARGET_AVX2 static bool IsAscii(const char* pos)
+         {
+            return _mm256_movemask_epi8(Load(pos)) == 0;
+         }
+
+         /// returns if the block contains valid UTF-8 text; a sequence that
+         /// is cut off at the end of the block isn't checked
+         ULIB_TARGET_AVX2 static bool IsValid(const char* pos)
+         {
+            __m256i input = Load(pos);
+            __m256i prev1 = Load(pos - 1);
+            __m256i prev2 = Load(pos - 2);
+            __m256i prev3 = Load(pos - 3);
+
+            const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+            __m256i byte1High = _mm256_shuffle_epi8(LoadTable(Lookup::c_byte1High), _mm256_and_si256(_mm256_srli_epi16(prev1, 4), lowNibble));
+            __m256i byte1Low = _mm256_shuffle_epi8(LoadTable(Lookup::c_byte1Low), _mm256_and_si256(prev1, lowNibble));
+            __m256i byte2High = _mm256_shuffle_epi8(LoadTable(Lookup::c_byte2High), _mm256_and_si256(_mm256_srli_epi16(input, 4), lowNibble));
+            __m256i specialCases = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+            // the third and fourth byte of a sequence must be continuation bytes
+            __m256i isThirdByte = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 1)));
+            __m256i isFourthByte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 1)));
+            __m256i mustBeContinuation = _mm256_cmpgt_epi8(_mm256_or_si256(isThirdByte, isFourthByte), _mm256_setzero_si256());
+            __m256i error = _mm256_xor_si256(_mm256_and_si256(mustBeContinuation, _mm256_set1_epi8(static_cast<char>(0x80))), specialCases);
+
+            return _mm256_testz_si256(error, error) != 0;
+         }
+
+         /// widens block of ASCII characters
+         ULIB_TARGET_AVX2 static void WidenAscii(wchar_t* dest, const char* pos)
+         {
+            if constexpr (IsWideUTF16())
+            {
+               Store(dest, _mm256_cvtepu8_epi16(Sse41::Load(pos)));
+               Store(dest + 16, _mm256_cvtepu8_epi16(Sse41::Load(pos + 16)));
+            }
+            else
+            {
+               for (size_t index = 0; index < c_size; index += 8)
+                  Store(dest + index, _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pos + index))));
+            }
+         }
+
+         /// returns number of code points in the first length bytes of a valid block
+         ULIB_TARGET_AVX2 static size_t CountCodePoints(const char* pos, size_t length)
+         {
+            return Sse41::CountCodePoints(pos, std::min<size_t>(length, 16)) +
+               (length > 16 ? Sse41::CountCodePoints(pos + 16, length - 16) : 0);
+         }
+
+         /// returns number of wide characters of the first length bytes of a valid block
+         ULIB_TARGET_AVX2 static size_t GetWideLength(const char* pos, size_t length)
+         {
+            return Sse41::GetWideLength(pos, std::min<size_t>(length, 16)) +
+               (length > 16 ? Sse41::GetWideLength(pos + 16, length - 16) : 0);
+         }
+
+         /// decodes runs of three byte or two byte sequences; see Sse41::DecodeRun()
+         ULIB_TARGET_AVX2 static size_t DecodeRun(wchar_t* dest, const char*& pos)
+         {
+            const char* blockEnd = pos + c_size;
+
+            size_t count = 0;
+            while (blockEnd - pos >= 16)
+            {
+               size_t runCount = Sse41::DecodeRun(dest + count, pos);
+               if (runCount == 0)
+                  break;
+
+               count += runCount;
+            }
+
+            return count;
+         }
+      };
+   } // namespace Block
+
+   /// \brief SIMD kernels, using the block operations
+   /// \details The first 3 bytes of the text are processed one code point at
+   /// a time, since validating a block needs the 3 bytes before it; so are
+   /// blocks that contain invalid sequences, and the rest of the text that
+   /// doesn't fill a block. A block must not start with a continuation byte,
+   /// since the validation only checks sequences that start in the block.
+   namespace Kernel
+   {
+      /// returns the length of the valid UTF-8 text at the start of the text
+      template <typename B>
+      inline size_t Validate(const char* src, size_t length)
+      {
+         const char* pos = src;
+         const char* end = src + length;
+
+         while (pos < end)
+         {
+            if (pos - src >= 3 && static_cast<size_t>(end - pos) < B::c_size)
+               break;
+
+            if (pos - src >= 3 && !IsContinuationByte(*pos))
+            {
+               if (B::IsAscii(pos))
+               {
+                  pos += B::c_size;
+                  continue;
+               }
+
+               if (B::IsValid(pos))
+               {
+                  pos += B::c_size - GetIncompleteLength(pos + B::c_size);
+                  continue;
+               }
+            }
+
+            const char* start = pos;
+            if (DecodeCodePoint(pos, end) > c_maxCodePoint)
+               return static_cast<size_t>(start - src);
+         }
+
+         return static_cast<size_t>(pos - src) + Scalar::Validate(pos, static_cast<size_t>(end - pos));
+      }
+
+      /// returns number of code points in the text; each invalid sequence counts as one
+      template <typename B>
+      inline size_t CountCodePoints(const char* src, size_t length)
+      {
+         const char* pos = src;
+         const char* end = src + length;
+
+         size_t count = 0;
+         while (pos < end)
+         {
+            if (pos - src >= 3 && static_cast<size_t>(end - pos) < B::c_size)
+               break;
+
+            if (pos - src >= 3 && !IsContinuationByte(*pos))
+            {
+               if (B::IsAscii(pos))
+               {
+                  pos += B::c_size;
+                  count += B::c_size;
+                  continue;
+               }
+
+               if (B::IsValid(pos))
+               {
+                  size_t blockLength = B::c_size - GetIncompleteLength(pos + B::c_size);
+                  count += B::CountCodePoints(pos, blockLength);
+                  pos += blockLength;
+                  continue;
+               }
+            }
+
+            DecodeCodePoint(pos, end);
+            count++;
+         }
+
+         return count + Scalar::CountCodePoints(pos, static_cast<size_t>(end - pos));
+      }
+
+      /// converts UTF-8 text to a wide string; see UTF8Convert::ToWide()
+      template <typename B>
+      inline size_t ToWide(wchar_t* dest, size_t destLength, const char* src, size_t srcLength)
+      {
+         const char* pos = src;
+         const char* end = src + srcLength;
+
+         size_t destPos = 0;
+         size_t destEnd = dest == nullptr ? SIZE_MAX : destLength;
+
+         while (pos < end && destPos < destEnd)
+         {
+            // a block never results in more wide characters than it has bytes
+            if (pos - src >= 3 && (static_cast<size_t>(end - pos) < B::c_size || destEnd - destPos < B::c_size))
+               break;
+
+            if (pos - src >= 3 && !IsContinuationByte(*pos))
+            {
+               if (B::IsAscii(pos))
+               {
+                  if (dest != nullptr)
+                     B::WidenAscii(dest + destPos, pos);
+
+                  pos += B::c_size;
+                  destPos += B::c_size;
+                  continue;
+               }
+
+               if (B::IsValid(pos))
+               {
+                  size_t count = dest == nullptr ? 0 : B::DecodeRun(dest + destPos, pos);
+                  if (count == 0)
+                  {
+                     size_t blockLength = B::c_size - GetIncompleteLength(pos + B::c_size);
+                     count = dest == nullptr
+                        ? B::GetWideLength(pos, blockLength)
+                        : DecodeValid(dest + destPos, pos, blockLength);
+
+                     pos += blockLength;
+                  }
+
+                  destPos += count;
+                  continue;
+               }
+            }
+
+            if (!ToWideStep(dest, destPos, destEnd, pos, end))
+               return destPos;
+         }
+
+         return destPos + Scalar::ToWide(dest == nullptr ? nullptr : dest + destPos,
+            destEnd - destPos, pos, static_cast<size_t>(end - pos));
+      }
+   } // namespace Kernel
+
+   /// \brief SSE4.1 kernel functions
+   namespace Sse41
+   {
+      /// returns the length of the valid UTF-8 text at the start of the text
+      ULIB_TARGET_SSE41 inline size_t Validate(const char* src, size_t length)
+      {
+         return Kernel::Validate<Block::Sse41>(src, length);
+      }
+
+      /// returns number of code points in the text
+      ULIB_TARGET_SSE41 inline size_t CountCodePoints(const char* src, size_t length)
+      {
+         return Kernel::CountCodePoints<Block::Sse41>(src, length);
+      }
+
+      /// converts UTF-8 text to a wide string
+      ULIB_TARGET_SSE41 inline size_t ToWide(wchar_t* dest, size_t destLength, const char* src, size_t srcLength)
+      {
+         return Kernel::ToWide<Block::Sse41>(dest, destLength, src, srcLength);
+      }
+   } // namespace Sse41
+
+   /// \brief AVX2 kernel functions
+   namespace Avx2
+   {
+      /// returns the length of the valid UTF-8 text at the start of the text
+      ULIB_TARGET_AVX2 inline size_t Validate(const char* src, size_t length)
+      {
+         return Kernel::Validate<Block::Avx2>(src, length);
+      }
+
+      /// returns number of code points in the text
+      ULIB_TARGET_AVX2 inline size_t CountCodePoints(const char* src, size_t length)
+      {
+         return Kernel::CountCodePoints<Block::Avx2>(src, length);
+      }
+
+      /// converts UTF-8 text to a wide string
+      ULIB_TARGET_AVX2 inline size_t ToWide(wchar_t* dest, size_t destLength, const char* src, size_t srcLength)
+      {
+         return Kernel::ToWide<Block::Avx2>(dest, destLength, src, srcLength);
+      }
+   } // namespace Avx2
+
+#endif // ULIB_STRINGSEARCH_X86
+
+   // dispatching functions
+
+   /// returns the length of the valid UTF-8 text at the start of the text;
+   /// this is the length of the text when the whole text is valid
+   inline size_t Validate(const char* src, size_t length)
+   {
+#ifdef ULIB_STRINGSEARCH_X86
+      StringSearch::CpuLevel cpuLevel = StringSearch::GetCpuLevel();
+      if (length >= Block::Avx2::c_size && cpuLevel == StringSearch::CpuLevel::avx2)
+         return Avx2::Validate(src, length);
+
+      if (length >= Block::Sse41::c_size && cpuLevel == StringSearch::CpuLevel::sse41)
+         return Sse41::Validate(src, length);
+#endif
+      return Scalar::Validate(src, length);
+   }
+
+   /// returns if the text is valid UTF-8
+   inline bool IsValid(const char* src, size_t length)
+   {
+      return Validate(src, length) == length;
+   }
+
+   /// returns number of code points in the text; each invalid sequence
+   /// counts as one code point, as it is replaced by U+FFFD when converting
+   inline size_t CountCodePoints(const char* src, size_t length)
+   {
+#ifdef ULIB_STRINGSEARCH_X86
+      StringSearch::CpuLevel cpuLevel = StringSearch::GetCpuLevel();
+      if (length >= Block::Avx2::c_size && cpuLevel == StringSearch::CpuLevel::avx2)
+         return Avx2::CountCodePoints(src, length);
+
+      if (length >= Block::Sse41::c_size && cpuLevel == StringSearch::CpuLevel::sse41)
+         return Sse41::CountCodePoints(src, length);
+#endif
+      return Scalar::CountCodePoints(src, length);
+   }
+
+   /// \brief converts UTF-8 text to a wide string
+   /// \details When dest is nullptr, only the number of wide characters is
+   /// returned. Otherwise at most destLength characters are written, without
+   /// a zero terminator; a surrogate pair that doesn't fit completely isn't
+   /// written. UTF-8 text never results in more wide characters than it has
+   /// bytes. Invalid sequences are replaced by U+FFFD.
+   inline size_t ToWide(wchar_t* dest, size_t destLength, const char* src, size_t srcLength)
+   {
+#ifdef ULIB_STRINGSEARCH_X86
+      StringSearch::CpuLevel cpuLevel = StringSearch::GetCpuLevel();
+      if (srcLength >= Block::Avx2::c_size && cpuLevel == StringSearch::CpuLevel::avx2)
+         return Avx2::ToWide(dest, destLength, src, srcLength);
+
+      if (srcLength >= Block::Sse41::c_size && cpuLevel == StringSearch::CpuLevel::sse41)
+         return Sse41::ToWide(dest, destLength, src, srcLength);
+#endif
+      return Scalar::ToWide(dest, destLength, src, srcLength);
+   }
+
+   /// \brief converts wide string to UTF-8 text
+   /// \details When dest is nullptr, only the number of bytes is returned.
+   /// Otherwise at most destLength bytes are written, without a zero
+   /// terminator; a sequence that doesn't fit completely isn't written.
+   /// Unpaired surrogates are replaced by U+FFFD. Runs of ASCII characters
+   /// are converted using the CharConvert kernels.
+   inline size_t FromWide(char* dest, size_t destLength, const wchar_t* src, size_t srcLength)
+   {
+      const wchar_t* pos = src;
+      const wchar_t* end = src + srcLength;
+
+      size_t destPos = 0;
+      size_t destEnd = dest == nullptr ? SIZE_MAX : destLength;
+
+      while (pos < end && destPos < destEnd)
+      {
+         if (static_cast<std::make_unsigned_t<wchar_t>>(*pos) < 0x80)
+         {
+            size_t count = std::min(static_cast<size_t>(end - pos), destEnd - destPos);
+            count = dest == nullptr
+               ? CharConvert::FindNonAscii(pos, count)
+               : CharConvert::NarrowAscii(dest + destPos, pos, count);
+
+            pos += count;
+            destPos += count;
+            continue;
+         }
+
+         char32_t codePoint = DecodeWide(pos, end);
+
+         char buffer[c_maxSequenceLength];
+         size_t length = EncodeCodePoint(codePoint, buffer);
+         if (destPos + length > destEnd)
+            break;
+
+         if (dest != nullptr)
+            std::copy(buffer, buffer + length, dest + destPos);
+
+         destPos += length;
+      }
+
+      return destPos;
+   }
+
+} // namespace UTF8Convert
+
+#if defined(ULIB_STRINGSEARCH_X86) && defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
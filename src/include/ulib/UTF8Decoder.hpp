@@ -0,0 +1,93 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file UTF8Decoder.hpp incremental UTF-8 decoder
+//
+#pragma once
+
+#include <ulib/UTF8Convert.hpp>
+
+/// \brief incremental UTF-8 decoder
+/// \details Decodes UTF-8 text that arrives in chunks, e.g. from a stream, a
+/// pipe or a network connection, to wide characters. Each chunk is decoded as
+/// a whole, using the UTF8Convert kernels; a sequence that is cut off at the
+/// end of a chunk is kept and completed with the first bytes of the next
+/// chunk. Code points outside the BMP are stored as surrogate pairs when
+/// wchar_t uses UTF-16. Invalid sequences are handled by the error policy.
+class UTF8Decoder
+{
+public:
+   /// policy for invalid sequences
+   enum class ErrorPolicy
+   {
+      replace,          ///< replaces each invalid sequence with U+FFFD
+      skip,             ///< leaves out invalid sequences
+      throwException,   ///< throws an Exception
+   };
+
+   /// ctor
+   explicit UTF8Decoder(ErrorPolicy errorPolicy = ErrorPolicy::replace) throw()
+      :m_errorPolicy(errorPolicy)
+   {
+   }
+
+   /// returns the error policy
+   ErrorPolicy GetErrorPolicy() const throw() { return m_errorPolicy; }
+
+   /// returns if the last chunk ended in the middle of a sequence
+   bool HasPendingBytes() const throw() { return m_pendingLength > 0; }
+
+   /// returns number of wide characters needed to decode a chunk with given length
+   static size_t GetMaxDecodedLength(size_t length) throw()
+   {
+      // each byte results in at most one wide character, including the
+      // bytes of a pending sequence
+      return length + UTF8Convert::c_maxSequenceLength - 1;
+   }
+
+   /// \brief decodes a chunk of UTF-8 text
+   /// \details All bytes are consumed; a sequence that is incomplete at the
+   /// end of the chunk is kept for the next call. The destination buffer
+   /// must have space for GetMaxDecodedLength(length) characters. Returns
+   /// the number of wide characters written. When the error policy is
+   /// throwException, the decoder is reset before throwing.
+   size_t Decode(const char* src, size_t length, wchar_t* dest);
+
+   /// \brief finishes decoding at the end of the text
+   /// \details A pending incomplete sequence is handled as invalid sequence.
+   /// The destination buffer must have space for one character. Returns the
+   /// number of wide characters written.
+   size_t Finish(wchar_t* dest);
+
+   /// discards a pending incomplete sequence
+   void Reset() throw()
+   {
+      m_pendingLength = 0;
+   }
+
+private:
+   /// returns number of bytes at the end of the text that start a valid,
+   /// but incomplete sequence
+   static size_t GetIncompleteLength(const char* src, size_t length);
+
+   /// completes the pending sequence with bytes from the chunk; returns
+   /// the number of bytes used
+   size_t DecodePending(const char* src, size_t length, wchar_t* dest, size_t& destPos);
+
+   /// decodes text that doesn't end with an incomplete sequence
+   size_t DecodeComplete(const char* src, size_t length, wchar_t* dest);
+
+   /// handles an invalid sequence; returns number of wide characters written
+   size_t OnInvalidSequence(wchar_t* dest);
+
+private:
+   /// error policy
+   ErrorPolicy m_errorPolicy;
+
+   /// bytes of an incomplete sequence at the end of the last chunk
+   char m_pendingBytes[UTF8Convert::c_maxSequenceLength] = {};
+
+   /// number of pending bytes
+   size_t m_pendingLength = 0;
+};
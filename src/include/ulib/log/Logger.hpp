@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006-2014,2017 Michael Fink
+// Copyright (C) 2006-2014,2017,2026 Michael Fink
 //
 /// \file Logger.hpp logger class
 //
@@ -8,8 +8,10 @@
 
 // includes
 #include <ulib/log/Log.hpp>
+#include <ulib/CStringView.hpp>
+#include <ulib/CStringAtom.hpp>
 #include <memory>
-#include <map>
+#include <unordered_map>
 #include <set>
 
 namespace Log
@@ -33,7 +35,10 @@ namespace Log
       LoggerPtr Parent() { return m_parentLogger; }
 
       /// returns full logger name
-      CString Name();
+      CString Name() const { return m_name.GetString(); }
+
+      /// returns full logger name, as atom
+      CStringAtom NameAtom() const { return m_name; }
 
       /// sets logger level
       void Level(Log::Level level) { m_level = level; }
@@ -50,6 +55,13 @@ namespace Log
       /// returns logger with given name
       static LoggerPtr GetLogger(const CString& name);
 
+      /// returns logger with given name; C-style string version
+      static LoggerPtr GetLogger(LPCTSTR name);
+
+      /// returns logger with given name; string view version, that only
+      /// allocates when a new logger is created
+      static LoggerPtr GetLogger(CStringView name);
+
       /// adds appender to this logger
       void AddAppender(AppenderPtr appender)
       {
@@ -108,7 +120,7 @@ namespace Log
 
    private:
       /// ctor; logger can only be created by itself
-      Logger(const CString& name, LoggerPtr parentLogger);
+      Logger(CStringAtom name, LoggerPtr parentLogger);
 
       /// inits root logger
       static void InitRootLogger();
@@ -129,11 +141,11 @@ namespace Log
       /// parent
       LoggerPtr m_parentLogger;
 
-      /// logger name
-      CString m_name;
+      /// full logger name
+      CStringAtom m_name;
 
-      /// map type for child logger
-      typedef std::map<CString, LoggerPtr> T_mapLoggerMap;
+      /// map type for child logger; the key is the lower case child logger name
+      typedef std::unordered_map<CStringAtom, LoggerPtr> T_mapLoggerMap;
       /// logger name / child logger mapping
       T_mapLoggerMap m_mapChildLogger;
 
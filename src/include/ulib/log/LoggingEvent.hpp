@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006-2014,2017 Michael Fink
+// Copyright (C) 2006-2014,2017,2026 Michael Fink
 //
 /// \file LoggingEvent.hpp logging event class
 //
@@ -8,6 +8,7 @@
 
 // includes
 #include <ulib/log/Log.hpp>
+#include <ulib/CStringAtom.hpp>
 #include <ulib/DateTime.hpp>
 #include <ulib/thread/Thread.hpp>
 #include <vector>
@@ -18,8 +19,16 @@ namespace Log
    class LoggingEvent
    {
    public:
-      /// ctor
+      /// ctor; interns the logger name, so only pass names of loggers, and
+      /// not arbitrary text
       LoggingEvent(Log::Level level, const CString& loggerName, const CString& message,
+         const CString& sourceFilename, UINT sourceLine)
+         :LoggingEvent(level, CStringAtom(CStringView(loggerName)), message, sourceFilename, sourceLine)
+      {
+      }
+
+      /// ctor; takes logger name as atom
+      LoggingEvent(Log::Level level, CStringAtom loggerName, const CString& message,
          const CString& sourceFilename, UINT sourceLine)
          :m_level(level),
          m_loggerName(loggerName),
@@ -35,7 +44,10 @@ namespace Log
       Log::Level Level() const { return m_level; }
 
       /// logger name
-      CString LoggerName() const { return m_loggerName; }
+      const CString& LoggerName() const { return m_loggerName.GetString(); }
+
+      /// logger name, as atom
+      CStringAtom LoggerNameAtom() const { return m_loggerName; }
 
       /// message
       CString Message() const { return m_message; }
@@ -63,7 +75,7 @@ namespace Log
       Log::Level m_level;
 
       /// logger name
-      CString m_loggerName;
+      CStringAtom m_loggerName;
 
       /// log message
       CString m_message;
@@ -0,0 +1,163 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file AsyncFileStream.hpp asynchronous file stream
+//
+#pragma once
+
+// needed includes
+#include <ulib/stream/FileStream.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace Stream
+{
+   /// \brief asynchronous file stream
+   /// \details Reads and writes a file at given offsets, without blocking the
+   /// calling thread; the requests are carried out by worker threads, using
+   /// FileStream::ReadAt() and FileStream::WriteAt(). Completion is signaled
+   /// with a future or by calling a completion handler on the worker thread.
+   /// At most "queue depth" requests are in flight; starting more requests
+   /// blocks until one of them has completed. The buffers passed to the
+   /// requests must stay valid until the request has completed.
+   class AsyncFileStream
+   {
+   public:
+      /// completion handler; called with the number of bytes transferred, and
+      /// the exception when the request failed. Called on a worker thread;
+      /// exceptions thrown by the handler are ignored.
+      typedef std::function<void (size_t numBytesTransferred, std::exception_ptr error)> T_fnCompletion;
+
+      /// default maximum number of requests in flight
+      static const size_t c_defaultQueueDepth = 32;
+
+      /// default number of worker threads
+      static const size_t c_defaultNumThreads = 4;
+
+      /// ctor; opens or creates a file and starts the worker threads
+      AsyncFileStream(LPCTSTR filename,
+         FileStream::EFileMode fileMode,
+         FileStream::EFileAccess fileAccess,
+         FileStream::EFileShare fileShare,
+         size_t queueDepth = c_defaultQueueDepth,
+         size_t numThreads = c_defaultNumThreads);
+
+      /// copy ctor; not available
+      AsyncFileStream(const AsyncFileStream&) = delete;
+
+      /// copy assignment operator; not available
+      AsyncFileStream& operator=(const AsyncFileStream&) = delete;
+
+      /// dtor; waits for all requests and closes the file
+      ~AsyncFileStream();
+
+      /// returns if the file is open
+      bool IsOpen() const { return m_fileStream.IsOpen(); }
+
+      /// returns maximum number of requests in flight
+      size_t QueueDepth() const { return m_queueDepth; }
+
+      /// \brief starts reading at given offset; the future returns the number of bytes read
+      /// \details Fewer bytes are only read at the end of the file. Errors are
+      /// returned as StreamException by the future.
+      std::future<size_t> ReadAsync(ULONGLONG offset, std::span<std::byte> buffer);
+
+      /// starts reading at given offset; calls the completion handler when done
+      void ReadAsync(ULONGLONG offset, std::span<std::byte> buffer, T_fnCompletion fnCompletion);
+
+      /// \brief starts writing at given offset; the future returns the number of bytes written
+      /// \details Errors are returned as StreamException by the future.
+      std::future<size_t> WriteAsync(ULONGLONG offset, std::span<const std::byte> data);
+
+      /// starts writing at given offset; calls the completion handler when done
+      void WriteAsync(ULONGLONG offset, std::span<const std::byte> data, T_fnCompletion fnCompletion);
+
+      /// \brief waits until all started requests have completed
+      /// \details All completion handlers have returned when Drain() returns.
+      /// Must not be called from a completion handler.
+      void Drain();
+
+      /// waits until all started requests have completed, then flushes the file
+      void Flush();
+
+      /// waits until all started requests have completed, then stops the
+      /// worker threads and closes the file
+      void Close();
+
+   private:
+      /// read or write request
+      struct Request
+      {
+         /// indicates if the request writes data
+         bool m_isWrite = false;
+
+         /// file offset
+         ULONGLONG m_offset = 0;
+
+         /// buffer to read into or to write from
+         std::byte* m_buffer = nullptr;
+
+         /// length of buffer
+         size_t m_length = 0;
+
+         /// completion handler
+         T_fnCompletion m_fnCompletion;
+      };
+
+      /// adds request to the queue; waits while the queue is full
+      void Submit(Request&& request);
+
+      /// carries out request; returns number of bytes transferred
+      size_t Execute(const Request& request);
+
+      /// worker thread function
+      void WorkerThread();
+
+      /// stops and joins worker threads
+      void StopThreads();
+
+   private:
+      /// file stream; ReadAt() and WriteAt() can be called from multiple threads
+      FileStream m_fileStream;
+
+      /// maximum number of requests in flight
+      size_t m_queueDepth;
+
+      /// mutex protecting the request queue and counters
+      std::mutex m_mutex;
+
+      /// signaled when a request was added to the queue, or the threads should stop
+      std::condition_variable m_requestAvailable;
+
+      /// signaled when a request in flight has been carried out
+      std::condition_variable m_queueNotFull;
+
+      /// signaled when all requests have completed
+      std::condition_variable m_allCompleted;
+
+      /// queued requests, not yet picked up by a worker thread
+      std::deque<Request> m_requests;
+
+      /// number of requests that are queued or being carried out
+      size_t m_numInFlight = 0;
+
+      /// number of requests whose completion handler hasn't returned yet
+      size_t m_numPending = 0;
+
+      /// indicates if the worker threads should stop
+      bool m_stopThreads = false;
+
+      /// worker threads
+      std::vector<std::thread> m_threads;
+   };
+
+} // namespace Stream
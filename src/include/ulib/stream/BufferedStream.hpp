@@ -0,0 +1,152 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file BufferedStream.hpp buffered stream
+//
+#pragma once
+
+// needed includes
+#include <ulib/stream/IStream.hpp>
+#include <vector>
+
+namespace Stream
+{
+   /// \brief buffered stream
+   /// \details Wraps another stream and reads and writes it in large blocks,
+   /// using separate read and write buffers; reading and writing single bytes
+   /// then only accesses the buffers. Only one of the buffers contains data
+   /// at any time; switching between reading and writing, seeking and
+   /// flushing writes out the write buffer. Seeking inside the read buffer
+   /// keeps the buffer. A buffer size of 0 disables buffering for reading or
+   /// writing.
+   class BufferedStream : public IStream
+   {
+   public:
+      /// default size of read and write buffers
+      static const size_t c_defaultBufferSize = 64 * 1024;
+
+      /// ctor; the stream must live longer than the buffered stream
+      explicit BufferedStream(IStream& stream,
+         size_t readBufferSize = c_defaultBufferSize,
+         size_t writeBufferSize = c_defaultBufferSize);
+
+      /// dtor; writes out the write buffer
+      virtual ~BufferedStream();
+
+      /// returns underlying stream
+      IStream& Stream() { return m_stream; }
+
+      // virtual methods from IStream
+
+      /// returns if the underlying stream can be read
+      virtual bool CanRead() const override { return m_stream.CanRead(); }
+      /// returns if the underlying stream can be written
+      virtual bool CanWrite() const override { return m_stream.CanWrite(); }
+      /// returns if the underlying stream can be seeked
+      virtual bool CanSeek() const override { return m_stream.CanSeek(); }
+
+      // read support
+      virtual bool Read(void* buffer, DWORD maxBufferLength, DWORD& numBytesRead) override;
+
+      /// reads one byte; only accesses the underlying stream when the read buffer is empty
+      virtual BYTE ReadByte() override final
+      {
+         if (m_readPos < m_readLength)
+            return m_readBuffer[m_readPos++];
+
+         return ReadByteUnbuffered();
+      }
+
+      /// returns bytes directly from the read buffer, when it contains enough bytes
+      virtual const BYTE* ReadDirect(DWORD length) override
+      {
+         if (m_readLength - m_readPos < length)
+            return nullptr;
+
+         const BYTE* data = m_readBuffer.data() + m_readPos;
+         m_readPos += length;
+         return data;
+      }
+
+      /// returns true when the stream end is reached and the read buffer is
+      /// empty; bytes in the write buffer aren't considered
+      virtual bool AtEndOfStream() const override;
+
+      // write support
+      virtual void Write(const void* dataToWrite, DWORD lengthInBytes, DWORD& numBytesWritten) override;
+
+      /// writes one byte; only accesses the underlying stream when the write buffer is full
+      virtual void WriteByte(BYTE byteToWrite) override final
+      {
+         if (m_writeLength < m_writeCapacity)
+            m_writeBuffer[m_writeLength++] = byteToWrite;
+         else
+            WriteByteUnbuffered(byteToWrite);
+      }
+
+      // seek support
+      virtual ULONGLONG Seek(LONGLONG seekOffset, ESeekOrigin origin) override;
+      virtual ULONGLONG Position() override;
+      virtual ULONGLONG Length() override;
+
+      /// writes out the write buffer and flushes the underlying stream
+      virtual void Flush() override;
+
+      /// writes out the write buffer and closes the underlying stream
+      virtual void Close() override;
+
+   private:
+      /// reads one byte when the read buffer is empty
+      BYTE ReadByteUnbuffered();
+
+      /// writes one byte when the write buffer is full or not in use
+      void WriteByteUnbuffered(BYTE byteToWrite);
+
+      /// copies bytes from the read buffer; returns number of bytes copied
+      size_t CopyFromReadBuffer(BYTE* buffer, size_t maxBufferLength);
+
+      /// fills the read buffer; returns false when no bytes could be read
+      bool FillReadBuffer();
+
+      /// discards the read buffer and moves the underlying stream back to
+      /// the position of the next unread byte
+      void DiscardReadBuffer();
+
+      /// writes out the write buffer to the underlying stream
+      void FlushWriteBuffer();
+
+      /// prepares the write buffer for writing
+      void StartWriting();
+
+   private:
+      /// underlying stream
+      IStream& m_stream;
+
+      /// read buffer
+      std::vector<BYTE> m_readBuffer;
+
+      /// size of read buffer
+      size_t m_readBufferSize;
+
+      /// number of valid bytes in the read buffer
+      size_t m_readLength = 0;
+
+      /// position of the next byte to read in the read buffer
+      size_t m_readPos = 0;
+
+      /// write buffer
+      std::vector<BYTE> m_writeBuffer;
+
+      /// size of write buffer
+      size_t m_writeBufferSize;
+
+      /// number of bytes in the write buffer
+      size_t m_writeLength = 0;
+
+      /// number of bytes that can currently be stored in the write buffer;
+      /// 0 while the read buffer is in use
+      size_t m_writeCapacity = 0;
+   };
+
+} // namespace Stream
@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006,2007,2008,2014,2017 Michael Fink
+// Copyright (C) 2006,2007,2008,2014,2017,2026 Michael Fink
 //
 /// \file EndianAwareFilter.hpp filter for reading/writing little and big endian values
 //
@@ -11,7 +11,10 @@
 
 namespace Stream
 {
-   /// stream filter for reading/writing endian aware WORD and DWORD values
+   /// \brief stream filter for reading/writing endian aware WORD and DWORD values
+   /// \details Values are read directly from the stream's bytes when the
+   /// stream supports IStream::ReadDirect(). Each value is written with a
+   /// single IStream::Write() call.
    class EndianAwareFilter
    {
    public:
@@ -26,6 +29,10 @@ namespace Stream
       {
          ATLASSERT(true == m_stream.CanRead());
 
+         const BYTE* data = m_stream.ReadDirect(2);
+         if (data != nullptr)
+            return static_cast<WORD>(data[0] | (data[1] << 8));
+
          WORD w = m_stream.ReadByte(); // low-byte
          w |= static_cast<WORD>(m_stream.ReadByte()) << 8; // high-byte
          return w;
@@ -36,6 +43,10 @@ namespace Stream
       {
          ATLASSERT(true == m_stream.CanRead());
 
+         const BYTE* data = m_stream.ReadDirect(2);
+         if (data != nullptr)
+            return static_cast<WORD>((data[0] << 8) | data[1]);
+
          WORD w = static_cast<WORD>(m_stream.ReadByte()) << 8; // high-byte
          w |= m_stream.ReadByte(); // low-byte
          return w;
@@ -46,6 +57,11 @@ namespace Stream
       {
          ATLASSERT(true == m_stream.CanRead());
 
+         const BYTE* data = m_stream.ReadDirect(4);
+         if (data != nullptr)
+            return static_cast<DWORD>(data[0]) | (static_cast<DWORD>(data[1]) << 8) |
+               (static_cast<DWORD>(data[2]) << 16) | (static_cast<DWORD>(data[3]) << 24);
+
          DWORD dw = Read16LE(); // low-word
          dw |= static_cast<DWORD>(Read16LE()) << 16; // high-word
          return dw;
@@ -56,6 +72,11 @@ namespace Stream
       {
          ATLASSERT(true == m_stream.CanRead());
 
+         const BYTE* data = m_stream.ReadDirect(4);
+         if (data != nullptr)
+            return (static_cast<DWORD>(data[0]) << 24) | (static_cast<DWORD>(data[1]) << 16) |
+               (static_cast<DWORD>(data[2]) << 8) | static_cast<DWORD>(data[3]);
+
          DWORD dw = static_cast<DWORD>(Read16BE()) << 16; // low-word
          dw |= Read16BE(); // high-word
          return dw;
@@ -64,37 +85,64 @@ namespace Stream
       /// writes 16-bit word, little endian format (or host byte order)
       void Write16LE(WORD w)
       {
-         ATLASSERT(true == m_stream.CanWrite());
+         const BYTE data[2] =
+         {
+            static_cast<BYTE>(w & 0xff), // low-byte
+            static_cast<BYTE>((w >> 8) & 0xff), // high-byte
+         };
 
-         m_stream.WriteByte(static_cast<BYTE>(w & 0xff)); // low-byte
-         m_stream.WriteByte(static_cast<BYTE>((w >> 8) & 0xff)); // high-byte
+         WriteBytes(data, sizeof(data));
       }
 
       /// writes 16-bit word, big endian format (or network byte order)
       void Write16BE(WORD w)
       {
-         ATLASSERT(true == m_stream.CanWrite());
+         const BYTE data[2] =
+         {
+            static_cast<BYTE>((w >> 8) & 0xff), // high-byte
+            static_cast<BYTE>(w & 0xff), // low-byte
+         };
 
-         m_stream.WriteByte(static_cast<BYTE>((w >> 8) & 0xff)); // high-byte
-         m_stream.WriteByte(static_cast<BYTE>(w & 0xff)); // low-byte
+         WriteBytes(data, sizeof(data));
       }
 
       /// writes 32-bit word, little endian format (or host byte order)
       void Write32LE(DWORD dw)
       {
-         ATLASSERT(true == m_stream.CanWrite());
-
-         Write16LE(static_cast<WORD>(dw & 0xffff)); // low-word
-         Write16LE(static_cast<WORD>((dw >> 16) & 0xffff)); // high-word
+         const BYTE data[4] =
+         {
+            static_cast<BYTE>(dw & 0xff), // low-word
+            static_cast<BYTE>((dw >> 8) & 0xff),
+            static_cast<BYTE>((dw >> 16) & 0xff), // high-word
+            static_cast<BYTE>((dw >> 24) & 0xff),
+         };
+
+         WriteBytes(data, sizeof(data));
       }
 
       /// writes 32-bit word, big endian format (or network byte order)
       void Write32BE(DWORD dw)
+      {
+         const BYTE data[4] =
+         {
+            static_cast<BYTE>((dw >> 24) & 0xff), // high-word
+            static_cast<BYTE>((dw >> 16) & 0xff),
+            static_cast<BYTE>((dw >> 8) & 0xff), // low-word
+            static_cast<BYTE>(dw & 0xff),
+         };
+
+         WriteBytes(data, sizeof(data));
+      }
+
+   private:
+      /// writes all bytes of a value with a single write call
+      void WriteBytes(const BYTE* data, DWORD length)
       {
          ATLASSERT(true == m_stream.CanWrite());
 
-         Write16BE(static_cast<WORD>((dw >> 16) & 0xffff)); // high-word
-         Write16BE(static_cast<WORD>(dw & 0xffff)); // low-word
+         DWORD numBytesWritten = 0;
+         m_stream.Write(data, length, numBytesWritten);
+         ATLASSERT(numBytesWritten == length);
       }
 
    private:
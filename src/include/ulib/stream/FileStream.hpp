@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006,2007,2008,2012,2014,2017 Michael Fink
+// Copyright (C) 2006,2007,2008,2012,2014,2017,2026 Michael Fink
 //
 /// \file FileStream.hpp file based stream
 //
@@ -9,10 +9,14 @@
 // needed includes
 #include <ulib/stream/IStream.hpp>
 #include <memory>
+#include <atomic>
 
 namespace Stream
 {
-   /// file stream
+   /// \brief file stream
+   /// \details Uses Win32 file handles on Windows and POSIX file descriptors
+   /// on other platforms. Neither implementation buffers data, so reading or
+   /// writing single bytes should be done through a BufferedStream.
    class FileStream : public IStream
    {
    public:
@@ -48,6 +52,12 @@ namespace Stream
       /// ctor; opens or creates a file
       FileStream(LPCTSTR filename, EFileMode fileMode, EFileAccess fileAccess, EFileShare fileShare);
 
+      /// copy ctor; the copy shares the file handle
+      FileStream(const FileStream& other);
+
+      /// copy assignment operator; the stream then shares the file handle
+      FileStream& operator=(const FileStream& other);
+
       /// returns if the file was successfully opened
       bool IsOpen() const { return m_spHandle.get() != nullptr; }
 
@@ -62,11 +72,39 @@ namespace Stream
 
       // read support
       virtual bool Read(void* buffer, DWORD maxBufferLength, DWORD& numBytesRead);
+
+      /// reads data; uses a single syscall on POSIX platforms, unless the
+      /// read is interrupted, and one per 2 GiB block on Windows
+      virtual size_t ReadSpan(std::span<std::byte> buffer);
+
+      /// reads data into multiple buffers; uses preadv() on POSIX platforms
+      virtual size_t ReadV(std::span<const std::span<std::byte>> buffers);
+
       virtual bool AtEndOfStream() const;
 
+      /// \brief reads at given position; can be called from multiple threads at once
+      /// \details Uses pread() on POSIX platforms. On Windows, ReadFile() with
+      /// an offset moves the file pointer, so ReadAt() restores it afterwards;
+      /// the current position is only kept when no other thread uses the
+      /// stream at the same time.
+      virtual bool ReadAt(ULONGLONG offset, void* buffer, DWORD maxBufferLength, DWORD& numBytesRead);
+
       // write support
       virtual void Write(const void* dataToWrite, DWORD lengthInBytes, DWORD& numBytesWritten);
 
+      /// writes data; see ReadSpan() for the number of syscalls
+      virtual size_t WriteSpan(std::span<const std::byte> data);
+
+      /// \brief writes data from multiple buffers; uses pwritev() on POSIX platforms
+      /// \details WriteFileGather() can't be used on Windows, since it needs
+      /// unbuffered file access and page sized buffers, so the buffers are
+      /// written one after the other there.
+      virtual size_t WriteV(std::span<const std::span<const std::byte>> buffers);
+
+      /// \brief writes at given position; can be called from multiple threads at once
+      /// \details Uses pwrite() on POSIX platforms; see ReadAt() for Windows.
+      virtual void WriteAt(ULONGLONG offset, const void* dataToWrite, DWORD lengthInBytes, DWORD& numBytesWritten);
+
       // seek support
       virtual ULONGLONG Seek(LONGLONG seekOffset, ESeekOrigin origin);
       virtual ULONGLONG Position();
@@ -75,18 +113,41 @@ namespace Stream
       virtual void Flush();
       virtual void Close();
 
+   private:
+#ifndef WIN32
+      /// updates position and file length after writing at the current position
+      void UpdatePositionAfterWrite(size_t numBytesWritten);
+#endif
+
+      /// extends cached file length to given end position, if it's larger
+      void ExtendFileLength(ULONGLONG endPosition);
+
    private:
       /// file access mode
       EFileAccess m_fileAccess;
 
+#ifdef WIN32
       /// handle to file
       std::shared_ptr<void> m_spHandle;
+#else
+      /// file descriptor; shared by copies of the stream
+      std::shared_ptr<int> m_spHandle;
+
+      /// indicates if file was opened in append mode
+      bool m_appendMode = false;
+
+      /// current file position; tracked here instead of using the file
+      /// descriptor's offset, so that no syscall is needed to get it
+      ULONGLONG m_position = 0;
+#endif
 
       /// indicates if end of file is reached
       bool m_atEndOfFile;
 
-      /// file length
-      mutable ULONGLONG m_fileLength;
+      /// file length; determined when opening the file and kept up to date
+      /// when writing. Atomic, since WriteAt() may update it from multiple
+      /// threads, while other methods read it.
+      mutable std::atomic<ULONGLONG> m_fileLength;
    };
 
 } // namespace Stream
@@ -1,11 +1,17 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006,2007,2008,2012,2014,2017,2020 Michael Fink
+// Copyright (C) 2006,2007,2008,2012,2014,2017,2020,2026 Michael Fink
 //
 /// \file IStream.hpp stream interface
 //
 #pragma once
 
+// needed includes
+#include <ulib/stream/StreamException.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <span>
+
 /// \brief stream related classes
 namespace Stream
 {
@@ -43,6 +49,39 @@ namespace Stream
       /// reads one byte
       virtual BYTE ReadByte();
 
+      /// \brief reads data into given buffer, which may be larger than 4 GiB
+      /// \details Returns the number of bytes read; fewer bytes than the
+      /// buffer size are only read at the end of the stream. The default
+      /// implementation calls Read() in blocks.
+      virtual size_t ReadSpan(std::span<std::byte> buffer);
+
+      /// \brief reads exactly the size of the given buffer
+      /// \exception StreamException thrown when the stream ends before
+      void ReadExactly(std::span<std::byte> buffer);
+
+      /// \brief reads data into multiple buffers, one after the other
+      /// \details Returns the total number of bytes read; fewer bytes are
+      /// only read at the end of the stream. The default implementation
+      /// calls ReadSpan() for each buffer.
+      virtual size_t ReadV(std::span<const std::span<std::byte>> buffers);
+
+      /// \brief reads bytes without copying them, when the stream supports it
+      /// \details Returns a pointer to the next length bytes and advances the
+      /// position, or returns nullptr without advancing when the stream
+      /// doesn't support direct access or fewer bytes are available. The
+      /// bytes stay valid until the next call of a stream method.
+      virtual const BYTE* ReadDirect(DWORD length)
+      {
+         (void)length;
+         return nullptr;
+      }
+
+      /// \brief reads amount of data at given position into given buffer
+      /// \details Doesn't use the current position. The default implementation
+      /// seeks to the position, reads and seeks back; streams that override
+      /// it document if it can be called from multiple threads at once.
+      virtual bool ReadAt(ULONGLONG offset, void* buffer, DWORD maxBufferLength, DWORD& numBytesRead);
+
       /// returns true when the stream end is reached
       virtual bool AtEndOfStream() const = 0;
 
@@ -53,6 +92,20 @@ namespace Stream
       /// writes out single byte
       virtual void WriteByte(BYTE byteToWrite);
 
+      /// \brief writes out given data, which may be larger than 4 GiB
+      /// \details Returns the number of bytes written. The default
+      /// implementation calls Write() in blocks.
+      virtual size_t WriteSpan(std::span<const std::byte> data);
+
+      /// \brief writes out data from multiple buffers, one after the other
+      /// \details Returns the total number of bytes written. The default
+      /// implementation calls WriteSpan() for each buffer.
+      virtual size_t WriteV(std::span<const std::span<const std::byte>> buffers);
+
+      /// \brief writes out given data buffer at given position
+      /// \details Doesn't use the current position; see ReadAt().
+      virtual void WriteAt(ULONGLONG offset, const void* dataToWrite, DWORD lengthInBytes, DWORD& numBytesWritten);
+
       // seek support
 
       /// seeks to given position, regarding given origin
@@ -76,6 +129,68 @@ namespace Stream
       return byteToRead;
    }
 
+   /// maximum number of bytes passed to Read() and Write() at once by
+   /// ReadSpan() and WriteSpan()
+   const size_t c_maxSpanBlockSize = 0x80000000;
+
+   inline size_t IStream::ReadSpan(std::span<std::byte> buffer)
+   {
+      size_t totalBytesRead = 0;
+      while (totalBytesRead < buffer.size())
+      {
+         size_t blockSize = std::min(buffer.size() - totalBytesRead, c_maxSpanBlockSize);
+
+         DWORD numBytesRead = 0;
+         if (!Read(buffer.data() + totalBytesRead, static_cast<DWORD>(blockSize), numBytesRead) ||
+            numBytesRead == 0)
+            break;
+
+         totalBytesRead += numBytesRead;
+      }
+
+      return totalBytesRead;
+   }
+
+   inline void IStream::ReadExactly(std::span<std::byte> buffer)
+   {
+      // don't rely on ReadSpan() filling the whole buffer in one call
+      size_t totalBytesRead = 0;
+      while (totalBytesRead < buffer.size())
+      {
+         size_t numBytesRead = ReadSpan(buffer.subspan(totalBytesRead));
+         if (numBytesRead == 0)
+            throw Stream::StreamException(_T("ReadExactly: end of stream reached"), __FILE__, __LINE__);
+
+         totalBytesRead += numBytesRead;
+      }
+   }
+
+   inline size_t IStream::ReadV(std::span<const std::span<std::byte>> buffers)
+   {
+      size_t totalBytesRead = 0;
+      for (std::span<std::byte> buffer : buffers)
+      {
+         size_t numBytesRead = ReadSpan(buffer);
+         totalBytesRead += numBytesRead;
+
+         if (numBytesRead < buffer.size())
+            break;
+      }
+
+      return totalBytesRead;
+   }
+
+   inline bool IStream::ReadAt(ULONGLONG offset, void* buffer, DWORD maxBufferLength, DWORD& numBytesRead)
+   {
+      ULONGLONG currentPosition = Position();
+
+      Seek(static_cast<LONGLONG>(offset), seekBegin);
+      bool ret = Read(buffer, maxBufferLength, numBytesRead);
+      Seek(static_cast<LONGLONG>(currentPosition), seekBegin);
+
+      return ret;
+   }
+
    inline void IStream::WriteByte(BYTE byteToWrite)
    {
       DWORD numBytesWritten;
@@ -83,4 +198,46 @@ namespace Stream
       ATLASSERT(1 == numBytesWritten);
    }
 
+   inline size_t IStream::WriteSpan(std::span<const std::byte> data)
+   {
+      size_t totalBytesWritten = 0;
+      while (totalBytesWritten < data.size())
+      {
+         size_t blockSize = std::min(data.size() - totalBytesWritten, c_maxSpanBlockSize);
+
+         DWORD numBytesWritten = 0;
+         Write(data.data() + totalBytesWritten, static_cast<DWORD>(blockSize), numBytesWritten);
+
+         totalBytesWritten += numBytesWritten;
+         if (numBytesWritten < blockSize)
+            break;
+      }
+
+      return totalBytesWritten;
+   }
+
+   inline size_t IStream::WriteV(std::span<const std::span<const std::byte>> buffers)
+   {
+      size_t totalBytesWritten = 0;
+      for (std::span<const std::byte> buffer : buffers)
+      {
+         size_t numBytesWritten = WriteSpan(buffer);
+         totalBytesWritten += numBytesWritten;
+
+         if (numBytesWritten < buffer.size())
+            break;
+      }
+
+      return totalBytesWritten;
+   }
+
+   inline void IStream::WriteAt(ULONGLONG offset, const void* dataToWrite, DWORD lengthInBytes, DWORD& numBytesWritten)
+   {
+      ULONGLONG currentPosition = Position();
+
+      Seek(static_cast<LONGLONG>(offset), seekBegin);
+      Write(dataToWrite, lengthInBytes, numBytesWritten);
+      Seek(static_cast<LONGLONG>(currentPosition), seekBegin);
+   }
+
 } // namespace Stream
@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2007,2008,2012,2014,2017,2020 Michael Fink
+// Copyright (C) 2007,2008,2012,2014,2017,2020,2026 Michael Fink
 //
 /// \file ITextStream.hpp text stream interface
 //
@@ -78,8 +78,8 @@ namespace Stream
       /// writes endline character
       virtual void WriteEndline() = 0;
 
-      /// writes a line
-      void WriteLine(const CString& line)
+      /// writes a line; may be overridden to write the text and the endline at once
+      virtual void WriteLine(const CString& line)
       {
          Write(line);
          WriteEndline();
@@ -0,0 +1,148 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file MappedFileStream.hpp memory mapped, read-only file stream
+//
+#pragma once
+
+// needed includes
+#include <ulib/stream/IStream.hpp>
+#include <memory>
+
+namespace Stream
+{
+   /// \brief memory mapped, read-only file stream
+   /// \details Maps a window of the file into memory and reads from it, so
+   /// that reading doesn't copy the file data through kernel buffers. View()
+   /// and ReadDirect() return pointers into the mapped window, without
+   /// copying at all. Files that are larger than the window size are mapped
+   /// one window at a time; the window slides to where the file is read.
+   class MappedFileStream : public IStream
+   {
+   public:
+      /// hint how the file is accessed
+      enum EAccessHint
+      {
+         accessNormal = 0,       ///< no special access pattern
+         accessSequential = 1,   ///< file is read sequentially; read-ahead is done aggressively
+         accessRandom = 2,       ///< file is read in random order; read-ahead is not useful
+      };
+
+      /// default size of the mapped window; large enough to map most files as a whole
+      static const size_t c_defaultWindowSize = sizeof(void*) >= 8 ? 1024 * 1024 * 1024 : 64 * 1024 * 1024;
+
+      /// ctor; opens the file and maps the first window
+      explicit MappedFileStream(LPCTSTR filename, size_t windowSize = c_defaultWindowSize);
+
+      /// copy ctor; not available
+      MappedFileStream(const MappedFileStream&) = delete;
+
+      /// copy assignment operator; not available
+      MappedFileStream& operator=(const MappedFileStream&) = delete;
+
+      /// dtor; unmaps the window and closes the file
+      virtual ~MappedFileStream();
+
+      /// returns if the file was successfully opened
+      bool IsOpen() const;
+
+      /// \brief sets access hint for the mapped windows
+      /// \details Uses madvise() on Linux and Android; the hint is ignored on Windows.
+      void SetAccessHint(EAccessHint accessHint);
+
+      /// \brief returns pointer to bytes of the file, without copying
+      /// \details Returns nullptr when the range isn't inside the file. The
+      /// pointer is valid until the next call of a method that reads from the
+      /// stream or returns a view. When the range is outside of the current
+      /// window, the window is moved, and is enlarged when the range is
+      /// larger than the window size.
+      const BYTE* View(ULONGLONG offset, size_t length);
+
+      // virtual methods from IStream
+
+      /// returns if the stream can be read (always true)
+      virtual bool CanRead() const override { return true; }
+      /// returns if the stream can be written (always false)
+      virtual bool CanWrite() const override { return false; }
+      /// returns if the stream can be seeked (always true)
+      virtual bool CanSeek() const override { return true; }
+
+      // read support
+      virtual bool Read(void* buffer, DWORD maxBufferLength, DWORD& numBytesRead) override;
+
+      /// reads one byte; only maps a new window when the position is outside of the current one
+      virtual BYTE ReadByte() override
+      {
+         if (m_position >= m_windowOffset && m_position - m_windowOffset < m_windowLength)
+            return m_window[m_position++ - m_windowOffset];
+
+         const BYTE* data = ReadDirect(1);
+         ATLASSERT(data != nullptr); // read past the end of the stream
+         return data != nullptr ? *data : 0;
+      }
+
+      virtual const BYTE* ReadDirect(DWORD length) override;
+
+      virtual bool AtEndOfStream() const override { return m_position >= m_fileLength; }
+
+      // write support
+      virtual void Write(const void* dataToWrite, DWORD lengthInBytes, DWORD& numBytesWritten) override;
+
+      // seek support
+      virtual ULONGLONG Seek(LONGLONG seekOffset, ESeekOrigin origin) override;
+      virtual ULONGLONG Position() override { return m_position; }
+      virtual ULONGLONG Length() override { return m_fileLength; }
+
+      virtual void Flush() override
+      {
+         // nothing to do for read-only stream
+      }
+
+      virtual void Close() override;
+
+   private:
+      /// maps the window containing the given range
+      void MapWindow(ULONGLONG offset, size_t length);
+
+      /// unmaps the current window
+      void UnmapWindow();
+
+      /// applies the access hint to the current window
+      void ApplyAccessHint();
+
+   private:
+#ifdef WIN32
+      /// file handle
+      std::shared_ptr<void> m_spFile;
+
+      /// file mapping handle
+      std::shared_ptr<void> m_spMapping;
+#else
+      /// file descriptor
+      int m_fd = -1;
+#endif
+
+      /// file length
+      ULONGLONG m_fileLength = 0;
+
+      /// current position
+      ULONGLONG m_position = 0;
+
+      /// size of the mapped windows
+      size_t m_windowSize;
+
+      /// start of the current window, or nullptr when no window is mapped
+      const BYTE* m_window = nullptr;
+
+      /// file offset of the current window
+      ULONGLONG m_windowOffset = 0;
+
+      /// length of the current window
+      size_t m_windowLength = 0;
+
+      /// access hint
+      EAccessHint m_accessHint = accessNormal;
+   };
+
+} // namespace Stream
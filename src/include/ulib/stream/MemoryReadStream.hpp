@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006,2007,2008,2017 Michael Fink
+// Copyright (C) 2006,2007,2008,2017,2026 Michael Fink
 //
 /// \file MemoryReadStream.hpp memory read-only stream
 //
@@ -38,6 +38,36 @@ namespace Stream
          return numBytesRead != 0;
       }
 
+      /// reads data with a single copy
+      virtual size_t ReadSpan(std::span<std::byte> buffer) override
+      {
+         size_t numBytesRead = std::min<size_t>(buffer.size(), m_length - m_currentPos);
+         if (numBytesRead > 0)
+            memcpy(buffer.data(), m_dataPtr + m_currentPos, numBytesRead);
+         m_currentPos += numBytesRead;
+         return numBytesRead;
+      }
+
+      virtual const BYTE* ReadDirect(DWORD length) override
+      {
+         if (m_length - m_currentPos < length)
+            return nullptr;
+
+         const BYTE* data = m_dataPtr + m_currentPos;
+         m_currentPos += length;
+         return data;
+      }
+
+      /// reads at given position; can be called from multiple threads at once
+      virtual bool ReadAt(ULONGLONG offset, void* buffer, DWORD maxBufferLength, DWORD& numBytesRead) override
+      {
+         ULONGLONG available = offset < m_length ? m_length - offset : 0;
+         numBytesRead = available > maxBufferLength ? maxBufferLength : static_cast<DWORD>(available);
+         if (numBytesRead > 0)
+            memcpy(buffer, m_dataPtr + offset, numBytesRead);
+         return numBytesRead != 0;
+      }
+
       virtual bool AtEndOfStream() const override
       {
          return m_currentPos >= m_length;
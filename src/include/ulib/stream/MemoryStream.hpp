@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006,2007,2008,2012,2014,2017 Michael Fink
+// Copyright (C) 2006,2007,2008,2012,2014,2017,2026 Michael Fink
 //
 /// \file MemoryStream.hpp memory read-write stream
 //
@@ -40,13 +40,42 @@ namespace Stream
 
       virtual bool Read(void* buffer, DWORD maxBufferLength, DWORD& numBytesRead)
       {
-         numBytesRead = m_memoryData.size() - m_currentPos > maxBufferLength ? maxBufferLength :
-            static_cast<DWORD>(m_memoryData.size() - m_currentPos);
+         numBytesRead = static_cast<DWORD>(
+            ReadSpan(std::span<std::byte>(static_cast<std::byte*>(buffer), maxBufferLength)));
+         return numBytesRead != 0;
+      }
+
+      /// reads data with a single copy
+      virtual size_t ReadSpan(std::span<std::byte> buffer)
+      {
+         size_t available = m_currentPos < m_memoryData.size() ? m_memoryData.size() - m_currentPos : 0;
+         size_t numBytesRead = std::min(buffer.size(), available);
          if (numBytesRead > 0)
          {
-            memcpy(buffer, &m_memoryData[m_currentPos], numBytesRead);
+            memcpy(buffer.data(), m_memoryData.data() + m_currentPos, numBytesRead);
             m_currentPos += numBytesRead;
          }
+         return numBytesRead;
+      }
+
+      virtual const BYTE* ReadDirect(DWORD length)
+      {
+         if (m_currentPos > m_memoryData.size() || m_memoryData.size() - m_currentPos < length)
+            return nullptr;
+
+         const BYTE* data = m_memoryData.data() + m_currentPos;
+         m_currentPos += length;
+         return data;
+      }
+
+      /// reads at given position; can be called from multiple threads at once,
+      /// as long as no write extends the stream at the same time
+      virtual bool ReadAt(ULONGLONG offset, void* buffer, DWORD maxBufferLength, DWORD& numBytesRead)
+      {
+         ULONGLONG available = offset < m_memoryData.size() ? m_memoryData.size() - offset : 0;
+         numBytesRead = available > maxBufferLength ? maxBufferLength : static_cast<DWORD>(available);
+         if (numBytesRead > 0)
+            memcpy(buffer, m_memoryData.data() + offset, numBytesRead);
          return numBytesRead != 0;
       }
 
@@ -54,14 +83,60 @@ namespace Stream
 
       /// \exception std::exception when resizing vector fails
       virtual void Write(const void* dataToWrite, DWORD lengthInBytes, DWORD& numBytesWritten)
+      {
+         numBytesWritten = static_cast<DWORD>(
+            WriteSpan(std::span<const std::byte>(static_cast<const std::byte*>(dataToWrite), lengthInBytes)));
+      }
+
+      /// writes data with a single resize and copy
+      /// \exception std::exception when resizing vector fails
+      virtual size_t WriteSpan(std::span<const std::byte> data)
       {
          // add at current pos
-         if (m_memoryData.size() < m_currentPos + lengthInBytes)
-            m_memoryData.resize(m_currentPos + lengthInBytes);
+         if (m_memoryData.size() < m_currentPos + data.size())
+            m_memoryData.resize(m_currentPos + data.size());
+
+         if (!data.empty())
+            memcpy(m_memoryData.data() + m_currentPos, data.data(), data.size());
+         m_currentPos += data.size();
+         return data.size();
+      }
+
+      /// writes data from multiple buffers, with a single resize
+      /// \exception std::exception when resizing vector fails
+      virtual size_t WriteV(std::span<const std::span<const std::byte>> buffers)
+      {
+         size_t totalLength = 0;
+         for (std::span<const std::byte> buffer : buffers)
+            totalLength += buffer.size();
+
+         if (m_memoryData.size() < m_currentPos + totalLength)
+            m_memoryData.resize(m_currentPos + totalLength);
+
+         for (std::span<const std::byte> buffer : buffers)
+         {
+            if (!buffer.empty())
+               memcpy(m_memoryData.data() + m_currentPos, buffer.data(), buffer.size());
+            m_currentPos += buffer.size();
+         }
+
+         return totalLength;
+      }
+
+      /// \brief writes at given position
+      /// \details Can be called from multiple threads at once, as long as the
+      /// written ranges are inside the stream and don't overlap; writing
+      /// beyond the end resizes the stream and must not be done concurrently.
+      /// \exception std::exception when resizing vector fails
+      virtual void WriteAt(ULONGLONG offset, const void* dataToWrite, DWORD lengthInBytes, DWORD& numBytesWritten)
+      {
+         size_t position = static_cast<size_t>(offset);
+         if (m_memoryData.size() < position + lengthInBytes)
+            m_memoryData.resize(position + lengthInBytes);
 
-         memcpy(&m_memoryData[m_currentPos], dataToWrite, lengthInBytes);
+         if (lengthInBytes > 0)
+            memcpy(m_memoryData.data() + position, dataToWrite, lengthInBytes);
          numBytesWritten = lengthInBytes;
-         m_currentPos += numBytesWritten;
       }
 
       virtual ULONGLONG Seek(LONGLONG seekOffset, ESeekOrigin origin)
@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006,2007,2008,2017,2020 Michael Fink
+// Copyright (C) 2006,2007,2008,2017,2020,2026 Michael Fink
 //
 /// \file NullStream.hpp null stream
 //
@@ -26,6 +26,12 @@ namespace Stream
          return true;
       }
 
+      virtual size_t ReadSpan(std::span<std::byte> buffer) override
+      {
+         std::fill(buffer.begin(), buffer.end(), std::byte{ 0 });
+         return buffer.size();
+      }
+
       virtual BYTE ReadByte() override { return 0; }
       virtual bool AtEndOfStream() const override { return false; }
       virtual void Write(const void*, DWORD numBytesToWrite, DWORD& numBytesWritten) override
@@ -33,6 +39,7 @@ namespace Stream
          numBytesWritten = numBytesToWrite;
       }
 
+      virtual size_t WriteSpan(std::span<const std::byte> data) override { return data.size(); }
       virtual void WriteByte(BYTE) override { /* nothing to do here */ }
       virtual ULONGLONG Seek(LONGLONG, IStream::ESeekOrigin) override { return Position(); }
       virtual ULONGLONG Position() override { return 0; }
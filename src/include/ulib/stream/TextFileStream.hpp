@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006,2007,2008,2012,2014,2017,2020 Michael Fink
+// Copyright (C) 2006,2007,2008,2012,2014,2017,2020,2026 Michael Fink
 //
 /// \file TextFileStream.hpp text file stream
 //
@@ -8,11 +8,14 @@
 
 // needed includes
 #include <ulib/stream/FileStream.hpp>
+#include <ulib/stream/BufferedStream.hpp>
 #include <ulib/stream/TextStreamFilter.hpp>
 
 namespace Stream
 {
-   /// text file stream
+   /// \brief text file stream
+   /// \details The file is read and written using a BufferedStream; pass a
+   /// buffer size of 0 to access the file directly.
    class TextFileStream : public TextStreamFilter
    {
    public:
@@ -22,9 +25,11 @@ namespace Stream
          FileStream::EFileAccess fileAccess,
          FileStream::EFileShare fileShare,
          ITextStream::ETextEncoding textEncoding = textEncodingNative,
-         ITextStream::ELineEndingMode lineEndingMode = lineEndingCRLF)
-         :TextStreamFilter(m_fileStream, textEncoding, lineEndingMode),
-         m_fileStream(filename, fileMode, fileAccess, fileShare)
+         ITextStream::ELineEndingMode lineEndingMode = lineEndingCRLF,
+         size_t bufferSize = BufferedStream::c_defaultBufferSize)
+         :TextStreamFilter(m_bufferedStream, textEncoding, lineEndingMode),
+         m_fileStream(filename, fileMode, fileAccess, fileShare),
+         m_bufferedStream(m_fileStream, bufferSize, bufferSize)
       {
       }
 
@@ -36,12 +41,13 @@ namespace Stream
 
       /// returns if the file was successfully opened
       bool IsOpen() const { return m_fileStream.IsOpen(); }
-      /// returns true when the file end is reached
-      virtual bool AtEndOfStream() const override { return m_fileStream.AtEndOfStream(); }
 
    private:
       /// file stream
       FileStream m_fileStream;
+
+      /// buffered stream for accessing the file stream
+      BufferedStream m_bufferedStream;
    };
 
 } // namespace Stream
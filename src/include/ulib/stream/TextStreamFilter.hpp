@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006,2007,2008,2009,2012,2014,2017,2020 Michael Fink
+// Copyright (C) 2006,2007,2008,2009,2012,2014,2017,2020,2026 Michael Fink
 //
 /// \file TextStreamFilter.hpp text stream filter
 //
@@ -9,6 +9,9 @@
 // needed includes
 #include <ulib/stream/IStream.hpp>
 #include <ulib/stream/ITextStream.hpp>
+#include <ulib/UTF8Decoder.hpp>
+#include <string>
+#include <vector>
 
 namespace Stream
 {
@@ -33,6 +36,9 @@ namespace Stream
       /// writes endline character
       virtual void WriteEndline() override;
 
+      /// writes a line; the text and the endline are written with a single IStream::WriteV() call
+      virtual void WriteLine(const CString& line) override;
+
       /// returns underlying stream (const version)
       const IStream& Stream() const { return m_stream; }
 
@@ -45,8 +51,8 @@ namespace Stream
       /// returns true when stream can be written to
       virtual bool CanWrite() const override { return m_stream.CanWrite(); }
 
-      /// returns true when the stream end is reached
-      virtual bool AtEndOfStream() const override { return m_stream.AtEndOfStream(); }
+      /// returns true when the stream end is reached, and all read characters were returned
+      virtual bool AtEndOfStream() const override;
 
       /// flushes out text stream
       virtual void Flush() override { m_stream.Flush(); }
@@ -55,6 +61,21 @@ namespace Stream
       /// puts back one character
       void PutBackChar(TCHAR ch);
 
+      /// reads next character of UTF-8 encoded text
+      TCHAR ReadCharUTF8();
+
+      /// reads and decodes the next block of UTF-8 encoded text; returns false at end of stream
+      bool ReadBlockUTF8();
+
+      /// reads next block of bytes, directly from the stream when possible; returns nullptr at end of stream
+      const BYTE* ReadBlock(DWORD& numBytesRead);
+
+      /// returns the endline characters for the line ending mode
+      LPCTSTR GetLineEnding() const;
+
+      /// encodes text in the text encoding, replacing the buffer contents
+      void EncodeText(const CString& text, std::string& buffer) const;
+
    private:
       /// stream to read from / write to
       IStream& m_stream;
@@ -64,6 +85,27 @@ namespace Stream
 
       /// the put back character
       TCHAR m_putBackChar;
+
+      /// buffer for encoded text to write; kept to reuse its memory
+      std::string m_writeBuffer;
+
+      /// buffer for the encoded endline, written by WriteLine()
+      std::string m_lineEndingBuffer;
+
+      /// decoder for UTF-8 encoded text
+      UTF8Decoder m_utf8Decoder;
+
+      /// buffer for bytes read from the stream, when the stream doesn't support direct access
+      std::vector<BYTE> m_readBuffer;
+
+      /// characters decoded from the last read block
+      std::vector<wchar_t> m_decodedChars;
+
+      /// number of valid characters in m_decodedChars
+      size_t m_decodedLength = 0;
+
+      /// position of the next character to return in m_decodedChars
+      size_t m_decodedPos = 0;
    };
 
 } // namespace Stream
@@ -1,11 +1,17 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2020 Michael Fink
+// Copyright (C) 2020,2026 Michael Fink
 //
 /// \file ulib.hpp all ulib includes
 //
 #pragma once
 
+#include <ulib/CStringAtom.hpp>
+#include <ulib/CStringReplacer.hpp>
+#include <ulib/CStringStats.hpp>
+#include <ulib/CStringU8.hpp>
+#include <ulib/CStringView.hpp>
+#include <ulib/CharConvert.hpp>
 #include <ulib/CommandLineParser.hpp>
 #include <ulib/CrashReporter.hpp>
 #include <ulib/DateTime.hpp>
@@ -18,12 +24,17 @@
 #include <ulib/Path.hpp>
 #include <ulib/ProgramOptions.hpp>
 #include <ulib/Singleton.hpp>
+#include <ulib/StringFormat.hpp>
+#include <ulib/StringHash.hpp>
+#include <ulib/StringNumber.hpp>
 #include <ulib/SystemException.hpp>
 #include <ulib/Timer.hpp>
 #include <ulib/TimeSpan.hpp>
 #include <ulib/TimeZone.hpp>
 #include <ulib/TraceOutputStopwatch.hpp>
 #include <ulib/UTF8.hpp>
+#include <ulib/UTF8Convert.hpp>
+#include <ulib/UTF8Decoder.hpp>
 
 #include <ulib/log/AndroidLogcatAppender.hpp>
 #include <ulib/log/Appender.hpp>
@@ -37,10 +48,13 @@
 #include <ulib/log/SimpleLayout.hpp>
 #include <ulib/log/TextStreamAppender.hpp>
 
+#include <ulib/stream/AsyncFileStream.hpp>
+#include <ulib/stream/BufferedStream.hpp>
 #include <ulib/stream/EndianAwareFilter.hpp>
 #include <ulib/stream/FileStream.hpp>
 #include <ulib/stream/IStream.hpp>
 #include <ulib/stream/ITextStream.hpp>
+#include <ulib/stream/MappedFileStream.hpp>
 #include <ulib/stream/MemoryReadStream.hpp>
 #include <ulib/stream/MemoryStream.hpp>
 #include <ulib/stream/NullStream.hpp>
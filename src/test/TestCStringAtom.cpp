@@ -0,0 +1,128 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file TestCStringAtom.cpp tests for CStringAtom class
+//
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <ulib/CStringAtom.hpp>
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// tests for CStringAtom
+   TEST_CLASS(TestCStringAtom)
+   {
+   public:
+      /// tests interning strings
+      TEST_METHOD(TestIntern)
+      {
+         CString text1 = _T("logger.name");
+         CString text2 = _T("logger.");
+         text2 += _T("name");
+
+         CStringAtom atom1{ CStringView(text1) };
+         CStringAtom atom2{ CStringView(text2) };
+         CStringAtom atom3(CStringView(_T("other.name")));
+
+         Assert::IsTrue(atom1 == atom2, L"atoms of equal strings must be equal");
+         Assert::IsTrue(atom1 != atom3, L"atoms of different strings must be different");
+         Assert::IsTrue(&atom1.GetString() == &atom2.GetString(), L"atoms must share the same string");
+         Assert::IsTrue(atom1.GetString() == text1, L"atom must contain the text");
+         Assert::IsTrue(atom1.GetHash() == atom2.GetHash(), L"hashes must be equal");
+         Assert::IsTrue(atom1.GetHash() == std::hash<CString>()(text1), L"hash must be equal to the string's hash");
+         Assert::IsTrue(CStringAtom().GetHash() == std::hash<CString>()(CString()), L"hash of empty atom must be equal to the string's hash");
+      }
+
+      /// tests empty atoms
+      TEST_METHOD(TestEmpty)
+      {
+         CStringAtom atom1;
+         CStringAtom atom2(CStringView(_T("")));
+
+         Assert::IsTrue(atom1.IsEmpty(), L"default atom must be empty");
+         Assert::IsTrue(atom1 == atom2, L"empty atoms must be equal");
+      }
+
+      /// tests FromLowerCase()
+      TEST_METHOD(TestFromLowerCase)
+      {
+         CStringAtom atom1 = CStringAtom::FromLowerCase(CStringView(_T("Logger.NAME")));
+         CStringAtom atom2(CStringView(_T("logger.name")));
+         CStringAtom atom3(CStringView(_T("Logger.NAME")));
+
+         Assert::IsTrue(atom1 == atom2, L"lower case atom must be equal to atom of lower case text");
+         Assert::IsTrue(atom1 != atom3, L"atoms must be case sensitive");
+         Assert::IsTrue(atom1.GetString() == _T("logger.name"), L"atom must contain lower case text");
+
+         // text longer than the stack buffer used for converting
+         CString longText(_T('A'), 300);
+         CString longLowerText(_T('a'), 300);
+         Assert::IsTrue(CStringAtom::FromLowerCase(CStringView(longText)) == CStringAtom(CStringView(longLowerText)),
+            L"lower case atom of long text must be equal to atom of lower case text");
+      }
+
+      /// tests interning many strings, so that the table is rehashed
+      TEST_METHOD(TestManyStrings)
+      {
+         const int numNames = 10000;
+
+         std::vector<CStringAtom> atoms;
+         for (int index = 0; index < numNames; index++)
+         {
+            CString name;
+            name.Format(_T("many.test.name%i"), index);
+
+            atoms.push_back(CStringAtom(CStringView(name)));
+         }
+
+         for (int index = 0; index < numNames; index++)
+         {
+            CString name;
+            name.Format(_T("many.test.name%i"), index);
+
+            CStringAtom atom{ CStringView(name) };
+            Assert::IsTrue(atom == atoms[index], L"atom must be found again");
+            Assert::IsTrue(atom.GetString() == name, L"atom must contain the text");
+         }
+
+         Assert::IsTrue(atoms[0] != atoms[1], L"atoms of different strings must be different");
+      }
+
+      /// tests interning the same strings from multiple threads
+      TEST_METHOD(TestMultipleThreads)
+      {
+         const int numThreads = 4;
+         const int numNames = 1000;
+
+         std::vector<std::vector<CStringAtom>> atomsPerThread(numThreads);
+         std::vector<std::thread> threads;
+
+         for (int threadIndex = 0; threadIndex < numThreads; threadIndex++)
+         {
+            threads.emplace_back([&atomsPerThread, threadIndex, numNames]()
+            {
+               for (int index = 0; index < numNames; index++)
+               {
+                  CString name;
+                  name.Format(_T("thread.test.name%i"), index);
+
+                  atomsPerThread[threadIndex].push_back(CStringAtom(CStringView(name)));
+               }
+            });
+         }
+
+         for (auto& thread : threads)
+            thread.join();
+
+         for (int threadIndex = 1; threadIndex < numThreads; threadIndex++)
+            Assert::IsTrue(atomsPerThread[0] == atomsPerThread[threadIndex], L"all threads must get the same atoms");
+      }
+   };
+
+} // namespace UnitTest
@@ -0,0 +1,190 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file TestCStringPool.cpp tests for CStringPool class
+//
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <ulib/CStringPool.hpp>
+#include <ulib/HighResolutionTimer.hpp>
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// tests for CStringPool
+   TEST_CLASS(TestCStringPool)
+   {
+   public:
+      /// tests rounding up sizes to size classes
+      TEST_METHOD(TestRoundUpSize)
+      {
+         Assert::AreEqual<size_t>(16, CStringPool::RoundUpSize(1), L"size must be rounded up");
+         Assert::AreEqual<size_t>(32, CStringPool::RoundUpSize(17), L"size must be rounded up");
+         Assert::AreEqual<size_t>(64, CStringPool::RoundUpSize(64), L"size must stay the same");
+         Assert::AreEqual<size_t>(256, CStringPool::RoundUpSize(129), L"size must be rounded up");
+         Assert::AreEqual<size_t>(257, CStringPool::RoundUpSize(257), L"large size must not be rounded up");
+      }
+
+      /// tests that freed blocks are reused by the pool
+      TEST_METHOD(TestReuseBlocks)
+      {
+         CStringPool::Enable();
+
+         CStringPoolStats statsBefore = CStringPool::GetStats();
+
+         void* block1 = CStringPool::Allocate(64);
+         Assert::IsNotNull(block1, L"block must have been allocated");
+         CStringPool::Free(block1, 64);
+
+         void* block2 = CStringPool::Allocate(64);
+         Assert::IsTrue(block1 == block2, L"freed block must be reused");
+
+         CStringPoolStats statsAfter = CStringPool::GetStats();
+         Assert::IsTrue(statsAfter.m_hits > statsBefore.m_hits, L"reusing block must count as hit");
+
+         CStringPool::Free(block2, 64);
+
+         CStringPool::Enable(false);
+      }
+
+      /// tests reallocating blocks, between size classes and to the heap
+      TEST_METHOD(TestReallocate)
+      {
+         CStringPool::Enable();
+
+         char* block = static_cast<char*>(CStringPool::Allocate(32));
+         memcpy(block, "0123456789abcdef0123456789abcde", 32);
+
+         block = static_cast<char*>(CStringPool::Reallocate(block, 32, 128));
+         Assert::AreEqual(0, strcmp("0123456789abcdef0123456789abcde", block), L"content must be preserved");
+
+         block = static_cast<char*>(CStringPool::Reallocate(block, 128, 1024));
+         Assert::AreEqual(0, strcmp("0123456789abcdef0123456789abcde", block), L"content must be preserved");
+
+         CStringPool::Free(block, 1024);
+
+         CStringPool::Enable(false);
+      }
+
+      /// tests that blocks freed by exited threads are returned to the global pool
+      TEST_METHOD(TestThreadExit)
+      {
+         CStringPool::Enable();
+
+         std::thread thread([]()
+         {
+            std::vector<void*> blocks;
+            for (int index = 0; index < 100; index++)
+               blocks.push_back(CStringPool::Allocate(128));
+
+            for (void* block : blocks)
+               CStringPool::Free(block, 128);
+         });
+
+         thread.join();
+
+         CStringPoolStats stats = CStringPool::GetStats();
+         Assert::IsTrue(stats.m_bytesHeld >= 100 * 128, L"blocks of exited thread must be held in global pool");
+
+         CStringPool::Enable(false);
+      }
+
+      /// tests that threads fetch batches of blocks from the global pool
+      TEST_METHOD(TestFetchBatch)
+      {
+         CStringPool::Enable();
+
+         // fill the global pool with batches of blocks
+         std::thread thread1([]()
+         {
+            std::vector<void*> blocks;
+            for (int index = 0; index < 100; index++)
+               blocks.push_back(CStringPool::Allocate(256));
+
+            for (void* block : blocks)
+               CStringPool::Free(block, 256);
+         });
+
+         thread1.join();
+
+         CStringPoolStats statsBefore = CStringPool::GetStats();
+
+         // a new thread has an empty free list and must fetch a batch
+         std::thread thread2([]()
+         {
+            void* block1 = CStringPool::Allocate(256);
+            void* block2 = CStringPool::Allocate(256);
+
+            CStringPool::Free(block1, 256);
+            CStringPool::Free(block2, 256);
+         });
+
+         thread2.join();
+
+         CStringPoolStats statsAfter = CStringPool::GetStats();
+         Assert::IsTrue(statsAfter.m_hits >= statsBefore.m_hits + 2, L"blocks must be fetched from the global pool");
+         Assert::IsTrue(statsAfter.m_misses == statsBefore.m_misses, L"allocating must not miss");
+
+         CStringPool::Enable(false);
+      }
+
+      /// measures allocating and freeing blocks using the pool and using the heap
+      TEST_METHOD(TestPoolPerformance)
+      {
+         const size_t numThreads = 4;
+         const size_t numIterations = 1000000;
+
+         for (int pass = 0; pass < 2; pass++)
+         {
+            CStringPool::Enable(pass == 1);
+
+            HighResolutionTimer timer;
+            timer.Start();
+
+            std::vector<std::thread> threads;
+            for (size_t threadIndex = 0; threadIndex < numThreads; threadIndex++)
+            {
+               threads.emplace_back([numIterations]()
+               {
+                  void* blocks[8] = {};
+                  for (size_t iteration = 0; iteration < numIterations; iteration++)
+                  {
+                     size_t size = size_t(32) << (iteration % 4);
+                     void*& block = blocks[iteration % 8];
+
+                     if (block != nullptr)
+                        CStringPool::Free(block, size_t(32) << ((iteration - 8) % 4));
+
+                     block = CStringPool::Allocate(size);
+                  }
+
+                  for (size_t index = 0; index < 8; index++)
+                     CStringPool::Free(blocks[index], size_t(32) << ((numIterations - 8 + index) % 4));
+               });
+            }
+
+            for (auto& thread : threads)
+               thread.join();
+
+            timer.Stop();
+
+            CStringPoolStats stats = CStringPool::GetStats();
+
+            ATLTRACE(_T("%s: %.3f ms, hits %u, misses %u, bytes held %u\n"),
+               pass == 1 ? _T("pool") : _T("heap"),
+               timer.TotalElapsed() * 1000.0,
+               static_cast<unsigned int>(stats.m_hits),
+               static_cast<unsigned int>(stats.m_misses),
+               static_cast<unsigned int>(stats.m_bytesHeld));
+         }
+
+         CStringPool::Enable(false);
+      }
+   };
+
+} // namespace UnitTest
@@ -0,0 +1,163 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file TestCStringReplacer.cpp tests for CStringReplacer class
+//
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <ulib/CStringReplacer.hpp>
+#include <ulib/HighResolutionTimer.hpp>
+#include <vector>
+#include <utility>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// tests for CStringReplacer class
+   TEST_CLASS(TestCStringReplacer)
+   {
+   public:
+      /// tests replacing multiple patterns
+      TEST_METHOD(TestReplace)
+      {
+         CStringReplacer replacer;
+         replacer.Add(_T("{name}"), _T("World"));
+         replacer.Add(_T("{greeting}"), _T("Hello"));
+         replacer.Add(_T("{empty}"), _T(""));
+         replacer.Compile();
+
+         CString text = _T("{greeting}, {name}!{empty} {name}{name}");
+         Assert::AreEqual(5, replacer.Replace(text), L"all patterns must be replaced");
+         Assert::IsTrue(text == _T("Hello, World! WorldWorld"), L"patterns must be replaced");
+
+         CString unchanged = _T("no {placeholders} here");
+         Assert::AreEqual(0, replacer.Replace(unchanged), L"no pattern must be replaced");
+         Assert::IsTrue(unchanged == _T("no {placeholders} here"), L"text must not be modified");
+
+         CString empty;
+         Assert::AreEqual(0, replacer.Replace(empty), L"empty text must not be modified");
+      }
+
+      /// tests replacing overlapping patterns; the leftmost, then the longest one must be replaced
+      TEST_METHOD(TestReplaceOverlapping)
+      {
+         CStringReplacer replacer;
+         replacer.Add(_T("he"), _T("1"));
+         replacer.Add(_T("she"), _T("2"));
+         replacer.Add(_T("hers"), _T("3"));
+         replacer.Add(_T("b"), _T("4"));
+         replacer.Add(_T("c"), _T("5"));
+         replacer.Add(_T("abcd"), _T("6"));
+         replacer.Compile();
+
+         CString text = _T("ushers");
+         replacer.Replace(text);
+         Assert::IsTrue(text == _T("u2rs"), L"leftmost match must be replaced");
+
+         text = _T("hershe");
+         replacer.Replace(text);
+         Assert::IsTrue(text == _T("31"), L"longest match must be replaced");
+
+         text = _T("abcd abce");
+         replacer.Replace(text);
+         Assert::IsTrue(text == _T("6 a45e"), L"matches after a partial match must be replaced");
+      }
+
+      /// tests replacing patterns in the result string, and adding a pattern again
+      TEST_METHOD(TestReplaceResult)
+      {
+         CStringReplacer replacer;
+         replacer.Add(_T("a"), _T("b"));
+         replacer.Add(_T("b"), _T("c"));
+         replacer.Add(_T("a"), _T("aa"));
+         replacer.Compile();
+
+         Assert::AreEqual<size_t>(2, replacer.GetCount(), L"same pattern must be added only once");
+
+         CString result;
+         const TCHAR* text = _T("abab");
+         Assert::AreEqual(4, replacer.Replace(text, 4, result), L"all patterns must be replaced");
+         Assert::IsTrue(result == _T("aacaac"), L"replaced text must not be replaced again");
+
+         replacer.Add(_T("x"), _T("y"));
+         Assert::IsFalse(replacer.IsCompiled(), L"replacer must be compiled again after adding a pattern");
+      }
+
+      /// tests replacing patterns with narrow and wide characters
+      TEST_METHOD(TestReplaceCharTypes)
+      {
+         CStringReplacerA replacerA;
+         replacerA.Add("\xe4", "ae");
+         replacerA.Compile();
+
+         CStringA textA = "K\xe4se";
+         replacerA.Replace(textA);
+         Assert::IsTrue(textA == "Kaese", L"narrow string must be replaced");
+
+         CStringReplacerW replacerW;
+         replacerW.Add(L"\x20ac", L"EUR");
+         replacerW.Add(L"\x00e4", L"ae");
+         replacerW.Compile();
+
+         CStringW textW = L"5 \x20ac K\x00e4se";
+         Assert::AreEqual(2, replacerW.Replace(textW), L"wide patterns must be replaced");
+         Assert::IsTrue(textW == L"5 EUR Kaese", L"wide string must be replaced");
+      }
+
+      /// compares calling Replace() for each pattern with using CStringReplacer
+      TEST_METHOD(TestReplacePerformance)
+      {
+         const int numPatterns = 100;
+
+         CString document;
+         for (int index = 0; index < 20000; index++)
+         {
+            CString placeholder;
+            placeholder.Format(_T("some text {placeholder%i} "), index % numPatterns);
+            document += placeholder;
+         }
+
+         CStringReplacer replacer;
+         std::vector<std::pair<CString, CString>> patterns;
+         for (int index = 0; index < numPatterns; index++)
+         {
+            CString pattern, replacement;
+            pattern.Format(_T("{placeholder%i}"), index);
+            replacement.Format(_T("value%i"), index);
+
+            patterns.push_back(std::make_pair(pattern, replacement));
+            replacer.Add(pattern, replacement);
+         }
+
+         replacer.Compile();
+
+         CString results[2];
+         for (int pass = 0; pass < 2; pass++)
+         {
+            HighResolutionTimer timer;
+            timer.Start();
+
+            results[pass] = document;
+            if (pass == 0)
+            {
+               for (const auto& pattern : patterns)
+                  results[pass].Replace(pattern.first, pattern.second);
+            }
+            else
+               replacer.Replace(results[pass]);
+
+            timer.Stop();
+
+            ATLTRACE(_T("%s: %.3f ms\n"),
+               pass == 0 ? _T("Replace()") : _T("CStringReplacer"),
+               timer.TotalElapsed() * 1000.0);
+         }
+
+         Assert::IsTrue(results[0] == results[1], L"results must be equal");
+      }
+   };
+
+} // namespace UnitTest
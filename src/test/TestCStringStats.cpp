@@ -0,0 +1,91 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file TestCStringStats.cpp tests for CStringStats class
+//
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <ulib/CStringStats.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// tests for CStringStats class
+   TEST_CLASS(TestCStringStats)
+   {
+   public:
+      /// tests size buckets
+      TEST_METHOD(TestSizeBuckets)
+      {
+         Assert::AreEqual<size_t>(0, CStringStats::GetBucketIndex(1), L"small size must be in first bucket");
+         Assert::AreEqual<size_t>(0, CStringStats::GetBucketIndex(16), L"size must be in first bucket");
+         Assert::AreEqual<size_t>(1, CStringStats::GetBucketIndex(17), L"size must be in second bucket");
+         Assert::AreEqual<size_t>(4, CStringStats::GetBucketIndex(256), L"size must be in bucket of limit");
+         Assert::AreEqual<size_t>(CStringStatsSnapshot::c_numSizeBuckets - 1, CStringStats::GetBucketIndex(100000000), L"large size must be in last bucket");
+
+         for (size_t index = 0; index < CStringStatsSnapshot::c_numSizeBuckets - 1; index++)
+         {
+            size_t limit = CStringStats::GetBucketLimit(index);
+            Assert::AreEqual(index, CStringStats::GetBucketIndex(limit), L"limit must be in its bucket");
+            Assert::AreEqual(index + 1, CStringStats::GetBucketIndex(limit + 1), L"limit + 1 must be in next bucket");
+         }
+
+         Assert::AreEqual<size_t>(0, CStringStats::GetBucketLimit(CStringStatsSnapshot::c_numSizeBuckets - 1), L"last bucket must have no limit");
+      }
+
+      /// tests recording statistics
+      TEST_METHOD(TestRecord)
+      {
+         CStringStatsSnapshot before = CStringStats::Snapshot();
+         Assert::AreEqual(CStringStats::c_enabled, before.m_enabled, L"enabled flag must match compile switch");
+
+         CStringStats::OnAllocate(100);
+         CStringStats::OnReallocate(100, 1000);
+         CStringStats::OnFork();
+         CStringStats::OnFree(1000);
+
+         CStringStatsSnapshot after = CStringStats::Snapshot();
+         if (!CStringStats::c_enabled)
+         {
+            Assert::IsTrue(after.m_numAllocations == 0, L"disabled statistics must not record anything");
+            return;
+         }
+
+         Assert::IsTrue(after.m_numAllocations == before.m_numAllocations + 1, L"allocation must be recorded");
+         Assert::IsTrue(after.m_numReallocations == before.m_numReallocations + 1, L"reallocation must be recorded");
+         Assert::IsTrue(after.m_numFrees == before.m_numFrees + 1, L"free must be recorded");
+         Assert::IsTrue(after.m_numForks == before.m_numForks + 1, L"fork must be recorded");
+         Assert::IsTrue(after.m_peakBytes >= before.m_liveBytes + 1000, L"peak bytes must contain reallocated size");
+      }
+
+      /// tests formatting a snapshot
+      TEST_METHOD(TestFormat)
+      {
+         CStringStatsSnapshot snapshot;
+         snapshot.m_enabled = true;
+         snapshot.m_liveBytes = 1024;
+         snapshot.m_peakBytes = 4096;
+         snapshot.m_numAllocations = 10;
+         snapshot.m_numReallocations = 2;
+         snapshot.m_numFrees = 8;
+         snapshot.m_numForks = 3;
+         snapshot.m_sizeBuckets[0] = 7;
+         snapshot.m_sizeBuckets[CStringStatsSnapshot::c_numSizeBuckets - 1] = 1;
+
+         std::string json = snapshot.ToJson();
+         Assert::IsTrue(json.find("\"liveBytes\":1024,\"peakBytes\":4096,\"allocations\":10,"
+            "\"reallocations\":2,\"frees\":8,\"forks\":3") != std::string::npos, L"JSON must contain counters");
+         Assert::IsTrue(json.find("{\"maxSize\":16,\"count\":7}") != std::string::npos, L"JSON must contain first bucket");
+         Assert::IsTrue(json.find("{\"maxSize\":null,\"count\":1}]}") != std::string::npos, L"JSON must contain last bucket");
+
+         std::string text = snapshot.ToText();
+         Assert::IsTrue(text.find("peak bytes: 4096\n") != std::string::npos, L"text must contain counters");
+         Assert::IsTrue(text.find("size <= 16: 7\n") != std::string::npos, L"text must contain first bucket");
+         Assert::IsTrue(text.find("size > 16384: 1\n") != std::string::npos, L"text must contain last bucket");
+      }
+   };
+
+} // namespace UnitTest
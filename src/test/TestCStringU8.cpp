@@ -0,0 +1,172 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file TestCStringU8.cpp tests for CStringU8 class
+//
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <ulib/CStringU8.hpp>
+#include <ulib/HighResolutionTimer.hpp>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// tests for CStringU8 class and UTF8Convert functions
+   TEST_CLASS(TestCStringU8)
+   {
+   public:
+      /// tests decoding and encoding single code points
+      TEST_METHOD(TestCodePoints)
+      {
+         const char32_t codePoints[] = { 0x24, 0xA2, 0x20AC, 0xFFFF, 0x10348, 0x10FFFF };
+         const size_t lengths[] = { 1, 2, 3, 3, 4, 4 };
+
+         for (size_t index = 0; index < std::size(codePoints); index++)
+         {
+            char buffer[UTF8Convert::c_maxSequenceLength];
+            size_t length = UTF8Convert::EncodeCodePoint(codePoints[index], buffer);
+            Assert::AreEqual(lengths[index], length, L"code point must be encoded with correct length");
+
+            const char* pos = buffer;
+            Assert::IsTrue(codePoints[index] == UTF8Convert::DecodeCodePoint(pos, buffer + length), L"code point must be decoded");
+            Assert::IsTrue(pos == buffer + length, L"all bytes must be decoded");
+         }
+
+         // invalid and incomplete sequences
+         const char* invalidTexts[] = { "\x80", "\xC0\xAF", "\xE0\x80\xAF", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xFF" };
+         for (const char* text : invalidTexts)
+         {
+            const char* pos = text;
+            Assert::IsTrue(UTF8Convert::c_invalidSequence == UTF8Convert::DecodeCodePoint(pos, text + strlen(text)),
+               L"invalid sequence must be detected");
+         }
+
+         const char* incomplete = "\xE2\x82";
+         const char* pos = incomplete;
+         Assert::IsTrue(UTF8Convert::c_incompleteSequence == UTF8Convert::DecodeCodePoint(pos, incomplete + 2),
+            L"incomplete sequence must be detected");
+         Assert::IsTrue(pos == incomplete + 2, L"incomplete sequence must be skipped");
+      }
+
+      /// tests validation flag and code point count
+      TEST_METHOD(TestValidate)
+      {
+         CStringU8 text = "\xe2\x82\xac 5 \xf0\x90\x8d\x88";
+         Assert::IsTrue(text.IsValid(), L"text must be valid");
+         Assert::AreEqual(10, text.GetLength(), L"length must be in bytes");
+         Assert::AreEqual(5, text.GetCodePointCount(), L"code points must be counted");
+
+         CStringU8 invalid("ab\xe2\x82z\xff", 6);
+         Assert::IsFalse(invalid.IsValid(), L"text must be invalid");
+         Assert::AreEqual(5, invalid.GetCodePointCount(), L"invalid sequences must be counted as one code point");
+
+         CStringU8 empty;
+         Assert::IsTrue(empty.IsValid(), L"empty text must be valid");
+         Assert::AreEqual(0, empty.GetCodePointCount(), L"empty text must have no code points");
+
+         // long text, to use the ASCII kernels
+         CStringA longText('x', 100);
+         longText += "\xc3\xa4";
+         longText += CStringA('y', 100);
+         CStringA truncated = longText.Left(101);
+         Assert::AreEqual<size_t>(100, UTF8Convert::Validate(truncated, 101), L"valid prefix must be found");
+         Assert::AreEqual(201, CStringU8(longText).GetCodePointCount(), L"code points of long text must be counted");
+      }
+
+      /// tests appending strings
+      TEST_METHOD(TestAppend)
+      {
+         CStringU8 text = "Stra\xc3\x9f" "e";
+         Assert::AreEqual(6, text.GetCodePointCount(), L"code points must be counted");
+
+         CStringU8 other(L"\x00e4", 1);
+         text += other;
+         Assert::IsTrue(text == CStringU8("Stra\xc3\x9f" "e\xc3\xa4"), L"string must be appended");
+         Assert::IsTrue(text.IsValid(), L"appended valid strings must be valid");
+         Assert::AreEqual(7, text.GetCodePointCount(), L"code points must be updated");
+
+         text += "\xff";
+         Assert::IsFalse(text.IsValid(), L"appended invalid text must be detected");
+
+         text.Empty();
+         Assert::IsTrue(text.IsEmpty(), L"string must be empty");
+         Assert::IsTrue(CStringU8("a") < CStringU8("\xc3\xa4"), L"strings must be ordered by code points");
+      }
+
+      /// tests iterating over code points
+      TEST_METHOD(TestIterate)
+      {
+         CStringU8 text = "a\xe2\x82\xac\xf0\x90\x8d\x88\xff" "b";
+
+         std::vector<char32_t> codePoints;
+         for (char32_t codePoint : text)
+            codePoints.push_back(codePoint);
+
+         const char32_t expected[] = { 0x61, 0x20AC, 0x10348, 0xFFFD, 0x62 };
+         Assert::AreEqual(std::size(expected), codePoints.size(), L"all code points must be iterated");
+         for (size_t index = 0; index < codePoints.size(); index++)
+            Assert::IsTrue(expected[index] == codePoints[index], L"code point must be decoded");
+      }
+
+      /// tests converting from and to wide strings
+      TEST_METHOD(TestConvertWide)
+      {
+         CStringW wide = L"\x20ac\xfeff" L"abc";
+         wide += static_cast<wchar_t>(0xD800); // unpaired surrogate
+         wide += L"\xe4";
+
+         CStringU8 text(wide);
+         Assert::IsTrue(text == CStringU8("\xe2\x82\xac\xef\xbb\xbf" "abc\xef\xbf\xbd\xc3\xa4"), L"wide string must be converted");
+         Assert::IsTrue(text.IsValid(), L"converted string must be valid");
+
+         CStringW converted = text.ToStringW();
+         Assert::IsTrue(converted == L"\x20ac\xfeff" L"abc\xfffd\xe4", L"string must be converted to wide string");
+
+         CStringU8 supplementary = "\xf0\x9f\x98\x80";
+         CStringW wideSupplementary = supplementary.ToStringW();
+         Assert::AreEqual(UTF8Convert::IsWideUTF16() ? 2 : 1, wideSupplementary.GetLength(), L"code point must be converted");
+         Assert::IsTrue(CStringU8(wideSupplementary) == supplementary, L"code point must be converted back");
+
+         CStringU8 invalid = "a\xe0\x80z";
+         Assert::IsTrue(invalid.ToStringW() == L"a\xfffd\xfffdz", L"invalid sequences must be replaced");
+      }
+
+      /// compares converting long text to wide strings with UTF8Convert and with a per-byte loop
+      TEST_METHOD(TestConvertPerformance)
+      {
+         CStringU8 text;
+         for (int index = 0; index < 100000; index++)
+            text += "some ASCII text, and some \xc3\xa4\xc3\xb6\xc3\xbc text\n";
+
+         for (int pass = 0; pass < 2; pass++)
+         {
+            HighResolutionTimer timer;
+            timer.Start();
+
+            if (pass == 0)
+            {
+               CStringW result;
+               wchar_t* buffer = result.GetBuffer(text.GetLength());
+               int length = 0;
+               for (char32_t codePoint : text)
+                  length += static_cast<int>(UTF8Convert::StoreWide(codePoint, buffer + length));
+
+               result.ReleaseBufferSetLength(length);
+            }
+            else
+               CStringW result = text.ToStringW();
+
+            timer.Stop();
+
+            ATLTRACE(_T("%s: %.3f ms\n"),
+               pass == 0 ? _T("code point loop") : _T("CStringU8::ToStringW()"),
+               timer.TotalElapsed() * 1000.0);
+         }
+      }
+   };
+
+} // namespace UnitTest
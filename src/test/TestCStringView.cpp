@@ -0,0 +1,123 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file TestCStringView.cpp tests for CStringView class
+//
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <ulib/CStringView.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// tests for CStringView
+   TEST_CLASS(TestCStringView)
+   {
+   public:
+      /// tests constructing views
+      TEST_METHOD(TestCtor)
+      {
+         CString text = _T("abc");
+
+         CStringView view1;
+         CStringView view2(text);
+         CStringView view3(_T("abcdef"), 3);
+         CStringView view4(_T("abc"));
+
+         Assert::IsTrue(view1.IsEmpty());
+         Assert::AreEqual(3, view2.GetLength());
+         Assert::IsTrue(text.GetString() == view2.GetData());
+         Assert::IsTrue(view2 == view3);
+         Assert::IsTrue(view3 == view4);
+         Assert::IsTrue(text == view4);
+
+         // views on temporary strings would dangle
+         static_assert(std::is_constructible_v<CStringView, const CString&>, "views on strings must be available");
+         static_assert(!std::is_constructible_v<CStringView, CString>, "views on temporary strings must not be available");
+         static_assert(!std::is_constructible_v<CStringView, decltype(text + text)>, "views on concatenations must not be available");
+      }
+
+      /// tests Find() and ReverseFind()
+      TEST_METHOD(TestFind)
+      {
+         CStringView view(_T("abc.def.ghi"));
+
+         Assert::AreEqual(3, view.Find(_T('.')));
+         Assert::AreEqual(7, view.Find(_T('.'), 4));
+         Assert::AreEqual(-1, view.Find(_T('x')));
+         Assert::AreEqual(-1, view.Find(_T('a'), 11));
+         Assert::AreEqual(4, view.Find(CStringView(_T("def"))));
+         Assert::AreEqual(-1, view.Find(CStringView(_T("deg"))));
+         Assert::AreEqual(7, view.ReverseFind(_T('.')));
+         Assert::AreEqual(-1, view.ReverseFind(_T('x')));
+         Assert::AreEqual(3, view.FindOneOf(CStringView(_T(".x"))));
+         Assert::AreEqual(-1, view.FindOneOf(CStringView(_T("xyz"))));
+      }
+
+      /// tests Find() and FindOneOf() with C-style strings and with strings
+      TEST_METHOD(TestFindString)
+      {
+         CString text = _T("abc.def.ghi.abc.def.ghi.abc.def.ghi");
+         CStringView view(text);
+
+         Assert::AreEqual(4, view.Find(_T("def")));
+         Assert::AreEqual(16, view.Find(_T("def"), 5));
+         Assert::AreEqual(-1, view.Find(_T("deg")));
+         Assert::AreEqual(2, view.Find(_T(""), 2));
+         Assert::AreEqual(3, view.FindOneOf(_T(".x")));
+         Assert::AreEqual(-1, view.FindOneOf(_T("xyz")));
+
+         CString subString = _T("ghi");
+         Assert::AreEqual(8, view.Find(subString));
+         Assert::AreEqual(32, view.Find(subString, 21));
+
+         // searching in a view must not find characters after its end
+         Assert::AreEqual(-1, view.Left(10).Find(_T("ghi")));
+         Assert::AreEqual(-1, view.Left(2).FindOneOf(_T("c")));
+      }
+
+      /// tests Compare() and CompareNoCase()
+      TEST_METHOD(TestCompare)
+      {
+         CStringView view(_T("abc"));
+
+         Assert::AreEqual(0, view.Compare(CStringView(_T("abc"))));
+         Assert::IsTrue(view.Compare(CStringView(_T("abd"))) < 0);
+         Assert::IsTrue(view.Compare(CStringView(_T("ab"))) > 0);
+         Assert::AreEqual(0, view.CompareNoCase(CStringView(_T("ABC"))));
+         Assert::IsTrue(view != _T("ABC"));
+      }
+
+      /// tests Mid(), Left() and Right()
+      TEST_METHOD(TestSubstrings)
+      {
+         CString text = _T("0123456789");
+         CStringView view(text);
+
+         Assert::AreEqual(_T("3456789"), view.Mid(3).ToString());
+         Assert::AreEqual(_T("34"), view.Mid(3, 2).ToString());
+         Assert::AreEqual(_T("89"), view.Mid(8, 5).ToString());
+         Assert::IsTrue(view.Mid(12).IsEmpty());
+         Assert::AreEqual(_T("01"), view.Left(2).ToString());
+         Assert::AreEqual(_T("89"), view.Right(2).ToString());
+
+         Assert::IsTrue(text.GetString() + 3 == view.Mid(3).GetData());
+      }
+
+      /// tests Trim(), TrimLeft() and TrimRight()
+      TEST_METHOD(TestTrim)
+      {
+         CStringView view(_T("  \t abc \n "));
+
+         Assert::AreEqual(_T("abc"), view.Trim().ToString());
+         Assert::AreEqual(_T("abc \n "), view.TrimLeft().ToString());
+         Assert::AreEqual(_T("  \t abc"), view.TrimRight().ToString());
+         Assert::AreEqual(_T("abc"), CStringView(_T("\"abc\"")).Trim(_T("\"")).ToString());
+         Assert::IsTrue(CStringView(_T("   ")).Trim().IsEmpty());
+      }
+   };
+
+} // namespace UnitTest
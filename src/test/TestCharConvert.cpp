@@ -0,0 +1,174 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file TestCharConvert.cpp tests for CharConvert functions
+//
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <ulib/CharConvert.hpp>
+#include <ulib/HighResolutionTimer.hpp>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// tests for CharConvert functions
+   TEST_CLASS(TestCharConvert)
+   {
+   public:
+      /// tests finding non-ASCII characters, at all positions and for all lengths
+      TEST_METHOD(TestFindNonAscii)
+      {
+         for (size_t length = 0; length <= 100; length++)
+         {
+            std::string narrow(length, 'a');
+            std::wstring wide(length, L'a');
+
+            Assert::AreEqual(length, CharConvert::FindNonAscii(narrow.data(), length), L"ASCII text must be found completely");
+            Assert::AreEqual(length, CharConvert::FindNonAscii(wide.data(), length), L"ASCII text must be found completely");
+
+            for (size_t pos = 0; pos < length; pos++)
+            {
+               narrow[pos] = '\xe4';
+               wide[pos] = L'\x20ac';
+
+               Assert::AreEqual(pos, CharConvert::FindNonAscii(narrow.data(), length), L"non-ASCII char must be found");
+               Assert::AreEqual(pos, CharConvert::FindNonAscii(wide.data(), length), L"non-ASCII char must be found");
+
+               narrow[pos] = 'a';
+               wide[pos] = L'a';
+            }
+         }
+      }
+
+      /// tests finding non-ASCII characters with the AVX2 kernel directly,
+      /// when the CPU supports AVX2; see TestStringSearch::TestKernelsAvx2()
+      TEST_METHOD(TestFindNonAsciiAvx2)
+      {
+#ifdef ULIB_STRINGSEARCH_X86
+         if (StringSearch::GetCpuLevel() != StringSearch::CpuLevel::avx2)
+            return;
+
+         for (size_t length = 0; length <= 100; length++)
+         {
+            std::string narrow(length, 'a');
+            std::wstring wide(length, L'a');
+
+            Assert::AreEqual(length, CharConvert::Avx2::FindNonAscii(narrow.data(), length), L"ASCII text must be found completely");
+            Assert::AreEqual(length, CharConvert::Avx2::FindNonAscii(wide.data(), length), L"ASCII text must be found completely");
+
+            if (length > 0)
+            {
+               narrow[length / 2] = '\xe4';
+               wide[length / 2] = L'\x20ac';
+
+               Assert::AreEqual(length / 2, CharConvert::Avx2::FindNonAscii(narrow.data(), length), L"non-ASCII char must be found");
+               Assert::AreEqual(length / 2, CharConvert::Avx2::FindNonAscii(wide.data(), length), L"non-ASCII char must be found");
+            }
+         }
+#endif
+      }
+
+      /// tests widening ASCII text, for all lengths
+      TEST_METHOD(TestWidenAscii)
+      {
+         std::string narrow;
+         for (size_t index = 0; index < 100; index++)
+            narrow += static_cast<char>(' ' + index % 95);
+
+         for (size_t length = 0; length <= narrow.size(); length++)
+         {
+            std::vector<wchar_t> wide(length + 1, L'#');
+
+            Assert::AreEqual(length, CharConvert::WidenAscii(wide.data(), narrow.data(), length), L"all chars must be converted");
+            Assert::IsTrue(std::wstring(narrow.begin(), narrow.begin() + length) == std::wstring(wide.data(), length), L"chars must be widened");
+            Assert::IsTrue(wide[length] == L'#', L"no char after the end must be written");
+         }
+
+         // conversion must stop at a non-ASCII character
+         std::string text = narrow;
+         text[70] = '\x80';
+
+         std::vector<wchar_t> wide(text.size());
+         Assert::AreEqual<size_t>(70, CharConvert::WidenAscii(wide.data(), text.data(), text.size()), L"conversion must stop at non-ASCII char");
+      }
+
+      /// tests narrowing ASCII text, for all lengths
+      TEST_METHOD(TestNarrowAscii)
+      {
+         std::wstring wide;
+         for (size_t index = 0; index < 100; index++)
+            wide += static_cast<wchar_t>(L' ' + index % 95);
+
+         for (size_t length = 0; length <= wide.size(); length++)
+         {
+            std::vector<char> narrow(length + 1, '#');
+
+            Assert::AreEqual(length, CharConvert::NarrowAscii(narrow.data(), wide.data(), length), L"all chars must be converted");
+            Assert::IsTrue(std::string(wide.begin(), wide.begin() + length) == std::string(narrow.data(), length), L"chars must be narrowed");
+            Assert::IsTrue(narrow[length] == '#', L"no char after the end must be written");
+         }
+
+         // conversion must stop at a non-ASCII character, also when only the high byte is set
+         std::wstring text = wide;
+         text[40] = L'\x0141';
+
+         std::vector<char> narrow(text.size());
+         Assert::AreEqual<size_t>(40, CharConvert::NarrowAscii(narrow.data(), text.data(), text.size()), L"conversion must stop at non-ASCII char");
+      }
+
+      /// tests converting whole strings
+      TEST_METHOD(TestConvertStrings)
+      {
+         const char* narrow = "The quick brown fox jumps over the lazy dog";
+         const wchar_t* wide = L"The quick brown fox jumps over the lazy dog";
+         int length = static_cast<int>(strlen(narrow));
+
+         Assert::AreEqual(length, CharConvert::NarrowToWide(nullptr, 0, narrow, length), L"length must be calculated");
+         Assert::AreEqual(length, CharConvert::WideToNarrow(nullptr, 0, wide, length), L"length must be calculated");
+
+         wchar_t wideBuffer[64] = {};
+         char narrowBuffer[64] = {};
+         Assert::AreEqual(length, CharConvert::NarrowToWide(wideBuffer, 64, narrow, length), L"string must be converted");
+         Assert::AreEqual(length, CharConvert::WideToNarrow(narrowBuffer, 64, wide, length), L"string must be converted");
+         Assert::AreEqual(0, wcscmp(wide, wideBuffer), L"converted string must be equal");
+         Assert::AreEqual(0, strcmp(narrow, narrowBuffer), L"converted string must be equal");
+
+         // limited destination buffer
+         Assert::AreEqual(10, CharConvert::NarrowToWide(wideBuffer, 10, narrow, length), L"conversion must stop at end of buffer");
+      }
+
+      /// compares converting ASCII text using the locale functions and using the ASCII kernels
+      TEST_METHOD(TestConvertPerformance)
+      {
+         const size_t length = 1024 * 1024;
+         std::string narrow(length, 'x');
+         std::vector<wchar_t> wide(length + 1);
+
+         for (int pass = 0; pass < 2; pass++)
+         {
+            HighResolutionTimer timer;
+            timer.Start();
+
+            for (int iteration = 0; iteration < 10; iteration++)
+            {
+               if (pass == 0)
+                  mbstowcs(wide.data(), narrow.c_str(), length + 1);
+               else
+                  CharConvert::NarrowToWide(wide.data(), static_cast<int>(length), narrow.data(), static_cast<int>(length));
+            }
+
+            timer.Stop();
+
+            ATLTRACE(_T("narrow to wide, %s: %.3f ms\n"),
+               pass == 0 ? _T("mbstowcs") : _T("CharConvert"),
+               timer.TotalElapsed() * 1000.0);
+         }
+      }
+   };
+
+} // namespace UnitTest
@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2017,2020 Michael Fink
+// Copyright (C) 2017,2020,2026 Michael Fink
 //
 /// \file TestPath.cpp Unit tests for Path class
 //
@@ -57,6 +57,21 @@ namespace UnitTest
          Assert::AreEqual(_T("E:\\acme\\"), Path::FolderName(_T("E:\\acme\\three")), "folder name must be correct");
       }
 
+      /// Tests FilenameAndExt(), FilenameOnly(), ExtensionOnly() and FolderName() with views
+      TEST_METHOD(TestViewOverloads)
+      {
+         CString path = _T("C:\\win\\desktop\\temp.txt");
+         CStringView pathView(path);
+
+         Assert::IsTrue(Path::FilenameAndExt(pathView) == _T("temp.txt"), L"filename must be temp.txt");
+         Assert::IsTrue(Path::FilenameOnly(pathView) == _T("temp"), L"filename must be temp");
+         Assert::IsTrue(Path::ExtensionOnly(pathView) == _T(".txt"), L"extension must be .txt");
+         Assert::IsTrue(Path::FolderName(pathView) == _T("C:\\win\\desktop\\"), L"folder name must be correct");
+         Assert::IsTrue(Path::ExtensionOnly(CStringView(_T("c:\\my.test\\filename"))).IsEmpty(), L"extension must be empty");
+
+         Assert::IsTrue(path.GetString() + 15 == Path::FilenameAndExt(pathView).GetData(), L"view must point into path");
+      }
+
       /// Tests ShortPathName() method
       TEST_METHOD(TestShortPathName)
       {
@@ -0,0 +1,476 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file TestPortableCString.cpp tests for the platform independent CStringT class
+//
+
+// includes
+// This file doesn't use the precompiled header: stdafx.h includes ATL, and
+// ATL's CString would be used instead of the CStringT class tested here.
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <sdkddkver.h>
+#include <windows.h>
+#include <tchar.h>
+#include <crtdbg.h>
+
+#ifndef ATLASSERT
+#define ATLASSERT(expr) _ASSERTE(expr)
+#endif
+
+#include <ulib/config/Common.hpp>
+#include <ulib/CString.hpp>
+#include <ulib/HighResolutionTimer.hpp>
+#include "CppUnitTest.h"
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// Tests for the platform independent CStringT class, from CString.hpp;
+   /// the other string tests use ATL's CString.
+   TEST_CLASS(TestPortableCString)
+   {
+      /// returns length of C-style string; used to test passing concatenations
+      static int StringLength(const char* str)
+      {
+         return static_cast<int>(strlen(str));
+      }
+
+      /// returns string length of string class or concatenation
+      template <typename TString>
+      static int GetLengthOf(const char* prefix, const TString& str)
+      {
+         return StringLength(prefix) + StringLength(str.GetString());
+      }
+
+   public:
+      /// tests ctors and basic accessors
+      TEST_METHOD(TestCtors)
+      {
+         CStringA s1("abc123");
+         Assert::AreEqual(6, s1.GetLength());
+         Assert::AreEqual("abc123", s1.GetString());
+
+         CStringW s2(L"abc123", 3);
+         Assert::AreEqual(L"abc", s2.GetString());
+
+         CStringA s3('x', 20);
+         Assert::AreEqual("xxxxxxxxxxxxxxxxxxxx", s3.GetString());
+
+         CStringA s4;
+         Assert::IsTrue(s4.IsEmpty());
+         Assert::AreEqual("", s4.GetString());
+
+         CStringW s5(s1);
+         Assert::AreEqual(L"abc123", s5.GetString());
+      }
+
+      /// tests strings that fit into the inline buffer
+      TEST_METHOD(TestInlineBuffer)
+      {
+         CStringA s1("123456789012345");
+         Assert::AreEqual(15, s1.GetLength());
+         Assert::AreEqual(15, s1.GetAllocLength());
+
+         // growing moves the string to the heap
+         s1.AppendChar('6');
+         Assert::AreEqual("1234567890123456", s1.GetString());
+         Assert::IsTrue(s1.GetAllocLength() >= 16);
+
+         // 7 characters with 16 bit wchar_t, 3 characters with 32 bit wchar_t
+         const int inlineLengthW = static_cast<int>(16 / sizeof(WCHAR)) - 1;
+
+         CStringW s2(L"123");
+         Assert::AreEqual(inlineLengthW, s2.GetAllocLength());
+
+         s2 += L"4567890";
+         Assert::AreEqual(L"1234567890", s2.GetString());
+         Assert::IsTrue(s2.GetAllocLength() > inlineLengthW);
+
+         // the heap pointer and the inline buffer share the same memory
+         Assert::AreEqual<size_t>(16, sizeof(CStringA));
+         Assert::AreEqual<size_t>(16, sizeof(CStringW));
+      }
+
+      /// compares creating short and long strings; the short strings are
+      /// stored in the inline buffer and don't allocate any memory
+      TEST_METHOD(TestInlineBufferPerformance)
+      {
+         CStringPool::Enable();
+
+         const int numStrings = 1000000;
+         const char* texts[2] = { "short string", "a string that is too long for the inline buffer" };
+
+         for (int pass = 0; pass < 2; pass++)
+         {
+            CStringPoolStats statsBefore = CStringPool::GetStats();
+
+            HighResolutionTimer timer;
+            timer.Start();
+
+            int totalLength = 0;
+            for (int index = 0; index < numStrings; index++)
+            {
+               CStringA text(texts[pass]);
+               text.AppendChar('!');
+               totalLength += text.GetLength();
+            }
+
+            timer.Stop();
+
+            CStringPoolStats statsAfter = CStringPool::GetStats();
+            uint64_t numAllocations =
+               (statsAfter.m_hits + statsAfter.m_misses) - (statsBefore.m_hits + statsBefore.m_misses);
+
+            Assert::AreEqual(numStrings * (static_cast<int>(strlen(texts[pass])) + 1), totalLength);
+
+            if (pass == 0)
+               Assert::AreEqual<uint64_t>(0, numAllocations);
+            else
+               Assert::IsTrue(numAllocations >= static_cast<uint64_t>(numStrings));
+
+            std::wstring message = pass == 0 ? L"short strings: " : L"long strings: ";
+            message += std::to_wstring(timer.TotalElapsed() * 1000.0) + L" ms, " +
+               std::to_wstring(numAllocations) + L" allocations";
+
+            Logger::WriteMessage(message.c_str());
+         }
+
+         CStringPool::Enable(false);
+      }
+
+      /// tests appending a string to itself, while the buffer is reallocated
+      TEST_METHOD(TestSelfAppend)
+      {
+         CStringA s1("abcdefgh");
+         s1.Append(s1);
+         Assert::AreEqual("abcdefghabcdefgh", s1.GetString());
+
+         s1.Append(s1.GetString() + 8);
+         Assert::AreEqual("abcdefghabcdefghabcdefgh", s1.GetString());
+      }
+
+      /// tests copying strings
+      TEST_METHOD(TestCopy)
+      {
+         CStringA s1("short");
+         CStringA s2("a string that is too long for the inline buffer");
+
+         CStringA s3(s1);
+         CStringA s4(s2);
+         Assert::AreEqual(s1.GetString(), s3.GetString());
+         Assert::AreEqual(s2.GetString(), s4.GetString());
+
+         // modifying a copy doesn't modify the original
+         s3.SetAt(0, 'S');
+         s4.SetAt(0, 'A');
+         Assert::AreEqual("short", s1.GetString());
+         Assert::AreEqual("Short", s3.GetString());
+         Assert::AreEqual("a string that is too long for the inline buffer", s2.GetString());
+         Assert::AreEqual("A string that is too long for the inline buffer", s4.GetString());
+
+         s3 = s2;
+         s3.AppendChar('!');
+         Assert::AreEqual("a string that is too long for the inline buffer", s2.GetString());
+         Assert::AreEqual("a string that is too long for the inline buffer!", s3.GetString());
+
+         s3 = s3;
+         Assert::AreEqual("a string that is too long for the inline buffer!", s3.GetString());
+      }
+
+      /// tests that copies share the string data until one of them is modified
+      TEST_METHOD(TestCopyOnWrite)
+      {
+         CStringA s1("a string that is too long for the inline buffer");
+
+         CStringA s2(s1);
+         CStringA s3;
+         s3 = s1;
+         Assert::IsTrue(s1.GetString() == s2.GetString());
+         Assert::IsTrue(s1.GetString() == s3.GetString());
+
+         // each write makes the string's data unique first
+         s2.SetAt(0, 'A');
+         Assert::IsTrue(s1.GetString() != s2.GetString());
+         Assert::IsTrue(s1.GetString() == s3.GetString());
+
+         s3.GetBuffer()[0] = 'B';
+         s3.ReleaseBuffer();
+         Assert::AreEqual("a string that is too long for the inline buffer", s1.GetString());
+         Assert::AreEqual("A string that is too long for the inline buffer", s2.GetString());
+         Assert::AreEqual("B string that is too long for the inline buffer", s3.GetString());
+
+         // the last reference writes to the data directly
+         const char* buffer = s1.GetString();
+         s1.SetAt(0, 'C');
+         Assert::IsTrue(buffer == s1.GetString());
+
+         // strings confined to a single thread share data the same way
+         CStringLocalA s4("another string that is too long for the inline buffer");
+         CStringLocalA s5(s4);
+         Assert::IsTrue(s4.GetString() == s5.GetString());
+
+         s5.AppendChar('!');
+         Assert::AreEqual("another string that is too long for the inline buffer", s4.GetString());
+         Assert::AreEqual("another string that is too long for the inline buffer!", s5.GetString());
+      }
+
+      /// tests that copy-on-write forks are recorded in the string statistics
+      TEST_METHOD(TestForkStats)
+      {
+         CStringA s1("a string that is too long for the inline buffer");
+         CStringA s2(s1);
+
+         CStringStatsSnapshot before = CStringStats::Snapshot();
+
+         // only the first write to shared data forks
+         s2.AppendChar('!');
+         s2.AppendChar('!');
+         s1.SetAt(0, 'A');
+
+         CStringStatsSnapshot after = CStringStats::Snapshot();
+         if (!CStringStats::c_enabled)
+         {
+            Assert::IsTrue(after.m_numForks == 0);
+            return;
+         }
+
+         Assert::IsTrue(after.m_numForks == before.m_numForks + 1);
+      }
+
+      /// tests that the hash value is cached in the string data, and that
+      /// copies share the cached value
+      TEST_METHOD(TestHash)
+      {
+         const char* text = "a string that is too long for the inline buffer";
+         size_t length = strlen(text);
+
+         CStringA s1(text);
+         Assert::AreEqual(StringHash::Hash(text, length), s1.GetHash());
+         Assert::AreEqual(s1.GetHash(), std::hash<CStringA>()(s1));
+
+         // the cached value is returned until the buffer is released, even
+         // when the buffer has been modified
+         char* buffer = s1.GetBuffer();
+         size_t hash = s1.GetHash();
+         buffer[0] = 'A';
+         Assert::AreEqual(hash, s1.GetHash());
+
+         s1.ReleaseBuffer();
+         Assert::AreNotEqual(hash, s1.GetHash());
+         Assert::AreEqual(StringHash::Hash(s1.GetString(), length), s1.GetHash());
+
+         // a copy shares the string data, including the cached value
+         hash = s1.GetHash();
+         CStringA s2(s1);
+         Assert::IsTrue(s1.GetString() == s2.GetString());
+         Assert::AreEqual(hash, s2.GetHash());
+
+         s2.SetAt(0, 'a');
+         Assert::AreEqual(StringHash::Hash(text, length), s2.GetHash());
+         Assert::AreEqual(hash, s1.GetHash());
+
+         // strings in the inline buffer
+         CStringA s3("short");
+         Assert::AreEqual(StringHash::Hash("short", 5), s3.GetHash());
+
+         s3.SetAt(0, 'S');
+         Assert::AreEqual(StringHash::Hash("Short", 5), s3.GetHash());
+      }
+
+      /// tests concatenating strings with operator+
+      TEST_METHOD(TestAddOperator)
+      {
+         CStringA s1("abc");
+         CStringA s2("def");
+
+         CStringA s3 = s1 + s2;
+         Assert::AreEqual("abcdef", s3.GetString());
+
+         CStringA s4 = "<" + s1 + ", " + s2 + '>' + '!';
+         Assert::AreEqual("<abc, def>!", s4.GetString());
+
+         CStringA s5 = (s1 + s2) + (s2 + s1);
+         Assert::AreEqual("abcdefdefabc", s5.GetString());
+
+         const char* nullString = nullptr;
+         CStringA s6 = s1 + nullString;
+         Assert::AreEqual("abc", s6.GetString());
+
+         s1 = s1 + s1;
+         Assert::AreEqual("abcabc", s1.GetString());
+      }
+
+      /// tests using concatenations as C-style strings, and concatenations of
+      /// temporary strings
+      TEST_METHOD(TestAddOperatorConversion)
+      {
+         static_assert(!std::is_copy_constructible_v<decltype(CStringA() + CStringA())>,
+            "concatenations must not be copied");
+
+         CStringA s1("abc");
+         CStringA s2("def");
+
+         Assert::AreEqual(6, StringLength(s1 + s2));
+         Assert::AreEqual(8, GetLengthOf("<>", s1 + s2));
+         Assert::AreEqual(14, GetLengthOf(s1 + s2, "<" + s1 + s2 + '>'));
+
+         CStringA s3;
+         s3.FormatFast("%s!", s1 + "-" + s2);
+         Assert::AreEqual("abc-def!", s3.GetString());
+
+         // comparisons
+         Assert::IsTrue(s1 + s2 == "abcdef");
+         Assert::IsTrue("abcdef" == s1 + s2);
+         Assert::IsTrue(CStringA("abcdef") == s1 + s2);
+         Assert::IsTrue(s1 + s2 != s2 + s1);
+         Assert::IsTrue(s1 + s2 < s2);
+         Assert::IsTrue(s2 + s1 >= s1 + s2);
+
+         // assigning and appending concatenations referencing the string itself
+         s3 = s1;
+         s3 += s3 + s2;
+         Assert::AreEqual("abcabcdef", s3.GetString());
+
+         s3.Append(s1 + s3);
+         Assert::AreEqual("abcabcdefabcabcabcdef", s3.GetString());
+
+         s3 = s2 + s3 + s2;
+         Assert::AreEqual("defabcabcdefabcabcabcdefdef", s3.GetString());
+
+         // temporary strings are kept by the concatenation
+         auto concat = CStringA("a temporary string on the heap") + s1 + CStringA(",") + CStringA("tmp");
+         Assert::AreEqual("a temporary string on the heapabc,tmp", concat.GetString());
+
+         CStringA s4(concat);
+         Assert::AreEqual("a temporary string on the heapabc,tmp", s4.GetString());
+      }
+
+      /// tests assigning and appending concatenations; the parts are copied
+      /// directly into the string's buffer
+      TEST_METHOD(TestAppendConcatenation)
+      {
+         CStringPool::Enable();
+
+         CStringA s1("a string that doesn't fit into the inline buffer");
+         CStringA s2("another string that doesn't fit into the inline buffer");
+
+         CStringA text;
+         text.Reserve(200);
+
+         CStringPoolStats statsBefore = CStringPool::GetStats();
+
+         text = s1 + ", " + s2;
+         text += " and " + s1;
+
+         CStringPoolStats statsAfter = CStringPool::GetStats();
+         uint64_t numAllocations =
+            (statsAfter.m_hits + statsAfter.m_misses) - (statsBefore.m_hits + statsBefore.m_misses);
+
+         Assert::AreEqual<uint64_t>(0, numAllocations);
+         Assert::IsTrue(s1 + ", " + s2 + " and " + s1 == text);
+
+         CStringPool::Enable(false);
+
+         // concatenations referencing the string itself
+         CStringA s3("abc");
+         s3 += s3 + s3;
+         Assert::AreEqual("abcabcabc", s3.GetString());
+
+         s3 += s1 + s3;
+         Assert::IsTrue("abcabcabc" + s1 + "abcabcabc" == s3);
+
+         s3 = s3.Mid(9, 8) + s3.Left(3);
+         Assert::AreEqual("a stringabc", s3.GetString());
+
+         s3 = "<" + s3 + ">";
+         Assert::AreEqual("<a stringabc>", s3.GetString());
+      }
+
+      /// tests Reserve() and Preallocate()
+      TEST_METHOD(TestReserve)
+      {
+         CStringA s1("abc");
+         s1.Reserve(100);
+         Assert::AreEqual("abc", s1.GetString());
+         Assert::IsTrue(s1.GetAllocLength() >= 100);
+
+         // appending up to the reserved length doesn't reallocate
+         const char* buffer = s1.GetString();
+         for (int index = s1.GetLength(); index < 100; index++)
+            s1.AppendChar('x');
+
+         Assert::AreEqual(100, s1.GetLength());
+         Assert::IsTrue(buffer == s1.GetString());
+
+         CStringA s2("abc");
+         s2.Preallocate(2);
+         Assert::AreEqual("abc", s2.GetString());
+      }
+
+      /// tests ShrinkToFit() and FreeExtra()
+      TEST_METHOD(TestShrinkToFit)
+      {
+         CStringA s1('a', 1000);
+         s1.Truncate(100);
+         s1.ShrinkToFit();
+         Assert::AreEqual(100, s1.GetLength());
+         Assert::IsTrue(s1.GetAllocLength() >= 100 && s1.GetAllocLength() < 1000);
+
+         s1.Truncate(5);
+         s1.FreeExtra();
+         Assert::AreEqual("aaaaa", s1.GetString());
+         Assert::AreEqual(15, s1.GetAllocLength());
+
+         s1.Truncate(0);
+         s1.ShrinkToFit();
+         Assert::IsTrue(s1.IsEmpty());
+      }
+
+      /// tests Truncate()
+      TEST_METHOD(TestTruncate)
+      {
+         CStringA s1("a string that is too long for the inline buffer");
+         s1.Truncate(8);
+         Assert::AreEqual("a string", s1.GetString());
+
+         s1.Truncate(0);
+         Assert::IsTrue(s1.IsEmpty());
+      }
+
+      /// tests AppendChar()
+      TEST_METHOD(TestAppendChar)
+      {
+         CStringW s1;
+         for (int index = 0; index < 1000; index++)
+            s1.AppendChar(static_cast<WCHAR>(L'a' + index % 26));
+
+         Assert::AreEqual(1000, s1.GetLength());
+         Assert::AreEqual(L"abc", s1.Left(3).GetString());
+         Assert::AreEqual(L"jkl", s1.Mid(997).GetString());
+      }
+
+      /// tests Format(), for both character types
+      TEST_METHOD(TestFormat)
+      {
+         CStringA s1;
+         s1.Format("%d-%s", 42, "abc");
+         Assert::AreEqual("42-abc", s1.GetString());
+
+         CStringW s2;
+         s2.Format(L"%d-%ls", 42, L"abc");
+         Assert::AreEqual(L"42-abc", s2.GetString());
+
+         // formatted text longer than the initial buffer used to determine the length
+         CStringW s3(L'x', 1000);
+         s2.Format(L"<%ls>", s3.GetString());
+         Assert::AreEqual(1002, s2.GetLength());
+         Assert::AreEqual(L"<xx", s2.Left(3).GetString());
+         Assert::AreEqual(L"xx>", s2.Mid(999).GetString());
+      }
+   };
+
+} // namespace UnitTest
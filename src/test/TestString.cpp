@@ -1,12 +1,13 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2013-2016,2017 Michael Fink
+// Copyright (C) 2013-2016,2017,2026 Michael Fink
 //
 /// \file TestString.cpp tests CString class
 //
 
 // includes
 #include "stdafx.h"
+#include <ulib/HighResolutionTimer.hpp>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -704,8 +705,90 @@ namespace UnitTest
          Assert::AreEqual(_T("aby1"), s1.GetString());
       }
 
+      /// tests Preallocate(), GetAllocLength()
+      TEST_METHOD(TestPreallocate)
+      {
+         CString s1(_T("abc123"));
+         s1.Preallocate(100);
+
+         Assert::IsTrue(s1.GetAllocLength() >= 100);
+         Assert::AreEqual(_T("abc123"), s1.GetString());
+
+         // appending must not reallocate the buffer
+         LPCTSTR buffer = s1.GetString();
+         for (int index = s1.GetLength(); index < 100; index++)
+            s1.AppendChar(_T('x'));
+
+         Assert::AreEqual(100, s1.GetLength());
+         Assert::IsTrue(buffer == s1.GetString());
+
+         // preallocating a shared string must not modify the other string
+         CString s2(s1);
+         s2.Preallocate(200);
+         s2.AppendChar(_T('y'));
+
+         Assert::AreEqual(100, s1.GetLength());
+         Assert::AreEqual(101, s2.GetLength());
+      }
+
+      /// tests FreeExtra()
+      TEST_METHOD(TestFreeExtra)
+      {
+         CString s1(_T("abc123"));
+         s1.Preallocate(1000);
+         s1.FreeExtra();
+
+         Assert::IsTrue(s1.GetAllocLength() < 1000);
+         Assert::AreEqual(_T("abc123"), s1.GetString());
+
+         s1 += _T("456");
+         Assert::AreEqual(_T("abc123456"), s1.GetString());
+      }
+
+      /// tests Truncate()
+      TEST_METHOD(TestTruncate)
+      {
+         CString s1(_T("abc123"));
+         CString s2(s1);
+
+         s1.Truncate(3);
+         Assert::AreEqual(_T("abc"), s1.GetString());
+         Assert::AreEqual(_T("abc123"), s2.GetString());
+
+         s1.Truncate(0);
+         Assert::IsTrue(s1.IsEmpty());
+      }
+
+      /// compares building a 1 MB string by appending single characters, with
+      /// and without preallocating the buffer
+      TEST_METHOD(TestAppendCharPerformance)
+      {
+         const int length = 1024 * 1024;
+
+         for (int pass = 0; pass < 2; pass++)
+         {
+            HighResolutionTimer timer;
+            timer.Start();
+
+            CString text;
+            if (pass == 1)
+               text.Preallocate(length);
+
+            for (int index = 0; index < length; index++)
+               text += static_cast<TCHAR>(_T('a') + index % 26);
+
+            timer.Stop();
+
+            Assert::AreEqual(length, text.GetLength());
+
+            ATLTRACE(_T("append 1 MB single chars, %s: %.3f ms\n"),
+               pass == 0 ? _T("growing buffer") : _T("preallocated"),
+               timer.TotalElapsed() * 1000.0);
+         }
+      }
+
       // missing tests from CStringT: Tokenize
-      // missing tests from CSimpleStringT: GetBufferSetLength, FreeExtra, LockBuffer, UnlockBuffer
+      // missing tests from CSimpleStringT: GetBufferSetLength, LockBuffer, UnlockBuffer
 
    }; // class TestString
 
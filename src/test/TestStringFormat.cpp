@@ -0,0 +1,122 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file TestStringFormat.cpp tests for StringFormat functions
+//
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <ulib/StringFormat.hpp>
+#include <ulib/CStringView.hpp>
+#include <ulib/HighResolutionTimer.hpp>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// tests for StringFormat functions
+   TEST_CLASS(TestStringFormat)
+   {
+   public:
+      /// tests formatting integers
+      TEST_METHOD(TestFormatInteger)
+      {
+         CString text;
+
+         StringFormat::Format(text, _T("%i, %d, %u"), 42, -17, 4000000000U);
+         Assert::IsTrue(text == _T("42, -17, 4000000000"), L"integers must be formatted");
+
+         StringFormat::Format(text, _T("[%5i][%-5i][%05i][%+i]"), 42, 42, -42, 42);
+         Assert::IsTrue(text == _T("[   42][42   ][-0042][+42]"), L"width and flags must be applied");
+
+         StringFormat::Format(text, _T("%x %X %08x"), 255, 0xabcdU, 0x1234);
+         Assert::IsTrue(text == _T("ff ABCD 00001234"), L"hex numbers must be formatted");
+
+         StringFormat::Format(text, _T("%lld %lu"), -9223372036854775807LL - 1, 17UL);
+         Assert::IsTrue(text == _T("-9223372036854775808 17"), L"length modifiers must be ignored");
+
+         StringFormat::Format(text, _T("%.3d"), 7);
+         Assert::IsTrue(text == _T("007"), L"precision must set minimum number of digits");
+      }
+
+      /// tests formatting floating point values
+      TEST_METHOD(TestFormatFloat)
+      {
+         CString text;
+
+         StringFormat::Format(text, _T("%f|%.2f|%8.3f|%-8.1f|"), 1.5, 3.14159, -2.5, 0.25f);
+         Assert::IsTrue(text == _T("1.500000|3.14|  -2.500|0.2     |"), L"floats must be formatted");
+
+         StringFormat::Format(text, _T("%e %.2E %g"), 12345.678, 0.000123, 0.0001);
+         Assert::IsTrue(text == _T("1.234568e+04 1.23E-04 0.0001"), L"scientific and general format must be used");
+
+         StringFormat::Format(text, _T("%08.2f"), -3.5);
+         Assert::IsTrue(text == _T("-0003.50"), L"zero padding must be applied after sign");
+      }
+
+      /// tests formatting characters and strings
+      TEST_METHOD(TestFormatString)
+      {
+         CString text;
+         CString name = _T("world");
+         CStringView view(_T("view text"), 4);
+
+         StringFormat::Format(text, _T("%s, %s%c %s"), _T("Hello"), name, _T('!'), view);
+         Assert::IsTrue(text == _T("Hello, world! view"), L"strings must be formatted");
+
+         StringFormat::Format(text, _T("[%7s][%-7s][%.3s]"), name, name, name);
+         Assert::IsTrue(text == _T("[  world][world  ][wor]"), L"width and precision must be applied");
+
+         StringFormat::Format(text, _T("100%% %s"), _T("done"));
+         Assert::IsTrue(text == _T("100% done"), L"percent sign must be formatted");
+      }
+
+      /// tests appending formatted text
+      TEST_METHOD(TestAppendFormat)
+      {
+         CString text = _T("line ");
+         CString copy = text;
+
+         StringFormat::AppendFormat(text, _T("%u: %s"), 42U, _T("text"));
+         Assert::IsTrue(text == _T("line 42: text"), L"text must be appended");
+         Assert::IsTrue(copy == _T("line "), L"copy of string must not be modified");
+
+         // append more than the initially reserved buffer
+         CString longText(_T('x'), 1000);
+         for (int index = 0; index < 10; index++)
+            StringFormat::AppendFormat(text, _T("%s%i"), longText, index);
+
+         Assert::AreEqual(13 + 10 * 1001, text.GetLength(), L"long text must be appended");
+         Assert::IsTrue(text.Right(1001) == longText + _T("9"), L"long text must be appended");
+      }
+
+      /// compares formatting with Format() and with StringFormat::Format()
+      TEST_METHOD(TestFormatPerformance)
+      {
+         const int numIterations = 100000;
+
+         for (int pass = 0; pass < 2; pass++)
+         {
+            HighResolutionTimer timer;
+            timer.Start();
+
+            CString text;
+            for (int index = 0; index < numIterations; index++)
+            {
+               if (pass == 0)
+                  text.Format(_T("%04u-%02u-%02uT%02u:%02u:%02u.%03u"), 2026U, 10U, 17U, 12U, index % 60, 13U, index % 1000);
+               else
+                  StringFormat::Format(text, _T("%04u-%02u-%02uT%02u:%02u:%02u.%03u"), 2026U, 10U, 17U, 12U, index % 60, 13U, index % 1000);
+            }
+
+            timer.Stop();
+
+            ATLTRACE(_T("%s: %.3f ms\n"),
+               pass == 0 ? _T("Format()") : _T("StringFormat::Format()"),
+               timer.TotalElapsed() * 1000.0);
+         }
+      }
+   };
+
+} // namespace UnitTest
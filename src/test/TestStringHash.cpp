@@ -0,0 +1,141 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file TestStringHash.cpp tests for StringHash functions and std::hash for strings
+//
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <ulib/StringHash.hpp>
+#include <ulib/CStringView.hpp>
+#include <ulib/HighResolutionTimer.hpp>
+#include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// tests for StringHash functions
+   TEST_CLASS(TestStringHash)
+   {
+   public:
+      /// tests hashing bytes of all lengths up to the block size
+      TEST_METHOD(TestHashLengths)
+      {
+         unsigned char buffer[200] = {};
+         for (size_t index = 0; index < sizeof(buffer); index++)
+            buffer[index] = static_cast<unsigned char>(index * 7);
+
+         std::unordered_set<uint64_t> hashValues;
+         for (size_t length = 0; length <= sizeof(buffer); length++)
+         {
+            uint64_t hash = StringHash::Hash64(buffer, length);
+            Assert::IsTrue(hash == StringHash::Hash64(buffer, length), L"hash value must be the same for same input");
+
+            hashValues.insert(hash);
+         }
+
+         Assert::AreEqual<size_t>(sizeof(buffer) + 1, hashValues.size(), L"all prefixes must have different hash values");
+      }
+
+      /// tests that a single changed bit changes the hash value
+      TEST_METHOD(TestHashBitChange)
+      {
+         unsigned char buffer[100] = {};
+
+         uint64_t hash = StringHash::Hash64(buffer, sizeof(buffer));
+         for (size_t bit = 0; bit < sizeof(buffer) * 8; bit++)
+         {
+            buffer[bit / 8] ^= static_cast<unsigned char>(1 << (bit % 8));
+            Assert::IsTrue(hash != StringHash::Hash64(buffer, sizeof(buffer)), L"changed bit must change hash value");
+            buffer[bit / 8] ^= static_cast<unsigned char>(1 << (bit % 8));
+         }
+      }
+
+      /// tests std::hash for strings and views
+      TEST_METHOD(TestStdHash)
+      {
+         CString text1 = _T("logger.name");
+         CString text2 = _T("logger.");
+         text2 += _T("name");
+
+         std::hash<CString> hashString;
+         std::hash<CStringView> hashView;
+
+         Assert::IsTrue(hashString(text1) == hashString(text2), L"equal strings must have equal hash values");
+         Assert::IsTrue(hashString(text1) == hashView(CStringView(text1)), L"string and view must have equal hash values");
+         Assert::IsTrue(hashString(text1) == hashView(CStringView(_T("logger.name.suffix"), 11)), L"view on part of string must have equal hash value");
+
+         // modifying the string must change the hash value
+         size_t hashBefore = hashString(text1);
+         text1 += _T("2");
+         Assert::IsTrue(hashBefore != hashString(text1), L"modified string must have different hash value");
+
+         text1.SetAt(0, _T('L'));
+         Assert::IsTrue(hashString(text1) == hashString(CString(_T("Logger.name2"))), L"hash value must be updated after SetAt()");
+      }
+
+      /// tests using strings as keys of unordered containers
+      TEST_METHOD(TestUnorderedMap)
+      {
+         std::unordered_map<CString, int> map;
+
+         for (int index = 0; index < 1000; index++)
+         {
+            CString key;
+            key.Format(_T("key%i"), index);
+            map[key] = index;
+         }
+
+         Assert::AreEqual<size_t>(1000, map.size(), L"map must contain all keys");
+         Assert::AreEqual(42, map[CString(_T("key42"))], L"key must be found");
+         Assert::IsTrue(map.find(CString(_T("key1000"))) == map.end(), L"missing key must not be found");
+      }
+
+      /// compares lookups in std::map and std::unordered_map with string keys
+      TEST_METHOD(TestLookupPerformance)
+      {
+         const int numKeys = 10000;
+         const int numLookups = 1000000;
+
+         std::vector<CString> keys;
+         std::map<CString, int> orderedMap;
+         std::unordered_map<CString, int> unorderedMap;
+
+         for (int index = 0; index < numKeys; index++)
+         {
+            CString key;
+            key.Format(_T("application.module%i.logger"), index);
+
+            keys.push_back(key);
+            orderedMap[key] = index;
+            unorderedMap[key] = index;
+         }
+
+         for (int pass = 0; pass < 2; pass++)
+         {
+            HighResolutionTimer timer;
+            timer.Start();
+
+            unsigned int sum = 0;
+            for (int index = 0; index < numLookups; index++)
+            {
+               const CString& key = keys[index % numKeys];
+               sum += pass == 0 ? orderedMap.find(key)->second : unorderedMap.find(key)->second;
+            }
+
+            timer.Stop();
+
+            ATLTRACE(_T("%s: %.3f ms, sum %u\n"),
+               pass == 0 ? _T("std::map") : _T("std::unordered_map"),
+               timer.TotalElapsed() * 1000.0,
+               sum);
+         }
+      }
+   };
+
+} // namespace UnitTest
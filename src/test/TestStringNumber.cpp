@@ -0,0 +1,162 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file TestStringNumber.cpp tests for StringNumber functions
+//
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <ulib/StringNumber.hpp>
+#include <ulib/HighResolutionTimer.hpp>
+#include <climits>
+#include <cstdint>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// tests for StringNumber functions
+   TEST_CLASS(TestStringNumber)
+   {
+   public:
+      /// tests appending integers
+      TEST_METHOD(TestAppendInt)
+      {
+         CString text = _T("x");
+
+         StringNumber::AppendInt(text, 0);
+         StringNumber::AppendInt(text, -17);
+         StringNumber::AppendUInt(text, 4000000000U);
+         Assert::IsTrue(text == _T("x0-174000000000"), L"integers must be appended");
+
+         text.Empty();
+         StringNumber::AppendInt(text, 7, 3);
+         StringNumber::AppendInt(text, -7, 3);
+         StringNumber::AppendUInt(text, 12345U, 3);
+         Assert::IsTrue(text == _T("007-00712345"), L"numbers must be padded with zeros");
+
+         text.Empty();
+         StringNumber::AppendInt(text, INT64_MIN);
+         Assert::IsTrue(text == _T("-9223372036854775808"), L"minimum value must be appended");
+
+         text.Empty();
+         StringNumber::AppendUInt(text, UINT64_MAX);
+         Assert::IsTrue(text == _T("18446744073709551615"), L"maximum value must be appended");
+
+         // all digit pairs
+         for (unsigned int value = 0; value < 1000; value++)
+         {
+            CString expected;
+            expected.Format(_T("%u"), value);
+
+            text.Empty();
+            StringNumber::AppendUInt(text, value);
+            Assert::IsTrue(text == expected, L"number must be formatted like Format()");
+         }
+      }
+
+      /// tests appending hex numbers
+      TEST_METHOD(TestAppendHex)
+      {
+         CString text;
+
+         StringNumber::AppendHex(text, 0);
+         text += _T(' ');
+         StringNumber::AppendHex(text, 0xabcdU, 8);
+         text += _T(' ');
+         StringNumber::AppendHex(text, 0xabcdU, 0, true);
+         text += _T(' ');
+         StringNumber::AppendHex(text, -1);
+         Assert::IsTrue(text == _T("0 0000abcd ABCD ffffffff"), L"hex numbers must be appended");
+      }
+
+      /// tests appending floating point values
+      TEST_METHOD(TestAppendDouble)
+      {
+         CString text;
+
+         StringNumber::AppendDouble(text, 0.1);
+         text += _T(' ');
+         StringNumber::AppendDouble(text, -2.5, 3);
+         text += _T(' ');
+         StringNumber::AppendDouble(text, 1e20);
+         Assert::IsTrue(text == _T("0.1 -2.500 1e+20"), L"floating point values must be appended");
+      }
+
+      /// tests parsing integers
+      TEST_METHOD(TestParseInt)
+      {
+         int value = 0;
+         Assert::IsTrue(StringNumber::ParseInt(CString(_T("-42")), value), L"number must be parsed");
+         Assert::AreEqual(-42, value, L"parsed value must be correct");
+
+         Assert::IsTrue(StringNumber::ParseInt(CString(_T("+17")), value), L"number with plus sign must be parsed");
+         Assert::AreEqual(17, value, L"parsed value must be correct");
+
+         Assert::IsTrue(StringNumber::ParseInt(CString(_T("ff")), value, 16), L"hex number must be parsed");
+         Assert::AreEqual(255, value, L"parsed value must be correct");
+
+         Assert::IsFalse(StringNumber::ParseInt(CString(_T("")), value), L"empty text must not be parsed");
+         Assert::IsFalse(StringNumber::ParseInt(CString(_T("12a")), value), L"trailing chars must not be accepted");
+         Assert::IsFalse(StringNumber::ParseInt(CString(_T(" 12")), value), L"whitespace must not be accepted");
+         Assert::IsFalse(StringNumber::ParseInt(CString(_T("+-12")), value), L"two signs must not be accepted");
+         Assert::IsFalse(StringNumber::ParseInt(CString(_T("99999999999")), value), L"out of range value must not be accepted");
+         Assert::AreEqual(255, value, L"value must not be modified on error");
+
+         unsigned int unsignedValue = 0;
+         Assert::IsFalse(StringNumber::ParseInt(CString(_T("-1")), unsignedValue), L"negative value must not be accepted");
+      }
+
+      /// tests parsing floating point values
+      TEST_METHOD(TestParseDouble)
+      {
+         double value = 0.0;
+         Assert::IsTrue(StringNumber::ParseDouble(CString(_T("3.25")), value), L"number must be parsed");
+         Assert::AreEqual(3.25, value, L"parsed value must be correct");
+
+         Assert::IsTrue(StringNumber::ParseDouble(CString(_T("-1.5e3")), value), L"scientific number must be parsed");
+         Assert::AreEqual(-1500.0, value, L"parsed value must be correct");
+
+         Assert::IsFalse(StringNumber::ParseDouble(CString(_T("1.5x")), value), L"trailing chars must not be accepted");
+         Assert::AreEqual(-1500.0, value, L"value must not be modified on error");
+
+         // round trip
+         CString text;
+         StringNumber::AppendDouble(text, 0.1 + 0.2);
+         Assert::IsTrue(StringNumber::ParseDouble(text, value), L"appended value must be parsed");
+         Assert::IsTrue(0.1 + 0.2 == value, L"value must be the same after round trip");
+      }
+
+      /// compares appending numbers with Format() and with StringNumber::AppendUInt()
+      TEST_METHOD(TestAppendPerformance)
+      {
+         const unsigned int numIterations = 1000000;
+
+         for (int pass = 0; pass < 2; pass++)
+         {
+            HighResolutionTimer timer;
+            timer.Start();
+
+            CString text;
+            for (unsigned int index = 0; index < numIterations; index++)
+            {
+               if (pass == 0)
+                  text.Format(_T("%u"), index);
+               else
+               {
+                  text.Empty();
+                  StringNumber::AppendUInt(text, index);
+               }
+            }
+
+            timer.Stop();
+
+            ATLTRACE(_T("%s: %.3f ms\n"),
+               pass == 0 ? _T("Format()") : _T("StringNumber::AppendUInt()"),
+               timer.TotalElapsed() * 1000.0);
+         }
+      }
+   };
+
+} // namespace UnitTest
@@ -0,0 +1,240 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file TestStringSearch.cpp tests for string search kernels
+//
+
+#include "stdafx.h"
+#include <ulib/StringSearch.hpp>
+#include <ulib/HighResolutionTimer.hpp>
+#include <vector>
+#include <algorithm>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// Tests for string search kernels
+   TEST_CLASS(TestStringSearch)
+   {
+      /// creates a text with given length, consisting of the characters a to d
+      template <typename T>
+      static std::vector<T> CreateText(size_t length)
+      {
+         std::vector<T> text(length + 1);
+         for (size_t index = 0; index < length; index++)
+            text[index] = static_cast<T>('a' + (index * 7 + index / 5) % 4);
+
+         return text;
+      }
+
+      /// checks all search functions against the scalar implementation, for
+      /// all text lengths that cross the vector boundaries
+      template <typename T>
+      static void CheckAgainstScalar()
+      {
+         const T charSet[] = { 'x', 'c', 'y', 0 };
+         const T subStr[] = { 'c', 'a', 'd', 0 };
+
+         for (size_t length = 0; length < 100; length++)
+         {
+            std::vector<T> text = CreateText<T>(length);
+            const T* str = text.data();
+
+            // put in a character that only appears once, at varying positions
+            if (length > 0)
+               text[length / 3] = 'x';
+
+            Assert::IsTrue(
+               StringSearch::Scalar::FindChar(str, length, T('x')) ==
+               StringSearch::FindChar(str, length, T('x')),
+               L"FindChar() must find the same character");
+
+            Assert::IsTrue(
+               StringSearch::Scalar::ReverseFindChar(str, length, T('b')) ==
+               StringSearch::ReverseFindChar(str, length, T('b')),
+               L"ReverseFindChar() must find the same character");
+
+            Assert::IsTrue(
+               StringSearch::Scalar::FindCharOf(str, length, charSet, 3, true) ==
+               StringSearch::FindCharOf(str, length, charSet, 3, true),
+               L"FindCharOf() must find the same character in the set");
+
+            Assert::IsTrue(
+               StringSearch::Scalar::FindCharOf(str, length, charSet, 3, false) ==
+               StringSearch::FindCharOf(str, length, charSet, 3, false),
+               L"FindCharOf() must find the same character not in the set");
+
+            Assert::IsTrue(
+               StringSearch::Scalar::FindString(str, length, subStr, 3) ==
+               StringSearch::FindString(str, length, subStr, 3),
+               L"FindString() must find the same substring");
+
+            std::vector<T> scalarText = text;
+            std::vector<T> vectorText = text;
+
+            Assert::AreEqual(
+               StringSearch::Scalar::ReplaceChar(scalarText.data(), length, T('a'), T('z')),
+               StringSearch::ReplaceChar(vectorText.data(), length, T('a'), T('z')),
+               L"ReplaceChar() must replace the same number of characters");
+            Assert::IsTrue(scalarText == vectorText, L"replaced texts must be equal");
+
+            size_t scalarLength = StringSearch::Scalar::RemoveChar(scalarText.data(), length, T('b'));
+            size_t vectorLength = StringSearch::RemoveChar(vectorText.data(), length, T('b'));
+
+            Assert::AreEqual(scalarLength, vectorLength, L"RemoveChar() must return the same length");
+            Assert::IsTrue(
+               std::equal(scalarText.begin(), scalarText.begin() + scalarLength, vectorText.begin()),
+               L"texts with removed characters must be equal");
+         }
+      }
+
+#ifdef ULIB_STRINGSEARCH_X86
+      /// checks the AVX2 kernels against the scalar implementation, calling
+      /// them directly; run in the debug configuration, this also checks
+      /// that the kernels work when they aren't optimized
+      template <typename T>
+      static void CheckAvx2AgainstScalar()
+      {
+         const T charSet[] = { 'x', 'c', 'y', 0 };
+         const T subStr[] = { 'c', 'a', 'd', 0 };
+
+         for (size_t length = 0; length < 100; length++)
+         {
+            std::vector<T> text = CreateText<T>(length);
+            const T* str = text.data();
+
+            if (length > 0)
+               text[length / 3] = 'x';
+
+            Assert::IsTrue(
+               StringSearch::Scalar::FindChar(str, length, T('x')) ==
+               StringSearch::Avx2::FindChar(str, length, T('x')),
+               L"FindChar() must find the same character");
+
+            Assert::IsTrue(
+               StringSearch::Scalar::ReverseFindChar(str, length, T('b')) ==
+               StringSearch::Avx2::ReverseFindChar(str, length, T('b')),
+               L"ReverseFindChar() must find the same character");
+
+            Assert::IsTrue(
+               StringSearch::Scalar::FindCharOf(str, length, charSet, 3, false) ==
+               StringSearch::Avx2::FindCharOf(str, length, charSet, 3, false),
+               L"FindCharOf() must find the same character not in the set");
+
+            Assert::IsTrue(
+               StringSearch::Scalar::FindString(str, length, subStr, 3) ==
+               StringSearch::Avx2::FindString(str, length, subStr, 3),
+               L"FindString() must find the same substring");
+
+            std::vector<T> scalarText = text;
+            std::vector<T> vectorText = text;
+
+            Assert::AreEqual(
+               StringSearch::Scalar::ReplaceChar(scalarText.data(), length, T('a'), T('z')),
+               StringSearch::Avx2::ReplaceChar(vectorText.data(), length, T('a'), T('z')),
+               L"ReplaceChar() must replace the same number of characters");
+            Assert::IsTrue(scalarText == vectorText, L"replaced texts must be equal");
+
+            size_t scalarLength = StringSearch::Scalar::RemoveChar(scalarText.data(), length, T('b'));
+            size_t vectorLength = StringSearch::Avx2::RemoveChar(vectorText.data(), length, T('b'));
+
+            Assert::AreEqual(scalarLength, vectorLength, L"RemoveChar() must return the same length");
+            Assert::IsTrue(
+               std::equal(scalarText.begin(), scalarText.begin() + scalarLength, vectorText.begin()),
+               L"texts with removed characters must be equal");
+         }
+      }
+#endif
+
+   public:
+      /// tests finding characters
+      TEST_METHOD(TestFindChar)
+      {
+         const char text[] = "0123456789abcdef0123456789ABCDEF0123456789";
+         size_t length = sizeof(text) - 1;
+
+         Assert::IsTrue(text + 10 == StringSearch::FindChar(text, length, 'a'), L"must find first char");
+         Assert::IsTrue(text + 31 == StringSearch::FindChar(text, length, 'F'), L"must find char in second block");
+         Assert::IsNull(StringSearch::FindChar(text, length, 'x'), L"must not find missing char");
+         Assert::IsNull(StringSearch::FindChar(text, 0, '0'), L"must not find char in empty text");
+
+         Assert::IsTrue(text + 41 == StringSearch::ReverseFindChar(text, length, '9'), L"must find char from end");
+         Assert::IsTrue(text + 0 == StringSearch::ReverseFindChar(text, 16, '0'), L"must find char at start");
+      }
+
+      /// tests finding substrings
+      TEST_METHOD(TestFindString)
+      {
+         const wchar_t text[] = L"The quick brown fox jumps over the lazy dog, the end.";
+         size_t length = sizeof(text) / sizeof(*text) - 1;
+
+         Assert::IsTrue(text + 31 == StringSearch::FindString(text, length, L"the", 3), L"must find substring");
+         Assert::IsTrue(text + 49 == StringSearch::FindString(text, length, L"end.", 4), L"must find substring at end");
+         Assert::IsTrue(text == StringSearch::FindString(text, length, L"", 0), L"must find empty substring at start");
+         Assert::IsNull(StringSearch::FindString(text, length, L"cat", 3), L"must not find missing substring");
+      }
+
+      /// tests all kernels with narrow characters
+      TEST_METHOD(TestKernelsNarrow)
+      {
+         CheckAgainstScalar<char>();
+      }
+
+      /// tests all kernels with wide characters
+      TEST_METHOD(TestKernelsWide)
+      {
+         CheckAgainstScalar<wchar_t>();
+      }
+
+      /// tests the AVX2 kernels directly, when the CPU supports AVX2
+      TEST_METHOD(TestKernelsAvx2)
+      {
+#ifdef ULIB_STRINGSEARCH_X86
+         if (StringSearch::GetCpuLevel() != StringSearch::CpuLevel::avx2)
+            return;
+
+         CheckAvx2AgainstScalar<char>();
+         CheckAvx2AgainstScalar<wchar_t>();
+#endif
+      }
+
+      /// measures search speed of vector and scalar kernels, for texts from
+      /// 16 bytes to 1 MB
+      TEST_METHOD(TestSearchPerformance)
+      {
+         ATLTRACE(_T("CPU level: %i\n"), static_cast<int>(StringSearch::GetCpuLevel()));
+
+         for (size_t length = 16; length <= 1024 * 1024; length *= 4)
+         {
+            std::vector<char> text = CreateText<char>(length);
+            text[length - 1] = 'x';
+
+            size_t numIterations = 64 * 1024 * 1024 / length;
+
+            HighResolutionTimer scalarTimer;
+            scalarTimer.Start();
+
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+               Assert::IsNotNull(StringSearch::Scalar::FindChar(text.data(), length, 'x'));
+
+            scalarTimer.Stop();
+
+            HighResolutionTimer vectorTimer;
+            vectorTimer.Start();
+
+            for (size_t iteration = 0; iteration < numIterations; iteration++)
+               Assert::IsNotNull(StringSearch::FindChar(text.data(), length, 'x'));
+
+            vectorTimer.Stop();
+
+            ATLTRACE(_T("FindChar, %u bytes: scalar %.3f ms, vector %.3f ms\n"),
+               static_cast<unsigned int>(length),
+               scalarTimer.TotalElapsed() * 1000.0,
+               vectorTimer.TotalElapsed() * 1000.0);
+         }
+      }
+   };
+
+} // namespace UnitTest
@@ -1,11 +1,15 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2020 Michael Fink
+// Copyright (C) 2020,2026 Michael Fink
 //
 /// \file TestUTF8.cpp unit test for UTF8 functions
 //
 #include "stdafx.h"
 #include <ulib/UTF8.hpp>
+#include <ulib/UTF8Convert.hpp>
+#include <ulib/HighResolutionTimer.hpp>
+#include <string>
+#include <vector>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -39,6 +43,157 @@ namespace UnitTest
          Assert::AreEqual(_T("\u20ac\uFEFFabc123"), text,
             L"UTF8-8 text must have been converted correctly");
       }
+
+      /// tests converting invalid text and code points outside the BMP
+      TEST_METHOD(TestConvertSpecialChars)
+      {
+         CString text = UTF8ToString("a\xff" "b\xf0\x9f\x98\x80");
+         Assert::IsTrue(text == CString(L"a\xfffd" L"b\U0001F600"), L"invalid sequence must be replaced");
+
+         std::vector<char> buffer;
+         StringToUTF8(text, buffer);
+         Assert::AreEqual<std::string>("a\xef\xbf\xbd" "b\xf0\x9f\x98\x80", std::string{ buffer.data() },
+            L"code point outside the BMP must be converted");
+
+         StringToUTF8(CString(), buffer);
+         Assert::AreEqual<size_t>(1, buffer.size(), L"empty string must be converted to terminator");
+         Assert::IsTrue(UTF8ToString("").IsEmpty(), L"empty text must be converted");
+      }
+
+      /// tests length-aware conversion functions
+      TEST_METHOD(TestConvertWithLength)
+      {
+         // text isn't zero terminated at the given length
+         const char* utf8Text = "\xe2\x82\xac" "abc" "\xc3\xa4" "def";
+         CString text = UTF8ToString(utf8Text, 8);
+         Assert::IsTrue(text == CString(L"\x20ac" L"abc\xe4"), L"only given length must be converted");
+
+         Assert::AreEqual<size_t>(5, UTF8ToString(utf8Text, 8, nullptr, 0), L"characters must be measured");
+         Assert::AreEqual<size_t>(4, StringToUTF8(text.GetString(), 2, nullptr, 0), L"bytes must be measured");
+
+         // buffer too small; only complete characters are written
+         char buffer[4] = {};
+         Assert::AreEqual<size_t>(0, StringToUTF8(text.GetString(), text.GetLength(), buffer, 2),
+            L"character that doesn't fit must not be written");
+         Assert::AreEqual<size_t>(4, StringToUTF8(text.GetString(), text.GetLength(), buffer, 4),
+            L"only characters that fit must be written");
+         Assert::IsTrue(std::string(buffer, 4) == "\xe2\x82\xac" "a", L"characters must be converted");
+
+         // embedded zero characters are converted, too
+         std::string utf8WithZero;
+         StringToUTF8(_T("a\0b"), 3, utf8WithZero);
+         Assert::IsTrue(utf8WithZero == std::string("a\0b", 3), L"zero character must be converted");
+         Assert::AreEqual(3, UTF8ToString(utf8WithZero.data(), utf8WithZero.size()).GetLength(),
+            L"zero character must be converted back");
+      }
+
+      /// tests appending converted text to existing strings
+      TEST_METHOD(TestConvertAppend)
+      {
+         std::string utf8Text = "x";
+         utf8Text.reserve(64);
+         const char* data = utf8Text.data();
+
+         CString text = L"\x20ac" L"abc";
+         Assert::AreEqual<size_t>(6, StringToUTF8(text.GetString(), text.GetLength(), utf8Text), L"bytes must be appended");
+         Assert::IsTrue(utf8Text == "x\xe2\x82\xac" "abc", L"text must be appended");
+         Assert::IsTrue(data == utf8Text.data(), L"string with enough capacity must not be reallocated");
+
+         CString appended = _T("x");
+         appended.Preallocate(64);
+         const TCHAR* buffer = appended.GetString();
+
+         Assert::AreEqual<size_t>(4, UTF8ToString(utf8Text.data() + 1, utf8Text.size() - 1, appended), L"characters must be appended");
+         Assert::IsTrue(appended == CString(L"x\x20ac" L"abc"), L"text must be appended");
+         Assert::IsTrue(buffer == appended.GetString(), L"string with enough capacity must not be reallocated");
+
+         Assert::AreEqual<size_t>(0, UTF8ToString("", 0, appended), L"empty text must append nothing");
+         Assert::AreEqual(5, appended.GetLength(), L"string must be unchanged");
+      }
+
+      /// tests that the SIMD kernels produce the same result as the scalar implementation
+      TEST_METHOD(TestConvertKernels)
+      {
+         const char* pieces[] =
+         {
+            "a", "text ", "\xc3\xa4", "\xe2\x82\xac", "\xe4\xb8\xad", "\xf0\x9f\x98\x80",
+            "\xd0\xb0", "\xed\xa0\x80", "\xc0\xaf", "\xff", "\x80", "\xe0\xa0", "\xf4\x90\x80\x80",
+         };
+
+         unsigned int random = 42;
+         for (int iteration = 0; iteration < 2000; iteration++)
+         {
+            // mostly valid text, with some invalid sequences
+            std::string text;
+            for (int index = 0; index < 40; index++)
+            {
+               random = random * 1103515245 + 12345;
+               unsigned int piece = (random >> 16) % 64;
+               text += pieces[piece < 7 * 8 ? piece / 8 : piece % std::size(pieces)];
+            }
+
+            size_t length = text.size();
+            std::vector<wchar_t> expected(length), converted(length);
+
+            size_t expectedLength = UTF8Convert::Scalar::ToWide(expected.data(), length, text.data(), length);
+            size_t convertedLength = UTF8Convert::ToWide(converted.data(), length, text.data(), length);
+
+            Assert::AreEqual(expectedLength, convertedLength, L"converted length must be equal");
+            Assert::IsTrue(std::equal(expected.begin(), expected.begin() + expectedLength, converted.begin()),
+               L"converted text must be equal");
+
+            Assert::AreEqual(expectedLength, UTF8Convert::ToWide(nullptr, 0, text.data(), length),
+               L"measured length must be equal");
+            Assert::AreEqual(UTF8Convert::Scalar::Validate(text.data(), length), UTF8Convert::Validate(text.data(), length),
+               L"validated length must be equal");
+            Assert::AreEqual(UTF8Convert::Scalar::CountCodePoints(text.data(), length), UTF8Convert::CountCodePoints(text.data(), length),
+               L"number of code points must be equal");
+         }
+      }
+
+      /// measures conversion throughput of ASCII, Latin-1 heavy and CJK text
+      TEST_METHOD(TestConvertPerformance)
+      {
+         const char* corpusNames[] = { "ASCII", "Latin-1", "CJK" };
+         const char* corpusTexts[] =
+         {
+            "The quick brown fox jumps over the lazy dog. ",
+            "\xc3\x9c" "ber \xc3\xa4hnliche Stra\xc3\x9f" "en f\xc3\xa4hrt der Fu\xc3\x9f" "g\xc3\xa4nger \xc3\xb6" "fter. ",
+            "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe6\x96\x87\xe7\xab\xa0\xe3\x81\xa8\xe4\xb8\xad\xe6\x96\x87\xe3\x80\x82",
+         };
+
+         for (size_t corpus = 0; corpus < std::size(corpusTexts); corpus++)
+         {
+            std::string text;
+            while (text.size() < 4 * 1024 * 1024)
+               text += corpusTexts[corpus];
+
+            size_t length = text.size();
+            std::vector<wchar_t> buffer(length);
+
+            for (int pass = 0; pass < 3; pass++)
+            {
+               HighResolutionTimer timer;
+               timer.Start();
+
+               if (pass == 0)
+                  UTF8Convert::Scalar::ToWide(buffer.data(), length, text.data(), length);
+               else if (pass == 1)
+                  UTF8Convert::ToWide(buffer.data(), length, text.data(), length);
+               else
+                  UTF8ToString(text.c_str());
+
+               timer.Stop();
+
+               double elapsed = timer.TotalElapsed();
+               ATLTRACE(_T("%hs, %s: %.3f ms, %.1f MB/s\n"),
+                  corpusNames[corpus],
+                  pass == 0 ? _T("scalar") : pass == 1 ? _T("UTF8Convert::ToWide()") : _T("UTF8ToString()"),
+                  elapsed * 1000.0,
+                  elapsed > 0.0 ? length / elapsed / (1024.0 * 1024.0) : 0.0);
+            }
+         }
+      }
    };
 
 } // namespace UnitTest
@@ -0,0 +1,107 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file TestUTF8Decoder.cpp tests for UTF8Decoder class
+//
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include <ulib/UTF8Decoder.hpp>
+#include <ulib/Exception.hpp>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// tests for UTF8Decoder class
+   TEST_CLASS(TestUTF8Decoder)
+   {
+      /// decodes text in chunks of given size
+      static std::wstring DecodeChunks(UTF8Decoder& decoder, const std::string& text, size_t chunkSize)
+      {
+         std::wstring result;
+         std::vector<wchar_t> buffer(UTF8Decoder::GetMaxDecodedLength(chunkSize));
+
+         for (size_t pos = 0; pos < text.size(); pos += chunkSize)
+         {
+            size_t length = std::min(chunkSize, text.size() - pos);
+            size_t decodedLength = decoder.Decode(text.data() + pos, length, buffer.data());
+            result.append(buffer.data(), decodedLength);
+         }
+
+         size_t decodedLength = decoder.Finish(buffer.data());
+         result.append(buffer.data(), decodedLength);
+
+         return result;
+      }
+
+   public:
+      /// tests decoding text split at every possible position
+      TEST_METHOD(TestDecodeChunks)
+      {
+         // U+20AC EURO SIGN, U+00E4, U+1F600 and ASCII characters
+         std::string text = "a\xe2\x82\xac" "b\xc3\xa4\xf0\x9f\x98\x80" "cd";
+         std::wstring expected = L"a\x20ac" L"b\xe4\U0001F600" L"cd";
+
+         for (size_t chunkSize = 1; chunkSize <= text.size(); chunkSize++)
+         {
+            UTF8Decoder decoder;
+            Assert::IsTrue(expected == DecodeChunks(decoder, text, chunkSize),
+               L"text must be decoded independent of chunk size");
+            Assert::IsFalse(decoder.HasPendingBytes(), L"no bytes must be pending after Finish()");
+         }
+      }
+
+      /// tests decoding code points outside the BMP
+      TEST_METHOD(TestDecodeSupplementary)
+      {
+         UTF8Decoder decoder;
+
+         wchar_t buffer[UTF8Convert::c_maxSequenceLength + 3];
+         Assert::AreEqual<size_t>(0, decoder.Decode("\xf0\x9f", 2, buffer), L"incomplete sequence must be kept");
+         Assert::IsTrue(decoder.HasPendingBytes(), L"bytes must be pending");
+
+         size_t length = decoder.Decode("\x98\x80", 2, buffer);
+         if (UTF8Convert::IsWideUTF16())
+         {
+            Assert::AreEqual<size_t>(2, length, L"code point must be decoded as surrogate pair");
+            Assert::IsTrue(buffer[0] == 0xD83D && buffer[1] == 0xDE00, L"surrogate pair must be correct");
+         }
+         else
+         {
+            Assert::AreEqual<size_t>(1, length, L"code point must be decoded as one character");
+            Assert::IsTrue(static_cast<char32_t>(buffer[0]) == 0x1F600, L"code point must be correct");
+         }
+      }
+
+      /// tests the error policies
+      TEST_METHOD(TestErrorPolicy)
+      {
+         // invalid byte, invalid continuation and incomplete sequence at the end
+         std::string text = "a\xff" "b\xe2\x28" "c\xe2\x82";
+
+         for (size_t chunkSize = 1; chunkSize <= text.size(); chunkSize++)
+         {
+            UTF8Decoder replaceDecoder(UTF8Decoder::ErrorPolicy::replace);
+            Assert::IsTrue(L"a\xfffd" L"b\xfffd(c\xfffd" == DecodeChunks(replaceDecoder, text, chunkSize),
+               L"invalid sequences must be replaced");
+
+            UTF8Decoder skipDecoder(UTF8Decoder::ErrorPolicy::skip);
+            Assert::IsTrue(L"ab(c" == DecodeChunks(skipDecoder, text, chunkSize),
+               L"invalid sequences must be skipped");
+         }
+
+         UTF8Decoder throwDecoder(UTF8Decoder::ErrorPolicy::throwException);
+         Assert::ExpectException<Exception>([&]() { DecodeChunks(throwDecoder, text, 4); },
+            L"invalid sequence must throw");
+         Assert::IsFalse(throwDecoder.HasPendingBytes(), L"decoder must be reset after throwing");
+
+         Assert::ExpectException<Exception>([&]() { DecodeChunks(throwDecoder, "ab\xe2\x82", 3); },
+            L"incomplete sequence at the end must throw");
+      }
+   };
+
+} // namespace UnitTest
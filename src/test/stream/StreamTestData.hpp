@@ -0,0 +1,25 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file StreamTestData.hpp test data for stream tests
+//
+#pragma once
+
+// needed includes
+#include <vector>
+
+namespace UnitTest
+{
+   /// returns test data with given length; the bytes differ from their
+   /// neighbours, and don't repeat with a power-of-two period
+   inline std::vector<BYTE> GetStreamTestData(size_t length)
+   {
+      std::vector<BYTE> data(length);
+      for (size_t index = 0; index < length; index++)
+         data[index] = static_cast<BYTE>(index * 7 + 3);
+
+      return data;
+   }
+
+} // namespace UnitTest
@@ -0,0 +1,198 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file TestAsyncFileStream.cpp tests for AsyncFileStream class
+//
+
+#include "stdafx.h"
+#include <ulib/stream/AsyncFileStream.hpp>
+#include <ulib/stream/FileStream.hpp>
+#include <ulib/stream/StreamException.hpp>
+#include <ulib/unittest/AutoCleanupFolder.hpp>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using Stream::AsyncFileStream;
+using Stream::FileStream;
+
+namespace UnitTest
+{
+   /// tests AsyncFileStream class
+   TEST_CLASS(TestAsyncFileStream)
+   {
+      /// size of records in test files
+      static constexpr size_t c_recordSize = 4096;
+
+      /// creates test file with given number of records; each record is filled with its index
+      static void CreateTestFile(const CString& filename, size_t numRecords)
+      {
+         FileStream fs(filename, FileStream::modeCreateNew, FileStream::accessWrite, FileStream::shareNone);
+
+         std::vector<std::byte> record(c_recordSize);
+         for (size_t recordIndex = 0; recordIndex < numRecords; recordIndex++)
+         {
+            std::fill(record.begin(), record.end(), static_cast<std::byte>(recordIndex));
+            fs.WriteSpan(record);
+         }
+      }
+
+      /// returns if all bytes of a record have the record's index
+      static bool CheckRecord(const std::vector<std::byte>& record, size_t recordIndex)
+      {
+         return std::all_of(record.begin(), record.end(),
+            [recordIndex](std::byte value) { return value == static_cast<std::byte>(recordIndex); });
+      }
+
+   public:
+      /// tests reading with futures
+      TEST_METHOD(TestReadAsync)
+      {
+         UnitTest::AutoCleanupFolder folder;
+         CString filename = folder.FolderName() + _T("test.bin");
+
+         const size_t numRecords = 100;
+         CreateTestFile(filename, numRecords);
+
+         AsyncFileStream afs(filename, FileStream::modeOpen, FileStream::accessRead, FileStream::shareRead, 8);
+         Assert::IsTrue(afs.IsOpen(), L"file must be open");
+         Assert::AreEqual<size_t>(8, afs.QueueDepth(), L"queue depth must be set");
+
+         // more requests than the queue depth
+         std::vector<std::vector<std::byte>> records(numRecords, std::vector<std::byte>(c_recordSize));
+         std::vector<std::future<size_t>> futures;
+
+         for (size_t recordIndex = 0; recordIndex < numRecords; recordIndex++)
+            futures.push_back(afs.ReadAsync(recordIndex * c_recordSize, records[recordIndex]));
+
+         for (size_t recordIndex = 0; recordIndex < numRecords; recordIndex++)
+         {
+            Assert::AreEqual(c_recordSize, futures[recordIndex].get(), L"record must be read completely");
+            Assert::IsTrue(CheckRecord(records[recordIndex], recordIndex), L"record must contain data");
+         }
+
+         // reading at the end of the file
+         std::vector<std::byte> buffer(2 * c_recordSize);
+         Assert::AreEqual(c_recordSize, afs.ReadAsync((numRecords - 1) * c_recordSize, buffer).get(),
+            L"only the bytes up to the end must be read");
+
+         Assert::AreEqual<size_t>(0, afs.ReadAsync(numRecords * c_recordSize, buffer).get(),
+            L"no bytes must be read past the end");
+      }
+
+      /// tests writing with completion handlers, and Drain()
+      TEST_METHOD(TestWriteAsync)
+      {
+         UnitTest::AutoCleanupFolder folder;
+         CString filename = folder.FolderName() + _T("test.bin");
+
+         const size_t numRecords = 50;
+         std::vector<std::vector<std::byte>> records;
+         for (size_t recordIndex = 0; recordIndex < numRecords; recordIndex++)
+            records.emplace_back(c_recordSize, static_cast<std::byte>(recordIndex));
+
+         {
+            AsyncFileStream afs(filename, FileStream::modeCreateNew, FileStream::accessWrite, FileStream::shareNone, 4, 2);
+
+            std::atomic<size_t> numBytesWritten = 0;
+            std::atomic<size_t> numErrors = 0;
+
+            // write in reverse order, so that the file grows with holes
+            for (size_t recordIndex = numRecords; recordIndex > 0; recordIndex--)
+            {
+               afs.WriteAsync((recordIndex - 1) * c_recordSize, records[recordIndex - 1],
+                  [&](size_t numBytesTransferred, std::exception_ptr error)
+                  {
+                     numBytesWritten += numBytesTransferred;
+                     if (error != nullptr)
+                        numErrors++;
+                  });
+            }
+
+            afs.Drain();
+
+            Assert::AreEqual(numRecords * c_recordSize, numBytesWritten.load(), L"all records must be written");
+            Assert::AreEqual<size_t>(0, numErrors.load(), L"no request must fail");
+
+            afs.Flush();
+         }
+
+         FileStream fs(filename, FileStream::modeOpen, FileStream::accessRead, FileStream::shareRead);
+         Assert::AreEqual<ULONGLONG>(numRecords * c_recordSize, fs.Length(), L"file must contain all records");
+
+         std::vector<std::byte> record(c_recordSize);
+         for (size_t recordIndex = 0; recordIndex < numRecords; recordIndex++)
+         {
+            fs.ReadExactly(record);
+            Assert::IsTrue(CheckRecord(record, recordIndex), L"record must be written at its offset");
+         }
+      }
+
+      /// tests starting new requests from completion handlers, with a full queue
+      TEST_METHOD(TestChainedRequests)
+      {
+         UnitTest::AutoCleanupFolder folder;
+         CString filename = folder.FolderName() + _T("test.bin");
+
+         const size_t numRecords = 64;
+         CreateTestFile(filename, numRecords);
+
+         AsyncFileStream afs(filename, FileStream::modeOpen, FileStream::accessRead, FileStream::shareRead, 2, 2);
+
+         std::vector<std::vector<std::byte>> records(numRecords, std::vector<std::byte>(c_recordSize));
+         std::atomic<size_t> numRecordsRead = 0;
+
+         // each handler reads the record after the next one, so that two chains run at once
+         std::function<void(size_t)> readRecord;
+         readRecord = [&](size_t recordIndex)
+         {
+            afs.ReadAsync(recordIndex * c_recordSize, records[recordIndex],
+               [&, recordIndex](size_t numBytesTransferred, std::exception_ptr error)
+               {
+                  if (error == nullptr && numBytesTransferred == c_recordSize)
+                     numRecordsRead++;
+
+                  if (recordIndex + 2 < numRecords)
+                     readRecord(recordIndex + 2);
+               });
+         };
+
+         readRecord(0);
+         readRecord(1);
+
+         afs.Drain();
+
+         Assert::AreEqual(numRecords, numRecordsRead.load(), L"all records must be read");
+
+         for (size_t recordIndex = 0; recordIndex < numRecords; recordIndex++)
+            Assert::IsTrue(CheckRecord(records[recordIndex], recordIndex), L"record must contain data");
+      }
+
+      /// tests starting requests after closing the stream
+      TEST_METHOD(TestClose)
+      {
+         UnitTest::AutoCleanupFolder folder;
+         CString filename = folder.FolderName() + _T("test.bin");
+
+         CreateTestFile(filename, 1);
+
+         AsyncFileStream afs(filename, FileStream::modeOpen, FileStream::accessRead, FileStream::shareRead);
+
+         std::vector<std::byte> buffer(c_recordSize);
+         std::future<size_t> future = afs.ReadAsync(0, buffer);
+
+         afs.Close();
+         Assert::IsFalse(afs.IsOpen(), L"file must be closed");
+
+         Assert::AreEqual(c_recordSize, future.get(), L"started request must be completed");
+
+         Assert::ExpectException<Stream::StreamException>(
+            [&]() { afs.ReadAsync(0, buffer); },
+            L"starting a request after closing must throw");
+      }
+   };
+
+} // namespace UnitTest
@@ -0,0 +1,176 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file TestBufferedStream.cpp tests for BufferedStream class
+//
+
+#include "stdafx.h"
+#include <ulib/stream/BufferedStream.hpp>
+#include <ulib/stream/MemoryStream.hpp>
+#include <ulib/stream/MemoryReadStream.hpp>
+#include "StreamTestData.hpp"
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTest
+{
+   /// tests BufferedStream class
+   TEST_CLASS(TestBufferedStream)
+   {
+   public:
+      /// tests reading bytes and blocks, with a buffer smaller than the data
+      TEST_METHOD(TestRead)
+      {
+         std::vector<BYTE> data = GetStreamTestData(100);
+         Stream::MemoryReadStream ms(data.data(), data.size());
+         Stream::BufferedStream bs(ms, 16, 16);
+
+         Assert::IsTrue(bs.CanRead(), L"stream must be readable");
+         Assert::IsFalse(bs.CanWrite(), L"stream must not be writable");
+
+         for (size_t index = 0; index < 10; index++)
+            Assert::AreEqual(data[index], bs.ReadByte(), L"byte must be read");
+
+         // read crossing the buffer end
+         BYTE buffer[64] = {};
+         DWORD numBytesRead = 0;
+         Assert::IsTrue(bs.Read(buffer, 10, numBytesRead), L"read must succeed");
+         Assert::AreEqual<DWORD>(10, numBytesRead, L"all bytes must be read");
+         Assert::IsTrue(0 == memcmp(buffer, data.data() + 10, 10), L"bytes must be read");
+
+         // large read, bypassing the buffer
+         Assert::IsTrue(bs.Read(buffer, sizeof(buffer), numBytesRead), L"read must succeed");
+         Assert::IsTrue(0 == memcmp(buffer, data.data() + 20, numBytesRead), L"bytes must be read");
+
+         Assert::AreEqual<ULONGLONG>(20 + numBytesRead, bs.Position(), L"position must account for read buffer");
+
+         while (!bs.AtEndOfStream())
+            bs.ReadByte();
+
+         Assert::AreEqual<ULONGLONG>(100, bs.Position(), L"all bytes must be read");
+      }
+
+      /// tests writing bytes and blocks
+      TEST_METHOD(TestWrite)
+      {
+         std::vector<BYTE> data = GetStreamTestData(100);
+
+         Stream::MemoryStream ms;
+         {
+            Stream::BufferedStream bs(ms, 16, 16);
+
+            for (size_t index = 0; index < 10; index++)
+               bs.WriteByte(data[index]);
+
+            Assert::AreEqual<size_t>(0, ms.GetData().size(), L"bytes must be buffered");
+            Assert::AreEqual<ULONGLONG>(10, bs.Position(), L"position must account for write buffer");
+
+            DWORD numBytesWritten = 0;
+            bs.Write(data.data() + 10, 90, numBytesWritten);
+            Assert::AreEqual<DWORD>(90, numBytesWritten, L"all bytes must be written");
+
+            bs.Flush();
+            Assert::AreEqual<size_t>(100, ms.GetData().size(), L"bytes must be written after flushing");
+
+            bs.WriteByte(42);
+            Assert::AreEqual<ULONGLONG>(101, bs.Length(), L"length must include write buffer");
+            bs.WriteByte(43);
+         }
+
+         Assert::AreEqual<size_t>(102, ms.GetData().size(), L"write buffer must be written out in dtor");
+         Assert::IsTrue(0 == memcmp(ms.GetData().data(), data.data(), data.size()), L"bytes must be written");
+         Assert::AreEqual<BYTE>(43, ms.GetData()[101], L"last byte must be written");
+      }
+
+      /// tests seeking inside and outside the read buffer, and after writing
+      TEST_METHOD(TestSeek)
+      {
+         std::vector<BYTE> data = GetStreamTestData(100);
+         Stream::MemoryStream ms(data.data(), data.size());
+         Stream::BufferedStream bs(ms, 16, 16);
+
+         bs.ReadByte();
+         bs.ReadByte();
+
+         // inside read buffer
+         Assert::AreEqual<ULONGLONG>(10, bs.Seek(10, Stream::IStream::seekBegin), L"seek must return new position");
+         Assert::AreEqual(data[10], bs.ReadByte(), L"byte must be read at new position");
+
+         Assert::AreEqual<ULONGLONG>(6, bs.Seek(-5, Stream::IStream::seekCurrent), L"seek must return new position");
+         Assert::AreEqual(data[6], bs.ReadByte(), L"byte must be read at new position");
+
+         // outside of read buffer
+         Assert::AreEqual<ULONGLONG>(50, bs.Seek(50, Stream::IStream::seekBegin), L"seek must return new position");
+         Assert::AreEqual(data[50], bs.ReadByte(), L"byte must be read at new position");
+
+         Assert::AreEqual<ULONGLONG>(90, bs.Seek(10, Stream::IStream::seekEnd), L"seek must return new position");
+         Assert::AreEqual(data[90], bs.ReadByte(), L"byte must be read at new position");
+
+         // writing after reading writes at the read position
+         bs.Seek(20, Stream::IStream::seekBegin);
+         bs.ReadByte();
+         bs.WriteByte(0);
+         bs.WriteByte(0);
+
+         // seeking writes out the write buffer
+         Assert::AreEqual<ULONGLONG>(21, bs.Seek(21, Stream::IStream::seekBegin), L"seek must return new position");
+         Assert::AreEqual<BYTE>(0, ms.GetData()[21], L"write buffer must be written out when seeking");
+         Assert::AreEqual<BYTE>(0, bs.ReadByte(), L"written byte must be read");
+         Assert::AreEqual<BYTE>(0, bs.ReadByte(), L"written byte must be read");
+         Assert::AreEqual(data[23], bs.ReadByte(), L"byte after written bytes must be unchanged");
+
+         // seeking back after a large read that bypassed the read buffer
+         bs.Seek(40, Stream::IStream::seekBegin);
+
+         BYTE buffer[40] = {};
+         DWORD numBytesRead = 0;
+         bs.Read(buffer, 4, numBytesRead);
+         bs.Read(buffer, sizeof(buffer), numBytesRead);
+         Assert::AreEqual<DWORD>(sizeof(buffer), numBytesRead, L"all bytes must be read");
+
+         Assert::AreEqual<ULONGLONG>(75, bs.Seek(75, Stream::IStream::seekBegin), L"seek must return new position");
+         Assert::AreEqual(data[75], bs.ReadByte(), L"byte must be read at new position");
+      }
+
+      /// tests unbuffered access, with buffer sizes of 0
+      TEST_METHOD(TestUnbuffered)
+      {
+         std::vector<BYTE> data = GetStreamTestData(10);
+         Stream::MemoryStream ms(data.data(), data.size());
+         Stream::BufferedStream bs(ms, 0, 0);
+
+         Assert::AreEqual(data[0], bs.ReadByte(), L"byte must be read");
+         Assert::AreEqual<ULONGLONG>(1, ms.Position(), L"underlying stream must be read directly");
+
+         bs.WriteByte(42);
+         Assert::AreEqual<BYTE>(42, ms.GetData()[1], L"underlying stream must be written directly");
+      }
+
+      /// tests ReadAt() and WriteAt(), using the default implementation based on Seek()
+      TEST_METHOD(TestReadWriteAt)
+      {
+         std::vector<BYTE> data = GetStreamTestData(100);
+         Stream::MemoryStream ms(data.data(), data.size());
+         Stream::BufferedStream bs(ms, 16, 16);
+
+         bs.ReadByte();
+
+         BYTE buffer[4] = {};
+         DWORD numBytesRead = 0;
+         Assert::IsTrue(bs.ReadAt(50, buffer, sizeof(buffer), numBytesRead), L"read must succeed");
+         Assert::AreEqual<DWORD>(4, numBytesRead, L"all bytes must be read");
+         Assert::IsTrue(0 == memcmp(buffer, data.data() + 50, 4), L"bytes must be read at position");
+
+         DWORD numBytesWritten = 0;
+         bs.WriteAt(2, buffer, 2, numBytesWritten);
+         Assert::AreEqual<DWORD>(2, numBytesWritten, L"all bytes must be written");
+
+         Assert::AreEqual<ULONGLONG>(1, bs.Position(), L"position must be unchanged");
+         Assert::AreEqual(data[1], bs.ReadByte(), L"byte must be read at previous position");
+         Assert::AreEqual(data[50], bs.ReadByte(), L"written byte must be read");
+      }
+   };
+
+} // namespace UnitTest
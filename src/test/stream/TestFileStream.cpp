@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006,2007,2017 Michael Fink
+// Copyright (C) 2006,2007,2017,2026 Michael Fink
 //
 /// \file TestFileStream.cpp unit tests for file streams
 //
@@ -9,6 +9,9 @@
 #include <ulib/stream/StreamException.hpp>
 #include <ulib/unittest/AutoCleanupFolder.hpp>
 #include <ulib/stream/FileStream.hpp>
+#include <thread>
+#include <vector>
+#include <algorithm>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using Stream::FileStream;
@@ -42,6 +45,24 @@ namespace UnitTest
 
       // tests FileStream class, AtEndOfStream function
       TEST_METHOD(TestAtEndOfStream);
+
+      /// tests ReadAt() and WriteAt()
+      TEST_METHOD(TestReadWriteAt);
+
+      /// tests that ReadAt() and WriteAt() keep the current position
+      TEST_METHOD(TestReadWriteAtKeepsPosition);
+
+      /// tests ReadAt() from multiple threads
+      TEST_METHOD(TestReadAtConcurrent);
+
+      /// tests WriteAt() from multiple threads, while getting the length
+      TEST_METHOD(TestWriteAtConcurrent);
+
+      /// tests ReadSpan(), WriteSpan() and ReadExactly()
+      TEST_METHOD(TestReadWriteSpan);
+
+      /// tests ReadV() and WriteV()
+      TEST_METHOD(TestReadWriteV);
    };
 
 } // namespace UnitTest
@@ -501,3 +522,290 @@ void TestFileStream::TestAtEndOfStream()
    Assert::IsTrue(fs.AtEndOfStream());
    Assert::IsTrue(1 == fs.Position());
 }
+
+/// tests ReadAt() and WriteAt()
+void TestFileStream::TestReadWriteAt()
+{
+   UnitTest::AutoCleanupFolder folder;
+   CString filename(folder.FolderName());
+   filename += _T("test.bin");
+
+   Assert::IsTrue(CreateTestFile(filename));
+
+   FileStream fs(filename, FileStream::modeOpen, FileStream::accessReadWrite, FileStream::shareNone);
+   Assert::IsTrue(fs.IsOpen());
+
+   BYTE buffer[8] = { 0 };
+   DWORD numBytesRead = 0;
+   Assert::IsTrue(fs.ReadAt(2, buffer, 3, numBytesRead));
+   Assert::IsTrue(3 == numBytesRead);
+   Assert::IsTrue(0x15 == buffer[0] && 0x41 == buffer[1] && 0x42 == buffer[2]);
+
+   // reading at the end
+   Assert::IsTrue(fs.ReadAt(4, buffer, sizeof(buffer), numBytesRead));
+   Assert::IsTrue(2 == numBytesRead);
+   Assert::IsFalse(fs.ReadAt(6, buffer, sizeof(buffer), numBytesRead));
+   Assert::IsTrue(0 == numBytesRead);
+
+   // writing, also past the end
+   BYTE data[] = { 1, 2, 3 };
+   DWORD numBytesWritten = 0;
+   fs.WriteAt(1, data, 1, numBytesWritten);
+   Assert::IsTrue(1 == numBytesWritten);
+   fs.WriteAt(5, data, sizeof(data), numBytesWritten);
+   Assert::IsTrue(3 == numBytesWritten);
+   Assert::IsTrue(8 == fs.Length());
+
+   Assert::IsTrue(fs.ReadAt(0, buffer, sizeof(buffer), numBytesRead));
+   Assert::IsTrue(8 == numBytesRead);
+   Assert::IsTrue(0x0c == buffer[0] && 1 == buffer[1] && 0x15 == buffer[2]);
+   Assert::IsTrue(1 == buffer[5] && 2 == buffer[6] && 3 == buffer[7]);
+}
+
+/// tests that ReadAt() and WriteAt() keep the current position
+void TestFileStream::TestReadWriteAtKeepsPosition()
+{
+   UnitTest::AutoCleanupFolder folder;
+   CString filename(folder.FolderName());
+   filename += _T("test.bin");
+
+   Assert::IsTrue(CreateTestFile(filename));
+
+   FileStream fs(filename, FileStream::modeOpen, FileStream::accessReadWrite, FileStream::shareNone);
+   Assert::IsTrue(fs.IsOpen());
+
+   BYTE buffer[8] = { 0 };
+   DWORD numBytesRead = 0;
+   Assert::IsTrue(fs.Read(buffer, 2, numBytesRead));
+   Assert::IsTrue(2 == fs.Position());
+
+   Assert::IsTrue(fs.ReadAt(4, buffer, sizeof(buffer), numBytesRead));
+   Assert::IsTrue(2 == numBytesRead);
+   Assert::IsTrue(2 == fs.Position());
+
+   // reading at the end must also keep the position
+   Assert::IsFalse(fs.ReadAt(6, buffer, sizeof(buffer), numBytesRead));
+   Assert::IsTrue(2 == fs.Position());
+
+   Assert::IsTrue(fs.Read(buffer, 1, numBytesRead));
+   Assert::IsTrue(0x15 == buffer[0]);
+
+   BYTE data[] = { 1, 2 };
+   DWORD numBytesWritten = 0;
+   fs.WriteAt(0, data, sizeof(data), numBytesWritten);
+   Assert::IsTrue(2 == numBytesWritten);
+   Assert::IsTrue(3 == fs.Position());
+
+   Assert::IsTrue(fs.Read(buffer, 1, numBytesRead));
+   Assert::IsTrue(0x41 == buffer[0]);
+
+   // writing at the current position continues after the bytes read
+   fs.Write(data, 1, numBytesWritten);
+   Assert::IsTrue(5 == fs.Position());
+
+   Assert::IsTrue(fs.ReadAt(0, buffer, sizeof(buffer), numBytesRead));
+   Assert::IsTrue(6 == numBytesRead);
+   Assert::IsTrue(1 == buffer[0] && 2 == buffer[1] && 0x15 == buffer[2]);
+   Assert::IsTrue(0x41 == buffer[3] && 1 == buffer[4] && 0xff == buffer[5]);
+}
+
+/// tests ReadAt() from multiple threads
+void TestFileStream::TestReadAtConcurrent()
+{
+   UnitTest::AutoCleanupFolder folder;
+   CString filename(folder.FolderName());
+   filename += _T("test.bin");
+
+   const DWORD recordSize = 256;
+   const DWORD numRecords = 64;
+
+   // write records containing their record number
+   {
+      FileStream fs(filename, FileStream::modeCreateNew, FileStream::accessWrite, FileStream::shareNone);
+
+      std::vector<BYTE> record(recordSize);
+      for (DWORD recordIndex = 0; recordIndex < numRecords; recordIndex++)
+      {
+         std::fill(record.begin(), record.end(), static_cast<BYTE>(recordIndex));
+
+         DWORD numBytesWritten = 0;
+         fs.WriteAt(recordIndex * recordSize, record.data(), recordSize, numBytesWritten);
+      }
+   }
+
+   FileStream fs(filename, FileStream::modeOpen, FileStream::accessRead, FileStream::shareRead);
+
+   const unsigned int numThreads = 4;
+   bool results[numThreads] = {};
+
+   std::vector<std::thread> threads;
+   for (unsigned int threadIndex = 0; threadIndex < numThreads; threadIndex++)
+   {
+      threads.emplace_back([&, threadIndex]()
+      {
+         bool allRecordsCorrect = true;
+
+         std::vector<BYTE> record(recordSize);
+         for (DWORD recordIndex = threadIndex; recordIndex < numRecords; recordIndex += numThreads)
+         {
+            DWORD numBytesRead = 0;
+            fs.ReadAt(recordIndex * recordSize, record.data(), recordSize, numBytesRead);
+
+            allRecordsCorrect = allRecordsCorrect &&
+               numBytesRead == recordSize &&
+               std::all_of(record.begin(), record.end(),
+                  [recordIndex](BYTE value) { return value == static_cast<BYTE>(recordIndex); });
+         }
+
+         results[threadIndex] = allRecordsCorrect;
+      });
+   }
+
+   for (std::thread& thread : threads)
+      thread.join();
+
+   for (unsigned int threadIndex = 0; threadIndex < numThreads; threadIndex++)
+      Assert::IsTrue(results[threadIndex]);
+}
+
+/// tests WriteAt() from multiple threads, while getting the length
+void TestFileStream::TestWriteAtConcurrent()
+{
+   UnitTest::AutoCleanupFolder folder;
+   CString filename(folder.FolderName());
+   filename += _T("test.bin");
+
+   const DWORD recordSize = 256;
+   const DWORD numRecords = 64;
+
+   FileStream fs(filename, FileStream::modeCreateNew, FileStream::accessReadWrite, FileStream::shareNone);
+
+   const unsigned int numThreads = 4;
+
+   std::vector<std::thread> threads;
+   for (unsigned int threadIndex = 0; threadIndex < numThreads; threadIndex++)
+   {
+      threads.emplace_back([&, threadIndex]()
+      {
+         std::vector<BYTE> record(recordSize);
+         for (DWORD recordIndex = threadIndex; recordIndex < numRecords; recordIndex += numThreads)
+         {
+            std::fill(record.begin(), record.end(), static_cast<BYTE>(recordIndex));
+
+            DWORD numBytesWritten = 0;
+            fs.WriteAt(recordIndex * recordSize, record.data(), recordSize, numBytesWritten);
+         }
+      });
+   }
+
+   // the length only grows while writing
+   ULONGLONG lastLength = 0;
+   for (int count = 0; count < 1000; count++)
+   {
+      ULONGLONG length = fs.Length();
+      Assert::IsTrue(length >= lastLength && length <= numRecords * recordSize);
+      lastLength = length;
+   }
+
+   for (std::thread& thread : threads)
+      thread.join();
+
+   Assert::IsTrue(numRecords * recordSize == fs.Length());
+
+   std::vector<BYTE> record(recordSize);
+   for (DWORD recordIndex = 0; recordIndex < numRecords; recordIndex++)
+   {
+      DWORD numBytesRead = 0;
+      fs.ReadAt(recordIndex * recordSize, record.data(), recordSize, numBytesRead);
+
+      Assert::IsTrue(numBytesRead == recordSize);
+      Assert::IsTrue(std::all_of(record.begin(), record.end(),
+         [recordIndex](BYTE value) { return value == static_cast<BYTE>(recordIndex); }));
+   }
+}
+
+/// tests ReadSpan(), WriteSpan() and ReadExactly()
+void TestFileStream::TestReadWriteSpan()
+{
+   UnitTest::AutoCleanupFolder folder;
+   CString filename(folder.FolderName());
+   filename += _T("test.bin");
+
+   std::vector<std::byte> data(100000);
+   for (size_t index = 0; index < data.size(); index++)
+      data[index] = static_cast<std::byte>(index * 7);
+
+   {
+      FileStream fs(filename, FileStream::modeCreateNew, FileStream::accessWrite, FileStream::shareNone);
+      Assert::IsTrue(data.size() == fs.WriteSpan(data));
+      Assert::IsTrue(data.size() == fs.Position());
+   }
+
+   FileStream fs(filename, FileStream::modeOpen, FileStream::accessRead, FileStream::shareRead);
+   Assert::IsTrue(data.size() == fs.Length());
+
+   std::vector<std::byte> buffer(data.size() + 10);
+   Assert::IsTrue(data.size() == fs.ReadSpan(buffer));
+   Assert::IsTrue(std::equal(data.begin(), data.end(), buffer.begin()));
+   Assert::IsTrue(fs.AtEndOfStream());
+
+   // reading exactly
+   fs.Seek(10, Stream::IStream::seekBegin);
+   fs.ReadExactly(std::span<std::byte>(buffer.data(), 100));
+   Assert::IsTrue(data[10] == buffer[0] && data[109] == buffer[99]);
+
+   try
+   {
+      fs.ReadExactly(buffer);
+      Assert::IsTrue(false);
+   }
+   catch (const Stream::StreamException& e)
+   {
+      UNUSED(e);
+   }
+}
+
+/// tests ReadV() and WriteV()
+void TestFileStream::TestReadWriteV()
+{
+   UnitTest::AutoCleanupFolder folder;
+   CString filename(folder.FolderName());
+   filename += _T("test.bin");
+
+   const char header[] = "header";
+   std::vector<std::byte> payload(5000, std::byte{ 0x42 });
+   const char trailer[] = "trailer";
+
+   {
+      FileStream fs(filename, FileStream::modeCreateNew, FileStream::accessWrite, FileStream::shareNone);
+
+      const std::span<const std::byte> buffers[] =
+      {
+         std::as_bytes(std::span<const char>(header, 6)),
+         std::span<const std::byte>(),
+         payload,
+         std::as_bytes(std::span<const char>(trailer, 7)),
+      };
+
+      Assert::IsTrue(5013 == fs.WriteV(buffers));
+      Assert::IsTrue(5013ULL == fs.Position());
+      Assert::IsTrue(5013ULL == fs.Length());
+   }
+
+   FileStream fs(filename, FileStream::modeOpen, FileStream::accessRead, FileStream::shareRead);
+
+   std::byte readHeader[6] = {};
+   std::vector<std::byte> readPayload(5000);
+   std::byte readTrailer[10] = {};
+
+   const std::span<std::byte> buffers[] = { readHeader, readPayload, readTrailer };
+
+   // the last buffer is only filled partially at the end of the file
+   Assert::IsTrue(5013 == fs.ReadV(buffers));
+   Assert::IsTrue(0 == memcmp(readHeader, header, 6));
+   Assert::IsTrue(payload == readPayload);
+   Assert::IsTrue(0 == memcmp(readTrailer, trailer, 7));
+   Assert::IsTrue(fs.AtEndOfStream());
+
+   Assert::IsTrue(0 == fs.ReadV(buffers));
+}
@@ -0,0 +1,172 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file TestMappedFileStream.cpp tests for MappedFileStream class
+//
+
+#include "stdafx.h"
+#include <ulib/stream/MappedFileStream.hpp>
+#include <ulib/stream/FileStream.hpp>
+#include <ulib/stream/EndianAwareFilter.hpp>
+#include <ulib/stream/TextStreamFilter.hpp>
+#include <ulib/stream/StreamException.hpp>
+#include <ulib/unittest/AutoCleanupFolder.hpp>
+#include "StreamTestData.hpp"
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using Stream::MappedFileStream;
+
+namespace UnitTest
+{
+   /// tests MappedFileStream class
+   TEST_CLASS(TestMappedFileStream)
+   {
+      /// creates test file with given data
+      static void CreateTestFile(const CString& filename, const void* data, size_t length)
+      {
+         Stream::FileStream fs(filename,
+            Stream::FileStream::modeCreateNew,
+            Stream::FileStream::accessWrite,
+            Stream::FileStream::shareNone);
+
+         Assert::IsTrue(fs.IsOpen(), L"test file must be created");
+
+         DWORD numBytesWritten = 0;
+         fs.Write(data, static_cast<DWORD>(length), numBytesWritten);
+         Assert::AreEqual<DWORD>(static_cast<DWORD>(length), numBytesWritten, L"test data must be written");
+
+         fs.Close();
+      }
+
+   public:
+      /// tests reading bytes, blocks and views
+      TEST_METHOD(TestRead)
+      {
+         UnitTest::AutoCleanupFolder folder;
+         CString filename = folder.FolderName() + _T("test.bin");
+
+         std::vector<BYTE> data = GetStreamTestData(1000);
+         CreateTestFile(filename, data.data(), data.size());
+
+         MappedFileStream ms(filename);
+
+         Assert::IsTrue(ms.IsOpen(), L"file must be open");
+         Assert::IsTrue(ms.CanRead(), L"stream must be readable");
+         Assert::IsFalse(ms.CanWrite(), L"stream must not be writable");
+         Assert::AreEqual<ULONGLONG>(1000, ms.Length(), L"length must be file length");
+
+         Assert::AreEqual(data[0], ms.ReadByte(), L"byte must be read");
+
+         BYTE buffer[100] = {};
+         DWORD numBytesRead = 0;
+         Assert::IsTrue(ms.Read(buffer, sizeof(buffer), numBytesRead), L"read must succeed");
+         Assert::AreEqual<DWORD>(100, numBytesRead, L"all bytes must be read");
+         Assert::IsTrue(0 == memcmp(buffer, data.data() + 1, 100), L"bytes must be read");
+
+         const BYTE* direct = ms.ReadDirect(10);
+         Assert::IsNotNull(direct, L"bytes must be read directly");
+         Assert::IsTrue(0 == memcmp(direct, data.data() + 101, 10), L"bytes must be read directly");
+         Assert::AreEqual<ULONGLONG>(111, ms.Position(), L"position must be advanced");
+
+         const BYTE* view = ms.View(990, 10);
+         Assert::IsNotNull(view, L"view must be returned");
+         Assert::IsTrue(0 == memcmp(view, data.data() + 990, 10), L"view must contain bytes");
+         Assert::IsNull(ms.View(990, 11), L"view past the end must not be returned");
+         Assert::AreEqual<ULONGLONG>(111, ms.Position(), L"view must not change position");
+
+         ms.Seek(10, Stream::IStream::seekEnd);
+         Assert::IsNull(ms.ReadDirect(11), L"reading directly past the end must fail");
+         Assert::IsTrue(ms.Read(buffer, sizeof(buffer), numBytesRead), L"read must succeed");
+         Assert::AreEqual<DWORD>(10, numBytesRead, L"remaining bytes must be read");
+         Assert::IsTrue(ms.AtEndOfStream(), L"stream must be at end");
+      }
+
+      /// tests reading with a window smaller than the file
+      TEST_METHOD(TestSlidingWindow)
+      {
+         UnitTest::AutoCleanupFolder folder;
+         CString filename = folder.FolderName() + _T("test.bin");
+
+         std::vector<BYTE> data = GetStreamTestData(200000);
+         CreateTestFile(filename, data.data(), data.size());
+
+         MappedFileStream ms(filename, 4096);
+         ms.SetAccessHint(MappedFileStream::accessSequential);
+
+         std::vector<BYTE> readData;
+         while (!ms.AtEndOfStream())
+            readData.push_back(ms.ReadByte());
+
+         Assert::IsTrue(data == readData, L"all bytes must be read");
+
+         // read larger than the window
+         ms.Seek(1000, Stream::IStream::seekBegin);
+
+         std::vector<BYTE> buffer(50000);
+         DWORD numBytesRead = 0;
+         Assert::IsTrue(ms.Read(buffer.data(), static_cast<DWORD>(buffer.size()), numBytesRead), L"read must succeed");
+         Assert::AreEqual<DWORD>(50000, numBytesRead, L"all bytes must be read");
+         Assert::IsTrue(0 == memcmp(buffer.data(), data.data() + 1000, buffer.size()), L"bytes must be read");
+
+         // view crossing a window border
+         ms.SetAccessHint(MappedFileStream::accessRandom);
+         const BYTE* view = ms.View(4000, 10000);
+         Assert::IsNotNull(view, L"view must be returned");
+         Assert::IsTrue(0 == memcmp(view, data.data() + 4000, 10000), L"view must contain bytes");
+      }
+
+      /// tests opening empty and non-existent files
+      TEST_METHOD(TestOpen)
+      {
+         UnitTest::AutoCleanupFolder folder;
+         CString filename = folder.FolderName() + _T("empty.bin");
+
+         CreateTestFile(filename, "", 0);
+
+         MappedFileStream ms(filename);
+         Assert::IsTrue(ms.IsOpen(), L"empty file must be open");
+         Assert::IsTrue(ms.AtEndOfStream(), L"empty file must be at end");
+         Assert::IsNull(ms.ReadDirect(1), L"reading empty file must fail");
+
+         ms.Close();
+         Assert::IsFalse(ms.IsOpen(), L"file must be closed");
+
+         CString missingFilename = folder.FolderName() + _T("missing.bin");
+         Assert::ExpectException<Stream::StreamException>(
+            [&]() { MappedFileStream ms2(missingFilename); },
+            L"opening a non-existent file must throw");
+      }
+
+      /// tests reading through filters that use ReadDirect()
+      TEST_METHOD(TestFilters)
+      {
+         UnitTest::AutoCleanupFolder folder;
+         CString filename = folder.FolderName() + _T("test.bin");
+
+         const char text[] = "\x34\x12\x78\x56\x34\x12" "line1\n" "line2\n";
+         CreateTestFile(filename, text, sizeof(text) - 1);
+
+         MappedFileStream ms(filename);
+
+         Stream::EndianAwareFilter endianFilter(ms);
+         Assert::AreEqual<WORD>(0x1234, endianFilter.Read16LE(), L"16-bit value must be read");
+         Assert::AreEqual<DWORD>(0x12345678, endianFilter.Read32LE(), L"32-bit value must be read");
+
+         Stream::TextStreamFilter textFilter(ms,
+            Stream::ITextStream::textEncodingUTF8,
+            Stream::ITextStream::lineEndingLF);
+
+         CString line;
+         textFilter.ReadLine(line);
+         Assert::AreEqual(_T("line1"), line.GetString(), L"first line must be read");
+
+         textFilter.ReadLine(line);
+         Assert::AreEqual(_T("line2"), line.GetString(), L"second line must be read");
+
+         Assert::IsTrue(textFilter.AtEndOfStream(), L"text must be read completely");
+      }
+   };
+
+} // namespace UnitTest
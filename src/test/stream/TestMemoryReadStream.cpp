@@ -1,12 +1,13 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2007,2017 Michael Fink
+// Copyright (C) 2007,2017,2026 Michael Fink
 //
 /// \file TestMemoryReadStream.cpp tests for memory read-only stream
 //
 
 #include "stdafx.h"
 #include <ulib/stream/MemoryReadStream.hpp>
+#include <ulib/stream/StreamException.hpp>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -136,6 +137,60 @@ namespace UnitTest
             Assert::IsTrue(3ULL == ms.Seek(4LL, Stream::IStream::seekCurrent));
          }
       }
+
+      /// tests reading at positions
+      TEST_METHOD(TestReadAt)
+      {
+         BYTE abData[] = { 42, 128, 64 };
+
+         Stream::MemoryReadStream ms(abData, sizeof(abData));
+         ms.ReadByte();
+
+         BYTE abBuffer[4] = { 0 };
+         DWORD numBytesRead = 0;
+         Assert::IsTrue(ms.ReadAt(1, abBuffer, sizeof(abBuffer), numBytesRead));
+         Assert::IsTrue(2 == numBytesRead);
+         Assert::IsTrue(128 == abBuffer[0] && 64 == abBuffer[1]);
+
+         Assert::IsFalse(ms.ReadAt(3, abBuffer, sizeof(abBuffer), numBytesRead));
+         Assert::IsTrue(0 == numBytesRead);
+         Assert::IsFalse(ms.ReadAt(100, abBuffer, sizeof(abBuffer), numBytesRead));
+         Assert::IsTrue(0 == numBytesRead);
+
+         // position is unchanged
+         Assert::IsTrue(1ULL == ms.Position());
+      }
+
+      /// tests reading spans
+      TEST_METHOD(TestReadSpan)
+      {
+         BYTE abData[] = { 42, 128, 64 };
+
+         Stream::MemoryReadStream ms(abData, sizeof(abData));
+
+         std::byte abBuffer[2] = {};
+         Assert::IsTrue(2 == ms.ReadSpan(abBuffer));
+         Assert::IsTrue(std::byte{ 42 } == abBuffer[0] && std::byte{ 128 } == abBuffer[1]);
+
+         Assert::IsTrue(1 == ms.ReadSpan(abBuffer));
+         Assert::IsTrue(std::byte{ 64 } == abBuffer[0]);
+         Assert::IsTrue(0 == ms.ReadSpan(abBuffer));
+
+         // reading exactly
+         ms.Seek(0, Stream::IStream::seekBegin);
+         ms.ReadExactly(abBuffer);
+         Assert::IsTrue(std::byte{ 128 } == abBuffer[1]);
+
+         try
+         {
+            ms.ReadExactly(abBuffer);
+            Assert::IsTrue(false);
+         }
+         catch (const Stream::StreamException& e)
+         {
+            UNUSED(e);
+         }
+      }
    };
 
 } // namespace UnitTest
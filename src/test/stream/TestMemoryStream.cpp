@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2007,2017 Michael Fink
+// Copyright (C) 2007,2017,2026 Michael Fink
 //
 /// \file TestMemoryStream.cpp tests for memory read-write stream
 //
@@ -180,6 +180,84 @@ namespace UnitTest
             Assert::IsTrue(3ULL == ms.Seek(4LL, Stream::IStream::seekCurrent));
          }
       }
+
+      /// tests reading and writing at positions
+      TEST_METHOD(TestReadWriteAt)
+      {
+         BYTE abData[] = { 42, 128, 64 };
+
+         Stream::MemoryStream ms(abData, sizeof(abData));
+         ms.ReadByte();
+
+         BYTE abBuffer[4] = { 0 };
+         DWORD numBytesRead = 0;
+         Assert::IsTrue(ms.ReadAt(2, abBuffer, sizeof(abBuffer), numBytesRead));
+         Assert::IsTrue(1 == numBytesRead);
+         Assert::IsTrue(64 == abBuffer[0]);
+
+         Assert::IsFalse(ms.ReadAt(4, abBuffer, sizeof(abBuffer), numBytesRead));
+         Assert::IsTrue(0 == numBytesRead);
+
+         // write inside and past the end
+         BYTE abWrite[] = { 1, 2 };
+         DWORD numBytesWritten = 0;
+         ms.WriteAt(0, abWrite, 1, numBytesWritten);
+         Assert::IsTrue(1 == numBytesWritten);
+         ms.WriteAt(4, abWrite, sizeof(abWrite), numBytesWritten);
+         Assert::IsTrue(2 == numBytesWritten);
+
+         Assert::IsTrue(6 == ms.GetData().size());
+         Assert::IsTrue(1 == ms.GetData()[0]);
+         Assert::IsTrue(128 == ms.GetData()[1]);
+         Assert::IsTrue(1 == ms.GetData()[4]);
+         Assert::IsTrue(2 == ms.GetData()[5]);
+
+         // position is unchanged
+         Assert::IsTrue(1ULL == ms.Position());
+      }
+
+      /// tests reading and writing spans
+      TEST_METHOD(TestReadWriteSpan)
+      {
+         Stream::MemoryStream ms;
+
+         std::byte abData[] = { std::byte{ 1 }, std::byte{ 2 }, std::byte{ 3 } };
+         Assert::IsTrue(3 == ms.WriteSpan(abData));
+         Assert::IsTrue(3 == ms.WriteSpan(abData));
+         Assert::IsTrue(6 == ms.GetData().size());
+         Assert::IsTrue(6ULL == ms.Position());
+
+         ms.Seek(2, Stream::IStream::seekBegin);
+
+         std::byte abBuffer[8] = {};
+         Assert::IsTrue(4 == ms.ReadSpan(abBuffer));
+         Assert::IsTrue(std::byte{ 3 } == abBuffer[0] && std::byte{ 1 } == abBuffer[1]);
+         Assert::IsTrue(0 == ms.ReadSpan(abBuffer));
+      }
+
+      /// tests ReadV() and WriteV()
+      TEST_METHOD(TestReadWriteV)
+      {
+         Stream::MemoryStream ms;
+
+         std::byte abHeader[] = { std::byte{ 1 }, std::byte{ 2 } };
+         std::byte abPayload[] = { std::byte{ 3 }, std::byte{ 4 }, std::byte{ 5 } };
+
+         const std::span<const std::byte> writeBuffers[] = { abHeader, abPayload, abHeader };
+         Assert::IsTrue(7 == ms.WriteV(writeBuffers));
+         Assert::IsTrue(7 == ms.GetData().size());
+         Assert::IsTrue(7ULL == ms.Position());
+
+         ms.Seek(1, Stream::IStream::seekBegin);
+
+         std::byte abBuffer1[3] = {};
+         std::byte abBuffer2[5] = {};
+         const std::span<std::byte> readBuffers[] = { abBuffer1, abBuffer2 };
+         Assert::IsTrue(6 == ms.ReadV(readBuffers));
+         Assert::IsTrue(std::byte{ 2 } == abBuffer1[0] && std::byte{ 4 } == abBuffer1[2]);
+         Assert::IsTrue(std::byte{ 5 } == abBuffer2[0] && std::byte{ 2 } == abBuffer2[2]);
+         Assert::IsTrue(0 == ms.ReadV(readBuffers));
+      }
    };
 
 } // namespace UnitTest
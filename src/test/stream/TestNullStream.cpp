@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2007,2017 Michael Fink
+// Copyright (C) 2007,2017,2026 Michael Fink
 //
 /// \file TestMemoryStream.cpp tests for memory read-write stream
 //
@@ -52,6 +52,20 @@ namespace UnitTest
          ns.Flush();
          ns.Close();
       }
+
+      /// tests reading and writing spans
+      TEST_METHOD(TestReadWriteSpan)
+      {
+         Stream::NullStream ns;
+
+         std::byte abBuffer[3] = { std::byte{ 1 }, std::byte{ 2 }, std::byte{ 3 } };
+         Assert::IsTrue(3 == ns.ReadSpan(abBuffer));
+         Assert::IsTrue(std::byte{ 0 } == abBuffer[0] && std::byte{ 0 } == abBuffer[2]);
+
+         ns.ReadExactly(abBuffer);
+
+         Assert::IsTrue(3 == ns.WriteSpan(abBuffer));
+      }
    };
 
 } // namespace UnitTest
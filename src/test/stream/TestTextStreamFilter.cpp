@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2007,2017 Michael Fink
+// Copyright (C) 2007,2017,2026 Michael Fink
 //
 /// \file TestTextStreamFilter.cpp tests for TextStreamFilter class
 //
@@ -547,6 +547,59 @@ namespace UnitTest
          Assert::IsTrue(pszData[2] == filter.ReadChar());
       }
 
+      /// tests reading utf-8 code points outside the BMP, and invalid sequences
+      TEST_METHOD(TestReadUTF8Supplementary)
+      {
+         // U+1F600, invalid byte, 'A'
+         BYTE abData[] = { 0xf0, 0x9f, 0x98, 0x80, 0xff, 0x41 };
+
+         Stream::MemoryReadStream ms(abData, sizeof(abData));
+         Stream::TextStreamFilter filter(ms, Stream::TextStreamFilter::textEncodingUTF8);
+
+#if defined(UNICODE) || defined(_UNICODE)
+         if (sizeof(TCHAR) == 2)
+         {
+            Assert::IsTrue(0xd83d == filter.ReadChar(), L"high surrogate must be read");
+            Assert::IsTrue(0xde00 == filter.ReadChar(), L"low surrogate must be read");
+         }
+         else
+            Assert::IsTrue(0x1f600 == static_cast<unsigned int>(filter.ReadChar()), L"code point must be read");
+
+         Assert::IsTrue(0xfffd == filter.ReadChar(), L"invalid sequence must be replaced");
+         Assert::IsTrue(0x0041 == filter.ReadChar(), L"character after invalid sequence must be read");
+         Assert::IsTrue(filter.AtEndOfStream(), L"filter must be at end of stream");
+#endif
+      }
+
+      /// tests reading utf-8 lines that span multiple blocks
+      TEST_METHOD(TestReadLineUTF8Blocks)
+      {
+         // lines of 3-byte sequences, so that sequences cross block borders
+         CStringA line1, line2;
+         for (int index = 0; index < 2000; index++)
+         {
+            line1 += "\xe2\x82\xac";
+            line2 += index % 2 == 0 ? "x" : "\xc3\xa4";
+         }
+
+         CStringA data = line1 + "\r" + line2 + "\r\n" + "last";
+
+         Stream::MemoryReadStream ms(reinterpret_cast<const BYTE*>(data.GetString()), data.GetLength());
+         Stream::TextStreamFilter filter(ms,
+            Stream::TextStreamFilter::textEncodingUTF8, Stream::TextStreamFilter::lineEndingReadAny);
+
+         CString text;
+         filter.ReadLine(text);
+         Assert::AreEqual(2000, text.GetLength(), L"first line must be read completely");
+
+         filter.ReadLine(text);
+         Assert::AreEqual(2000, text.GetLength(), L"second line must be read completely");
+
+         filter.ReadLine(text);
+         Assert::IsTrue(_T("last") == text, L"last line must be read");
+         Assert::IsTrue(filter.AtEndOfStream(), L"filter must be at end of stream");
+      }
+
       /// tests CanRead() and CanWrite methods
       TEST_METHOD(TestCanReadCanWrite)
       {
@@ -0,0 +1,201 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file CStringAtom.cpp interned string atoms
+//
+
+#include "stdafx.h"
+#include <ulib/CStringAtom.hpp>
+#include <ulib/StringHash.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cctype>
+#include <cwctype>
+#include <iterator>
+
+/// returns lower case character
+static TCHAR ToLower(TCHAR ch)
+{
+#if defined(UNICODE) || defined(_UNICODE)
+   return static_cast<TCHAR>(towlower(ch));
+#else
+   return static_cast<TCHAR>(tolower(static_cast<unsigned char>(ch)));
+#endif
+}
+
+/// \brief intern table
+/// \details The table is an array of slots, using open addressing with linear
+/// probing. New entries are only ever stored into empty slots, while holding
+/// the mutex, and are published using a release store; readers search the
+/// slots without locking. When the table is half full, the entries are
+/// rehashed into a new slot array with twice the size. The old slot arrays
+/// are kept, since readers may still search them; all of them together are
+/// at most as large as the current one.
+struct CStringAtom::Table
+{
+   /// initial number of slots; must be a power of two
+   static constexpr size_t c_initialNumSlots = 256;
+
+   /// slot array
+   struct Slots
+   {
+      /// ctor; creates empty slots
+      explicit Slots(size_t numSlots)
+         :m_numSlots(numSlots),
+         m_slots(new std::atomic<const Entry*>[numSlots]())
+      {
+      }
+
+      /// number of slots; a power of two
+      size_t m_numSlots;
+
+      /// slots; nullptr when empty
+      std::unique_ptr<std::atomic<const Entry*>[]> m_slots;
+   };
+
+   /// ctor; creates initial slot array
+   Table()
+   {
+      m_allSlots.push_back(std::make_unique<Slots>(c_initialNumSlots));
+      m_currentSlots.store(m_allSlots.back().get(), std::memory_order_release);
+   }
+
+   /// mutex to protect inserting entries and rehashing
+   std::mutex m_mutex;
+
+   /// current slot array
+   std::atomic<const Slots*> m_currentSlots = nullptr;
+
+   /// all slot arrays that were ever used
+   std::vector<std::unique_ptr<Slots>> m_allSlots;
+
+   /// number of entries in the table
+   size_t m_numEntries = 0;
+
+   /// entry for the empty string
+   Entry m_emptyEntry = { CString(), Hash(CStringView()) };
+
+   /// returns the intern table; it is never destroyed, since atoms may be
+   /// used during static destruction
+   static Table& Get()
+   {
+      static Table* s_table = new Table;
+      return *s_table;
+   }
+
+   /// calculates hash value of text; the same as std::hash<CString> uses
+   static size_t Hash(CStringView text)
+   {
+      return StringHash::Hash(text.GetData(), static_cast<size_t>(text.GetLength()));
+   }
+
+   /// searches slots for entry; returns nullptr when not found
+   static const Entry* Find(const Slots& slots, size_t hash, CStringView text)
+   {
+      // the slots are never full, so the search ends at an empty slot
+      size_t mask = slots.m_numSlots - 1;
+      for (size_t index = hash & mask; ; index = (index + 1) & mask)
+      {
+         const Entry* entry = slots.m_slots[index].load(std::memory_order_acquire);
+         if (entry == nullptr)
+            return nullptr;
+
+         if (entry->m_hash == hash && text == CStringView(entry->m_text))
+            return entry;
+      }
+   }
+
+   /// stores entry in the first empty slot; mutex must be locked
+   static void Insert(Slots& slots, const Entry* entry)
+   {
+      size_t mask = slots.m_numSlots - 1;
+      size_t index = entry->m_hash & mask;
+      while (slots.m_slots[index].load(std::memory_order_relaxed) != nullptr)
+         index = (index + 1) & mask;
+
+      slots.m_slots[index].store(entry, std::memory_order_release);
+   }
+
+   /// rehashes all entries into a new slot array with twice the size; mutex
+   /// must be locked
+   Slots& Rehash()
+   {
+      const Slots& oldSlots = *m_allSlots.back();
+
+      m_allSlots.push_back(std::make_unique<Slots>(oldSlots.m_numSlots * 2));
+      Slots& newSlots = *m_allSlots.back();
+
+      for (size_t index = 0; index < oldSlots.m_numSlots; index++)
+      {
+         const Entry* entry = oldSlots.m_slots[index].load(std::memory_order_relaxed);
+         if (entry != nullptr)
+            Insert(newSlots, entry);
+      }
+
+      m_currentSlots.store(&newSlots, std::memory_order_release);
+
+      return newSlots;
+   }
+};
+
+CStringAtom::CStringAtom() throw()
+   :m_entry(&Table::Get().m_emptyEntry)
+{
+}
+
+CStringAtom::CStringAtom(CStringView text)
+   :m_entry(Intern(text))
+{
+}
+
+CStringAtom CStringAtom::FromLowerCase(CStringView text)
+{
+   // convert on the stack, so that looking up short texts doesn't allocate
+   TCHAR stackBuffer[256];
+   CString lowerText;
+
+   int length = text.GetLength();
+   LPTSTR buffer = length <= static_cast<int>(std::size(stackBuffer)) ? stackBuffer : lowerText.GetBuffer(length);
+
+   for (int index = 0; index < length; index++)
+      buffer[index] = ToLower(text[index]);
+
+   return CStringAtom(Intern(CStringView(buffer, length)));
+}
+
+const CStringAtom::Entry* CStringAtom::Intern(CStringView text)
+{
+   Table& table = Table::Get();
+
+   if (text.IsEmpty())
+      return &table.m_emptyEntry;
+
+   size_t hash = Table::Hash(text);
+
+   // lock-free lookup
+   const Entry* entry = Table::Find(*table.m_currentSlots.load(std::memory_order_acquire), hash, text);
+   if (entry != nullptr)
+      return entry;
+
+   std::lock_guard<std::mutex> lock(table.m_mutex);
+
+   // search again; the entry may have been inserted in the meantime
+   Table::Slots* slots = table.m_allSlots.back().get();
+   entry = Table::Find(*slots, hash, text);
+   if (entry != nullptr)
+      return entry;
+
+   Entry* newEntry = new Entry{ text.ToString(), hash };
+
+   // keep the slots at most half full
+   if ((table.m_numEntries + 1) * 2 > slots->m_numSlots)
+      slots = &table.Rehash();
+
+   Table::Insert(*slots, newEntry);
+   table.m_numEntries++;
+
+   return newEntry;
+}
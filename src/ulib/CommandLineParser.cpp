@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2008,2009,2013,2017 Michael Fink
+// Copyright (C) 2008,2009,2013,2017,2026 Michael Fink
 //
 /// \file CommandLineParser.cpp command line parser
 //
@@ -26,6 +26,16 @@ CommandLineParser::CommandLineParser(int argc, LPCTSTR argv[])
 }
 
 bool CommandLineParser::GetNext(CString& nextParameter)
+{
+   CStringView nextParameterView;
+   if (!GetNext(nextParameterView))
+      return false;
+
+   nextParameter = nextParameterView.ToString();
+   return true;
+}
+
+bool CommandLineParser::GetNext(CStringView& nextParameter)
 {
    if (m_commandLine.IsEmpty() || m_currentIndex >= m_commandLine.GetLength())
       return false;
@@ -39,24 +49,25 @@ bool CommandLineParser::GetNext(CString& nextParameter)
    }
 
    // search for stopper
-   int maxIndex = m_commandLine.Find(stopperChar, m_currentIndex);
+   CStringView commandLine(m_commandLine);
+   int maxIndex = commandLine.Find(stopperChar, m_currentIndex);
 
    // extract next parameter and advance index
    if (maxIndex == -1)
    {
-      nextParameter = m_commandLine.Mid(m_currentIndex);
+      nextParameter = commandLine.Mid(m_currentIndex);
       m_currentIndex = m_commandLine.GetLength();
    }
    else
    {
-      nextParameter = m_commandLine.Mid(m_currentIndex, maxIndex - m_currentIndex);
+      nextParameter = commandLine.Mid(m_currentIndex, maxIndex - m_currentIndex);
       m_currentIndex = maxIndex + 1;
    }
 
    // trim " stopper
    if (stopperChar != _T(' '))
    {
-      nextParameter.Trim(_T("\""));
+      nextParameter = nextParameter.Trim(_T("\""));
    }
 
    // eat space chars
@@ -1,41 +1,74 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006-2014,2017,2019,2020,2025 Michael Fink
+// Copyright (C) 2006-2014,2017,2019,2020,2025,2026 Michael Fink
 //
 /// \file DateTime.cpp date/time class
 //
 #include "stdafx.h"
 #include <ulib/DateTime.hpp>
+#include <ulib/StringNumber.hpp>
 
 CString DateTime::FormatISO8601(DateTime::T_enISO8601Format enFormat, bool basic, const TimeZone& tz) const
 {
+   if (m_status == T_enStatus::invalid)
+      return _T("");
+
+   // calculate date and time in given time zone
+   TimeSpan spanTimezone = tz.GetUtcOffset(*this);
+
+   auto localTimePoint = m_timePoint + spanTimezone.m_span;
+   auto dayPoint = std::chrono::floor<std::chrono::days>(localTimePoint);
+   std::chrono::year_month_day ymd{ dayPoint };
+   std::chrono::hh_mm_ss time{ std::chrono::floor<std::chrono::milliseconds>(localTimePoint - dayPoint) };
+
+   int year = static_cast<int>(ymd.year());
+   unsigned int month = static_cast<unsigned int>(ymd.month());
+   unsigned int day = static_cast<unsigned int>(ymd.day());
+   unsigned int hour = static_cast<unsigned int>(time.hours().count());
+   unsigned int minute = static_cast<unsigned int>(time.minutes().count());
+   unsigned int second = static_cast<unsigned int>(time.seconds().count());
+   unsigned int millisecond = static_cast<unsigned int>(time.subseconds().count());
+
+   ATLASSERT(enFormat >= formatY && enFormat <= formatYMD_HMSF_Z); // invalid format
+
+   // the formats are ordered, and each one extends the previous one
    CString date;
-   switch (enFormat)
+   StringNumber::AppendInt(date, year, 4);
+
+   if (enFormat >= formatYM)
    {
-   case formatY:  return Format(_T("%Y"), tz);
-   case formatYM: return Format(basic ? _T("%Y%m") : _T("%Y-%m"), tz);
-   case formatYMD: return Format(basic ? _T("%Y%m%d") : _T("%Y-%m-%d"), tz);
-   case formatYMD_HM_Z:
-      date = Format(basic ? _T("%Y%m%dT%H%M") : _T("%Y-%m-%dT%H:%M"), tz);
-      break;
-
-   case formatYMD_HMS_Z:
-      date = Format(basic ? _T("%Y%m%dT%H%M%S") : _T("%Y-%m-%dT%H:%M:%S"), tz);
-      break;
-
-   case formatYMD_HMSF_Z:
+      if (!basic)
+         date += _T('-');
+      StringNumber::AppendUInt(date, month, 2);
+   }
+
+   if (enFormat >= formatYMD)
    {
-      date = Format(basic ? _T("%Y%m%dT%H%M%S") : _T("%Y-%m-%dT%H:%M:%S"), tz);
+      if (!basic)
+         date += _T('-');
+      StringNumber::AppendUInt(date, day, 2);
+   }
+
+   if (enFormat < formatYMD_HM_Z)
+      return date;
 
-      CString fraction;
-      fraction.Format(_T(".%03u"), Millisecond());
-      date += fraction;
+   date += _T('T');
+   StringNumber::AppendUInt(date, hour, 2);
+   if (!basic)
+      date += _T(':');
+   StringNumber::AppendUInt(date, minute, 2);
+
+   if (enFormat >= formatYMD_HMS_Z)
+   {
+      if (!basic)
+         date += _T(':');
+      StringNumber::AppendUInt(date, second, 2);
    }
-   break;
 
-   default:
-      ATLASSERT(false); // invalid format
-      break;
+   if (enFormat >= formatYMD_HMSF_Z)
+   {
+      date += _T('.');
+      StringNumber::AppendUInt(date, millisecond, 3);
    }
 
    // add timezone
@@ -43,18 +76,15 @@ CString DateTime::FormatISO8601(DateTime::T_enISO8601Format enFormat, bool basic
       date += _T("Z");
    else
    {
-      TimeSpan spanTimezone = tz.GetUtcOffset(*this);
       bool isNegative = spanTimezone < TimeSpan(0, 0, 0, 0);
 
       TimeSpan spanTimezoneAbs = isNegative ? -spanTimezone : spanTimezone;
 
-      CString cszTimezone;
-      cszTimezone.Format(basic ? _T("%c%02u%02u") : _T("%c%02u:%02u"),
-         !isNegative ? _T('+') : _T('-'),
-         spanTimezoneAbs.Hours(),
-         spanTimezoneAbs.Minutes());
-
-      date += cszTimezone;
+      date += !isNegative ? _T('+') : _T('-');
+      StringNumber::AppendInt(date, spanTimezoneAbs.Hours(), 2);
+      if (!basic)
+         date += _T(':');
+      StringNumber::AppendInt(date, spanTimezoneAbs.Minutes(), 2);
    }
 
    return date;
@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2004,2005,2006,2007,2008,2017,2020 Michael Fink
+// Copyright (C) 2004,2005,2006,2007,2008,2017,2020,2026 Michael Fink
 //
 /// \file Path.cpp Path class
 //
@@ -62,6 +62,13 @@ CString Path::FilenameAndExt(const CString& path)
    return path.Mid(pos + 1);
 }
 
+CStringView Path::FilenameAndExt(CStringView path)
+{
+   int pos = path.ReverseFind(Path::SeparatorCh);
+
+   return path.Mid(pos + 1);
+}
+
 /// \note: deprecated, to be removed
 CString Path::FilenameOnly() const
 {
@@ -79,6 +86,17 @@ CString Path::FilenameOnly(const CString& path)
    return path.Mid(pos + 1, pos2 - pos - 1);
 }
 
+CStringView Path::FilenameOnly(CStringView path)
+{
+   int pos = path.ReverseFind(Path::SeparatorCh);
+
+   int pos2 = path.ReverseFind(_T('.'));
+   if (pos2 == -1)
+      return path.Mid(pos + 1);
+
+   return path.Mid(pos + 1, pos2 - pos - 1);
+}
+
 /// \note: deprecated, to be removed
 CString Path::ExtensionOnly() const
 {
@@ -96,6 +114,17 @@ CString Path::ExtensionOnly(const CString& path)
    return path.Mid(pos2);
 }
 
+CStringView Path::ExtensionOnly(CStringView path)
+{
+   int pos = path.ReverseFind(Path::SeparatorCh);
+
+   int pos2 = path.ReverseFind(_T('.'));
+   if (pos2 == -1 || pos2 < pos)
+      return CStringView();
+
+   return path.Mid(pos2);
+}
+
 /// \note: deprecated, to be removed
 CString Path::FolderName() const
 {
@@ -111,6 +140,15 @@ CString Path::FolderName(const CString& path)
    return path.Left(pos + 1);
 }
 
+CStringView Path::FolderName(CStringView path)
+{
+   int pos = path.ReverseFind(Path::SeparatorCh);
+   if (pos == -1)
+      return path;
+
+   return path.Left(pos + 1);
+}
+
 /// \note: deprecated, to be removed
 CString Path::ShortPathName() const
 {
@@ -1,68 +1,97 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2000-2022 Michael Fink
+// Copyright (C) 2000-2022,2026 Michael Fink
 //
 /// \file UTF8.cpp UTF-8 conversion
 //
 
 #include "stdafx.h"
 #include <ulib/UTF8.hpp>
+#include <ulib/UTF8Convert.hpp>
+#include <cstring>
+#include <algorithm>
 
-#if __ANDROID__
-#include <locale>
-#include <codecvt>
+#if defined(WIN32) && !defined(UNICODE) && !defined(_UNICODE)
+#error non-unicode variant not implemented!
 #endif
 
 void StringToUTF8(const CString& text, std::vector<char>& utf8Buffer)
 {
-#if WIN32
-#if defined(UNICODE) || defined(_UNICODE)
-   // calculate the bytes necessary
-   unsigned int length = ::WideCharToMultiByte(CP_UTF8, 0, text, -1, nullptr, 0, nullptr, nullptr);
+   size_t length = static_cast<size_t>(text.GetLength());
+   size_t utf8Length = StringToUTF8(text.GetString(), length, nullptr, 0);
 
-   utf8Buffer.resize(length);
+   utf8Buffer.resize(utf8Length + 1);
+
+   StringToUTF8(text.GetString(), length, utf8Buffer.data(), utf8Length);
+   utf8Buffer[utf8Length] = 0;
+}
 
-   // convert
-   ::WideCharToMultiByte(CP_UTF8, 0, text, -1, &utf8Buffer[0], length, nullptr, nullptr);
+size_t StringToUTF8(const TCHAR* text, size_t length, char* utf8Buffer, size_t bufferLength)
+{
+#if defined(UNICODE) || defined(_UNICODE)
+   return UTF8Convert::FromWide(utf8Buffer, bufferLength, text, length);
 #else
-#error non-unicode variant not implemented!
-#endif
+   if (utf8Buffer == nullptr)
+      return length;
+
+   size_t count = std::min(length, bufferLength);
+   std::copy(text, text + count, utf8Buffer);
+   return count;
 #endif
+}
 
-#if __ANDROID__
-#if defined(UNICODE) || defined(_UNICODE)
-   std::wstring source{ text.GetString() };
+size_t StringToUTF8(const TCHAR* text, size_t length, std::string& utf8Text)
+{
+   size_t utf8Length = StringToUTF8(text, length, nullptr, 0);
+   size_t oldLength = utf8Text.size();
 
-   std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>, wchar_t> convert;
-   std::string dest = convert.to_bytes(source);
+   utf8Text.resize(oldLength + utf8Length);
 
-   utf8Buffer.assign(dest.data(), dest.data() + dest.length());
-#else
-   utf8Buffer.assign(text.GetString(), text.GetString() + text.GetLength());
-#endif
-#endif
+   return StringToUTF8(text, length, &utf8Text[oldLength], utf8Length);
 }
 
 CString UTF8ToString(const char* utf8Text)
 {
-#if WIN32
-   int bufferLength = MultiByteToWideChar(CP_UTF8, 0,
-      utf8Text, -1,
-      nullptr, 0);
+   return UTF8ToString(utf8Text, std::strlen(utf8Text));
+}
 
+CString UTF8ToString(const char* utf8Text, size_t length)
+{
    CString text;
-   MultiByteToWideChar(CP_UTF8, 0,
-      utf8Text, -1,
-      text.GetBuffer(bufferLength), bufferLength);
-
-   text.ReleaseBuffer();
+   UTF8ToString(utf8Text, length, text);
    return text;
-#endif
+}
 
-#if __ANDROID__
-   std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>, wchar_t> convert;
-   std::wstring dest = convert.from_bytes(utf8Text);
+size_t UTF8ToString(const char* utf8Text, size_t length, TCHAR* buffer, size_t bufferLength)
+{
+#if defined(UNICODE) || defined(_UNICODE)
+   return UTF8Convert::ToWide(buffer, bufferLength, utf8Text, length);
+#else
+   if (buffer == nullptr)
+      return length;
 
-   return CString{ dest.c_str() };
+   size_t count = std::min(length, bufferLength);
+   std::copy(utf8Text, utf8Text + count, buffer);
+   return count;
 #endif
 }
+
+size_t UTF8ToString(const char* utf8Text, size_t length, CString& text)
+{
+   if (length == 0)
+      return 0;
+
+   // the text never results in more characters than it has bytes; only
+   // measure the exact length when the buffer would have to grow anyway
+   int oldLength = text.GetLength();
+   size_t maxLength = length;
+   if (oldLength + static_cast<int>(length) > text.GetAllocLength())
+      maxLength = UTF8ToString(utf8Text, length, nullptr, 0);
+
+   TCHAR* buffer = text.GetBuffer(oldLength + static_cast<int>(maxLength));
+
+   size_t textLength = UTF8ToString(utf8Text, length, buffer + oldLength, maxLength);
+
+   text.ReleaseBufferSetLength(oldLength + static_cast<int>(textLength));
+   return textLength;
+}
@@ -0,0 +1,141 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file UTF8Decoder.cpp incremental UTF-8 decoder
+//
+
+#include "stdafx.h"
+#include <ulib/UTF8Decoder.hpp>
+#include <ulib/Exception.hpp>
+#include <algorithm>
+
+size_t UTF8Decoder::Decode(const char* src, size_t length, wchar_t* dest)
+{
+   size_t destPos = 0;
+
+   if (m_pendingLength > 0)
+   {
+      size_t usedLength = DecodePending(src, length, dest, destPos);
+      src += usedLength;
+      length -= usedLength;
+
+      if (m_pendingLength > 0 || length == 0)
+         return destPos;
+   }
+
+   size_t incompleteLength = GetIncompleteLength(src, length);
+   length -= incompleteLength;
+
+   destPos += DecodeComplete(src, length, dest + destPos);
+
+   std::copy(src + length, src + length + incompleteLength, m_pendingBytes);
+   m_pendingLength = incompleteLength;
+
+   return destPos;
+}
+
+size_t UTF8Decoder::Finish(wchar_t* dest)
+{
+   if (m_pendingLength == 0)
+      return 0;
+
+   m_pendingLength = 0;
+   return OnInvalidSequence(dest);
+}
+
+size_t UTF8Decoder::GetIncompleteLength(const char* src, size_t length)
+{
+   // an incomplete sequence starts at one of the last 3 bytes
+   size_t maxLength = std::min(length, UTF8Convert::c_maxSequenceLength - 1);
+   for (size_t count = 1; count <= maxLength; count++)
+   {
+      const char* pos = src + length - count;
+      if (UTF8Convert::IsContinuationByte(*pos))
+         continue;
+
+      return UTF8Convert::DecodeCodePoint(pos, src + length) == UTF8Convert::c_incompleteSequence
+         ? count
+         : 0;
+   }
+
+   return 0;
+}
+
+size_t UTF8Decoder::DecodePending(const char* src, size_t length, wchar_t* dest, size_t& destPos)
+{
+   char sequence[UTF8Convert::c_maxSequenceLength];
+   size_t count = std::min(length, UTF8Convert::c_maxSequenceLength - m_pendingLength);
+
+   std::copy(m_pendingBytes, m_pendingBytes + m_pendingLength, sequence);
+   std::copy(src, src + count, sequence + m_pendingLength);
+
+   const char* pos = sequence;
+   char32_t codePoint = UTF8Convert::DecodeCodePoint(pos, sequence + m_pendingLength + count);
+
+   if (codePoint == UTF8Convert::c_incompleteSequence)
+   {
+      // still incomplete; the whole chunk was used
+      std::copy(src, src + count, m_pendingBytes + m_pendingLength);
+      m_pendingLength += count;
+      return count;
+   }
+
+   // the pending bytes are the start of a valid sequence, so at least all
+   // of them were used
+   size_t usedLength = static_cast<size_t>(pos - sequence) - m_pendingLength;
+   m_pendingLength = 0;
+
+   destPos += codePoint > UTF8Convert::c_maxCodePoint
+      ? OnInvalidSequence(dest + destPos)
+      : UTF8Convert::StoreWide(codePoint, dest + destPos);
+
+   return usedLength;
+}
+
+size_t UTF8Decoder::DecodeComplete(const char* src, size_t length, wchar_t* dest)
+{
+   if (m_errorPolicy == ErrorPolicy::replace)
+      return UTF8Convert::ToWide(dest, length, src, length);
+
+   const char* pos = src;
+   const char* end = src + length;
+
+   size_t destPos = 0;
+   while (pos < end)
+   {
+      size_t validLength = UTF8Convert::Validate(pos, static_cast<size_t>(end - pos));
+      destPos += UTF8Convert::ToWide(dest + destPos, validLength, pos, validLength);
+      pos += validLength;
+
+      if (pos == end)
+         break;
+
+      // skips the invalid sequence
+      UTF8Convert::DecodeCodePoint(pos, end);
+      destPos += OnInvalidSequence(dest + destPos);
+   }
+
+   return destPos;
+}
+
+size_t UTF8Decoder::OnInvalidSequence(wchar_t* dest)
+{
+   switch (m_errorPolicy)
+   {
+   case ErrorPolicy::replace:
+      dest[0] = static_cast<wchar_t>(UTF8Convert::c_replacementChar);
+      return 1;
+
+   case ErrorPolicy::skip:
+      return 0;
+
+   case ErrorPolicy::throwException:
+      Reset();
+      throw Exception(_T("invalid UTF-8 sequence encountered"), __FILE__, __LINE__);
+
+   default:
+      ATLASSERT(false);
+      return 0;
+   }
+}
@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006-2014,2017 Michael Fink
+// Copyright (C) 2006-2014,2017,2026 Michael Fink
 //
 /// \file Logger.cpp Logger implementation
 //
@@ -15,18 +15,6 @@
 using Log::Logger;
 using Log::LoggerPtr;
 
-CString Logger::Name()
-{
-   // check if parent is the root logger
-   if (Parent() == NULL)
-      return _T("");
-
-   if (Parent()->Parent() == NULL)
-      return m_name; // just one above the parent
-   else
-      return Parent()->Name() + _T(".") + m_name;
-}
-
 /// once flag for root logger initialisation
 std::once_flag g_rootLoggerOnceFlag;
 
@@ -35,7 +23,7 @@ static Log::LoggerPtr s_rootLogger;
 
 void Logger::InitRootLogger()
 {
-   s_rootLogger = Log::LoggerPtr(new Log::Logger(_T(""), Log::LoggerPtr()));
+   s_rootLogger = Log::LoggerPtr(new Log::Logger(CStringAtom(), Log::LoggerPtr()));
 }
 
 LoggerPtr Logger::GetRootLogger()
@@ -45,6 +33,16 @@ LoggerPtr Logger::GetRootLogger()
 }
 
 LoggerPtr Logger::GetLogger(const CString& name)
+{
+   return GetLogger(CStringView(name));
+}
+
+LoggerPtr Logger::GetLogger(LPCTSTR name)
+{
+   return GetLogger(CStringView(name));
+}
+
+LoggerPtr Logger::GetLogger(CStringView name)
 {
    LoggerPtr logger = GetRootLogger();
    ATLASSERT(logger != NULL); // should not happen!
@@ -53,25 +51,25 @@ LoggerPtr Logger::GetLogger(const CString& name)
    int pos = 0, maxPos = name.GetLength();
    while (pos < maxPos)
    {
-      CString loggerName;
+      CStringView loggerNameView;
 
       // check if there's a dot
       int posDot = name.Find(_T('.'), pos);
       if (posDot != -1)
       {
-         loggerName = name.Mid(pos, posDot - pos);
+         loggerNameView = name.Mid(pos, posDot - pos);
          pos = posDot + 1;
       }
       else
       {
          // no further dots
-         loggerName = name.Mid(pos);
+         loggerNameView = name.Mid(pos);
          pos = maxPos;
       }
 
-      loggerName.MakeLower();
-
       // search logger name
+      CStringAtom loggerName = CStringAtom::FromLowerCase(loggerNameView);
+
       T_mapLoggerMap::const_iterator iter = logger->m_mapChildLogger.find(loggerName);
       if (iter == logger->m_mapChildLogger.end())
       {
@@ -103,7 +101,7 @@ void Logger::Log(Log::Level level, const CString& message, LPCSTR filename, UINT
       CString sourceFilename(filename);
 
       LoggingEventPtr event(
-         new LoggingEvent(level, Name(), message, sourceFilename, lineNumber));
+         new LoggingEvent(level, m_name, message, sourceFilename, lineNumber));
 
       LogEvent(event);
    }
@@ -118,12 +116,20 @@ void Logger::LogEvent(Log::LoggingEventPtr event)
       Parent()->LogEvent(event);
 }
 
-Logger::Logger(const CString& name, LoggerPtr parentLogger)
+Logger::Logger(CStringAtom name, LoggerPtr parentLogger)
    :m_level(none),
    m_additivity(true),
    m_parentLogger(parentLogger),
    m_name(name)
 {
+   // prepend parent's name, unless parent is the root logger
+   if (parentLogger.get() != nullptr &&
+      parentLogger->Parent() != nullptr)
+   {
+      CString fullName = parentLogger->Name() + _T(".") + name.GetString();
+      m_name = CStringAtom(CStringView(fullName));
+   }
+
    // construct a root logger?
    if (parentLogger.get() == nullptr)
    {
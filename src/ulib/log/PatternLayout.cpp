@@ -1,31 +1,39 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006-2014,2017 Michael Fink
+// Copyright (C) 2006-2014,2017,2026 Michael Fink
 //
 /// \file PatternLayout.cpp pattern layout implementation
 //
 #include "stdafx.h"
 #include <ulib/log/PatternLayout.hpp>
+#include <ulib/StringNumber.hpp>
 
 void Log::PatternLayout::Format(CString& outputText, const LoggingEventPtr loggingEvent)
 {
    ATLASSERT(loggingEvent.get() != nullptr);
 
-   outputText = m_pattern;
+   outputText.Empty();
 
-   int currentPos = 0, maxPos = outputText.GetLength();
+   LPCTSTR pattern = m_pattern.GetString();
+
+   // text from pattern is copied to the output text as is, up to the next
+   // format specifier; format specifiers are replaced by the formatted text
+   int currentPos = 0, maxPos = m_pattern.GetLength();
    while (currentPos < maxPos)
    {
-      int charPos = currentPos = outputText.Find(_T('%'), currentPos);
+      int charPos = m_pattern.Find(_T('%'), currentPos);
       if (charPos == -1)
          break; // no more format specifiers
 
+      outputText.Append(pattern + currentPos, charPos - currentPos);
+      currentPos = charPos;
+
       // read format specifier
       charPos++;
       if (charPos >= maxPos)
          break; // finished in the middle of parsing
 
-      TCHAR ch = outputText[charPos];
+      TCHAR ch = pattern[charPos];
 
       bool bLeftJustify = false; // right justify is default
 
@@ -37,7 +45,7 @@ void Log::PatternLayout::Format(CString& outputText, const LoggingEventPtr loggi
          if (charPos >= maxPos)
             break; // finished
 
-         ch = outputText[charPos];
+         ch = pattern[charPos];
       }
 
       /// read min width when available
@@ -54,7 +62,7 @@ void Log::PatternLayout::Format(CString& outputText, const LoggingEventPtr loggi
          if (charPos >= maxPos)
             break; // finished
 
-         ch = outputText[charPos];
+         ch = pattern[charPos];
       }
 
       if (charPos >= maxPos)
@@ -68,7 +76,7 @@ void Log::PatternLayout::Format(CString& outputText, const LoggingEventPtr loggi
          if (charPos >= maxPos)
             break; // finished
 
-         ch = outputText[charPos];
+         ch = pattern[charPos];
 
          // now read max width
          while (ch >= _T('0') && ch <= _T('9'))
@@ -83,7 +91,7 @@ void Log::PatternLayout::Format(CString& outputText, const LoggingEventPtr loggi
             if (charPos >= maxPos)
                break; // finished
 
-            ch = outputText[charPos];
+            ch = pattern[charPos];
          }
 
          if (charPos >= maxPos)
@@ -111,7 +119,7 @@ void Log::PatternLayout::Format(CString& outputText, const LoggingEventPtr loggi
          replaceText = loggingEvent->SourceFilename();
          break;
       case _T('L'): // source file line where log message occured
-         replaceText.Format(_T("%u"), loggingEvent->SourceLine());
+         StringNumber::AppendUInt(replaceText, loggingEvent->SourceLine());
          break;
       case _T('m'): // log message
          replaceText = loggingEvent->Message();
@@ -137,7 +145,7 @@ void Log::PatternLayout::Format(CString& outputText, const LoggingEventPtr loggi
          replaceText = _T("");
          break;
       case _T('t'): // thread id
-         replaceText.Format(_T("%u"), loggingEvent->ThreadId());
+         StringNumber::AppendUInt(replaceText, loggingEvent->ThreadId());
          break;
       case _T('%'): // percent sign
          replaceText = _T("%");
@@ -172,12 +180,12 @@ void Log::PatternLayout::Format(CString& outputText, const LoggingEventPtr loggi
             replaceText = replaceText.Right(maxPosWidth);
       }
 
-      // delete old string
-      outputText.Delete(currentPos, charPos - currentPos);
-      // insert new one
-      outputText.Insert(currentPos, replaceText);
+      outputText += replaceText;
 
-      currentPos += replaceText.GetLength();
-      maxPos = outputText.GetLength();
+      currentPos = charPos;
    }
+
+   // copy remaining text, including an unfinished format specifier
+   if (currentPos < maxPos)
+      outputText.Append(pattern + currentPos, maxPos - currentPos);
 }
@@ -0,0 +1,269 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file AsyncFileStream.cpp asynchronous file stream
+//
+#include "stdafx.h"
+#include <ulib/stream/AsyncFileStream.hpp>
+#include <ulib/stream/StreamException.hpp>
+#include <algorithm>
+#include <memory>
+
+using Stream::AsyncFileStream;
+
+/// stream whose worker thread is the current thread, if any; requests
+/// started by completion handlers don't wait for a free queue entry, since
+/// all worker threads could be waiting then
+static thread_local const AsyncFileStream* s_currentWorkerStream = nullptr;
+
+/// \exception StreamException thrown when file couldn't be opened
+AsyncFileStream::AsyncFileStream(LPCTSTR filename,
+   FileStream::EFileMode fileMode,
+   FileStream::EFileAccess fileAccess,
+   FileStream::EFileShare fileShare,
+   size_t queueDepth,
+   size_t numThreads)
+   :m_fileStream(filename, fileMode, fileAccess, fileShare),
+   m_queueDepth(std::max<size_t>(queueDepth, 1))
+{
+   ATLASSERT(queueDepth > 0);
+   ATLASSERT(numThreads > 0);
+
+   if (!m_fileStream.IsOpen())
+      return;
+
+   // more threads than requests in flight would never be busy
+   numThreads = std::clamp<size_t>(numThreads, 1, m_queueDepth);
+
+   m_threads.reserve(numThreads);
+   for (size_t threadIndex = 0; threadIndex < numThreads; threadIndex++)
+      m_threads.emplace_back(&AsyncFileStream::WorkerThread, this);
+}
+
+AsyncFileStream::~AsyncFileStream()
+{
+   try
+   {
+      Close();
+   }
+   catch (...)
+   {
+      // ignore any exceptions
+   }
+}
+
+std::future<size_t> AsyncFileStream::ReadAsync(ULONGLONG offset, std::span<std::byte> buffer)
+{
+   // the completion handler must be copyable, so the promise is shared
+   auto spPromise = std::make_shared<std::promise<size_t>>();
+   std::future<size_t> future = spPromise->get_future();
+
+   ReadAsync(offset, buffer,
+      [spPromise](size_t numBytesTransferred, std::exception_ptr error)
+      {
+         if (error != nullptr)
+            spPromise->set_exception(error);
+         else
+            spPromise->set_value(numBytesTransferred);
+      });
+
+   return future;
+}
+
+void AsyncFileStream::ReadAsync(ULONGLONG offset, std::span<std::byte> buffer, T_fnCompletion fnCompletion)
+{
+   ATLASSERT(true == m_fileStream.CanRead());
+
+   Request request;
+   request.m_isWrite = false;
+   request.m_offset = offset;
+   request.m_buffer = buffer.data();
+   request.m_length = buffer.size();
+   request.m_fnCompletion = std::move(fnCompletion);
+
+   Submit(std::move(request));
+}
+
+std::future<size_t> AsyncFileStream::WriteAsync(ULONGLONG offset, std::span<const std::byte> data)
+{
+   auto spPromise = std::make_shared<std::promise<size_t>>();
+   std::future<size_t> future = spPromise->get_future();
+
+   WriteAsync(offset, data,
+      [spPromise](size_t numBytesTransferred, std::exception_ptr error)
+      {
+         if (error != nullptr)
+            spPromise->set_exception(error);
+         else
+            spPromise->set_value(numBytesTransferred);
+      });
+
+   return future;
+}
+
+void AsyncFileStream::WriteAsync(ULONGLONG offset, std::span<const std::byte> data, T_fnCompletion fnCompletion)
+{
+   ATLASSERT(true == m_fileStream.CanWrite());
+
+   Request request;
+   request.m_isWrite = true;
+   request.m_offset = offset;
+   request.m_buffer = const_cast<std::byte*>(data.data()); // only read from when writing
+   request.m_length = data.size();
+   request.m_fnCompletion = std::move(fnCompletion);
+
+   Submit(std::move(request));
+}
+
+void AsyncFileStream::Drain()
+{
+   ATLASSERT(s_currentWorkerStream != this); // would wait for itself
+
+   std::unique_lock<std::mutex> lock(m_mutex);
+   m_allCompleted.wait(lock, [this]() { return m_numPending == 0; });
+}
+
+/// \exception StreamException thrown when flushing fails
+void AsyncFileStream::Flush()
+{
+   Drain();
+
+   if (m_fileStream.IsOpen())
+      m_fileStream.Flush();
+}
+
+void AsyncFileStream::Close()
+{
+   Drain();
+   StopThreads();
+
+   if (m_fileStream.IsOpen())
+      m_fileStream.Close();
+}
+
+/// \exception StreamException thrown when the stream is closed
+void AsyncFileStream::Submit(Request&& request)
+{
+   std::unique_lock<std::mutex> lock(m_mutex);
+
+   if (m_threads.empty() || m_stopThreads)
+      throw Stream::StreamException(_T("AsyncFileStream: stream is closed"), __FILE__, __LINE__);
+
+   if (s_currentWorkerStream != this)
+      m_queueNotFull.wait(lock, [this]() { return m_numInFlight < m_queueDepth; });
+
+   m_requests.push_back(std::move(request));
+
+   m_numInFlight++;
+   m_numPending++;
+
+   m_requestAvailable.notify_one();
+}
+
+/// \exception StreamException thrown when reading or writing fails
+size_t AsyncFileStream::Execute(const Request& request)
+{
+   // ReadAt() and WriteAt() only take DWORD lengths
+   size_t totalBytesTransferred = 0;
+   while (totalBytesTransferred < request.m_length)
+   {
+      DWORD blockLength = static_cast<DWORD>(
+         std::min<size_t>(request.m_length - totalBytesTransferred, c_maxSpanBlockSize));
+
+      DWORD numBytesTransferred = 0;
+      if (request.m_isWrite)
+      {
+         m_fileStream.WriteAt(request.m_offset + totalBytesTransferred,
+            request.m_buffer + totalBytesTransferred, blockLength, numBytesTransferred);
+      }
+      else
+      {
+         m_fileStream.ReadAt(request.m_offset + totalBytesTransferred,
+            request.m_buffer + totalBytesTransferred, blockLength, numBytesTransferred);
+      }
+
+      totalBytesTransferred += numBytesTransferred;
+
+      if (numBytesTransferred < blockLength)
+         break;
+   }
+
+   return totalBytesTransferred;
+}
+
+void AsyncFileStream::WorkerThread()
+{
+   s_currentWorkerStream = this;
+
+   for (;;)
+   {
+      Request request;
+      {
+         std::unique_lock<std::mutex> lock(m_mutex);
+         m_requestAvailable.wait(lock, [this]() { return m_stopThreads || !m_requests.empty(); });
+
+         // remaining requests are still carried out when stopping
+         if (m_requests.empty())
+            break;
+
+         request = std::move(m_requests.front());
+         m_requests.pop_front();
+      }
+
+      size_t numBytesTransferred = 0;
+      std::exception_ptr error;
+      try
+      {
+         numBytesTransferred = Execute(request);
+      }
+      catch (...)
+      {
+         error = std::current_exception();
+      }
+
+      // the queue entry is free before calling the completion handler, so
+      // that the handler can start a new request
+      {
+         std::lock_guard<std::mutex> lock(m_mutex);
+         m_numInFlight--;
+         m_queueNotFull.notify_one();
+      }
+
+      try
+      {
+         if (request.m_fnCompletion)
+            request.m_fnCompletion(numBytesTransferred, error);
+      }
+      catch (...)
+      {
+         // ignore any exceptions
+      }
+
+      {
+         std::lock_guard<std::mutex> lock(m_mutex);
+         m_numPending--;
+
+         if (m_numPending == 0)
+            m_allCompleted.notify_all();
+      }
+   }
+
+   s_currentWorkerStream = nullptr;
+}
+
+void AsyncFileStream::StopThreads()
+{
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stopThreads = true;
+      m_requestAvailable.notify_all();
+   }
+
+   for (std::thread& thread : m_threads)
+      thread.join();
+
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_threads.clear();
+   m_stopThreads = false;
+}
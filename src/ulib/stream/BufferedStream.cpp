@@ -0,0 +1,227 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file BufferedStream.cpp buffered stream
+//
+#include "stdafx.h"
+#include <ulib/stream/BufferedStream.hpp>
+#include <algorithm>
+
+using Stream::BufferedStream;
+
+BufferedStream::BufferedStream(IStream& stream, size_t readBufferSize, size_t writeBufferSize)
+   :m_stream(stream),
+   m_readBufferSize(readBufferSize),
+   m_writeBufferSize(writeBufferSize)
+{
+}
+
+BufferedStream::~BufferedStream()
+{
+   try
+   {
+      FlushWriteBuffer();
+   }
+   catch (...)
+   {
+      // ignore any exceptions; call Flush() before to get notified about errors
+   }
+}
+
+bool BufferedStream::Read(void* buffer, DWORD maxBufferLength, DWORD& numBytesRead)
+{
+   FlushWriteBuffer();
+
+   BYTE* dest = static_cast<BYTE*>(buffer);
+
+   size_t length = CopyFromReadBuffer(dest, maxBufferLength);
+
+   // only read from the underlying stream once, since it may block, e.g. for pipes
+   size_t remaining = maxBufferLength - length;
+   if (remaining >= m_readBufferSize)
+   {
+      // large reads bypass the read buffer; the buffer was fully consumed
+      m_readLength = m_readPos = 0;
+
+      DWORD numBytesReadDirect = 0;
+      m_stream.Read(dest + length, static_cast<DWORD>(remaining), numBytesReadDirect);
+      length += numBytesReadDirect;
+   }
+   else if (remaining > 0 && FillReadBuffer())
+      length += CopyFromReadBuffer(dest + length, remaining);
+
+   numBytesRead = static_cast<DWORD>(length);
+   return numBytesRead != 0;
+}
+
+bool BufferedStream::AtEndOfStream() const
+{
+   return m_readPos == m_readLength && m_stream.AtEndOfStream();
+}
+
+void BufferedStream::Write(const void* dataToWrite, DWORD lengthInBytes, DWORD& numBytesWritten)
+{
+   StartWriting();
+
+   if (m_writeLength + lengthInBytes > m_writeCapacity)
+   {
+      FlushWriteBuffer();
+
+      // large writes bypass the write buffer
+      if (lengthInBytes >= m_writeCapacity)
+      {
+         m_stream.Write(dataToWrite, lengthInBytes, numBytesWritten);
+         return;
+      }
+   }
+
+   const BYTE* src = static_cast<const BYTE*>(dataToWrite);
+   std::copy(src, src + lengthInBytes, m_writeBuffer.data() + m_writeLength);
+
+   m_writeLength += lengthInBytes;
+   numBytesWritten = lengthInBytes;
+}
+
+ULONGLONG BufferedStream::Seek(LONGLONG seekOffset, ESeekOrigin origin)
+{
+   FlushWriteBuffer();
+
+   if (m_readLength > 0 && origin != seekEnd)
+   {
+      // the underlying stream is at the end of the read buffer
+      LONGLONG streamPos = static_cast<LONGLONG>(m_stream.Position());
+      LONGLONG bufferStart = streamPos - static_cast<LONGLONG>(m_readLength);
+
+      LONGLONG newPos = origin == seekBegin
+         ? seekOffset
+         : bufferStart + static_cast<LONGLONG>(m_readPos) + seekOffset;
+
+      // seeking inside the read buffer keeps the buffer
+      if (newPos >= bufferStart && newPos <= streamPos)
+      {
+         m_readPos = static_cast<size_t>(newPos - bufferStart);
+         return static_cast<ULONGLONG>(newPos);
+      }
+
+      m_readLength = m_readPos = 0;
+      return m_stream.Seek(std::max<LONGLONG>(newPos, 0), seekBegin);
+   }
+
+   m_readLength = m_readPos = 0;
+   return m_stream.Seek(seekOffset, origin);
+}
+
+ULONGLONG BufferedStream::Position()
+{
+   if (m_writeLength > 0)
+      return m_stream.Position() + m_writeLength;
+
+   return m_stream.Position() - (m_readLength - m_readPos);
+}
+
+ULONGLONG BufferedStream::Length()
+{
+   FlushWriteBuffer();
+
+   return m_stream.Length();
+}
+
+void BufferedStream::Flush()
+{
+   FlushWriteBuffer();
+
+   m_stream.Flush();
+}
+
+void BufferedStream::Close()
+{
+   FlushWriteBuffer();
+
+   m_readLength = m_readPos = 0;
+   m_writeCapacity = 0;
+
+   m_stream.Close();
+}
+
+BYTE BufferedStream::ReadByteUnbuffered()
+{
+   BYTE byteToRead = 0;
+   DWORD numBytesRead = 0;
+   ATLVERIFY(true == Read(&byteToRead, 1, numBytesRead) && 1 == numBytesRead);
+   return byteToRead;
+}
+
+void BufferedStream::WriteByteUnbuffered(BYTE byteToWrite)
+{
+   DWORD numBytesWritten = 0;
+   Write(&byteToWrite, 1, numBytesWritten);
+   ATLASSERT(1 == numBytesWritten);
+}
+
+size_t BufferedStream::CopyFromReadBuffer(BYTE* buffer, size_t maxBufferLength)
+{
+   size_t length = std::min(m_readLength - m_readPos, maxBufferLength);
+
+   std::copy(m_readBuffer.data() + m_readPos, m_readBuffer.data() + m_readPos + length, buffer);
+   m_readPos += length;
+
+   return length;
+}
+
+bool BufferedStream::FillReadBuffer()
+{
+   // the write buffer is only used again after the read buffer was discarded
+   m_writeCapacity = 0;
+
+   if (m_readBuffer.empty())
+      m_readBuffer.resize(m_readBufferSize);
+
+   DWORD numBytesRead = 0;
+   m_stream.Read(m_readBuffer.data(), static_cast<DWORD>(m_readBufferSize), numBytesRead);
+
+   m_readLength = numBytesRead;
+   m_readPos = 0;
+
+   return numBytesRead != 0;
+}
+
+void BufferedStream::DiscardReadBuffer()
+{
+   size_t unreadLength = m_readLength - m_readPos;
+   m_readLength = m_readPos = 0;
+
+   if (unreadLength > 0)
+   {
+      ATLASSERT(true == m_stream.CanSeek());
+      m_stream.Seek(-static_cast<LONGLONG>(unreadLength), seekCurrent);
+   }
+}
+
+void BufferedStream::FlushWriteBuffer()
+{
+   if (m_writeLength == 0)
+      return;
+
+   // reset length first, so that the bytes aren't written again after an exception
+   DWORD lengthInBytes = static_cast<DWORD>(m_writeLength);
+   m_writeLength = 0;
+
+   DWORD numBytesWritten = 0;
+   m_stream.Write(m_writeBuffer.data(), lengthInBytes, numBytesWritten);
+   ATLASSERT(lengthInBytes == numBytesWritten);
+}
+
+void BufferedStream::StartWriting()
+{
+   if (m_writeCapacity > 0)
+      return;
+
+   // the underlying stream must be at the position of the next unread byte
+   DiscardReadBuffer();
+
+   if (m_writeBuffer.empty())
+      m_writeBuffer.resize(m_writeBufferSize);
+
+   m_writeCapacity = m_writeBufferSize;
+}
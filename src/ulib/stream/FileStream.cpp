@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006,2007,2008,2012,2014,2017 Michael Fink
+// Copyright (C) 2006,2007,2008,2012,2014,2017,2026 Michael Fink
 //
 /// \file FileStream.cpp file based stream
 //
@@ -8,9 +8,20 @@
 #include <ulib/stream/FileStream.hpp>
 #include <ulib/stream/StreamException.hpp>
 #include <ulib/win32/ErrorMessage.hpp>
+#include <atomic>
 
 using Stream::FileStream;
 
+/// returns current file pointer of given file handle
+static LARGE_INTEGER GetFilePointer(HANDLE fileHandle)
+{
+   LARGE_INTEGER distance = {};
+   LARGE_INTEGER currentPos = {};
+   ::SetFilePointerEx(fileHandle, distance, &currentPos, FILE_CURRENT);
+
+   return currentPos;
+}
+
 /// \note when a file on a floppy or cdrom drive is tried to open without a disc in the drive,
 ///       a message box appears asking for a disc in the drive. Use SetErrorMode with flag
 ///       SEM_FAILCRITICALERRORS to prevent this.
@@ -18,7 +29,7 @@ using Stream::FileStream;
 FileStream::FileStream(LPCTSTR filename, EFileMode fileMode, EFileAccess fileAccess, EFileShare fileShare)
    :m_fileAccess(fileAccess),
    m_atEndOfFile(true),
-   m_fileLength((ULONGLONG)-1)
+   m_fileLength(0)
 {
    ATLASSERT(filename != NULL);
 
@@ -40,6 +51,29 @@ FileStream::FileStream(LPCTSTR filename, EFileMode fileMode, EFileAccess fileAcc
 
    m_spHandle = std::shared_ptr<void>(fileHandle, CloseHandle);
 
+   // cache file length; it's kept up to date when writing
+#ifdef _WIN32_WCE
+   // CE has no GetFileSizeEx, so we have to use GetFileSize
+   LARGE_INTEGER fileSize; fileSize.QuadPart = 0;
+   DWORD dwRet = ::GetFileSize(m_spHandle.get(), reinterpret_cast<ULONG*>(&fileSize.HighPart));
+   if (dwRet == 0xffffffff)
+   {
+      DWORD dwError = GetLastError();
+
+      if (dwError != NO_ERROR)
+         throw Stream::StreamException(_T("Length: ") + Tools::CWin32ErrorMessage(dwError).GetMessage(), __FILE__, __LINE__);
+   }
+   fileSize.LowPart = dwRet;
+#else
+   LARGE_INTEGER fileSize; fileSize.QuadPart = 0;
+   BOOL ret = ::GetFileSizeEx(m_spHandle.get(), &fileSize);
+
+   if (ret == FALSE)
+      throw Stream::StreamException(_T("Length: ") + Win32::ErrorMessage().ToString(), __FILE__, __LINE__);
+#endif
+
+   m_fileLength.store(fileSize.QuadPart);
+
    m_atEndOfFile = false;
 
    if (fileMode == modeAppend)
@@ -48,6 +82,24 @@ FileStream::FileStream(LPCTSTR filename, EFileMode fileMode, EFileAccess fileAcc
    // cppcheck-suppress resourceLeak
 }
 
+FileStream::FileStream(const FileStream& other)
+   :m_fileAccess(other.m_fileAccess),
+   m_spHandle(other.m_spHandle),
+   m_atEndOfFile(other.m_atEndOfFile),
+   m_fileLength(other.m_fileLength.load())
+{
+}
+
+FileStream& FileStream::operator=(const FileStream& other)
+{
+   m_fileAccess = other.m_fileAccess;
+   m_spHandle = other.m_spHandle;
+   m_atEndOfFile = other.m_atEndOfFile;
+   m_fileLength.store(other.m_fileLength.load());
+
+   return *this;
+}
+
 /// \exception StreamException thrown when reading fails
 bool FileStream::Read(void* buffer, DWORD maxBufferLength, DWORD& numBytesRead)
 {
@@ -63,6 +115,67 @@ bool FileStream::Read(void* buffer, DWORD maxBufferLength, DWORD& numBytesRead)
    return numBytesRead != 0;
 }
 
+/// \exception StreamException thrown when reading fails
+size_t FileStream::ReadSpan(std::span<std::byte> buffer)
+{
+   ATLASSERT(m_spHandle.get() != NULL);
+   ATLASSERT(true == CanRead());
+
+   // ReadFile() can only read up to 4 GiB at once
+   size_t totalBytesRead = 0;
+   while (totalBytesRead < buffer.size())
+   {
+      DWORD blockSize = static_cast<DWORD>(std::min(buffer.size() - totalBytesRead, Stream::c_maxSpanBlockSize));
+
+      DWORD numBytesRead = 0;
+      BOOL ret = ::ReadFile(m_spHandle.get(), buffer.data() + totalBytesRead, blockSize, &numBytesRead, NULL);
+
+      if (ret == FALSE)
+         throw Stream::StreamException(_T("Read: ") + Win32::ErrorMessage().ToString(), __FILE__, __LINE__);
+
+      if (numBytesRead == 0)
+         break;
+
+      totalBytesRead += numBytesRead;
+   }
+
+   return totalBytesRead;
+}
+
+/// \exception StreamException thrown when reading fails
+size_t FileStream::ReadV(std::span<const std::span<std::byte>> buffers)
+{
+   // ReadFileScatter() needs unbuffered file access and page sized buffers
+   return IStream::ReadV(buffers);
+}
+
+/// \exception StreamException thrown when reading fails
+bool FileStream::ReadAt(ULONGLONG offset, void* buffer, DWORD maxBufferLength, DWORD& numBytesRead)
+{
+   ATLASSERT(m_spHandle.get() != NULL);
+   ATLASSERT(true == CanRead());
+
+   OVERLAPPED overlapped = {};
+   overlapped.Offset = static_cast<DWORD>(offset & 0xffffffff);
+   overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+   // ReadFile() with an offset also moves the file pointer of a synchronous
+   // file handle, so restore it afterwards
+   LARGE_INTEGER currentPos = GetFilePointer(m_spHandle.get());
+
+   numBytesRead = 0;
+   BOOL ret = ::ReadFile(m_spHandle.get(), buffer, maxBufferLength, &numBytesRead, &overlapped);
+   DWORD lastError = ::GetLastError();
+
+   ::SetFilePointerEx(m_spHandle.get(), currentPos, NULL, FILE_BEGIN);
+
+   // reading at or after the end of file fails with ERROR_HANDLE_EOF
+   if (ret == FALSE && lastError != ERROR_HANDLE_EOF)
+      throw Stream::StreamException(_T("Read: ") + Win32::ErrorMessage(lastError).ToString(), __FILE__, __LINE__);
+
+   return numBytesRead != 0;
+}
+
 bool FileStream::AtEndOfStream() const
 {
    if (!IsOpen() || m_atEndOfFile)
@@ -101,12 +214,70 @@ void FileStream::Write(const void* dataToWrite, DWORD lengthInBytes, DWORD& numB
    if (ret == FALSE)
       throw Stream::StreamException(_T("Write: ") + Win32::ErrorMessage().ToString(), __FILE__, __LINE__);
 
-   if (m_fileLength != (ULONGLONG)-1)
+   // extend file length when writing beyond current end of file
+   ExtendFileLength(Position());
+}
+
+/// \exception StreamException thrown when writing fails
+size_t FileStream::WriteSpan(std::span<const std::byte> data)
+{
+   size_t totalBytesWritten = 0;
+   while (totalBytesWritten < data.size())
    {
-      // invalidate file length when writing beyond current end of file
-      ULONGLONG position = Position();
-      if (position > m_fileLength)
-         m_fileLength = (ULONGLONG)-1;
+      DWORD blockSize = static_cast<DWORD>(std::min(data.size() - totalBytesWritten, Stream::c_maxSpanBlockSize));
+
+      DWORD numBytesWritten = 0;
+      Write(data.data() + totalBytesWritten, blockSize, numBytesWritten);
+
+      totalBytesWritten += numBytesWritten;
+      if (numBytesWritten < blockSize)
+         break;
+   }
+
+   return totalBytesWritten;
+}
+
+/// \exception StreamException thrown when writing fails
+size_t FileStream::WriteV(std::span<const std::span<const std::byte>> buffers)
+{
+   // WriteFileGather() needs unbuffered file access and page sized buffers
+   return IStream::WriteV(buffers);
+}
+
+/// \exception StreamException thrown when writing fails
+void FileStream::WriteAt(ULONGLONG offset, const void* dataToWrite, DWORD lengthInBytes, DWORD& numBytesWritten)
+{
+   ATLASSERT(m_spHandle.get() != NULL);
+   ATLASSERT(true == CanWrite());
+
+   OVERLAPPED overlapped = {};
+   overlapped.Offset = static_cast<DWORD>(offset & 0xffffffff);
+   overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+   // restore the file pointer; see ReadAt()
+   LARGE_INTEGER currentPos = GetFilePointer(m_spHandle.get());
+
+   numBytesWritten = 0;
+   BOOL ret = ::WriteFile(m_spHandle.get(), dataToWrite,
+      lengthInBytes, &numBytesWritten, &overlapped);
+   DWORD lastError = ::GetLastError();
+
+   ::SetFilePointerEx(m_spHandle.get(), currentPos, NULL, FILE_BEGIN);
+
+   if (ret == FALSE)
+      throw Stream::StreamException(_T("Write: ") + Win32::ErrorMessage(lastError).ToString(), __FILE__, __LINE__);
+
+   // other threads may write at the same time
+   ExtendFileLength(offset + numBytesWritten);
+}
+
+void FileStream::ExtendFileLength(ULONGLONG endPosition)
+{
+   ULONGLONG cachedLength = m_fileLength.load();
+   while (endPosition > cachedLength &&
+      !m_fileLength.compare_exchange_weak(cachedLength, endPosition))
+   {
+      // cachedLength was updated; try again
    }
 }
 
@@ -147,32 +318,7 @@ ULONGLONG FileStream::Length()
 {
    ATLASSERT(m_spHandle.get() != NULL);
 
-   if (m_fileLength != (ULONGLONG)-1)
-      return m_fileLength;
-
-#ifdef _WIN32_WCE
-   // CE has no GetFileSizeEx, so we have to use GetFileSize
-   LARGE_INTEGER fileSize; fileSize.QuadPart = 0;
-   DWORD dwRet = ::GetFileSize(m_spHandle.get(), reinterpret_cast<ULONG*>(&fileSize.HighPart));
-   if (dwRet == 0xffffffff)
-   {
-      DWORD dwError = GetLastError();
-
-      if (dwError != NO_ERROR)
-         throw Stream::StreamException(_T("Length: ") + Tools::CWin32ErrorMessage(dwError).GetMessage(), __FILE__, __LINE__);
-   }
-#else
-   LARGE_INTEGER fileSize; fileSize.QuadPart = 0;
-   BOOL ret = ::GetFileSizeEx(m_spHandle.get(), &fileSize);
-
-   if (ret == FALSE)
-      throw Stream::StreamException(_T("Length: ") + Win32::ErrorMessage().ToString(), __FILE__, __LINE__);
-#endif
-
-   // cache in case we need it later
-   m_fileLength = fileSize.QuadPart;
-
-   return fileSize.QuadPart;
+   return m_fileLength.load();
 }
 
 /// \exception StreamException thrown when flushing the file fails
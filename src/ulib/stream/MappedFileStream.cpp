@@ -0,0 +1,294 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2026 Michael Fink
+//
+/// \file MappedFileStream.cpp memory mapped, read-only file stream
+//
+#include "stdafx.h"
+#include <ulib/stream/MappedFileStream.hpp>
+#include <ulib/stream/StreamException.hpp>
+#include <ulib/win32/ErrorMessage.hpp>
+#include <algorithm>
+#include <cstring>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using Stream::MappedFileStream;
+
+/// returns the alignment of file offsets of mapped windows
+static ULONGLONG GetMappingGranularity()
+{
+#ifdef WIN32
+   SYSTEM_INFO systemInfo = {};
+   ::GetSystemInfo(&systemInfo);
+   return systemInfo.dwAllocationGranularity;
+#else
+   return static_cast<ULONGLONG>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+/// \exception StreamException thrown when file couldn't be opened or mapped
+MappedFileStream::MappedFileStream(LPCTSTR filename, size_t windowSize)
+   :m_windowSize(windowSize)
+{
+   ATLASSERT(filename != nullptr);
+   ATLASSERT(windowSize > 0);
+
+#ifdef WIN32
+   HANDLE fileHandle = ::CreateFile(filename,
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr, // security attributes
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr); // template file handle
+
+   if (fileHandle == INVALID_HANDLE_VALUE)
+      throw Stream::StreamException(Win32::ErrorMessage().ToString() + filename, __FILE__, __LINE__);
+
+   m_spFile = std::shared_ptr<void>(fileHandle, ::CloseHandle);
+
+   LARGE_INTEGER fileSize; fileSize.QuadPart = 0;
+   if (!::GetFileSizeEx(fileHandle, &fileSize))
+      throw Stream::StreamException(_T("Length: ") + Win32::ErrorMessage().ToString(), __FILE__, __LINE__);
+
+   m_fileLength = static_cast<ULONGLONG>(fileSize.QuadPart);
+
+   // empty files can't be mapped
+   if (m_fileLength > 0)
+   {
+      HANDLE mappingHandle = ::CreateFileMapping(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (mappingHandle == nullptr)
+         throw Stream::StreamException(_T("Map: ") + Win32::ErrorMessage().ToString(), __FILE__, __LINE__);
+
+      m_spMapping = std::shared_ptr<void>(mappingHandle, ::CloseHandle);
+   }
+#else
+   m_fd = ::open(CStringA(filename).GetString(), O_RDONLY | O_CLOEXEC);
+   if (m_fd < 0)
+      throw Stream::StreamException(
+         Win32::ErrorMessage(static_cast<DWORD>(errno)).ToString() + filename, __FILE__, __LINE__);
+
+   struct stat fileStat = {};
+   if (::fstat(m_fd, &fileStat) != 0)
+   {
+      int errorNr = errno;
+      Close();
+      throw Stream::StreamException(
+         _T("Length: ") + Win32::ErrorMessage(static_cast<DWORD>(errorNr)).ToString(), __FILE__, __LINE__);
+   }
+
+   m_fileLength = static_cast<ULONGLONG>(fileStat.st_size);
+#endif
+
+   if (m_fileLength > 0)
+      MapWindow(0, static_cast<size_t>(std::min<ULONGLONG>(m_fileLength, m_windowSize)));
+}
+
+MappedFileStream::~MappedFileStream()
+{
+   try
+   {
+      Close();
+   }
+   catch (...)
+   {
+      // ignore any exceptions
+   }
+}
+
+bool MappedFileStream::IsOpen() const
+{
+#ifdef WIN32
+   return m_spFile.get() != nullptr;
+#else
+   return m_fd >= 0;
+#endif
+}
+
+void MappedFileStream::SetAccessHint(EAccessHint accessHint)
+{
+   m_accessHint = accessHint;
+
+   ApplyAccessHint();
+}
+
+const BYTE* MappedFileStream::View(ULONGLONG offset, size_t length)
+{
+   ATLASSERT(IsOpen());
+
+   if (length == 0 || offset > m_fileLength || m_fileLength - offset < length)
+      return nullptr;
+
+   if (m_window == nullptr ||
+      offset < m_windowOffset ||
+      offset + length > m_windowOffset + m_windowLength)
+      MapWindow(offset, length);
+
+   return m_window + (offset - m_windowOffset);
+}
+
+bool MappedFileStream::Read(void* buffer, DWORD maxBufferLength, DWORD& numBytesRead)
+{
+   ATLASSERT(IsOpen());
+
+   ULONGLONG length = std::min<ULONGLONG>(maxBufferLength, m_fileLength - std::min(m_position, m_fileLength));
+   numBytesRead = static_cast<DWORD>(length);
+
+   // copy one window at a time, since the read may be larger than the window
+   BYTE* dest = static_cast<BYTE*>(buffer);
+   while (length > 0)
+   {
+      size_t chunkLength = static_cast<size_t>(std::min<ULONGLONG>(length, m_windowSize));
+
+      const BYTE* data = View(m_position, chunkLength);
+      std::memcpy(dest, data, chunkLength);
+
+      dest += chunkLength;
+      m_position += chunkLength;
+      length -= chunkLength;
+   }
+
+   return numBytesRead != 0;
+}
+
+const BYTE* MappedFileStream::ReadDirect(DWORD length)
+{
+   const BYTE* data = View(m_position, length);
+   if (data != nullptr)
+      m_position += length;
+
+   return data;
+}
+
+void MappedFileStream::Write(const void* dataToWrite, DWORD lengthInBytes, DWORD& numBytesWritten)
+{
+   UNUSED(dataToWrite);
+   UNUSED(lengthInBytes);
+
+   numBytesWritten = 0;
+
+   ATLASSERT(false); // can't write to stream
+}
+
+ULONGLONG MappedFileStream::Seek(LONGLONG seekOffset, ESeekOrigin origin)
+{
+   LONGLONG newPosition = 0;
+
+   switch (origin)
+   {
+   case seekBegin:
+      newPosition = seekOffset;
+      break;
+
+   case seekCurrent:
+      newPosition = static_cast<LONGLONG>(m_position) + seekOffset;
+      break;
+
+   case seekEnd:
+      newPosition = static_cast<LONGLONG>(m_fileLength) - seekOffset;
+      break;
+
+   default:
+      ATLASSERT(false); // invalid seek origin
+      break;
+   }
+
+   m_position = std::min<ULONGLONG>(std::max<LONGLONG>(newPosition, 0), m_fileLength);
+
+   return m_position;
+}
+
+void MappedFileStream::Close()
+{
+   UnmapWindow();
+
+#ifdef WIN32
+   m_spMapping.reset();
+   m_spFile.reset();
+#else
+   if (m_fd >= 0)
+      ::close(m_fd);
+
+   m_fd = -1;
+#endif
+
+   m_fileLength = m_position = 0;
+}
+
+/// \exception StreamException thrown when the window couldn't be mapped
+void MappedFileStream::MapWindow(ULONGLONG offset, size_t length)
+{
+   UnmapWindow();
+
+   static const ULONGLONG s_granularity = GetMappingGranularity();
+
+   // the window starts at an aligned offset before the range, and has at
+   // least the window size, when the file is large enough
+   ULONGLONG windowOffset = offset - offset % s_granularity;
+   ULONGLONG windowEnd = std::min(std::max(offset + length, windowOffset + m_windowSize), m_fileLength);
+
+   size_t windowLength = static_cast<size_t>(windowEnd - windowOffset);
+
+#ifdef WIN32
+   void* window = ::MapViewOfFile(m_spMapping.get(),
+      FILE_MAP_READ,
+      static_cast<DWORD>(windowOffset >> 32),
+      static_cast<DWORD>(windowOffset & 0xffffffff),
+      windowLength);
+
+   if (window == nullptr)
+      throw Stream::StreamException(_T("Map: ") + Win32::ErrorMessage().ToString(), __FILE__, __LINE__);
+#else
+   void* window = ::mmap(nullptr, windowLength, PROT_READ, MAP_SHARED, m_fd, static_cast<off_t>(windowOffset));
+
+   if (window == MAP_FAILED)
+      throw Stream::StreamException(
+         _T("Map: ") + Win32::ErrorMessage(static_cast<DWORD>(errno)).ToString(), __FILE__, __LINE__);
+#endif
+
+   m_window = static_cast<const BYTE*>(window);
+   m_windowOffset = windowOffset;
+   m_windowLength = windowLength;
+
+   ApplyAccessHint();
+}
+
+void MappedFileStream::UnmapWindow()
+{
+   if (m_window == nullptr)
+      return;
+
+#ifdef WIN32
+   ::UnmapViewOfFile(m_window);
+#else
+   ::munmap(const_cast<BYTE*>(m_window), m_windowLength);
+#endif
+
+   m_window = nullptr;
+   m_windowOffset = 0;
+   m_windowLength = 0;
+}
+
+void MappedFileStream::ApplyAccessHint()
+{
+#ifndef WIN32
+   if (m_window == nullptr)
+      return;
+
+   int advice = MADV_NORMAL;
+   if (m_accessHint == accessSequential)
+      advice = MADV_SEQUENTIAL;
+   else if (m_accessHint == accessRandom)
+      advice = MADV_RANDOM;
+
+   // the hint is only an optimization, so errors are ignored
+   ::madvise(const_cast<BYTE*>(m_window), m_windowLength, advice);
+#endif
+}
@@ -0,0 +1,496 @@
+//
+// ulib - a collection of useful classes
+// Copyright (C) 2015,2022,2026 Michael Fink
+//
+/// \file PosixFileStream.cpp POSIX file descriptor based stream
+//
+#include "stdafx.h"
+#include <ulib/stream/FileStream.hpp>
+#include <ulib/stream/StreamException.hpp>
+#include <ulib/win32/ErrorMessage.hpp>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <atomic>
+#include <climits>
+#include <vector>
+
+using Stream::FileStream;
+
+CString MessageFromErrno(int errorNr)
+{
+   return Win32::ErrorMessage(static_cast<DWORD>(errorNr)).ToString();
+};
+
+/// reads from file at given offset; 32-bit Android has a 32-bit off_t, so
+/// the 64-bit variant is used there to support large files
+static ssize_t ReadFileAt(int fd, void* buffer, size_t length, ULONGLONG offset)
+{
+#if defined(__ANDROID__) && !defined(__LP64__)
+   return ::pread64(fd, buffer, length, static_cast<off64_t>(offset));
+#else
+   return ::pread(fd, buffer, length, static_cast<off_t>(offset));
+#endif
+}
+
+/// writes to file at given offset; see ReadFileAt()
+static ssize_t WriteFileAt(int fd, const void* buffer, size_t length, ULONGLONG offset)
+{
+#if defined(__ANDROID__) && !defined(__LP64__)
+   return ::pwrite64(fd, buffer, length, static_cast<off64_t>(offset));
+#else
+   return ::pwrite(fd, buffer, length, static_cast<off_t>(offset));
+#endif
+}
+
+// preadv() and pwritev() are only available from API level 24 on
+#if !defined(__ANDROID__) || __ANDROID_API__ >= 24
+/// reads from file at given offset into multiple buffers; see ReadFileAt()
+static ssize_t ReadFileAtV(int fd, const iovec* ioVectors, int count, ULONGLONG offset)
+{
+#if defined(__ANDROID__) && !defined(__LP64__)
+   return ::preadv64(fd, ioVectors, count, static_cast<off64_t>(offset));
+#else
+   return ::preadv(fd, ioVectors, count, static_cast<off_t>(offset));
+#endif
+}
+
+/// writes to file at given offset from multiple buffers; see ReadFileAt()
+static ssize_t WriteFileAtV(int fd, const iovec* ioVectors, int count, ULONGLONG offset)
+{
+#if defined(__ANDROID__) && !defined(__LP64__)
+   return ::pwritev64(fd, ioVectors, count, static_cast<off64_t>(offset));
+#else
+   return ::pwritev(fd, ioVectors, count, static_cast<off_t>(offset));
+#endif
+}
+#endif
+
+/// closes file descriptor, when the last copy of a FileStream releases it
+static void CloseFileDescriptor(int* fd)
+{
+   ::close(*fd);
+   delete fd;
+}
+
+/// reads until the buffer is full or the end of the file is reached, since
+/// pread() may return fewer bytes than requested, e.g. when interrupted
+/// \exception StreamException thrown when reading fails
+static size_t ReadFully(int fd, BYTE* buffer, size_t length, ULONGLONG offset)
+{
+   size_t numBytesRead = 0;
+   while (numBytesRead < length)
+   {
+      ssize_t ret = ReadFileAt(fd, buffer + numBytesRead, length - numBytesRead, offset + numBytesRead);
+
+      if (ret < 0 && errno == EINTR)
+         continue;
+
+      if (ret < 0)
+         throw Stream::StreamException(
+            _T("Read: ") + MessageFromErrno(errno), __FILE__, __LINE__);
+
+      if (ret == 0)
+         break;
+
+      numBytesRead += static_cast<size_t>(ret);
+   }
+
+   return numBytesRead;
+}
+
+/// writes all bytes; in append mode, write() is used, which always writes
+/// at the end of the file, and the offset is ignored
+/// \exception StreamException thrown when writing fails
+static size_t WriteFully(int fd, const BYTE* data, size_t length, ULONGLONG offset, bool appendMode)
+{
+   size_t numBytesWritten = 0;
+   while (numBytesWritten < length)
+   {
+      ssize_t ret = appendMode
+         ? ::write(fd, data + numBytesWritten, length - numBytesWritten)
+         : WriteFileAt(fd, data + numBytesWritten, length - numBytesWritten, offset + numBytesWritten);
+
+      if (ret < 0 && errno == EINTR)
+         continue;
+
+      if (ret < 0)
+         throw Stream::StreamException(
+            _T("Write: ") + MessageFromErrno(errno), __FILE__, __LINE__);
+
+      numBytesWritten += static_cast<size_t>(ret);
+   }
+
+   return numBytesWritten;
+}
+
+#if !defined(__ANDROID__) || __ANDROID_API__ >= 24
+/// skips given number of transferred bytes in the I/O vectors, starting
+/// at given index; returns the index of the first vector with bytes left
+static size_t AdvanceIoVectors(std::vector<iovec>& ioVectors, size_t index, size_t numBytes)
+{
+   while (index < ioVectors.size() && numBytes >= ioVectors[index].iov_len)
+   {
+      numBytes -= ioVectors[index].iov_len;
+      index++;
+   }
+
+   if (index < ioVectors.size())
+   {
+      ioVectors[index].iov_base = static_cast<BYTE*>(ioVectors[index].iov_base) + numBytes;
+      ioVectors[index].iov_len -= numBytes;
+   }
+
+   return index;
+}
+
+/// reads until all buffers are full or the end of the file is reached
+/// \exception StreamException thrown when reading fails
+static size_t ReadFullyV(int fd, std::vector<iovec>& ioVectors, ULONGLONG offset)
+{
+   size_t numBytesRead = 0;
+   size_t index = AdvanceIoVectors(ioVectors, 0, 0);
+   while (index < ioVectors.size())
+   {
+      int count = static_cast<int>(std::min<size_t>(ioVectors.size() - index, IOV_MAX));
+      ssize_t ret = ReadFileAtV(fd, ioVectors.data() + index, count, offset + numBytesRead);
+
+      if (ret < 0 && errno == EINTR)
+         continue;
+
+      if (ret < 0)
+         throw Stream::StreamException(
+            _T("Read: ") + MessageFromErrno(errno), __FILE__, __LINE__);
+
+      if (ret == 0)
+         break;
+
+      numBytesRead += static_cast<size_t>(ret);
+      index = AdvanceIoVectors(ioVectors, index, static_cast<size_t>(ret));
+   }
+
+   return numBytesRead;
+}
+
+/// writes all buffers; see WriteFully() for append mode
+/// \exception StreamException thrown when writing fails
+static size_t WriteFullyV(int fd, std::vector<iovec>& ioVectors, ULONGLONG offset, bool appendMode)
+{
+   size_t numBytesWritten = 0;
+   size_t index = AdvanceIoVectors(ioVectors, 0, 0);
+   while (index < ioVectors.size())
+   {
+      int count = static_cast<int>(std::min<size_t>(ioVectors.size() - index, IOV_MAX));
+      ssize_t ret = appendMode
+         ? ::writev(fd, ioVectors.data() + index, count)
+         : WriteFileAtV(fd, ioVectors.data() + index, count, offset + numBytesWritten);
+
+      if (ret < 0 && errno == EINTR)
+         continue;
+
+      if (ret < 0)
+         throw Stream::StreamException(
+            _T("Write: ") + MessageFromErrno(errno), __FILE__, __LINE__);
+
+      numBytesWritten += static_cast<size_t>(ret);
+      index = AdvanceIoVectors(ioVectors, index, static_cast<size_t>(ret));
+   }
+
+   return numBytesWritten;
+}
+#endif
+
+/// \exception StreamException thrown when file couldn't be opened
+FileStream::FileStream(LPCTSTR filename, EFileMode fileMode, EFileAccess fileAccess, EFileShare fileShare)
+   :m_fileAccess(fileAccess),
+   m_atEndOfFile(true),
+   m_fileLength(0)
+{
+   ATLASSERT(filename != nullptr);
+   UNUSED(fileShare); // there are no mandatory file locks
+
+#if defined(DEBUG) || defined(_DEBUG)
+   if (fileMode == modeTruncate) // write access needed in modeTruncate
+      ATLASSERT((fileAccess & FileStream::accessWrite) != 0);
+#endif
+
+   int flags = O_CLOEXEC;
+
+   if (fileAccess == EFileAccess::accessRead) flags |= O_RDONLY;
+   else if (fileAccess == EFileAccess::accessWrite) flags |= O_WRONLY;
+   else if (fileAccess == EFileAccess::accessReadWrite) flags |= O_RDWR;
+   else
+      throw Stream::StreamException(
+         _T("Open: Couldn't determine open flags from file access"), __FILE__, __LINE__);
+
+   switch (fileMode)
+   {
+   case modeCreateNew: flags |= O_CREAT | O_EXCL; break;
+   case modeCreate: flags |= O_CREAT | O_TRUNC; break;
+   case modeOpen: break;
+   case modeOpenOrCreate: flags |= O_CREAT; break;
+   case modeTruncate: flags |= O_TRUNC; break;
+   case modeAppend: flags |= O_APPEND; break;
+   default:
+      throw Stream::StreamException(
+         _T("Open: Couldn't determine open flags from file mode"), __FILE__, __LINE__);
+   }
+
+   int fd = ::open(CStringA(filename).GetString(), flags, 0666);
+   if (fd < 0)
+      throw Stream::StreamException(
+         MessageFromErrno(errno) + filename, __FILE__, __LINE__);
+
+   m_spHandle = std::shared_ptr<int>(new int(fd), CloseFileDescriptor);
+
+   // cache file length; it's kept up to date when writing
+   struct stat fileStat = {};
+   if (::fstat(fd, &fileStat) != 0)
+      throw Stream::StreamException(
+         _T("Length: ") + MessageFromErrno(errno), __FILE__, __LINE__);
+
+   m_fileLength.store(static_cast<ULONGLONG>(fileStat.st_size));
+
+   m_atEndOfFile = false;
+   m_appendMode = fileMode == modeAppend;
+
+   if (fileMode == modeAppend)
+      Seek(0L, FileStream::seekEnd);
+}
+
+FileStream::FileStream(const FileStream& other)
+   :m_fileAccess(other.m_fileAccess),
+   m_spHandle(other.m_spHandle),
+   m_appendMode(other.m_appendMode),
+   m_position(other.m_position),
+   m_atEndOfFile(other.m_atEndOfFile),
+   m_fileLength(other.m_fileLength.load())
+{
+}
+
+FileStream& FileStream::operator=(const FileStream& other)
+{
+   m_fileAccess = other.m_fileAccess;
+   m_spHandle = other.m_spHandle;
+   m_appendMode = other.m_appendMode;
+   m_position = other.m_position;
+   m_atEndOfFile = other.m_atEndOfFile;
+   m_fileLength.store(other.m_fileLength.load());
+
+   return *this;
+}
+
+/// \exception StreamException thrown when reading fails
+bool FileStream::Read(void* buffer, DWORD maxBufferLength, DWORD& numBytesRead)
+{
+   numBytesRead = static_cast<DWORD>(
+      ReadSpan(std::span<std::byte>(static_cast<std::byte*>(buffer), maxBufferLength)));
+
+   return numBytesRead != 0;
+}
+
+/// \exception StreamException thrown when reading fails
+size_t FileStream::ReadSpan(std::span<std::byte> buffer)
+{
+   ATLASSERT(m_spHandle.get() != nullptr);
+   ATLASSERT(true == CanRead());
+
+   size_t numBytesRead = ReadFully(*m_spHandle,
+      reinterpret_cast<BYTE*>(buffer.data()), buffer.size(), m_position);
+
+   m_position += numBytesRead;
+
+   // the file may have been extended by someone else
+   ExtendFileLength(m_position);
+
+   return numBytesRead;
+}
+
+/// \exception StreamException thrown when reading fails
+size_t FileStream::ReadV(std::span<const std::span<std::byte>> buffers)
+{
+#if defined(__ANDROID__) && __ANDROID_API__ < 24
+   // preadv() is only available from API level 24 on
+   return IStream::ReadV(buffers);
+#else
+   ATLASSERT(m_spHandle.get() != nullptr);
+   ATLASSERT(true == CanRead());
+
+   std::vector<iovec> ioVectors;
+   ioVectors.reserve(buffers.size());
+   for (std::span<std::byte> buffer : buffers)
+      ioVectors.push_back(iovec{ buffer.data(), buffer.size() });
+
+   size_t numBytesRead = ReadFullyV(*m_spHandle, ioVectors, m_position);
+
+   m_position += numBytesRead;
+
+   ExtendFileLength(m_position);
+
+   return numBytesRead;
+#endif
+}
+
+/// \exception StreamException thrown when reading fails
+bool FileStream::ReadAt(ULONGLONG offset, void* buffer, DWORD maxBufferLength, DWORD& numBytesRead)
+{
+   ATLASSERT(m_spHandle.get() != nullptr);
+   ATLASSERT(true == CanRead());
+
+   numBytesRead = static_cast<DWORD>(
+      ReadFully(*m_spHandle, static_cast<BYTE*>(buffer), maxBufferLength, offset));
+
+   return numBytesRead != 0;
+}
+
+bool FileStream::AtEndOfStream() const
+{
+   return !IsOpen() || m_atEndOfFile || m_position >= m_fileLength.load();
+}
+
+/// \exception StreamException thrown when writing fails
+void FileStream::Write(const void* dataToWrite, DWORD lengthInBytes, DWORD& numBytesWritten)
+{
+   numBytesWritten = static_cast<DWORD>(
+      WriteSpan(std::span<const std::byte>(static_cast<const std::byte*>(dataToWrite), lengthInBytes)));
+}
+
+/// \exception StreamException thrown when writing fails
+size_t FileStream::WriteSpan(std::span<const std::byte> data)
+{
+   ATLASSERT(m_spHandle.get() != nullptr);
+   ATLASSERT(true == CanWrite());
+
+   size_t numBytesWritten = WriteFully(*m_spHandle,
+      reinterpret_cast<const BYTE*>(data.data()), data.size(), m_position, m_appendMode);
+
+   UpdatePositionAfterWrite(numBytesWritten);
+
+   return numBytesWritten;
+}
+
+/// \exception StreamException thrown when writing fails
+size_t FileStream::WriteV(std::span<const std::span<const std::byte>> buffers)
+{
+#if defined(__ANDROID__) && __ANDROID_API__ < 24
+   // pwritev() is only available from API level 24 on
+   return IStream::WriteV(buffers);
+#else
+   ATLASSERT(m_spHandle.get() != nullptr);
+   ATLASSERT(true == CanWrite());
+
+   std::vector<iovec> ioVectors;
+   ioVectors.reserve(buffers.size());
+   for (std::span<const std::byte> buffer : buffers)
+      ioVectors.push_back(iovec{ const_cast<std::byte*>(buffer.data()), buffer.size() });
+
+   size_t numBytesWritten = WriteFullyV(*m_spHandle, ioVectors, m_position, m_appendMode);
+
+   UpdatePositionAfterWrite(numBytesWritten);
+
+   return numBytesWritten;
+#endif
+}
+
+/// \exception StreamException thrown when writing fails
+void FileStream::WriteAt(ULONGLONG offset, const void* dataToWrite, DWORD lengthInBytes, DWORD& numBytesWritten)
+{
+   ATLASSERT(m_spHandle.get() != nullptr);
+   ATLASSERT(true == CanWrite());
+
+   // note: on Linux, pwrite() ignores the offset in append mode and
+   // writes at the end of the file
+   numBytesWritten = static_cast<DWORD>(
+      WriteFully(*m_spHandle, static_cast<const BYTE*>(dataToWrite), lengthInBytes, offset, false));
+
+   // other threads may write at the same time
+   ExtendFileLength(offset + numBytesWritten);
+}
+
+void FileStream::UpdatePositionAfterWrite(size_t numBytesWritten)
+{
+   if (m_appendMode)
+      m_position = m_fileLength.fetch_add(numBytesWritten) + numBytesWritten;
+   else
+   {
+      m_position += numBytesWritten;
+      ExtendFileLength(m_position);
+   }
+}
+
+void FileStream::ExtendFileLength(ULONGLONG endPosition)
+{
+   ULONGLONG cachedLength = m_fileLength.load();
+   while (endPosition > cachedLength &&
+      !m_fileLength.compare_exchange_weak(cachedLength, endPosition))
+   {
+      // cachedLength was updated; try again
+   }
+}
+
+/// \exception StreamException thrown when setting file position fails
+ULONGLONG FileStream::Seek(LONGLONG seekOffset, ESeekOrigin origin)
+{
+   ATLASSERT(m_spHandle.get() != nullptr);
+   ATLASSERT(true == CanSeek());
+
+   LONGLONG newPosition = 0;
+
+   switch (origin)
+   {
+   case seekBegin:
+      newPosition = seekOffset;
+      break;
+
+   case seekCurrent:
+      newPosition = static_cast<LONGLONG>(m_position) + seekOffset;
+      break;
+
+   case seekEnd:
+      newPosition = static_cast<LONGLONG>(m_fileLength.load()) + seekOffset;
+      break;
+
+   default:
+      ATLASSERT(false); // invalid seek origin
+      break;
+   }
+
+   // the position stays unchanged, like with lseek()
+   if (newPosition < 0)
+      throw Stream::StreamException(_T("Seek: ") + MessageFromErrno(EINVAL), __FILE__, __LINE__);
+
+   m_position = static_cast<ULONGLONG>(newPosition);
+
+   return m_position;
+}
+
+ULONGLONG FileStream::Position()
+{
+   return m_position;
+}
+
+ULONGLONG FileStream::Length()
+{
+   ATLASSERT(m_spHandle.get() != nullptr);
+
+   return m_fileLength.load();
+}
+
+void FileStream::Flush()
+{
+   ATLASSERT(m_spHandle.get() != nullptr);
+   ATLASSERT(true == CanWrite());
+
+   // nothing to do; data isn't buffered, and is written to the kernel directly
+}
+
+void FileStream::Close()
+{
+   ATLASSERT(m_spHandle.get() != nullptr);
+
+   m_spHandle.reset();
+
+   m_atEndOfFile = true;
+}
@@ -1,6 +1,6 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2006,2007,2008,2014,2017,2025 Michael Fink
+// Copyright (C) 2006,2007,2008,2014,2017,2025,2026 Michael Fink
 //
 /// \file TextStreamFilter.cpp text stream filter
 //
@@ -8,7 +8,6 @@
 #include <ulib/stream/TextStreamFilter.hpp>
 #include <ulib/Exception.hpp>
 #include <ulib/UTF8.hpp>
-#include <vector>
 
 /// character for carriage return
 const TCHAR c_cCR = _T('\r');
@@ -18,6 +17,9 @@ const TCHAR c_cLF = _T('\n');
 
 using Stream::TextStreamFilter;
 
+/// number of bytes read at once, for UTF-8 encoded text
+const DWORD c_readBlockSize = 4096;
+
 TextStreamFilter::TextStreamFilter(Stream::IStream& stream,
    ETextEncoding textEncoding,
    ELineEndingMode lineEndingMode)
@@ -72,74 +74,102 @@ TCHAR TextStreamFilter::ReadChar()
    break;
 
    case textEncodingUTF8:
+      ch = ReadCharUTF8();
+      break;
+
+   case textEncodingUCS2:
+      // assume UCS2-LE
+      ch = m_stream.ReadByte();
+      ch |= static_cast<TCHAR>(m_stream.ReadByte()) << 8;
+      break;
+
+   default:
+      ATLASSERT(false);
+      break;
+   }
+
+   return ch;
+}
+
+TCHAR TextStreamFilter::ReadCharUTF8()
+{
+   if (m_decodedPos == m_decodedLength && !ReadBlockUTF8())
    {
-      // read first octet; determines how much further octets are needed; all
-      // remaining octets start with bit 7 set and bit 6 cleared (10xx xxxx)
-      BYTE bLeading = m_stream.ReadByte();
-      if (bLeading <= 0x7f)
-      {
-         // easy case: char in ASCII zone
-         ch = static_cast<char>(bLeading);
-         break;
-      }
+      ATLASSERT(false); // read past the end of the stream
+      return 0;
+   }
 
-      // count bits from bit 7 until a 0 occurs
-      unsigned int uiCount = 0;
-      while ((bLeading & 0x80) != 0)
-         uiCount++, bLeading <<= 1;
+   wchar_t chw = m_decodedChars[m_decodedPos++];
 
-      // only one bit? or more than 6? illegal value for leading octet!
-      if (uiCount <= 1 || uiCount > 6)
-         throw Exception(_T("illegal utf8 lead byte encountered"), __FILE__, __LINE__);
+#if defined(_UNICODE) || defined(UNICODE)
+   return static_cast<TCHAR>(chw);
+#else
+   CStringA ansiChar(chw);
+   return ansiChar.GetAt(0);
+#endif
+}
 
-      // move remaining bits in position
-      bLeading >>= uiCount;
+bool TextStreamFilter::ReadBlockUTF8()
+{
+   if (m_decodedChars.empty())
+      m_decodedChars.resize(UTF8Decoder::GetMaxDecodedLength(c_readBlockSize));
 
-      // move remaining bits to bits 6..n, so that the next byte's 6 bits
-      // can fill out the dword
-      DWORD dwBits = bLeading;
+   m_decodedLength = 0;
+   m_decodedPos = 0;
 
-      // read in remaining bytes, remove bits 6 and 7 and add it to the resulting byte
-      for (unsigned int ui = 1; ui < uiCount; ui++)
+   // a block may only contain the start of a sequence, so read until at
+   // least one character was decoded
+   while (m_decodedLength == 0)
+   {
+      DWORD numBytesRead = 0;
+      const BYTE* data = ReadBlock(numBytesRead);
+      if (data == nullptr)
       {
-         BYTE bNext = m_stream.ReadByte();
-         if ((bNext & 0xc0) != 0x80)
-            throw Exception(_T("illegal utf8 byte encountered"), __FILE__, __LINE__);
-         dwBits <<= 6;
-         dwBits |= bNext & 0x3f;
+         m_decodedLength = m_utf8Decoder.Finish(m_decodedChars.data());
+         return m_decodedLength > 0;
       }
 
-      if (dwBits > 0xffff)
-         throw Exception(_T("utf8 character out of range"), __FILE__, __LINE__);
+      m_decodedLength = m_utf8Decoder.Decode(reinterpret_cast<const char*>(data), numBytesRead, m_decodedChars.data());
+   }
 
-#if defined(_UNICODE) || defined(UNICODE)
-      ch = static_cast<TCHAR>(dwBits & 0xffff);
-#else
-      WCHAR chw = static_cast<WCHAR>(dwBits & 0xffff);
+   return true;
+}
 
-      CStringA ansiChar(chw);
-      ch = ansiChar.GetAt(0);
-#endif
+const BYTE* TextStreamFilter::ReadBlock(DWORD& numBytesRead)
+{
+   if (m_stream.AtEndOfStream())
+      return nullptr;
+
+   // use the stream's bytes directly, when possible
+   const BYTE* data = m_stream.ReadDirect(c_readBlockSize);
+   if (data != nullptr)
+   {
+      numBytesRead = c_readBlockSize;
+      return data;
    }
-   break;
 
-   case textEncodingUCS2:
-      // assume UCS2-LE
-      ch = m_stream.ReadByte();
-      ch |= static_cast<TCHAR>(m_stream.ReadByte()) << 8;
-      break;
+   if (m_readBuffer.empty())
+      m_readBuffer.resize(c_readBlockSize);
 
-   default:
-      ATLASSERT(false);
-      break;
-   }
+   if (!m_stream.Read(m_readBuffer.data(), static_cast<DWORD>(m_readBuffer.size()), numBytesRead) ||
+      numBytesRead == 0)
+      return nullptr;
 
-   return ch;
+   return m_readBuffer.data();
+}
+
+bool TextStreamFilter::AtEndOfStream() const
+{
+   return !m_isCharPutBack &&
+      m_decodedPos == m_decodedLength &&
+      !m_utf8Decoder.HasPendingBytes() &&
+      m_stream.AtEndOfStream();
 }
 
 void TextStreamFilter::ReadLine(CString& line)
 {
-   line.Empty();
+   // keep the buffer, so that appending characters reuses it
+   line.Truncate(0);
 
    TCHAR lastCharacter = 0;
 #ifdef _WIN32_WCE
@@ -149,7 +179,7 @@ void TextStreamFilter::ReadLine(CString& line)
 #endif
 
    // depending on the line type, read in a line of characters
-   for (; !m_stream.AtEndOfStream();)
+   for (; !AtEndOfStream();)
    {
       TCHAR ch = ReadChar();
 
@@ -170,7 +200,7 @@ void TextStreamFilter::ReadLine(CString& line)
          if (m_lineEndingMode == lineEndingCRLF)
          {
             // check if at end of stream
-            if (m_stream.AtEndOfStream())
+            if (AtEndOfStream())
                break;
 
             // threre might be a LF, but we don't know for sure, so check
@@ -202,8 +232,10 @@ void TextStreamFilter::ReadLine(CString& line)
             // not CR nor LF, but previous was a CR
             if (m_lineEndingMode == lineEndingReadAny && lastCharacter == c_cCR)
             {
-               // recognized a CR line ending; try to put back current
-               if (m_stream.CanSeek())
+               // recognized a CR line ending; try to put back current; UTF-8
+               // encoded text is read in blocks, so the stream position
+               // is already past the character
+               if (m_stream.CanSeek() && m_textEncoding != textEncodingUTF8)
                {
                   // seek back to previous position
                   m_stream.Seek(position, Stream::IStream::seekBegin);
@@ -225,8 +257,51 @@ void TextStreamFilter::ReadLine(CString& line)
 
 void TextStreamFilter::Write(const CString& text)
 {
-   // write text in proper encoding
+   EncodeText(text, m_writeBuffer);
+
    DWORD numWriteBytes = 0;
+   if (!m_writeBuffer.empty())
+      m_stream.Write(m_writeBuffer.data(), static_cast<DWORD>(m_writeBuffer.size()), numWriteBytes);
+}
+
+void TextStreamFilter::WriteEndline()
+{
+   Write(GetLineEnding());
+}
+
+void TextStreamFilter::WriteLine(const CString& line)
+{
+   EncodeText(line, m_writeBuffer);
+   EncodeText(GetLineEnding(), m_lineEndingBuffer);
+
+   const std::span<const std::byte> buffers[] =
+   {
+      std::as_bytes(std::span<const char>(m_writeBuffer)),
+      std::as_bytes(std::span<const char>(m_lineEndingBuffer)),
+   };
+
+   m_stream.WriteV(buffers);
+}
+
+LPCTSTR TextStreamFilter::GetLineEnding() const
+{
+   ATLASSERT(m_lineEndingMode != lineEndingReadAny);
+
+   switch (m_lineEndingMode)
+   {
+   case lineEndingCRLF: return _T("\r\n");
+   case lineEndingLF:   return _T("\n");
+   case lineEndingCR:   return _T("\r");
+
+   default:
+      ATLASSERT(false);
+      return _T("");
+   }
+}
+
+void TextStreamFilter::EncodeText(const CString& text, std::string& buffer) const
+{
+   buffer.clear();
 
    switch (m_textEncoding)
    {
@@ -235,25 +310,19 @@ void TextStreamFilter::Write(const CString& text)
       CStringA ansiText { text };
       LPCSTR textPtr = ansiText.GetString();
       if (ansiText.GetLength() > 0 && textPtr != nullptr)
-         m_stream.Write(textPtr, static_cast<DWORD>(strlen(textPtr) * sizeof(*textPtr)), numWriteBytes);
+         buffer.assign(textPtr, strlen(textPtr));
    }
    break;
 
    case textEncodingUTF8:
-   {
-      std::vector<char> buffer;
-      StringToUTF8(text, buffer);
-
-      // don't write null byte at the end
-      m_stream.Write(buffer.data(), static_cast<DWORD>(buffer.size() - 1), numWriteBytes);
-   }
-   break;
+      StringToUTF8(text.GetString(), static_cast<size_t>(text.GetLength()), buffer);
+      break;
 
    case textEncodingUCS2:
    {
       CStringW unicodeText = text;
       LPCWSTR textPtr = unicodeText;
-      m_stream.Write(textPtr, static_cast<DWORD>(wcslen(textPtr) * sizeof(*textPtr)), numWriteBytes);
+      buffer.assign(reinterpret_cast<const char*>(textPtr), wcslen(textPtr) * sizeof(*textPtr));
    }
    break;
 
@@ -263,22 +332,6 @@ void TextStreamFilter::Write(const CString& text)
    }
 }
 
-void TextStreamFilter::WriteEndline()
-{
-   ATLASSERT(m_lineEndingMode != lineEndingReadAny);
-
-   switch (m_lineEndingMode)
-   {
-   case lineEndingCRLF: Write(_T("\r\n")); break;
-   case lineEndingLF:   Write(_T("\n")); break;
-   case lineEndingCR:   Write(_T("\r")); break;
-
-   default:
-      ATLASSERT(false);
-      break;
-   }
-}
-
 void TextStreamFilter::PutBackChar(TCHAR ch)
 {
    ATLASSERT(false == m_isCharPutBack);
@@ -1,11 +1,12 @@
 //
 // ulib - a collection of useful classes
-// Copyright (C) 2004,2005,2006,2007,2008,2018,2020 Michael Fink
+// Copyright (C) 2004,2005,2006,2007,2008,2018,2020,2026 Michael Fink
 //
 /// \file VersionInfoResource.cpp version info resource class
 //
 #include "stdafx.h"
 #include <ulib/win32/VersionInfoResource.hpp>
+#include <ulib/StringNumber.hpp>
 #include <WinBase.h> // for VOS_* constants
 #include <winver.h> // for VOS_* constants, when not in winbase.h
 
@@ -25,22 +26,28 @@ using Win32::LANGANDCODEPAGE;
 // FixedFileInfo
 //
 
-CString FixedFileInfo::GetFileVersion() const
+/// formats version number from most and least significant parts, as a.b.c.d
+static CString FormatVersion(DWORD versionMS, DWORD versionLS)
 {
    CString text;
-   text.Format(_T("%u.%u.%u.%u"),
-      HIWORD(dwFileVersionMS), LOWORD(dwFileVersionMS),
-      HIWORD(dwFileVersionLS), LOWORD(dwFileVersionLS));
+   StringNumber::AppendUInt(text, HIWORD(versionMS));
+   text += _T('.');
+   StringNumber::AppendUInt(text, LOWORD(versionMS));
+   text += _T('.');
+   StringNumber::AppendUInt(text, HIWORD(versionLS));
+   text += _T('.');
+   StringNumber::AppendUInt(text, LOWORD(versionLS));
    return text;
 }
 
+CString FixedFileInfo::GetFileVersion() const
+{
+   return FormatVersion(dwFileVersionMS, dwFileVersionLS);
+}
+
 CString FixedFileInfo::GetProductVersion() const
 {
-   CString text;
-   text.Format(_T("%u.%u.%u.%u"),
-      HIWORD(dwProductVersionMS), LOWORD(dwProductVersionMS),
-      HIWORD(dwProductVersionLS), LOWORD(dwProductVersionLS));
-   return text;
+   return FormatVersion(dwProductVersionMS, dwProductVersionLS);
 }
 
 CString FixedFileInfo::GetFileOS() const